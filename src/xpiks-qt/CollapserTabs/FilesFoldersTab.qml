@@ -144,6 +144,7 @@ ColumnLayout {
                             anchors.verticalCenter: parent.verticalCenter
                             isActive: false
                             crossOpacity: 1
+                            enabled: !artItemsModel.isScanningDirectories
 
                             onItemClicked: {
                                 if (mustUseConfirmation()) {
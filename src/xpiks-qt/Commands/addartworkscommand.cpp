@@ -91,27 +91,36 @@ std::shared_ptr<Commands::ICommandResult> Commands::AddArtworksCommand::execute(
     Models::ArtworksRepository *artworksRepository = commandManager->getArtworksRepository();
     Models::ArtItemsModel *artItemsModel = commandManager->getArtItemsModel();
 
-    const int newFilesCount = artworksRepository->getNewFilesCount(m_FilePathes);
+    // dedup and filesystem checks for the whole batch at once,
+    // directory scanner has checked its files already
+    Models::ArtworksRepository::PreparedFiles preparedFiles;
+    if (m_IsPartOfScan) {
+        artworksRepository->prepareScannedFiles(m_FilePathes, m_Directories, preparedFiles);
+    } else {
+        artworksRepository->prepareFiles(m_FilePathes, preparedFiles);
+    }
+
+    const int newFilesCount = preparedFiles.m_Filepaths.length();
     const int initialCount = artItemsModel->rowCount();
-    const bool filesWereAccounted = artworksRepository->beginAccountingFiles(m_FilePathes);
+    const bool filesWereAccounted = artworksRepository->beginAccountingDirectories(preparedFiles.m_NewDirectoriesCount);
 
     QVector<Models::ArtworkMetadata*> artworksToImport;
     artworksToImport.reserve(newFilesCount);
     QStringList filesToWatch;
     filesToWatch.reserve(newFilesCount);
+    QVector<int> modifiedIndices;
+    int matchedVectorsCount = 0;
 
     if (newFilesCount > 0) {
         LOG_INFO << newFilesCount << "new files found";
         LOG_INFO << "Current files count is" << initialCount;
         artItemsModel->beginAccountingFiles(newFilesCount);
 
-        const int count = m_FilePathes.count();
-
-        for (int i = 0; i < count; ++i) {
-            const QString &filename = m_FilePathes[i];
+        for (int i = 0; i < newFilesCount; ++i) {
+            const QString &filename = preparedFiles.m_Filepaths[i];
             qint64 directoryID = 0;
 
-            if (artworksRepository->accountFile(filename, directoryID)) {
+            if (artworksRepository->accountPreparedFile(filename, preparedFiles.m_Directories[i], directoryID)) {
                 Models::ArtworkMetadata *metadata = artItemsModel->createMetadata(filename, directoryID);
                 commandManager->connectArtworkSignals(metadata);
 
@@ -120,6 +129,16 @@ std::shared_ptr<Commands::ICommandResult> Commands::AddArtworksCommand::execute(
                 artItemsModel->appendMetadata(metadata);
                 artworksToImport.append(metadata);
                 filesToWatch.append(filename);
+
+                if (!m_MatchedVectors.isEmpty()) {
+                    const QString vectorPath = m_MatchedVectors.value(filename);
+                    Models::ImageArtwork *image = dynamic_cast<Models::ImageArtwork *>(metadata);
+                    if (!vectorPath.isEmpty() && (image != NULL)) {
+                        image->attachVector(vectorPath);
+                        modifiedIndices.append(initialCount + artworksToImport.size() - 1);
+                        matchedVectorsCount++;
+                    }
+                }
             } else {
                 LOG_INFO << "Rejected file:" << filename;
             }
@@ -134,9 +153,8 @@ std::shared_ptr<Commands::ICommandResult> Commands::AddArtworksCommand::execute(
 
     QHash<QString, QHash<QString, QString> > vectorsHash;
     decomposeVectors(vectorsHash);
-    QVector<int> modifiedIndices;
 
-    int attachedCount = artItemsModel->attachVectors(vectorsHash, modifiedIndices);
+    int attachedCount = matchedVectorsCount + artItemsModel->attachVectors(vectorsHash, modifiedIndices);
 
     if (m_AutoDetectVectors) {
         QVector<int> autoAttachedIndices;
@@ -147,25 +165,37 @@ std::shared_ptr<Commands::ICommandResult> Commands::AddArtworksCommand::execute(
         }
     }
 
+    std::shared_ptr<AddArtworksCommandResult> result(new AddArtworksCommandResult(newFilesCount));
+    result->m_AttachedVectorsCount = attachedCount;
+
     if (newFilesCount > 0) {
         int length = artItemsModel->rowCount();
         int start = length - newFilesCount, end = length - 1;
         QVector<QPair<int, int> > ranges;
         ranges << qMakePair(start, end);
-        commandManager->readMetadata(artworksToImport, ranges);
         accountVectors(artworksRepository, artworksToImport);
         artworksRepository->updateCountsForExistingDirectories();
 
-        std::unique_ptr<UndoRedo::IHistoryItem> addArtworksItem(new UndoRedo::AddArtworksHistoryItem(getCommandID() ,initialCount, newFilesCount));
-        commandManager->recordHistoryItem(addArtworksItem);
+        if (m_IsPartOfScan) {
+            result->m_ArtworksToImport = artworksToImport;
+            result->m_AddedRanges = ranges;
+            result->m_AddedFiles = filesToWatch;
+        } else {
+            commandManager->readMetadata(artworksToImport, ranges);
+
+            std::unique_ptr<UndoRedo::IHistoryItem> addArtworksItem(new UndoRedo::AddArtworksHistoryItem(getCommandID() ,initialCount, newFilesCount));
+            commandManager->recordHistoryItem(addArtworksItem);
+
+            commandManager->addToRecentFiles(filesToWatch);
+        }
+    }
 
-        commandManager->addToRecentFiles(filesToWatch);
+    if (!m_IsPartOfScan) {
+        artItemsModel->raiseArtworksAdded(newFilesCount, attachedCount);
     }
 
-    artItemsModel->raiseArtworksAdded(newFilesCount, attachedCount);
     artItemsModel->updateItems(modifiedIndices, QVector<int>() << Models::ArtItemsModel::HasVectorAttachedRole);
 
-    std::shared_ptr<AddArtworksCommandResult> result(new AddArtworksCommandResult(newFilesCount));
     return result;
 }
 
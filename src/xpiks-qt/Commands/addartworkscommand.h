@@ -24,8 +24,14 @@
 
 #include <QStringList>
 #include <QHash>
+#include <QVector>
+#include <QPair>
 #include "commandbase.h"
 
+namespace Models {
+    class ArtworkMetadata;
+}
+
 namespace Commands {
     class AddArtworksCommand : public CommandBase
     {
@@ -34,7 +40,19 @@ namespace Commands {
             CommandBase(CommandType::AddArtworks),
             m_FilePathes(pathes),
             m_VectorsPathes(vectorPathes),
-            m_AutoDetectVectors(autoDetectVectors)
+            m_AutoDetectVectors(autoDetectVectors),
+            m_IsPartOfScan(false)
+        {}
+
+        // batch of a directory scan: vectors are matched already and
+        // metadata import and history are done once for the whole scan
+        AddArtworksCommand(const QStringList &pathes, const QStringList &directories, const QHash<QString, QString> &matchedVectors) :
+            CommandBase(CommandType::AddArtworks),
+            m_FilePathes(pathes),
+            m_Directories(directories),
+            m_MatchedVectors(matchedVectors),
+            m_AutoDetectVectors(false),
+            m_IsPartOfScan(true)
         {}
 
         virtual ~AddArtworksCommand();
@@ -48,16 +66,27 @@ namespace Commands {
     public:
         QStringList m_FilePathes;
         QStringList m_VectorsPathes;
+        // directory of each file found by directory scanner
+        QStringList m_Directories;
+        // image path to vector path
+        QHash<QString, QString> m_MatchedVectors;
         bool m_AutoDetectVectors;
+        bool m_IsPartOfScan;
     };
 
     class AddArtworksCommandResult : public CommandResult {
     public:
         AddArtworksCommandResult(int count):
-        m_NewFilesAdded(count)
+        m_NewFilesAdded(count),
+        m_AttachedVectorsCount(0)
         {}
     public:
         int m_NewFilesAdded;
+        int m_AttachedVectorsCount;
+        // filled only for batches of a directory scan
+        QVector<Models::ArtworkMetadata*> m_ArtworksToImport;
+        QVector<QPair<int, int> > m_AddedRanges;
+        QStringList m_AddedFiles;
     };
 }
 
@@ -289,6 +289,18 @@ void Commands::CommandManager::connectEntitiesSignalsSlots() const {
                          m_FilteredItemsModel, SLOT(onSettingsUpdated()));
     }
 
+#ifndef CORE_TESTS
+    if (m_SettingsModel != NULL && m_ImageCachingService != NULL) {
+        QObject::connect(m_SettingsModel, SIGNAL(imagesCacheSizeChanged(int)),
+                         m_ImageCachingService, SLOT(imagesCacheSizeChangedHandler(int)));
+    }
+
+    if (m_ArtworksRepository != NULL && m_ImageCachingService != NULL) {
+        QObject::connect(m_ArtworksRepository, SIGNAL(filesChangedInDirectories(QStringList)),
+                         m_ImageCachingService, SLOT(filesChangedHandler(QStringList)));
+    }
+#endif
+
     if (m_SpellCheckerService != NULL && m_FilteredItemsModel != NULL) {
         QObject::connect(m_SpellCheckerService, SIGNAL(serviceAvailable(bool)),
                          m_FilteredItemsModel, SLOT(onSpellCheckerAvailable(bool)));
@@ -786,6 +798,7 @@ void Commands::CommandManager::afterConstructionCallback() {
     m_AfterInitCalled = true;
 
 #ifndef CORE_TESTS
+    m_ImageCachingService->setMaxCacheSize((qint64)m_SettingsModel->getImagesCacheSize() * 1024 * 1024);
     m_ImageCachingService->startService();
 #endif
     m_SpellCheckerService->startService();
@@ -853,6 +866,7 @@ void Commands::CommandManager::beforeDestructionCallback() const {
     m_MetadataSaverService->stopSaving();
     m_AutoCompleteService->stopService();
     m_TranslationService->stopService();
+    m_MetadataIOCoordinator->stopExiftool();
 
 #ifndef CORE_TESTS
 
@@ -903,7 +917,8 @@ void Commands::CommandManager::removeUnavailableFiles() {
     m_ArtItemsModel->removeUnavailableItems();
 
 #ifndef CORE_TESTS
-    m_UndoRedoManager->discardLastAction();
+    // indices stored in history are no longer valid
+    m_UndoRedoManager->clearHistory();
 #endif
 
     if (m_ArtworksRepository->canPurgeUnavailableFiles()) {
@@ -29,41 +29,132 @@
 #include "../UndoRedo/modifyartworkshistoryitem.h"
 #include "../Common/defines.h"
 #include "../Helpers/filterhelpers.h"
+#include "../Helpers/stringhelper.h"
 
 namespace Commands {
+    bool anyKeywordMatches(const QStringList &keywords, const QString &replaceWhat, Common::SearchFlags flags) {
+        const bool wholeWords = Common::HasFlag(flags, Common::SearchFlags::WholeWords);
+        const bool caseSensitive = Common::HasFlag(flags, Common::SearchFlags::CaseSensitive);
+        const Qt::CaseSensitivity caseSensivity = caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+        bool anyMatch = false;
+
+        for (const QString &keyword: keywords) {
+            anyMatch = wholeWords ?
+                        Helpers::containsWholeWords(keyword, replaceWhat, caseSensivity) :
+                        keyword.contains(replaceWhat, caseSensivity);
+            if (anyMatch) { break; }
+        }
+
+        return anyMatch;
+    }
+
+    ReplacePlan ReplacePlanner::operator()(int elementIndex) const {
+        ReplacePlan plan(elementIndex);
+        Models::ArtworkMetadata *metadata = m_MetadataElements->at(elementIndex).getOrigin();
+
+        if (Common::HasFlag(m_Flags, Common::SearchFlags::Description)) {
+            const QString description = metadata->getDescription();
+            plan.m_Description = Helpers::replaceInText(description, m_ReplaceWhat, m_ReplaceTo, m_Flags);
+            plan.m_DescriptionChanged = plan.m_Description != description;
+        }
+
+        if (Common::HasFlag(m_Flags, Common::SearchFlags::Title)) {
+            const QString title = metadata->getTitle();
+            plan.m_Title = Helpers::replaceInText(title, m_ReplaceWhat, m_ReplaceTo, m_Flags);
+            plan.m_TitleChanged = plan.m_Title != title;
+        }
+
+        if (Common::HasFlag(m_Flags, Common::SearchFlags::Keywords)) {
+            plan.m_KeywordsMatch = anyKeywordMatches(metadata->getKeywords(), m_ReplaceWhat, m_Flags);
+        }
+
+        return plan;
+    }
+
+    QVector<int> getSelectedElements(const std::vector<Models::PreviewMetadataElement> &metadataElements) {
+        QVector<int> selected;
+        selected.reserve((int)metadataElements.size());
+
+        const int size = (int)metadataElements.size();
+        for (int i = 0; i < size; ++i) {
+            if (metadataElements.at(i).isSelected()) {
+                selected.append(i);
+            }
+        }
+
+        return selected;
+    }
+
     FindAndReplaceCommand::~FindAndReplaceCommand() { LOG_DEBUG << "#"; }
 
     std::shared_ptr<Commands::ICommandResult> FindAndReplaceCommand::execute(const ICommandManager *commandManagerInterface) const {
         LOG_INFO << "Replacing [" << m_ReplaceWhat << "] to [" << m_ReplaceTo << "] in" << m_MetadataElements.size() << "item(s)";
         CommandManager *commandManager = (CommandManager *)commandManagerInterface;
 
+        QVector<ReplacePlan> plans;
+
+        if (m_IsPlanned) {
+            plans = m_Plans;
+        } else {
+            const QVector<int> selected = getSelectedElements(m_MetadataElements);
+            ReplacePlanner planner(&m_MetadataElements, m_ReplaceWhat, m_ReplaceTo, m_Flags);
+
+            plans.reserve(selected.size());
+            for (int elementIndex: selected) {
+                plans.append(planner(elementIndex));
+            }
+        }
+
+        Common::SearchFlags keywordsFlags = m_Flags;
+        Common::UnsetFlag(keywordsFlags, Common::SearchFlags::Description);
+        Common::UnsetFlag(keywordsFlags, Common::SearchFlags::Title);
+
         std::vector<UndoRedo::ArtworkMetadataBackup> artworksBackups;
+        artworksBackups.reserve(plans.size());
 
         QVector<int> indicesToUpdate;
         QVector<Models::ArtworkMetadata *> itemsToSave;
 
-        size_t size = m_MetadataElements.size();
-        itemsToSave.reserve((int)size);
-        indicesToUpdate.reserve((int)size);
-
-        for (size_t i = 0; i < size; i++) {
-            const Models::PreviewMetadataElement &element = m_MetadataElements.at(i);
-            if (!element.isSelected()) {
-                continue;
-            }
+        int size = plans.size();
+        itemsToSave.reserve(size);
+        indicesToUpdate.reserve(size);
 
+        // keywords models are bound to views so edits are applied here
+        for (int i = 0; i < size; i++) {
+            const ReplacePlan &plan = plans.at(i);
+            const Models::PreviewMetadataElement &element = m_MetadataElements.at(plan.m_ElementIndex);
             Models::ArtworkMetadata *metadata = element.getOrigin();
             int index = element.getOriginalIndex();
 
+            if (!plan.m_KeywordsMatch && !plan.m_DescriptionChanged && !plan.m_TitleChanged) {
+                LOG_INFO << "Failed to replace [" << m_ReplaceWhat << "] to [" << m_ReplaceTo << "] in" << metadata->getFilepath();
+                continue;
+            }
+
             artworksBackups.emplace_back(metadata);
 
-            bool succeeded = metadata->replace(m_ReplaceWhat, m_ReplaceTo, m_Flags);
+            bool succeeded = false;
+
+            if (plan.m_KeywordsMatch && metadata->replace(m_ReplaceWhat, m_ReplaceTo, keywordsFlags)) {
+                succeeded = true;
+            }
+
+            if (plan.m_DescriptionChanged && metadata->setDescription(plan.m_Description)) {
+                succeeded = true;
+            }
+
+            if (plan.m_TitleChanged && metadata->setTitle(plan.m_Title)) {
+                succeeded = true;
+            }
+
             if (succeeded) {
                 LOG_FOR_TESTS << "Succeeded";
                 itemsToSave.append(metadata);
                 indicesToUpdate.append(index);
             } else {
                 LOG_INFO << "Failed to replace [" << m_ReplaceWhat << "] to [" << m_ReplaceTo << "] in" << metadata->getFilepath();
+                artworksBackups.pop_back();
             }
         }
 
@@ -33,6 +33,45 @@ namespace Models {
 }
 
 namespace Commands {
+    // new values for one of the metadata elements, artwork itself is not modified
+    struct ReplacePlan {
+        ReplacePlan(int elementIndex=-1):
+            m_ElementIndex(elementIndex),
+            m_DescriptionChanged(false),
+            m_TitleChanged(false),
+            m_KeywordsMatch(false)
+        {}
+
+        int m_ElementIndex;
+        QString m_Description;
+        QString m_Title;
+        bool m_DescriptionChanged;
+        bool m_TitleChanged;
+        bool m_KeywordsMatch;
+    };
+
+    // only reads artworks so it can be used with QtConcurrent::mapped()
+    struct ReplacePlanner {
+        typedef ReplacePlan result_type;
+
+        ReplacePlanner(const std::vector<Models::PreviewMetadataElement> *metadataElements,
+                       const QString &replaceWhat, const QString &replaceTo, Common::SearchFlags flags):
+            m_MetadataElements(metadataElements),
+            m_ReplaceWhat(replaceWhat),
+            m_ReplaceTo(replaceTo),
+            m_Flags(flags)
+        {}
+
+        ReplacePlan operator()(int elementIndex) const;
+
+        const std::vector<Models::PreviewMetadataElement> *m_MetadataElements;
+        QString m_ReplaceWhat;
+        QString m_ReplaceTo;
+        Common::SearchFlags m_Flags;
+    };
+
+    QVector<int> getSelectedElements(const std::vector<Models::PreviewMetadataElement> &metadataElements);
+
     class FindAndReplaceCommand:
         public CommandBase
     {
@@ -43,7 +82,21 @@ namespace Commands {
             m_MetadataElements(std::move(metadataElements)),
             m_ReplaceWhat(replaceWhat),
             m_ReplaceTo(replaceTo),
-            m_Flags(flags)
+            m_Flags(flags),
+            m_IsPlanned(false)
+        {}
+
+        // plans for selected elements were computed in the background with ReplacePlanner
+        FindAndReplaceCommand(std::vector<Models::PreviewMetadataElement> &metadataElements,
+        const QVector<ReplacePlan> &plans,
+        const QString &replaceWhat, const QString &replaceTo, Common::SearchFlags flags):
+            CommandBase(CommandType::FindAndReplace),
+            m_MetadataElements(std::move(metadataElements)),
+            m_Plans(plans),
+            m_ReplaceWhat(replaceWhat),
+            m_ReplaceTo(replaceTo),
+            m_Flags(flags),
+            m_IsPlanned(true)
         {}
 
         virtual ~FindAndReplaceCommand();
@@ -53,9 +106,11 @@ namespace Commands {
 
     private:
         std::vector<Models::PreviewMetadataElement> m_MetadataElements;
+        QVector<ReplacePlan> m_Plans;
         QString m_ReplaceWhat;
         QString m_ReplaceTo;
         Common::SearchFlags m_Flags;
+        bool m_IsPlanned;
     };
 
     class FindAndReplaceCommandResult:
@@ -36,7 +36,8 @@
 namespace Common {
     BasicKeywordsModel::BasicKeywordsModel(Hold &hold, QObject *parent):
         AbstractListModel(parent),
-        m_Hold(hold)
+        m_Hold(hold),
+        m_Revision(0)
     {}
 
     void BasicKeywordsModel::removeItemsAtIndices(const QVector<QPair<int, int> > &ranges) {
@@ -295,6 +296,7 @@ namespace Common {
 
             beginInsertRows(QModelIndex(), keywordsCount, keywordsCount);
             m_KeywordsList.append(sanitizedKeyword);
+            incrementRevision();
             endInsertRows();
             added = true;
         }
@@ -310,6 +312,7 @@ namespace Common {
 
         removedKeyword = m_KeywordsList.takeAt(index);
         wasCorrect = m_SpellCheckResults.takeAt(index);
+        incrementRevision();
     }
 
     void BasicKeywordsModel::setKeywordsUnsafe(const QStringList &keywordsList) {
@@ -350,6 +353,7 @@ namespace Common {
                 m_KeywordsList.append(keywordToAdd);
             }
 
+            incrementRevision();
             endInsertRows();
         }
 
@@ -393,12 +397,14 @@ namespace Common {
                 m_KeywordsSet.insert(lowerCasedNew);
                 m_KeywordsList[index] = sanitized;
                 m_KeywordsSet.remove(lowerCasedExisting);
+                incrementRevision();
                 LOG_INFO << "common case edit:" << existing << "->" << sanitized;
 
                 result = true;
             } else if (lowerCasedNew == lowerCasedExisting) {
                 LOG_INFO << "changing case in same keyword";
                 m_KeywordsList[index] = sanitized;
+                incrementRevision();
 
                 result = true;
             } else {
@@ -439,6 +445,7 @@ namespace Common {
         if (anyKeywords) {
             beginResetModel();
             m_KeywordsList.clear();
+            incrementRevision();
             endResetModel();
 
             m_SpellCheckResults.clear();
@@ -30,6 +30,7 @@
 #include <QSet>
 #include <QVector>
 #include <QReadWriteLock>
+#include <QAtomicInt>
 #include "baseentity.h"
 #include "hold.h"
 #include "../Common/flags.h"
@@ -75,6 +76,13 @@ namespace Common {
         virtual int rowCount(const QModelIndex &parent=QModelIndex()) const override;
         virtual QVariant data(const QModelIndex &index, int role=Qt::DisplayRole) const override;
 
+    public:
+        // changes every time keywords or other metadata are modified
+        int getRevision() const { return m_Revision.loadAcquire(); }
+
+    protected:
+        void incrementRevision() { m_Revision.fetchAndAddOrdered(1); }
+
     public:
         int getKeywordsCount();
         QSet<QString> getKeywordsSet();
@@ -178,6 +186,7 @@ namespace Common {
         QSet<QString> m_KeywordsSet;
         QReadWriteLock m_KeywordsLock;
         QVector<bool> m_SpellCheckResults;
+        QAtomicInt m_Revision;
     };
 }
 
@@ -28,6 +28,7 @@
 #include "../SpellCheck/spellcheckiteminfo.h"
 #include "../Helpers/keywordshelpers.h"
 #include "../Helpers/stringhelper.h"
+#include "../Helpers/filterhelpers.h"
 #include "flags.h"
 #include "../Common/defines.h"
 #include "../Helpers/indiceshelper.h"
@@ -186,17 +187,7 @@ namespace Common {
     bool BasicMetadataModel::replaceInDescription(const QString &replaceWhat, const QString &replaceTo,
                                                   Common::SearchFlags flags) {
         LOG_DEBUG << "#";
-        const bool wholeWords = Common::HasFlag(flags, Common::SearchFlags::WholeWords);
-        const bool caseSensitive = Common::HasFlag(flags, Common::SearchFlags::CaseSensitive);
-        const Qt::CaseSensitivity caseSensivity = caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
-
-        QString description = getDescription();
-        if (!wholeWords) {
-            description.replace(replaceWhat, replaceTo, caseSensivity);
-        } else {
-            description = Helpers::replaceWholeWords(description, replaceWhat, replaceTo, caseSensivity);
-        }
-
+        QString description = Helpers::replaceInText(getDescription(), replaceWhat, replaceTo, flags);
         bool result = setDescription(description);
         return result;
     }
@@ -204,17 +195,7 @@ namespace Common {
     bool BasicMetadataModel::replaceInTitle(const QString &replaceWhat, const QString &replaceTo,
                                             Common::SearchFlags flags) {
         LOG_DEBUG << "#";
-        const bool wholeWords = Common::HasFlag(flags, Common::SearchFlags::WholeWords);
-        const bool caseSensitive = Common::HasFlag(flags, Common::SearchFlags::CaseSensitive);
-        const Qt::CaseSensitivity caseSensivity = caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
-
-        QString title = getTitle();
-        if (!wholeWords) {
-            title.replace(replaceWhat, replaceTo, caseSensivity);
-        } else {
-            title = Helpers::replaceWholeWords(title, replaceWhat, replaceTo, caseSensivity);
-        }
-
+        QString title = Helpers::replaceInText(getTitle(), replaceWhat, replaceTo, flags);
         bool result = setTitle(title);
         return result;
     }
@@ -298,6 +279,7 @@ namespace Common {
         bool result = value != m_Description;
         if (result) {
             m_Description = value;
+            incrementRevision();
         }
 
         return result;
@@ -311,6 +293,7 @@ namespace Common {
         bool result = value != m_Title;
         if (result) {
             m_Title = value;
+            incrementRevision();
         }
 
         return result;
@@ -0,0 +1,123 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOUNDEDMPMCQUEUE_H
+#define BOUNDEDMPMCQUEUE_H
+
+#include <QAtomicInteger>
+#include <QtGlobal>
+#include <memory>
+#include <utility>
+
+namespace Common {
+    // lock-free bounded queue for any number of producers and consumers
+    // every cell carries a sequence number which tells whose turn it is:
+    // producer of the lap when it equals the position, consumer when it is position + 1
+    template<typename T>
+    class BoundedMPMCQueue
+    {
+    private:
+        struct Cell {
+            QAtomicInteger<quint32> m_Sequence;
+            T m_Data;
+        };
+
+    public:
+        // capacity is rounded up to the power of two
+        BoundedMPMCQueue(quint32 capacity):
+            m_EnqueuePosition(0),
+            m_DequeuePosition(0)
+        {
+            quint32 size = 2;
+            while (size < capacity) { size <<= 1; }
+
+            m_Mask = size - 1;
+            m_Cells.reset(new Cell[size]);
+
+            for (quint32 i = 0; i < size; ++i) {
+                m_Cells[i].m_Sequence.storeRelease(i);
+            }
+        }
+
+    public:
+        quint32 capacity() const { return m_Mask + 1; }
+
+    public:
+        bool tryPush(const T &item) {
+            Cell *cell = nullptr;
+            quint32 position = m_EnqueuePosition.loadAcquire();
+
+            for (;;) {
+                cell = &m_Cells[position & m_Mask];
+                const quint32 sequence = cell->m_Sequence.loadAcquire();
+                const qint32 diff = (qint32)(sequence - position);
+
+                if (diff == 0) {
+                    if (m_EnqueuePosition.testAndSetOrdered(position, position + 1)) { break; }
+                    position = m_EnqueuePosition.loadAcquire();
+                } else if (diff < 0) {
+                    // consumers did not free this cell yet
+                    return false;
+                } else {
+                    position = m_EnqueuePosition.loadAcquire();
+                }
+            }
+
+            cell->m_Data = item;
+            cell->m_Sequence.storeRelease(position + 1);
+            return true;
+        }
+
+        bool tryPop(T &item) {
+            Cell *cell = nullptr;
+            quint32 position = m_DequeuePosition.loadAcquire();
+
+            for (;;) {
+                cell = &m_Cells[position & m_Mask];
+                const quint32 sequence = cell->m_Sequence.loadAcquire();
+                const qint32 diff = (qint32)(sequence - (position + 1));
+
+                if (diff == 0) {
+                    if (m_DequeuePosition.testAndSetOrdered(position, position + 1)) { break; }
+                    position = m_DequeuePosition.loadAcquire();
+                } else if (diff < 0) {
+                    // producer did not fill this cell yet
+                    return false;
+                } else {
+                    position = m_DequeuePosition.loadAcquire();
+                }
+            }
+
+            item = std::move(cell->m_Data);
+            cell->m_Data = T();
+            cell->m_Sequence.storeRelease(position + m_Mask + 1);
+            return true;
+        }
+
+    private:
+        std::unique_ptr<Cell[]> m_Cells;
+        quint32 m_Mask;
+        QAtomicInteger<quint32> m_EnqueuePosition;
+        QAtomicInteger<quint32> m_DequeuePosition;
+    };
+}
+
+#endif // BOUNDEDMPMCQUEUE_H
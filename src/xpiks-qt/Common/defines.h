@@ -35,8 +35,22 @@
 #define qInfo qDebug
 #endif
 
+// disabled levels are compiled out: 0 - debug, 1 - info, 2 - warnings only
+#ifndef XPIKS_LOG_LEVEL
+#define XPIKS_LOG_LEVEL 0
+#endif
+
+#if (XPIKS_LOG_LEVEL > 0)
+#define LOG_DEBUG if (1) {} else qDebug()
+#else
 #define LOG_DEBUG qDebug()
+#endif
+
+#if (XPIKS_LOG_LEVEL > 1)
+#define LOG_INFO if (1) {} else qInfo()
+#else
 #define LOG_INFO qInfo()
+#endif
 
 #ifdef QT_DEBUG
 #define LOG_FOR_DEBUG qDebug()
@@ -24,20 +24,61 @@
 
 #include <QWaitCondition>
 #include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QAtomicInt>
+#include <QHash>
+#include <QPair>
 #include <deque>
+#include <algorithm>
 #include <memory>
 #include <vector>
+#include <functional>
 #include "../Common/defines.h"
+#include "boundedmpmcqueue.h"
 
 namespace Common {
+    // runs additional consumers of the same worker
+    class ConsumerThread: public QThread
+    {
+    public:
+        ConsumerThread(const std::function<void()> &loop):
+            m_Loop(loop)
+        { }
+
+    protected:
+        virtual void run() override { m_Loop(); }
+
+    private:
+        std::function<void()> m_Loop;
+    };
+
+    // identity of the item and kind of work which is done for it
+    typedef QPair<quintptr, int> CoalescingKey;
+
+    // items submitted from the GUI thread go to the lock-free ring when it is enabled
+    // and to the locked queue when the ring is full or the item has to go first
+    // item with the same coalescing key as a queued one is merged with it and queued again
+    // while the superseded one is dropped when it is taken from the queue
     template<typename T>
     class ItemProcessingWorker
     {
     public:
-        ItemProcessingWorker():
+        ItemProcessingWorker(int consumersCount=1, quint32 ringCapacity=0):
+            m_PendingCount(0),
+            m_OverflowCount(0),
+            m_PriorityCount(0),
+            m_SleepingCount(0),
+            m_BusyCount(0),
+            m_NotifyPending(0),
+            m_ConsumersCount(std::max(consumersCount, 1)),
             m_Cancel(false),
             m_IsRunning(false)
-        { }
+        {
+            if (ringCapacity > 0) {
+                m_Ring.reset(new BoundedMPMCQueue<std::shared_ptr<T> >(ringCapacity));
+            }
+        }
 
         virtual ~ItemProcessingWorker() { }
 
@@ -47,16 +88,8 @@ namespace Common {
                 return;
             }
 
-            m_QueueMutex.lock();
-            {
-                bool wasEmpty = m_Queue.empty();
-                m_Queue.push_back(item);
-
-                if (wasEmpty) {
-                    m_WaitAnyItem.wakeOne();
-                }
-            }
-            m_QueueMutex.unlock();
+            pushBack(item);
+            wakeConsumers(false);
         }
 
         void submitFirst(const std::shared_ptr<T> &item) {
@@ -64,14 +97,14 @@ namespace Common {
                 return;
             }
 
+            std::shared_ptr<T> latest = coalesce(item);
+
             m_QueueMutex.lock();
             {
-                bool wasEmpty = m_Queue.empty();
-                m_Queue.push_front(item);
-
-                if (wasEmpty) {
-                    m_WaitAnyItem.wakeOne();
-                }
+                m_PendingCount.ref();
+                m_PriorityCount.ref();
+                m_PriorityQueue.push_front(latest);
+                m_WaitAnyItem.wakeOne();
             }
             m_QueueMutex.unlock();
         }
@@ -81,21 +114,12 @@ namespace Common {
                 return;
             }
 
-            m_QueueMutex.lock();
-            {
-                bool wasEmpty = m_Queue.empty();
-
-                size_t size = items.size();
-                for (size_t i = 0; i < size; ++i) {
-                    auto &item = items.at(i);
-                    m_Queue.push_back(item);
-                }
-
-                if (wasEmpty) {
-                    m_WaitAnyItem.wakeOne();
-                }
+            size_t size = items.size();
+            for (size_t i = 0; i < size; ++i) {
+                pushBack(items.at(i));
             }
-            m_QueueMutex.unlock();
+
+            wakeConsumers(size > 1);
         }
 
         void submitFirst(const std::vector<std::shared_ptr<T> > &items) {
@@ -105,35 +129,46 @@ namespace Common {
 
             m_QueueMutex.lock();
             {
-                bool wasEmpty = m_Queue.empty();
-
                 size_t size = items.size();
                 for (size_t i = 0; i < size; ++i) {
-                    auto &item = items.at(i);
-                    m_Queue.push_front(item);
-                }
+                    std::shared_ptr<T> latest = coalesce(items.at(i));
 
-                if (wasEmpty) {
-                    m_WaitAnyItem.wakeOne();
+                    m_PendingCount.ref();
+                    m_PriorityCount.ref();
+                    m_PriorityQueue.push_front(latest);
                 }
+
+                m_WaitAnyItem.wakeAll();
             }
             m_QueueMutex.unlock();
         }
 
         void cancelCurrentBatch() {
+            std::shared_ptr<T> item;
+
+            if (m_Ring) {
+                while (m_Ring->tryPop(item)) {
+                    m_PendingCount.deref();
+                }
+            }
+
             m_QueueMutex.lock();
             {
-                m_Queue.clear();
+                m_PendingCount.fetchAndAddOrdered(-(int)(m_PriorityQueue.size() + m_OverflowQueue.size()));
+                m_PriorityQueue.clear();
+                m_OverflowQueue.clear();
+                m_PriorityCount.storeRelease(0);
+                m_OverflowCount.storeRelease(0);
             }
             m_QueueMutex.unlock();
 
+            clearCoalescedItems();
+
             notifyQueueIsEmpty();
         }
 
         bool hasPendingJobs() {
-            QMutexLocker locker(&m_QueueMutex);
-            bool isEmpty = m_Queue.empty();
-            return !isEmpty;
+            return m_PendingCount.loadAcquire() > 0;
         }
 
         bool isCancelled() const { return m_Cancel; }
@@ -142,7 +177,19 @@ namespace Common {
         void doWork() {
             if (initWorker()) {
                 m_IsRunning = true;
+
+                std::vector<std::unique_ptr<ConsumerThread> > consumers;
+                for (int i = 1; i < m_ConsumersCount; ++i) {
+                    consumers.emplace_back(new ConsumerThread([this]() { runWorkerLoop(); }));
+                    consumers.back()->start();
+                }
+
                 runWorkerLoop();
+
+                for (auto &consumer: consumers) {
+                    consumer->wait();
+                }
+
                 m_IsRunning = false;
             } else {
                 m_Cancel = true;
@@ -154,14 +201,13 @@ namespace Common {
         void stopWorking(bool immediately=true) {
             m_Cancel = true;
 
+            if (immediately) {
+                cancelPendingItems();
+            }
+
             m_QueueMutex.lock();
             {
-                if (immediately) {
-                    m_Queue.clear();
-                }
-
-                m_Queue.emplace_back(std::shared_ptr<T>());
-                m_WaitAnyItem.wakeOne();
+                m_WaitAnyItem.wakeAll();
             }
             m_QueueMutex.unlock();
         }
@@ -172,50 +218,267 @@ namespace Common {
         virtual void notifyQueueIsEmpty() = 0;
         virtual void workerStopped() = 0;
 
+        // workers which can share work between queued items take several at once
+        virtual size_t getMaxBatchSize() const { return 1; }
+        virtual void processBatch(std::vector<std::shared_ptr<T> > &items) {
+            for (auto &item: items) {
+                processOneItem(item);
+            }
+        }
+
+        // items are coalesced only when a key is returned
+        virtual bool getCoalescingKey(const std::shared_ptr<T> &item, CoalescingKey &key) const {
+            Q_UNUSED(item); Q_UNUSED(key);
+            return false;
+        }
+
+        // incoming item supersedes the pending one unless it merges something from it
+        virtual void mergeItems(const std::shared_ptr<T> &pending, std::shared_ptr<T> &incoming) {
+            Q_UNUSED(pending); Q_UNUSED(incoming);
+        }
+
+        int getConsumersCount() const { return m_ConsumersCount; }
+
+        // is executed by every consumer thread
         void runWorkerLoop() {
+            const size_t maxBatchSize = std::max(getMaxBatchSize(), (size_t)1);
+            std::vector<std::shared_ptr<T> > batch;
+
             for (;;) {
-                if (m_Cancel) {
+                // items queued before graceful stop are still processed
+                if (m_Cancel && (m_PendingCount.fetchAndAddOrdered(0) <= 0)) {
                     LOG_INFO << "Cancelled. Exiting...";
                     break;
                 }
 
-                bool noMoreItems = false;
+                // busy before taking so others do not report empty queue too early
+                m_BusyCount.ref();
+                takeBatch(batch, maxBatchSize);
+
+                if (batch.empty()) {
+                    finishBusy();
+                    waitForItems();
+                    continue;
+                }
 
-                m_QueueMutex.lock();
+                resolveCoalescedItems(batch);
+
+                if (batch.empty()) {
+                    // everything taken was superseded by items queued later
+                    finishBusy();
+                    continue;
+                }
 
-                while (m_Queue.empty()) {
+                try {
+                    if (batch.size() == 1) {
+                        processOneItem(batch.front());
+                    } else {
+                        processBatch(batch);
+                    }
+                }
+                catch (...) {
+                    LOG_WARNING << "Exception while processing item!";
+                }
+
+                batch.clear();
+
+                m_NotifyPending.storeRelease(1);
+                finishBusy();
+            }
+        }
+
+    private:
+        void pushBack(const std::shared_ptr<T> &item) {
+            std::shared_ptr<T> latest = coalesce(item);
+
+            m_PendingCount.ref();
+
+            // while anything overflowed the ring new items go after it to keep the order
+            if (m_Ring && (m_OverflowCount.loadAcquire() == 0) && m_Ring->tryPush(latest)) {
+                return;
+            }
+
+            m_QueueMutex.lock();
+            {
+                m_OverflowCount.ref();
+                m_OverflowQueue.push_back(latest);
+            }
+            m_QueueMutex.unlock();
+        }
+
+        void wakeConsumers(bool all) {
+            // full barrier pairs with the one of consumer going to sleep
+            if (m_SleepingCount.fetchAndAddOrdered(0) == 0) { return; }
+
+            m_QueueMutex.lock();
+            {
+                if (all) {
+                    m_WaitAnyItem.wakeAll();
+                } else {
+                    m_WaitAnyItem.wakeOne();
+                }
+            }
+            m_QueueMutex.unlock();
+        }
+
+        void waitForItems() {
+            m_QueueMutex.lock();
+            {
+                m_SleepingCount.ref();
+
+                while (!m_Cancel && (m_PendingCount.fetchAndAddOrdered(0) <= 0)) {
                     bool waitResult = m_WaitAnyItem.wait(&m_QueueMutex);
                     if (!waitResult) {
                         LOG_WARNING << "Waiting failed for new items";
                     }
                 }
 
-                std::shared_ptr<T> item = m_Queue.front();
-                m_Queue.pop_front();
-
-                noMoreItems = m_Queue.empty();
+                m_SleepingCount.deref();
+            }
+            m_QueueMutex.unlock();
+        }
 
-                m_QueueMutex.unlock();
+        void takeBatch(std::vector<std::shared_ptr<T> > &batch, size_t maxBatchSize) {
+            std::shared_ptr<T> item;
 
-                if (item.get() == nullptr) { break; }
+            if (m_PriorityCount.loadAcquire() > 0) {
+                QMutexLocker locker(&m_QueueMutex);
+                while (!m_PriorityQueue.empty() && (batch.size() < maxBatchSize)) {
+                    batch.push_back(m_PriorityQueue.front());
+                    m_PriorityQueue.pop_front();
+                    m_PriorityCount.deref();
+                    m_PendingCount.deref();
+                }
+            }
 
-                try {
-                    processOneItem(item);
+            if (m_Ring) {
+                while ((batch.size() < maxBatchSize) && m_Ring->tryPop(item)) {
+                    batch.push_back(item);
+                    m_PendingCount.deref();
                 }
-                catch (...) {
-                    LOG_WARNING << "Exception while processing item!";
+            }
+
+            if ((batch.size() < maxBatchSize) && (m_OverflowCount.loadAcquire() > 0)) {
+                QMutexLocker locker(&m_QueueMutex);
+                while (!m_OverflowQueue.empty() && (batch.size() < maxBatchSize)) {
+                    batch.push_back(m_OverflowQueue.front());
+                    m_OverflowQueue.pop_front();
+                    m_OverflowCount.deref();
+                    m_PendingCount.deref();
                 }
+            }
+        }
+
+        void finishBusy() {
+            // only the last busy consumer reports that everything is processed
+            const bool wasLastBusy = !m_BusyCount.deref();
+
+            if (wasLastBusy &&
+                    (m_PendingCount.fetchAndAddOrdered(0) <= 0) &&
+                    m_NotifyPending.testAndSetOrdered(1, 0)) {
+                notifyQueueIsEmpty();
+            }
+        }
+
+        // returns the item to queue which supersedes all queued ones with the same key
+        std::shared_ptr<T> coalesce(const std::shared_ptr<T> &item) {
+            CoalescingKey key;
+            if (!getCoalescingKey(item, key)) { return item; }
+
+            std::shared_ptr<T> incoming = item;
+            QMutexLocker locker(&m_CoalescingMutex);
+
+            CoalescedItem &coalesced = m_CoalescedItems[key];
+            if (coalesced.m_Latest) {
+                mergeItems(coalesced.m_Latest, incoming);
+            }
+
+            coalesced.m_Latest = incoming;
+            coalesced.m_QueuedCount++;
+            return incoming;
+        }
+
+        // drops items superseded by the ones queued later
+        void resolveCoalescedItems(std::vector<std::shared_ptr<T> > &batch) {
+            auto it = std::remove_if(batch.begin(), batch.end(),
+                                     [this](const std::shared_ptr<T> &item) { return takeSuperseded(item); });
+            batch.erase(it, batch.end());
+        }
+
+        bool takeSuperseded(const std::shared_ptr<T> &item) {
+            CoalescingKey key;
+            if (!getCoalescingKey(item, key)) { return false; }
+
+            QMutexLocker locker(&m_CoalescingMutex);
+
+            auto it = m_CoalescedItems.find(key);
+            // items are not tracked anymore after cancelling
+            if (it == m_CoalescedItems.end()) { return false; }
+
+            CoalescedItem &coalesced = it.value();
+            const bool superseded = (coalesced.m_Latest != item);
+            if (!superseded) {
+                // slots which are still queued are stale now
+                coalesced.m_Latest.reset();
+            }
+
+            coalesced.m_QueuedCount--;
+            if (coalesced.m_QueuedCount <= 0) {
+                m_CoalescedItems.erase(it);
+            }
+
+            return superseded;
+        }
+
+        void clearCoalescedItems() {
+            QMutexLocker locker(&m_CoalescingMutex);
+            m_CoalescedItems.clear();
+        }
 
-                if (noMoreItems) {
-                    notifyQueueIsEmpty();
+        void cancelPendingItems() {
+            std::shared_ptr<T> item;
+
+            if (m_Ring) {
+                while (m_Ring->tryPop(item)) {
+                    m_PendingCount.deref();
                 }
             }
+
+            QMutexLocker locker(&m_QueueMutex);
+            m_PendingCount.fetchAndAddOrdered(-(int)(m_PriorityQueue.size() + m_OverflowQueue.size()));
+            m_PriorityQueue.clear();
+            m_OverflowQueue.clear();
+            m_PriorityCount.storeRelease(0);
+            m_OverflowCount.storeRelease(0);
+            locker.unlock();
+
+            clearCoalescedItems();
         }
 
+    private:
+        struct CoalescedItem {
+            CoalescedItem(): m_QueuedCount(0) { }
+
+            std::shared_ptr<T> m_Latest;
+            // queued slots of the key including superseded ones
+            int m_QueuedCount;
+        };
+
     private:
         QWaitCondition m_WaitAnyItem;
         QMutex m_QueueMutex;
-        std::deque<std::shared_ptr<T> > m_Queue;
+        std::unique_ptr<BoundedMPMCQueue<std::shared_ptr<T> > > m_Ring;
+        std::deque<std::shared_ptr<T> > m_PriorityQueue;
+        std::deque<std::shared_ptr<T> > m_OverflowQueue;
+        QMutex m_CoalescingMutex;
+        QHash<CoalescingKey, CoalescedItem> m_CoalescedItems;
+        QAtomicInt m_PendingCount;
+        QAtomicInt m_OverflowCount;
+        QAtomicInt m_PriorityCount;
+        QAtomicInt m_SleepingCount;
+        QAtomicInt m_BusyCount;
+        QAtomicInt m_NotifyPending;
+        int m_ConsumersCount;
         volatile bool m_Cancel;
         volatile bool m_IsRunning;
     };
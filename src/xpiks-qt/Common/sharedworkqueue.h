@@ -0,0 +1,65 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SHAREDWORKQUEUE_H
+#define SHAREDWORKQUEUE_H
+
+#include <QVector>
+#include <QAtomicInt>
+
+namespace Common {
+    // hands out items of a fixed batch to any number of consumers one by one
+    // so a slow item delays only the thread which took it
+    template<typename T>
+    class SharedWorkQueue
+    {
+    public:
+        SharedWorkQueue(const QVector<T> &items):
+            m_Items(items),
+            m_NextIndex(0),
+            m_Cancelled(0)
+        { }
+
+    public:
+        int size() const { return m_Items.size(); }
+        bool isCancelled() const { return m_Cancelled.loadAcquire() != 0; }
+        void cancel() { m_Cancelled.storeRelease(1); }
+
+    public:
+        bool tryTakeNext(int &index, T &item) {
+            if (isCancelled()) { return false; }
+
+            const int next = m_NextIndex.fetchAndAddOrdered(1);
+            if (next >= m_Items.size()) { return false; }
+
+            index = next;
+            item = m_Items.at(next);
+            return true;
+        }
+
+    private:
+        const QVector<T> m_Items;
+        QAtomicInt m_NextIndex;
+        QAtomicInt m_Cancelled;
+    };
+}
+
+#endif // SHAREDWORKQUEUE_H
@@ -0,0 +1,219 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "archivespipeline.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include "../Common/defines.h"
+
+namespace Conectivity {
+    ArchivesPipeline::ArchivesPipeline(int capacity, int consumersCount, int expectedCount):
+        m_Cursors(consumersCount, 0),
+        m_Detached(consumersCount, false),
+        m_Capacity(qMax(1, capacity)),
+        m_ConsumersCount(consumersCount),
+        m_ActiveConsumersCount(consumersCount),
+        m_ExpectedCount(expectedCount),
+        m_InFlightCount(0),
+        m_FailedCount(0),
+        m_ProducingFinished(false),
+        m_Cancelled(false),
+        m_RemoveUploaded(true)
+    {
+        Q_ASSERT(consumersCount > 0);
+
+        if (!m_ArchivesDirectory.isValid()) {
+            LOG_WARNING << "Failed to create temporary directory for archives";
+        }
+    }
+
+    bool ArchivesPipeline::reserveSlot() {
+        QMutexLocker locker(&m_PipelineMutex);
+
+        while (!m_Cancelled && (m_InFlightCount >= m_Capacity)) {
+            m_SlotReleased.wait(&m_PipelineMutex);
+        }
+
+        if (m_Cancelled) {
+            return false;
+        }
+
+        m_InFlightCount++;
+        return true;
+    }
+
+    void ArchivesPipeline::pushArchive(const QString &archivePath) {
+        LOG_INFO << archivePath;
+        QMutexLocker locker(&m_PipelineMutex);
+        Q_ASSERT(m_InFlightCount > 0);
+
+        m_Archives.append(archivePath);
+        ArchiveState state;
+        state.m_PendingConsumers = m_ActiveConsumersCount + 1;
+        state.m_AnyFailed = m_Cancelled;
+        m_PendingArchives.insert(archivePath, state);
+
+        // release the reference of the producer so archive
+        // nobody is going to upload is not kept in flight
+        releaseUnsafe(archivePath, true);
+    }
+
+    void ArchivesPipeline::cancelReservation() {
+        QMutexLocker locker(&m_PipelineMutex);
+        Q_ASSERT(m_InFlightCount > 0);
+
+        m_InFlightCount--;
+        m_ExpectedCount--;
+        m_FailedCount++;
+        m_SlotReleased.wakeOne();
+    }
+
+    void ArchivesPipeline::finishProducing() {
+        LOG_DEBUG << "#";
+        QMutexLocker locker(&m_PipelineMutex);
+        m_ProducingFinished = true;
+    }
+
+    bool ArchivesPipeline::tryTakeNext(int consumerIndex, QString &archivePath) {
+        Q_ASSERT((0 <= consumerIndex) && (consumerIndex < m_ConsumersCount));
+        QMutexLocker locker(&m_PipelineMutex);
+
+        int &cursor = m_Cursors[consumerIndex];
+        if (m_Detached[consumerIndex] || (cursor >= m_Archives.size())) {
+            return false;
+        }
+
+        archivePath = m_Archives.at(cursor);
+        cursor++;
+        return true;
+    }
+
+    bool ArchivesPipeline::isDrained(int consumerIndex) {
+        Q_ASSERT((0 <= consumerIndex) && (consumerIndex < m_ConsumersCount));
+        QMutexLocker locker(&m_PipelineMutex);
+        return m_Cancelled ||
+                m_Detached[consumerIndex] ||
+                (m_ProducingFinished && (m_Cursors[consumerIndex] >= m_Archives.size()));
+    }
+
+    void ArchivesPipeline::releaseArchive(const QString &archivePath, bool uploaded) {
+        bool needToRemove = false;
+
+        {
+            QMutexLocker locker(&m_PipelineMutex);
+            needToRemove = releaseUnsafe(archivePath, uploaded);
+        }
+
+        if (needToRemove && !isInArchivesDirectory(archivePath)) {
+            LOG_WARNING << "Not removing archive outside of" << m_ArchivesDirectory.path();
+            needToRemove = false;
+        }
+
+        if (needToRemove) {
+            if (QFile::remove(archivePath)) {
+                LOG_INFO << "Removed uploaded archive" << archivePath;
+            } else {
+                LOG_WARNING << "Failed to remove" << archivePath;
+            }
+        }
+    }
+
+    void ArchivesPipeline::detachConsumer(int consumerIndex) {
+        Q_ASSERT((0 <= consumerIndex) && (consumerIndex < m_ConsumersCount));
+        LOG_DEBUG << consumerIndex;
+        QMutexLocker locker(&m_PipelineMutex);
+        if (m_Detached[consumerIndex]) { return; }
+
+        m_Detached[consumerIndex] = true;
+        m_ActiveConsumersCount--;
+
+        // archives which were never taken by this consumer
+        // are marked as failed so they are kept on disk
+        int &cursor = m_Cursors[consumerIndex];
+        const int size = m_Archives.size();
+        for (; cursor < size; ++cursor) {
+            releaseUnsafe(m_Archives.at(cursor), false);
+        }
+    }
+
+    void ArchivesPipeline::cancel() {
+        LOG_INFO << "#";
+        QMutexLocker locker(&m_PipelineMutex);
+        m_Cancelled = true;
+        m_SlotReleased.wakeAll();
+    }
+
+    int ArchivesPipeline::getExpectedCount() {
+        QMutexLocker locker(&m_PipelineMutex);
+        return m_ExpectedCount;
+    }
+
+    int ArchivesPipeline::getInFlightCount() {
+        QMutexLocker locker(&m_PipelineMutex);
+        return m_InFlightCount;
+    }
+
+    int ArchivesPipeline::getFailedCount() {
+        QMutexLocker locker(&m_PipelineMutex);
+        return m_FailedCount;
+    }
+
+    bool ArchivesPipeline::isInArchivesDirectory(const QString &archivePath) const {
+        if (!m_ArchivesDirectory.isValid()) { return false; }
+
+        QString archiveDirectory = QFileInfo(archivePath).absolutePath();
+        return QDir(archiveDirectory) == QDir(m_ArchivesDirectory.path());
+    }
+
+    bool ArchivesPipeline::getIsCancelled() {
+        QMutexLocker locker(&m_PipelineMutex);
+        return m_Cancelled;
+    }
+
+    bool ArchivesPipeline::releaseUnsafe(const QString &archivePath, bool uploaded) {
+        auto it = m_PendingArchives.find(archivePath);
+        if (it == m_PendingArchives.end()) {
+            LOG_WARNING << "Unknown archive" << archivePath;
+            return false;
+        }
+
+        ArchiveState &state = it.value();
+        if (!uploaded) {
+            state.m_AnyFailed = true;
+        }
+
+        state.m_PendingConsumers--;
+        if (state.m_PendingConsumers > 0) {
+            return false;
+        }
+
+        const bool anyFailed = state.m_AnyFailed;
+        m_PendingArchives.erase(it);
+
+        Q_ASSERT(m_InFlightCount > 0);
+        m_InFlightCount--;
+        m_SlotReleased.wakeOne();
+
+        // failed archive is kept until the pipeline is destroyed
+        return m_RemoveUploaded && !anyFailed;
+    }
+}
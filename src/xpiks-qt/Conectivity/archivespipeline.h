@@ -0,0 +1,104 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARCHIVESPIPELINE_H
+#define ARCHIVESPIPELINE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QTemporaryDir>
+
+namespace Conectivity {
+    /*
+     * Bounded queue between zip archiver and ftp uploaders.
+     * Every created archive is uploaded by each consumer (host)
+     * and removed from disk when all of them succeeded so
+     * no more than capacity archives exist at the same time.
+     * Archives are created in own temporary directory so
+     * files of the user are never removed.
+    */
+    class ArchivesPipeline
+    {
+    public:
+        ArchivesPipeline(int capacity, int consumersCount, int expectedCount);
+
+    public:
+        // producer side
+        bool reserveSlot();
+        void pushArchive(const QString &archivePath);
+        void cancelReservation();
+        void finishProducing();
+
+    public:
+        // consumer side
+        bool tryTakeNext(int consumerIndex, QString &archivePath);
+        bool isDrained(int consumerIndex);
+        void releaseArchive(const QString &archivePath, bool uploaded);
+        void detachConsumer(int consumerIndex);
+
+    public:
+        void cancel();
+        void setRemoveUploaded(bool value) { m_RemoveUploaded = value; }
+        QString getArchivesDirectory() const { return m_ArchivesDirectory.path(); }
+        bool isInArchivesDirectory(const QString &archivePath) const;
+        int getCapacity() const { return m_Capacity; }
+        int getConsumersCount() const { return m_ConsumersCount; }
+        int getExpectedCount();
+        int getInFlightCount();
+        int getFailedCount();
+        bool getIsCancelled();
+
+    private:
+        bool releaseUnsafe(const QString &archivePath, bool uploaded);
+
+    private:
+        struct ArchiveState {
+            int m_PendingConsumers;
+            bool m_AnyFailed;
+        };
+
+    private:
+        QTemporaryDir m_ArchivesDirectory;
+        QMutex m_PipelineMutex;
+        QWaitCondition m_SlotReleased;
+        QStringList m_Archives;
+        QHash<QString, ArchiveState> m_PendingArchives;
+        // position of the next archive for each consumer
+        QVector<int> m_Cursors;
+        QVector<bool> m_Detached;
+        int m_Capacity;
+        int m_ConsumersCount;
+        int m_ActiveConsumersCount;
+        int m_ExpectedCount;
+        // archives which are being created or not yet uploaded everywhere
+        int m_InFlightCount;
+        int m_FailedCount;
+        bool m_ProducingFinished;
+        bool m_Cancelled;
+        bool m_RemoveUploaded;
+    };
+}
+
+#endif // ARCHIVESPIPELINE_H
@@ -27,6 +27,7 @@
 #include "../Encryption/secretsmanager.h"
 #include "uploadcontext.h"
 #include "uploadbatch.h"
+#include "archivespipeline.h"
 #include "../Helpers/filenameshelpers.h"
 #include "../Models/imageartwork.h"
 #include "../Commands/commandmanager.h"
@@ -72,6 +73,7 @@ namespace Conectivity {
 
         Models::ProxySettings *proxySettings = settingsModel->getProxySettings();
         int timeoutSeconds = settingsModel->getUploadTimeout();
+        int maxConnections = settingsModel->getMaxConnectionsPerHost();
         const bool useProxy = settingsModel->getUseProxy();
         const bool verbose = settingsModel->getVerboseUpload();
 
@@ -87,6 +89,7 @@ namespace Conectivity {
             context->m_UseProxy = useProxy;
             context->m_ProxySettings = proxySettings;
             context->m_TimeoutSeconds = timeoutSeconds;
+            context->m_MaxConnections = maxConnections;
             context->m_VerboseLogging = verbose;
             // TODO: move to configs/options
             context->m_RetriesCount = RETRIES_COUNT;
@@ -107,7 +110,8 @@ namespace Conectivity {
     std::vector<std::shared_ptr<UploadBatch> > generateUploadBatches(const QVector<Models::ArtworkMetadata *> &artworksToUpload,
                                                 const std::vector<std::shared_ptr<Models::UploadInfo> > &uploadInfos,
                                                 Encryption::SecretsManager *secretsManager,
-                                                Models::SettingsModel *settingsModel) {
+                                                Models::SettingsModel *settingsModel,
+                                                const std::shared_ptr<ArchivesPipeline> &archivesPipeline) {
         LOG_DEBUG << artworksToUpload.length() << "file(s)";
         std::vector<std::shared_ptr<UploadBatch> > batches;
 
@@ -115,17 +119,35 @@ namespace Conectivity {
         QStringList zipFilePathes;
         extractFilePathes(artworksToUpload, filePathes, zipFilePathes);
 
+        if (archivesPipeline) {
+            // archives will come from the pipeline when they are created
+            zipFilePathes.clear();
+            foreach (Models::ArtworkMetadata *metadata, artworksToUpload) {
+                Models::ImageArtwork *image = dynamic_cast<Models::ImageArtwork*>(metadata);
+                if (image == NULL || !image->hasVectorAttached()) {
+                    zipFilePathes.append(metadata->getFilepath());
+                }
+            }
+        }
+
         std::vector<std::shared_ptr<UploadContext> > contexts;
         generateUploadContexts(uploadInfos, contexts, secretsManager, settingsModel);
 
         size_t size = contexts.size();
         batches.reserve(size);
+        int consumerIndex = 0;
 
         for (size_t i = 0; i < size; ++i) {
             auto &context = contexts.at(i);
 
             if (uploadInfos[i]->getZipBeforeUpload()) {
                 batches.emplace_back(new UploadBatch(context, zipFilePathes));
+
+                if (archivesPipeline) {
+                    Q_ASSERT(consumerIndex < archivesPipeline->getConsumersCount());
+                    batches.back()->setArchivesPipeline(archivesPipeline, consumerIndex);
+                    consumerIndex++;
+                }
             } else {
                 batches.emplace_back(new UploadBatch(context, filePathes));
             }
@@ -41,6 +41,7 @@ namespace Encryption {
 
 namespace Conectivity {
     class UploadBatch;
+    class ArchivesPipeline;
 
     void extractFilePathes(const QVector<Models::ArtworkMetadata *> &artworkList,
                            QStringList &filePathes,
@@ -54,7 +55,8 @@ namespace Conectivity {
     std::vector<std::shared_ptr<UploadBatch> > generateUploadBatches(const QVector<Models::ArtworkMetadata *> &artworksToUpload,
                                                 const std::vector<std::shared_ptr<Models::UploadInfo> > &uploadInfos,
                                                 Encryption::SecretsManager *secretsManager,
-                                                Models::SettingsModel *settingsModel);
+                                                Models::SettingsModel *settingsModel,
+                                                const std::shared_ptr<ArchivesPipeline> &archivesPipeline = std::shared_ptr<ArchivesPipeline>());
 }
 
 #endif // CONECTIVITYHELPERS_H
@@ -22,6 +22,7 @@
 #include "curlftpuploader.h"
 #include <QCoreApplication>
 #include <QFileInfo>
+#include <QThread>
 #include <sys/stat.h>
 #include <cstdio>
 #include <cstdlib>
@@ -30,8 +31,10 @@
 #include "ftphelpers.h"
 #include "../Common/defines.h"
 #include "uploadbatch.h"
+#include "archivespipeline.h"
 
 #define MINIMAL_PROGRESS_FUNCTIONALITY_INTERVAL 2
+#define MULTI_WAIT_TIMEOUT_MS 100
 
 namespace Conectivity {
 
@@ -55,8 +58,6 @@ namespace Conectivity {
         if ((curtime - progressReporter->getLastTime()) >= MINIMAL_PROGRESS_FUNCTIONALITY_INTERVAL) {
             progressReporter->setLastTime(curtime);
             progressReporter->updateProgress((double)ultotal, (double)ulnow);
-
-            QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
         }
 
         int result = progressReporter->cancelRequested() ? 1 : 0;
@@ -104,36 +105,28 @@ namespace Conectivity {
         curl_easy_setopt(curlHandle, CURLOPT_NOPROGRESS, 0L);
     }
 
-    bool uploadFile(CURL *curlHandle, UploadContext *context, CurlProgressReporter *progressReporter,
-                    const QString &filepath, const QString &remoteUrl) {
-        LOG_INFO << filepath << "-->" << remoteUrl;
-        bool result = false;
-
-        FILE *f;
-        long uploaded_len = 0;
-        CURLcode r = CURLE_GOT_NOTHING;
+    FILE *openFileForUpload(const QString &filepath, curl_off_t &fileSize) {
+        FILE *f = NULL;
 #ifdef Q_OS_WIN
         struct _stati64 file_info;
 #else
         struct stat file_info;
 #endif
-        int c;
-        curl_off_t fsize;
 
         /* get the file size of the local file */
 #ifdef Q_OS_WIN
         if (_wstati64(filepath.toStdWString().c_str(), &file_info)) {
             LOG_WARNING << "Failed to stat file" << filepath;
-            return result;
+            return f;
         }
 #else
         if (stat(filepath.toLocal8Bit().data(), &file_info)) {
             LOG_WARNING << "Failed to stat file" << filepath;
-            return result;
+            return f;
         }
 #endif
 
-        fsize = (curl_off_t) file_info.st_size;
+        fileSize = (curl_off_t) file_info.st_size;
 
 #ifdef Q_OS_WIN
         f = _wfopen(filepath.toStdWString().c_str(), L"rb");
@@ -142,72 +135,9 @@ namespace Conectivity {
 #endif
         if (f == NULL) {
             LOG_WARNING << "Failed to open file" << filepath;
-            return result;
-        }
-
-        fillCurlOptions(curlHandle, context, remoteUrl);
-        setCurlProgressCallback(curlHandle, progressReporter);
-        curl_easy_setopt(curlHandle, CURLOPT_READDATA, f);
-        curl_easy_setopt(curlHandle, CURLOPT_INFILESIZE_LARGE,
-                             (curl_off_t)fsize);
-        curl_easy_setopt(curlHandle, CURLOPT_HEADERDATA, &uploaded_len);
-
-        if (context->m_VerboseLogging) {
-            curl_easy_setopt(curlHandle, CURLOPT_VERBOSE, 1L);
-        }
-
-        for (c = 0; (r != CURLE_OK) && (c < context->m_RetriesCount); c++) {
-            QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-
-            if (r == CURLE_ABORTED_BY_CALLBACK) {
-                LOG_INFO << "Upload aborted by user...";
-                break;
-            }
-
-            /* are we resuming? */
-            if (c) { /* yes */
-                LOG_INFO << "Attempting to resume upload" << uploaded_len << "try #" << c;
-                /* determine the length of the file already written */
-                /*
-               * With NOBODY and NOHEADER, libcurl will issue a SIZE
-               * command, but the only way to retrieve the result is
-               * to parse the returned Content-Length header. Thus,
-               * getcontentlengthfunc(). We need discardfunc() above
-               * because HEADER will dump the headers to stdout
-               * without it.
-               */
-                curl_easy_setopt(curlHandle, CURLOPT_NOBODY, 1L);
-                curl_easy_setopt(curlHandle, CURLOPT_HEADER, 1L);
-
-                r = curl_easy_perform(curlHandle);
-                if (r != CURLE_OK) {
-                    LOG_WARNING << "Attempt failed! Curl error:" << curl_easy_strerror(r);
-                    continue;
-                }
-
-                curl_easy_setopt(curlHandle, CURLOPT_NOBODY, 0L);
-                curl_easy_setopt(curlHandle, CURLOPT_HEADER, 0L);
-
-                fseek(f, uploaded_len, SEEK_SET);
-
-                curl_easy_setopt(curlHandle, CURLOPT_APPEND, 1L);
-            }
-            else { /* no */
-                curl_easy_setopt(curlHandle, CURLOPT_APPEND, 0L);
-            }
-
-            r = curl_easy_perform(curlHandle);
         }
 
-        fclose(f);
-
-        result = (r == CURLE_OK);
-
-        if (!result) {
-            LOG_WARNING << "Upload failed! Curl error:" << curl_easy_strerror(r);
-        }
-
-        return result;
+        return f;
     }
 
     QString generateRemoteAddress(const QString &host, const QString &filepath, UploadContext *context) {
@@ -260,6 +190,7 @@ namespace Conectivity {
     CurlProgressReporter::CurlProgressReporter(void *curl):
         QObject(),
         m_LastTime(0.0),
+        m_Percent(0.0),
         m_Curl(curl),
         m_Cancel(false)
     {
@@ -267,8 +198,7 @@ namespace Conectivity {
 
     void CurlProgressReporter::updateProgress(double ultotal, double ulnow) {
         if (fabs(ultotal) > 1e-6) {
-            double progress = ulnow * 100.0 / ultotal;
-            emit progressChanged(progress);
+            m_Percent = ulnow * 100.0 / ultotal;
         }
     }
 
@@ -280,17 +210,22 @@ namespace Conectivity {
     CurlFtpUploader::CurlFtpUploader(const std::shared_ptr<UploadBatch> &batchToUpload, QObject *parent) :
         QObject(parent),
         m_BatchToUpload(batchToUpload),
+        m_AnyErrors(false),
         m_UploadedCount(0),
         m_Cancel(false),
         m_LastPercentage(0.0)
     {
-        m_TotalCount = batchToUpload->getFilesToUpload().length();
+        m_ArchivesPipeline = batchToUpload->getArchivesPipeline();
+        m_FilesToUpload = batchToUpload->getFilesToUpload();
+        m_FirstArchiveIndex = m_FilesToUpload.length();
+        m_TotalCount = m_FilesToUpload.length();
+
+        if (m_ArchivesPipeline) {
+            m_TotalCount += m_ArchivesPipeline->getExpectedCount();
+        }
     }
 
     void CurlFtpUploader::uploadBatch() {
-        CURL *curlHandle = NULL;
-        bool anyErrors = false;
-
         UploadContext *context = m_BatchToUpload->getContext();
 
         if (m_Cancel) {
@@ -298,59 +233,116 @@ namespace Conectivity {
             return;
         }
 
-        const QStringList &filesToUpload = m_BatchToUpload->getFilesToUpload();
-        int size = filesToUpload.size();
+        int size = m_FilesToUpload.size();
 
-        QString host = sanitizeHost(context->m_Host);
+        m_Host = sanitizeHost(context->m_Host);
+        m_AnyErrors = false;
 
-        // curl_global_init should be done from coordinator
-        curlHandle = curl_easy_init();
+        for (int i = 0; i < size; ++i) {
+            m_FilesQueue.push_back(i);
+        }
 
-        CurlProgressReporter progressReporter(curlHandle);
-        QObject::connect(&progressReporter, SIGNAL(progressChanged(double)),
-                         this, SLOT(reportCurrentFileProgress(double)));
-        QObject::connect(this, SIGNAL(cancelCurrentUpload()), &progressReporter, SLOT(cancelHandler()));
+        const int connectionsCount = qMax(1, qMin(context->m_MaxConnections, m_TotalCount));
+
+        // curl_global_init should be done from coordinator
+        CURLM *multiHandle = curl_multi_init();
+        // finished transfers leave their connections in the cache of the multi handle
+        // so the next file skips login and CWD
+        curl_multi_setopt(multiHandle, CURLMOPT_MAXCONNECTS, (long)connectionsCount);
+
+        m_Connections.resize(connectionsCount);
+        for (auto &connection: m_Connections) {
+            connection.m_Handle = curl_easy_init();
+            connection.m_ProgressReporter.reset(new CurlProgressReporter(connection.m_Handle));
+            QObject::connect(this, SIGNAL(cancelCurrentUpload()),
+                             connection.m_ProgressReporter.get(), SLOT(cancelHandler()));
+        }
 
         // temporary do not emit started signal: not used
         //emit uploadStarted();
-        LOG_INFO << "Uploading" << size << "file(s) started for" << host << "Passive mode =" << context->m_UsePassiveMode;
+        LOG_INFO << "Uploading" << m_TotalCount << "file(s) started for" << m_Host <<
+                    "Passive mode =" << context->m_UsePassiveMode << "Connections =" << connectionsCount;
 
-        for (int i = 0; i < size; ++i) {
+        int activeCount = 0;
+        for (auto &connection: m_Connections) {
+            if (startNextFile(multiHandle, connection)) {
+                activeCount++;
+            }
+        }
+
+        bool waitingForArchives = (bool)m_ArchivesPipeline;
+
+        while ((activeCount > 0) || waitingForArchives) {
+            QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
 
-            if (m_Cancel) {
-                LOG_WARNING << "Cancelled. Breaking..." << host;
-                break;
+            if (waitingForArchives) {
+                // archives are uploaded while others are still being created
+                if (takeReadyArchives() > 0) {
+                    for (auto &connection: m_Connections) {
+                        if ((connection.m_FileIndex == -1) && startNextFile(multiHandle, connection)) {
+                            activeCount++;
+                        }
+                    }
+                }
+
+                waitingForArchives = !m_Cancel && !m_ArchivesPipeline->isDrained(m_BatchToUpload->getConsumerIndex());
             }
 
-            reportCurrentFileProgress(0.0);
+            int runningCount = 0;
+            curl_multi_perform(multiHandle, &runningCount);
+
+            CURLMsg *message = nullptr;
+            int messagesLeft = 0;
+            while ((message = curl_multi_info_read(multiHandle, &messagesLeft)) != nullptr) {
+                if (message->msg != CURLMSG_DONE) { continue; }
+
+                for (auto &connection: m_Connections) {
+                    if (connection.m_Handle != message->easy_handle) { continue; }
 
-            const QString &filepath = filesToUpload.at(i);
-            QString remoteUrl = generateRemoteAddress(host, filepath, context);
-            bool uploadSuccess = false;
+                    const CURLcode result = message->data.result;
+                    processFinishedTransfer(multiHandle, connection, result);
 
-            try {
-                uploadSuccess = uploadFile(curlHandle, context, &progressReporter, filepath, remoteUrl);
-            } catch (...) {
-                LOG_WARNING << "CRASHED for file" << filepath << "for host" << host;
+                    if (connection.m_FileIndex == -1) {
+                        activeCount--;
+                    }
+
+                    break;
+                }
             }
 
-            if (!uploadSuccess) {
-                anyErrors = true;
-                emit transferFailed(filepath, host);
+            reportConnectionsProgress();
+
+            if (activeCount > 0) {
+                curl_multi_wait(multiHandle, nullptr, 0, MULTI_WAIT_TIMEOUT_MS, nullptr);
+            } else if (waitingForArchives) {
+                QThread::msleep(MULTI_WAIT_TIMEOUT_MS);
             }
+        }
+
+        if (m_Cancel) {
+            LOG_WARNING << "Cancelled." << m_FilesQueue.size() << "file(s) were not uploaded to" << m_Host;
+        }
 
-            // TODO: only update progress of not-failed uploads
-            if (uploadSuccess) {
-                m_UploadedCount++;
+        if (m_ArchivesPipeline) {
+            for (int index: m_FilesQueue) {
+                releaseArchive(index, false);
             }
+
+            m_FilesQueue.clear();
+            m_ArchivesPipeline->detachConsumer(m_BatchToUpload->getConsumerIndex());
         }
 
         reportCurrentFileProgress(0.0);
 
-        emit uploadFinished(anyErrors);
-        LOG_INFO << "Uploading finished for" << host;
+        emit uploadFinished(m_AnyErrors);
+        LOG_INFO << "Uploading finished for" << m_Host;
+
+        for (auto &connection: m_Connections) {
+            curl_easy_cleanup((CURL *)connection.m_Handle);
+        }
 
-        curl_easy_cleanup(curlHandle);
+        m_Connections.clear();
+        curl_multi_cleanup(multiHandle);
         // curl_global_cleanup should be done from coordinator
     }
 
@@ -365,5 +357,179 @@ namespace Conectivity {
         emit progressChanged(m_LastPercentage, newProgress);
         m_LastPercentage = newProgress;
     }
-}
 
+    void CurlFtpUploader::reportConnectionsProgress() {
+        double percent = 0.0;
+
+        for (auto &connection: m_Connections) {
+            if (connection.m_FileIndex != -1) {
+                percent += connection.m_ProgressReporter->getPercent();
+            }
+        }
+
+        double newProgress = (m_UploadedCount*100.0 + percent) / m_TotalCount;
+        if (fabs(newProgress - m_LastPercentage) > 1e-6) {
+            reportCurrentFileProgress(percent);
+        }
+    }
+
+    int CurlFtpUploader::takeReadyArchives() {
+        Q_ASSERT(m_ArchivesPipeline);
+        const int consumerIndex = m_BatchToUpload->getConsumerIndex();
+        int count = 0;
+        QString archivePath;
+
+        while (m_ArchivesPipeline->tryTakeNext(consumerIndex, archivePath)) {
+            m_FilesQueue.push_back(m_FilesToUpload.length());
+            m_FilesToUpload.append(archivePath);
+            count++;
+        }
+
+        if (count > 0) {
+            LOG_DEBUG << count << "archive(s) are ready for" << m_Host;
+        }
+
+        return count;
+    }
+
+    bool CurlFtpUploader::startNextFile(void *multiHandle, FtpConnection &connection) {
+        UploadContext *context = m_BatchToUpload->getContext();
+        CURL *curlHandle = (CURL *)connection.m_Handle;
+        bool started = false;
+
+        while (!started && !m_Cancel && !m_FilesQueue.empty()) {
+            const int index = m_FilesQueue.front();
+            m_FilesQueue.pop_front();
+
+            const QString &filepath = m_FilesToUpload.at(index);
+            QString remoteUrl = generateRemoteAddress(m_Host, filepath, context);
+            LOG_INFO << filepath << "-->" << remoteUrl;
+
+            curl_off_t fileSize = 0;
+            FILE *f = openFileForUpload(filepath, fileSize);
+            if (f == NULL) {
+                m_AnyErrors = true;
+                emit transferFailed(filepath, m_Host);
+                releaseArchive(index, false);
+                continue;
+            }
+
+            connection.m_File = f;
+            connection.m_FileIndex = index;
+            connection.m_Attempt = 0;
+            connection.m_FileSize = (qint64)fileSize;
+            connection.m_UploadedLength = 0;
+            connection.m_IsQueryingSize = false;
+            connection.m_ProgressReporter->resetProgress();
+
+            fillCurlOptions(curlHandle, context, remoteUrl);
+            setCurlProgressCallback(curlHandle, connection.m_ProgressReporter.get());
+            curl_easy_setopt(curlHandle, CURLOPT_READDATA, f);
+            curl_easy_setopt(curlHandle, CURLOPT_INFILESIZE_LARGE, fileSize);
+            curl_easy_setopt(curlHandle, CURLOPT_HEADERDATA, &connection.m_UploadedLength);
+            curl_easy_setopt(curlHandle, CURLOPT_NOBODY, 0L);
+            curl_easy_setopt(curlHandle, CURLOPT_HEADER, 0L);
+            curl_easy_setopt(curlHandle, CURLOPT_APPEND, 0L);
+
+            if (context->m_VerboseLogging) {
+                curl_easy_setopt(curlHandle, CURLOPT_VERBOSE, 1L);
+            }
+
+            CURLMcode result = curl_multi_add_handle((CURLM *)multiHandle, curlHandle);
+            if (result != CURLM_OK) {
+                LOG_WARNING << "Failed to start upload:" << curl_multi_strerror(result);
+                finishFile(connection, false);
+                continue;
+            }
+
+            started = true;
+        }
+
+        return started;
+    }
+
+    void CurlFtpUploader::processFinishedTransfer(void *multiHandle, FtpConnection &connection, int curlResult) {
+        CURLM *multi = (CURLM *)multiHandle;
+        CURL *curlHandle = (CURL *)connection.m_Handle;
+        const CURLcode r = (CURLcode)curlResult;
+        const int retriesCount = m_BatchToUpload->getContext()->m_RetriesCount;
+
+        curl_multi_remove_handle(multi, curlHandle);
+
+        if (connection.m_IsQueryingSize && (r == CURLE_OK)) {
+            connection.m_IsQueryingSize = false;
+
+            curl_easy_setopt(curlHandle, CURLOPT_NOBODY, 0L);
+            curl_easy_setopt(curlHandle, CURLOPT_HEADER, 0L);
+
+            fseek(connection.m_File, connection.m_UploadedLength, SEEK_SET);
+            // otherwise curl fails the transfer since less than the whole file was sent
+            curl_easy_setopt(curlHandle, CURLOPT_INFILESIZE_LARGE,
+                             (curl_off_t)(connection.m_FileSize - connection.m_UploadedLength));
+
+            curl_easy_setopt(curlHandle, CURLOPT_APPEND, 1L);
+            curl_multi_add_handle(multi, curlHandle);
+            return;
+        }
+
+        if (r == CURLE_OK) {
+            finishFile(connection, true);
+        } else if (r == CURLE_ABORTED_BY_CALLBACK) {
+            LOG_INFO << "Upload aborted by user...";
+            finishFile(connection, false);
+        } else {
+            connection.m_Attempt++;
+
+            if (!m_Cancel && (connection.m_Attempt < retriesCount)) {
+                LOG_WARNING << "Attempt failed! Curl error:" << curl_easy_strerror(r);
+                LOG_INFO << "Attempting to resume upload" << connection.m_UploadedLength << "try #" << connection.m_Attempt;
+                connection.m_IsQueryingSize = true;
+                /* determine the length of the file already written */
+                /*
+                 * With NOBODY and NOHEADER, libcurl will issue a SIZE
+                 * command, but the only way to retrieve the result is
+                 * to parse the returned Content-Length header. Thus,
+                 * getcontentlengthfunc().
+                 */
+                curl_easy_setopt(curlHandle, CURLOPT_NOBODY, 1L);
+                curl_easy_setopt(curlHandle, CURLOPT_HEADER, 1L);
+                curl_multi_add_handle(multi, curlHandle);
+                return;
+            }
+
+            LOG_WARNING << "Upload failed! Curl error:" << curl_easy_strerror(r);
+            finishFile(connection, false);
+        }
+
+        // connection is free for the next file from the queue
+        startNextFile(multiHandle, connection);
+    }
+
+    void CurlFtpUploader::finishFile(FtpConnection &connection, bool success) {
+        const int index = connection.m_FileIndex;
+        const QString &filepath = m_FilesToUpload.at(index);
+
+        if (connection.m_File != NULL) {
+            fclose(connection.m_File);
+            connection.m_File = NULL;
+        }
+
+        connection.m_ProgressReporter->resetProgress();
+        connection.m_FileIndex = -1;
+
+        if (success) {
+            m_UploadedCount++;
+        } else {
+            m_AnyErrors = true;
+            emit transferFailed(filepath, m_Host);
+        }
+
+        releaseArchive(index, success);
+    }
+
+    void CurlFtpUploader::releaseArchive(int fileIndex, bool uploaded) {
+        if (m_ArchivesPipeline && (fileIndex >= m_FirstArchiveIndex)) {
+            m_ArchivesPipeline->releaseArchive(m_FilesToUpload.at(fileIndex), uploaded);
+        }
+    }
+}
@@ -27,10 +27,14 @@
 #include <QStringList>
 #include <QVector>
 #include <memory>
+#include <vector>
+#include <deque>
+#include <cstdio>
 #include "uploadcontext.h"
 
 namespace Conectivity {
     class UploadBatch;
+    class ArchivesPipeline;
 
     class CurlProgressReporter : public QObject {
         Q_OBJECT
@@ -39,23 +43,45 @@ namespace Conectivity {
 
     public:
         void updateProgress(double ultotal, double ulnow);
+        void resetProgress() { m_LastTime = 0.0; m_Percent = 0.0; }
         void *getCurl() const { return m_Curl; }
         double getLastTime() const { return m_LastTime; }
         void setLastTime(double value) { m_LastTime = value; }
+        double getPercent() const { return m_Percent; }
         bool cancelRequested() const { return m_Cancel; }
 
-    signals:
-        void progressChanged(double percentsDone);
-
     public slots:
         void cancelHandler();
 
     private:
         double m_LastTime;
+        double m_Percent;
         void *m_Curl;
         volatile bool m_Cancel;
     };
 
+    // one control connection to the host which uploads files from the queue one by one
+    struct FtpConnection {
+        FtpConnection():
+            m_Handle(nullptr),
+            m_File(nullptr),
+            m_FileIndex(-1),
+            m_Attempt(0),
+            m_FileSize(0),
+            m_UploadedLength(0),
+            m_IsQueryingSize(false)
+        { }
+
+        void *m_Handle;
+        std::unique_ptr<CurlProgressReporter> m_ProgressReporter;
+        FILE *m_File;
+        int m_FileIndex;
+        int m_Attempt;
+        qint64 m_FileSize;
+        long m_UploadedLength;
+        bool m_IsQueryingSize;
+    };
+
     class CurlFtpUploader : public QObject
     {
         Q_OBJECT
@@ -75,15 +101,29 @@ namespace Conectivity {
     public slots:
         void cancel();
 
-    private slots:
+    private:
         void reportCurrentFileProgress(double percent);
+        void reportConnectionsProgress();
+        int takeReadyArchives();
+        bool startNextFile(void *multiHandle, FtpConnection &connection);
+        void processFinishedTransfer(void *multiHandle, FtpConnection &connection, int curlResult);
+        void finishFile(FtpConnection &connection, bool success);
+        void releaseArchive(int fileIndex, bool uploaded);
 
     private:
         std::shared_ptr<UploadBatch> m_BatchToUpload;
+        std::shared_ptr<ArchivesPipeline> m_ArchivesPipeline;
+        // files from the batch followed by archives taken from the pipeline
+        QStringList m_FilesToUpload;
+        std::vector<FtpConnection> m_Connections;
+        std::deque<int> m_FilesQueue;
+        QString m_Host;
+        volatile bool m_AnyErrors;
         volatile int m_UploadedCount;
         volatile bool m_Cancel;
         double m_LastPercentage;
         int m_TotalCount;
+        int m_FirstArchiveIndex;
     };
 }
 
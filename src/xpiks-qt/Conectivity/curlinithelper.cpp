@@ -21,6 +21,7 @@
 
 #include "curlinithelper.h"
 #include <curl/curl.h>
+#include "curlrequestsengine.h"
 
 namespace Conectivity {
     CurlInitHelper::CurlInitHelper() {
@@ -28,6 +29,8 @@ namespace Conectivity {
     }
 
     CurlInitHelper::~CurlInitHelper() {
+        // pooled handles have to be released before global cleanup
+        CurlRequestsEngine::getInstance().shutdown();
         curl_global_cleanup();
     }
 }
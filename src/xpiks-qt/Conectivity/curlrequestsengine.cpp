@@ -0,0 +1,346 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "curlrequestsengine.h"
+#include <curl/curl.h>
+#include <string>
+#include <QMutexLocker>
+#include "simplecurlrequest.h"
+#include "ftphelpers.h"
+#include "../Common/defines.h"
+
+#define MULTI_WAIT_TIMEOUT_MS 50
+#define MAX_IDLE_HANDLES 8
+#define MAX_CACHED_CONNECTIONS 16
+#define DNS_CACHE_TIMEOUT_SECONDS 300
+#define RESPONSE_BUFFER_INITIAL_SIZE (16*1024)
+#define RESPONSE_BUFFER_MAX_PREALLOCATE (16*1024*1024)
+
+static size_t WriteMemoryCallback(void *contents, size_t size, size_t nmemb, void *userp) {
+    size_t realsize = size * nmemb;
+    Conectivity::CurlTransfer *transfer = (Conectivity::CurlTransfer *)userp;
+    QByteArray &buffer = transfer->m_ResponseData;
+
+    if (buffer.isEmpty()) {
+        // headers are already received so we can grow the buffer only once
+        double contentLength = 0.0;
+        if ((curl_easy_getinfo((CURL *)transfer->m_Handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &contentLength) == CURLE_OK) &&
+                (contentLength > buffer.capacity()) &&
+                (contentLength < RESPONSE_BUFFER_MAX_PREALLOCATE)) {
+            buffer.reserve((int)contentLength);
+        }
+    }
+
+    buffer.append((const char *)contents, (int)realsize);
+
+    return realsize;
+}
+
+namespace Conectivity {
+    CurlRequestsEngine::CurlRequestsEngine():
+        QThread(),
+        m_CreatedHandlesCount(0),
+        m_IsStopped(false)
+    {
+    }
+
+    CurlRequestsEngine::~CurlRequestsEngine() {
+        shutdown();
+    }
+
+    void CurlRequestsEngine::submitRequest(SimpleCurlRequest *request) {
+        Q_ASSERT(request != nullptr);
+        std::unique_ptr<CurlTransfer> transfer(new CurlTransfer(request));
+
+        QMutexLocker locker(&m_Mutex);
+
+        if (m_IsStopped) {
+            locker.unlock();
+            LOG_WARNING << "Requests engine is stopped";
+            finishTransfer(transfer, false, QLatin1String("Requests engine is stopped"));
+            return;
+        }
+
+        setupTransfer(transfer.get());
+
+        bool wasEmpty = m_PendingTransfers.empty();
+        m_PendingTransfers.emplace_back(std::move(transfer));
+
+        if (!isRunning()) {
+            LOG_INFO << "Starting requests engine";
+            start(QThread::LowPriority);
+        } else if (wasEmpty) {
+            m_WaitAnyTransfer.wakeOne();
+        }
+    }
+
+    void CurlRequestsEngine::shutdown() {
+        m_Mutex.lock();
+        {
+            m_IsStopped = true;
+            m_WaitAnyTransfer.wakeOne();
+        }
+        m_Mutex.unlock();
+
+        if (isRunning()) {
+            LOG_INFO << "Waiting for requests engine to stop...";
+            wait();
+        }
+
+        cleanupIdleHandles();
+    }
+
+    void CurlRequestsEngine::run() {
+        LOG_DEBUG << "#";
+
+        CURLM *multiHandle = curl_multi_init();
+        // all easy handles of one multi handle share its connection cache
+        curl_multi_setopt(multiHandle, CURLMOPT_MAXCONNECTS, (long)MAX_CACHED_CONNECTIONS);
+
+        CURLSH *shareHandle = curl_share_init();
+        // share handle is only used from this thread so no locking callbacks are needed
+        curl_share_setopt(shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
+        for (;;) {
+            m_Mutex.lock();
+            {
+                while (!m_IsStopped && m_PendingTransfers.empty() && m_ActiveTransfers.empty()) {
+                    m_WaitAnyTransfer.wait(&m_Mutex);
+                }
+            }
+            m_Mutex.unlock();
+
+            if (m_IsStopped) { break; }
+
+            addPendingTransfers(multiHandle, shareHandle);
+
+            int runningCount = 0;
+            curl_multi_perform(multiHandle, &runningCount);
+
+            readFinishedTransfers(multiHandle);
+
+            if (!m_ActiveTransfers.empty()) {
+                curl_multi_wait(multiHandle, nullptr, 0, MULTI_WAIT_TIMEOUT_MS, nullptr);
+            }
+        }
+
+        cancelAllTransfers(multiHandle);
+
+        curl_multi_cleanup(multiHandle);
+        // idle handles still point to the share handle
+        cleanupIdleHandles();
+        curl_share_cleanup(shareHandle);
+
+        LOG_INFO << "Requests engine stopped";
+    }
+
+    void CurlRequestsEngine::addPendingTransfers(void *multi, void *shareHandle) {
+        CURLM *multiHandle = (CURLM *)multi;
+        std::deque<std::unique_ptr<CurlTransfer> > transfers;
+
+        m_Mutex.lock();
+        {
+            transfers.swap(m_PendingTransfers);
+        }
+        m_Mutex.unlock();
+
+        for (auto &transfer: transfers) {
+            CURL *handle = (CURL *)transfer->m_Handle;
+            curl_easy_setopt(handle, CURLOPT_SHARE, shareHandle);
+
+            CURLMcode result = curl_multi_add_handle(multiHandle, handle);
+            if (result != CURLM_OK) {
+                LOG_WARNING << "Failed to add request:" << curl_multi_strerror(result);
+                finishTransfer(transfer, false, QString::fromLatin1(curl_multi_strerror(result)));
+                continue;
+            }
+
+            m_ActiveTransfers.emplace(handle, std::move(transfer));
+        }
+    }
+
+    void CurlRequestsEngine::readFinishedTransfers(void *multi) {
+        CURLM *multiHandle = (CURLM *)multi;
+        CURLMsg *message = nullptr;
+        int messagesLeft = 0;
+
+        while ((message = curl_multi_info_read(multiHandle, &messagesLeft)) != nullptr) {
+            if (message->msg != CURLMSG_DONE) { continue; }
+
+            CURL *handle = message->easy_handle;
+            const CURLcode result = message->data.result;
+
+            curl_multi_remove_handle(multiHandle, handle);
+
+            auto it = m_ActiveTransfers.find(handle);
+            if (it == m_ActiveTransfers.end()) {
+                Q_ASSERT(false);
+                continue;
+            }
+
+            std::unique_ptr<CurlTransfer> transfer(std::move(it->second));
+            m_ActiveTransfers.erase(it);
+
+            const bool success = (CURLE_OK == result);
+            QString errorString;
+
+            if (!success) {
+                errorString = QString::fromLatin1(curl_easy_strerror(result));
+                LOG_WARNING << "request failed:" << errorString;
+            } else {
+                LOG_INFO << transfer->m_ResponseData.size() << "bytes received";
+            }
+
+            finishTransfer(transfer, success, errorString);
+        }
+    }
+
+    void CurlRequestsEngine::cancelAllTransfers(void *multi) {
+        CURLM *multiHandle = (CURLM *)multi;
+
+        for (auto &pair: m_ActiveTransfers) {
+            curl_multi_remove_handle(multiHandle, (CURL *)pair.first);
+            finishTransfer(pair.second, false, QLatin1String("Cancelled"));
+        }
+
+        m_ActiveTransfers.clear();
+
+        std::deque<std::unique_ptr<CurlTransfer> > transfers;
+
+        m_Mutex.lock();
+        {
+            transfers.swap(m_PendingTransfers);
+        }
+        m_Mutex.unlock();
+
+        for (auto &transfer: transfers) {
+            finishTransfer(transfer, false, QLatin1String("Cancelled"));
+        }
+    }
+
+    void CurlRequestsEngine::finishTransfer(std::unique_ptr<CurlTransfer> &transfer, bool success, const QString &errorString) {
+        if (transfer->m_Handle != nullptr) {
+            releaseHandle(transfer->m_Handle);
+            transfer->m_Handle = nullptr;
+        }
+
+        if (transfer->m_Headers != nullptr) {
+            curl_slist_free_all(transfer->m_Headers);
+            transfer->m_Headers = nullptr;
+        }
+
+        transfer->m_Request->finishRequest(success, transfer->m_ResponseData, errorString);
+        transfer.reset();
+    }
+
+    void *CurlRequestsEngine::acquireHandle() {
+        // called from submitRequest() with the mutex locked
+        CURL *handle = nullptr;
+
+        if (!m_IdleHandles.empty()) {
+            handle = (CURL *)m_IdleHandles.back();
+            m_IdleHandles.pop_back();
+            curl_easy_reset(handle);
+        } else {
+            handle = curl_easy_init();
+            m_CreatedHandlesCount++;
+        }
+
+        return handle;
+    }
+
+    void CurlRequestsEngine::releaseHandle(void *handle) {
+        // idle handles are touched both from the callers and from the engine thread
+        QMutexLocker locker(&m_Mutex);
+
+        if (m_IdleHandles.size() < MAX_IDLE_HANDLES) {
+            m_IdleHandles.push_back(handle);
+        } else {
+            curl_easy_cleanup((CURL *)handle);
+        }
+    }
+
+    void CurlRequestsEngine::cleanupIdleHandles() {
+        QMutexLocker locker(&m_Mutex);
+        Q_UNUSED(locker);
+
+        for (void *handle: m_IdleHandles) {
+            curl_easy_cleanup((CURL *)handle);
+        }
+
+        m_IdleHandles.clear();
+    }
+
+    void CurlRequestsEngine::setupTransfer(CurlTransfer *transfer) {
+        SimpleCurlRequest *request = transfer->m_Request;
+        CURL *handle = (CURL *)acquireHandle();
+        transfer->m_Handle = handle;
+        transfer->m_ResponseData.reserve(RESPONSE_BUFFER_INITIAL_SIZE);
+
+        // curl copies string options so temporaries are fine here
+        std::string resourceString = request->getResource().toStdString();
+        curl_easy_setopt(handle, CURLOPT_URL, resourceString.data());
+
+        if (!request->getVerifySSL()) {
+            curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, 0L);
+            curl_easy_setopt(handle, CURLOPT_SSL_VERIFYHOST, 0L);
+        }
+
+        curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, WriteMemoryCallback);
+        curl_easy_setopt(handle, CURLOPT_WRITEDATA, (void *)transfer);
+
+        curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(handle, CURLOPT_DNS_CACHE_TIMEOUT, (long)DNS_CACHE_TIMEOUT_SECONDS);
+
+        const QString &userAgent = request->getUserAgent();
+        if (!userAgent.isEmpty()) {
+            std::string userAgentString = userAgent.toStdString();
+            curl_easy_setopt(handle, CURLOPT_USERAGENT, userAgentString.data());
+        } else {
+            /* some servers don't like requests that are made without a user-agent
+                 field, so we provide one */
+            curl_easy_setopt(handle, CURLOPT_USERAGENT, "libcurl-agent/1.0");
+        }
+
+        const QByteArray &postData = request->getPostData();
+        if (!postData.isEmpty()) {
+            curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE, (long)postData.size());
+            curl_easy_setopt(handle, CURLOPT_COPYPOSTFIELDS, postData.constData());
+        }
+
+        const QStringList &rawHeaders = request->getRawHeaders();
+        if (!rawHeaders.empty()) {
+            foreach (const QString &header, rawHeaders) {
+                std::string headerString = header.toStdString();
+                transfer->m_Headers = curl_slist_append(transfer->m_Headers, headerString.data());
+            }
+
+            curl_easy_setopt(handle, CURLOPT_HTTPHEADER, transfer->m_Headers);
+        }
+
+        Models::ProxySettings *proxySettings = request->getProxySettings();
+        if (proxySettings != nullptr) {
+            fillProxySettings(handle, proxySettings);
+        }
+    }
+}
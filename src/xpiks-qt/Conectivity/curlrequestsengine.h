@@ -0,0 +1,107 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CURLREQUESTSENGINE_H
+#define CURLREQUESTSENGINE_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QByteArray>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+struct curl_slist;
+
+namespace Conectivity {
+    class SimpleCurlRequest;
+
+    struct CurlTransfer {
+        CurlTransfer(SimpleCurlRequest *request):
+            m_Request(request),
+            m_Handle(nullptr),
+            m_Headers(nullptr)
+        { }
+
+        SimpleCurlRequest *m_Request;
+        void *m_Handle;
+        struct curl_slist *m_Headers;
+        QByteArray m_ResponseData;
+    };
+
+    // runs all simple requests on one thread using a single curl multi handle
+    // so connections, dns lookups and ssl sessions are reused between requests
+    class CurlRequestsEngine : public QThread
+    {
+        Q_OBJECT
+    public:
+        static CurlRequestsEngine& getInstance()
+        {
+            static CurlRequestsEngine instance; // Guaranteed to be destroyed.
+            // Instantiated on first use.
+            return instance;
+        }
+
+    private:
+        CurlRequestsEngine();
+        CurlRequestsEngine(CurlRequestsEngine const&);
+        void operator=(CurlRequestsEngine const&);
+
+    public:
+        virtual ~CurlRequestsEngine();
+
+    public:
+        void submitRequest(SimpleCurlRequest *request);
+        // should be called before curl_global_cleanup()
+        void shutdown();
+
+#ifdef INTEGRATION_TESTS
+    public:
+        int getCreatedHandlesCount() const { return m_CreatedHandlesCount; }
+#endif
+
+    protected:
+        virtual void run() override;
+
+    private:
+        void addPendingTransfers(void *multiHandle, void *shareHandle);
+        void readFinishedTransfers(void *multiHandle);
+        void cancelAllTransfers(void *multiHandle);
+        void finishTransfer(std::unique_ptr<CurlTransfer> &transfer, bool success, const QString &errorString);
+        void *acquireHandle();
+        void releaseHandle(void *handle);
+        void cleanupIdleHandles();
+        void setupTransfer(CurlTransfer *transfer);
+
+    private:
+        QMutex m_Mutex;
+        QWaitCondition m_WaitAnyTransfer;
+        std::deque<std::unique_ptr<CurlTransfer> > m_PendingTransfers;
+        std::unordered_map<void*, std::unique_ptr<CurlTransfer> > m_ActiveTransfers;
+        std::vector<void*> m_IdleHandles;
+        volatile int m_CreatedHandlesCount;
+        volatile bool m_IsStopped;
+    };
+}
+
+#endif // CURLREQUESTSENGINE_H
@@ -44,12 +44,19 @@ namespace Conectivity {
         m_OverallProgress(0.0),
         m_FinishedWorkersCount(0),
         m_AllWorkersCount(0),
+        m_MaxParallelUploads(maxParallelUploads),
         m_AnyFailed(false)
     {
     }
 
     void FtpCoordinator::uploadArtworks(const QVector<Models::ArtworkMetadata *> &artworksToUpload,
                                         std::vector<std::shared_ptr<Models::UploadInfo> > &uploadInfos) {
+        uploadArtworks(artworksToUpload, uploadInfos, std::shared_ptr<ArchivesPipeline>());
+    }
+
+    void FtpCoordinator::uploadArtworks(const QVector<Models::ArtworkMetadata *> &artworksToUpload,
+                                        std::vector<std::shared_ptr<Models::UploadInfo> > &uploadInfos,
+                                        const std::shared_ptr<ArchivesPipeline> &archivesPipeline) {
         LOG_INFO << "Trying to upload" << artworksToUpload.size() <<
                    "file(s) to" << uploadInfos.size() << "host(s)";
 
@@ -63,7 +70,8 @@ namespace Conectivity {
         std::vector<std::shared_ptr<UploadBatch> > batches = std::move(generateUploadBatches(artworksToUpload,
                                                                                              uploadInfos,
                                                                                              secretsManager,
-                                                                                             settingsModel));
+                                                                                             settingsModel,
+                                                                                             archivesPipeline));
 
         Q_ASSERT(batches.size() == uploadInfos.size());
 
@@ -53,8 +53,14 @@ namespace Conectivity {
         // IFTPCOORDINATOR
         virtual void uploadArtworks(const QVector<Models::ArtworkMetadata *> &artworksToUpload,
                                     std::vector<std::shared_ptr<Models::UploadInfo> > &uploadInfos) override;
+        virtual void uploadArtworks(const QVector<Models::ArtworkMetadata *> &artworksToUpload,
+                                    std::vector<std::shared_ptr<Models::UploadInfo> > &uploadInfos,
+                                    const std::shared_ptr<ArchivesPipeline> &archivesPipeline) override;
         virtual void cancelUpload() override;
 
+    public:
+        int getMaxParallelUploads() const { return m_MaxParallelUploads; }
+
     signals:
         void uploadStarted();
         void cancelAll();
@@ -76,6 +82,7 @@ namespace Conectivity {
         double m_OverallProgress;
         QAtomicInt m_FinishedWorkersCount;
         volatile size_t m_AllWorkersCount;
+        int m_MaxParallelUploads;
         volatile bool m_AnyFailed;
     };
 }
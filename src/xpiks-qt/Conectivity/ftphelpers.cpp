@@ -211,7 +211,8 @@ namespace Conectivity {
         }
 
         if (!host.startsWith(QLatin1String("ftp.")) &&
-            !host.startsWith(QLatin1String("ftp://"))) {
+            !host.startsWith(QLatin1String("ftp://")) &&
+            !host.startsWith(QLatin1String("ftps://"))) {
             host = QLatin1String("ftp://") + host;
         }
 
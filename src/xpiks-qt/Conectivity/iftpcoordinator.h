@@ -32,12 +32,18 @@ namespace Models {
 }
 
 namespace Conectivity {
+    class ArchivesPipeline;
+
     class IFtpCoordinator {
     public:
         virtual ~IFtpCoordinator() {}
 
         virtual void uploadArtworks(const QVector<Models::ArtworkMetadata *> &artworksToUpload,
                             std::vector<std::shared_ptr<Models::UploadInfo> > &uploadInfos) = 0;
+        // hosts with zipping enabled upload archives as they appear in the pipeline
+        virtual void uploadArtworks(const QVector<Models::ArtworkMetadata *> &artworksToUpload,
+                                    std::vector<std::shared_ptr<Models::UploadInfo> > &uploadInfos,
+                                    const std::shared_ptr<ArchivesPipeline> &archivesPipeline) = 0;
         virtual void cancelUpload() = 0;
     };
 }
@@ -26,12 +26,17 @@
 #include <QString>
 #include <QByteArray>
 #include <QStringList>
+#include <QSemaphore>
 
 namespace Models {
     class ProxySettings;
 }
 
 namespace Conectivity {
+    class CurlRequestsEngine;
+
+    // request is executed by the shared CurlRequestsEngine
+    // and requestFinished() is emitted from the engine thread
     class SimpleCurlRequest : public QObject
     {
         Q_OBJECT
@@ -41,30 +46,42 @@ namespace Conectivity {
     public:
         const QByteArray &getResponseData() const { return m_ResponseData; }
         const QString &getErrorString() const { return m_ErrorString; }
+        const QString &getResource() const { return m_RemoteResource; }
+        const QStringList &getRawHeaders() const { return m_RawHeaders; }
+        const QByteArray &getPostData() const { return m_PostData; }
+        const QString &getUserAgent() const { return m_UserAgent; }
+        Models::ProxySettings *getProxySettings() const { return m_ProxySettings; }
+        bool getVerifySSL() const { return m_VerifySSL; }
 
     public:
         void dispose() { emit stopped(); }
         bool sendRequestSync();
+        void sendRequestAsync();
         void setRawHeaders(const QStringList &headers);
         void setProxySettings(Models::ProxySettings *proxySettings);
-
-    public slots:
-        void process();
+        void setPostData(const QByteArray &postData) { m_PostData = postData; }
+        void setUserAgent(const QString &userAgent) { m_UserAgent = userAgent; }
 
     signals:
         void requestFinished(bool success);
         void stopped();
 
     private:
-        bool doRequest();
+        friend class CurlRequestsEngine;
+        void finishRequest(bool success, QByteArray &responseData, const QString &errorString);
 
     private:
         QString m_RemoteResource;
         QStringList m_RawHeaders;
+        QByteArray m_PostData;
+        QString m_UserAgent;
         QByteArray m_ResponseData;
         QString m_ErrorString;
+        QSemaphore m_FinishedSemaphore;
         Models::ProxySettings *m_ProxySettings;
         bool m_VerifySSL;
+        volatile bool m_IsSync;
+        volatile bool m_Success;
     };
 }
 
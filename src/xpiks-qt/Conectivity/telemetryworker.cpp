@@ -27,9 +27,8 @@
 #include <QByteArray>
 #include <QTime>
 #include <QRegExp>
-#include <curl/curl.h>
-#include <string>
 #include "../Common/version.h"
+#include "simplecurlrequest.h"
 
 void buildQuery(std::shared_ptr<Conectivity::AnalyticsUserEvent> &userEvent, const QString &userAgent, QUrlQuery &query) {
     query.addQueryItem(QLatin1String("idsite"), QLatin1String("1"));
@@ -95,19 +94,6 @@ namespace Conectivity {
     }
 
     bool TelemetryWorker::sendOneReport(const QString &resource, const QString &payload) {
-        CURL *curl_handle;
-        CURLcode res;
-
-        /* init the curl session */
-        curl_handle = curl_easy_init();
-
-        std::string resourceString = resource.toStdString();
-        const char *url = resourceString.data();
-        /* specify URL to get */
-        curl_easy_setopt(curl_handle, CURLOPT_URL, url);
-
-        /* some servers don't like requests that are made without a user-agent
-             field, so we provide one */
         QString userAgent;
 #if defined(Q_OS_DARWIN)
         userAgent = QString("Mozilla/5.0 (Macintosh; Mac OS X %2; rv:1.1) Qt Xpiks/1.1")
@@ -123,30 +109,17 @@ namespace Conectivity {
                 .arg("?");
 #  endif
 #endif
-        std::string userAgentString = userAgent.toStdString();
-        const char *userAgentData = userAgentString.data();
-        curl_easy_setopt(curl_handle, CURLOPT_USERAGENT, userAgentData);
-
-        std::string postString = payload.toStdString();
-        const char *postData = postString.data();
-        /* Now specify the POST data */
-        curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDS, postData);
 
-        curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDSIZE, (long)postString.size());
+        // reuses the connection to the reporting endpoint between events
+        SimpleCurlRequest request(resource, true);
+        request.setUserAgent(userAgent);
+        request.setPostData(payload.toUtf8());
 
-        /* get it! */
-        res = curl_easy_perform(curl_handle);
-
-        const bool success = (CURLE_OK == res);
-
-        /* check for errors */
-        if(!success) {
-            LOG_WARNING << "curl_easy_perform() failed" << curl_easy_strerror(res);
+        const bool success = request.sendRequestSync();
+        if (!success) {
+            LOG_WARNING << "Failed to send report" << request.getErrorString();
         }
 
-        /* cleanup curl stuff */
-        curl_easy_cleanup(curl_handle);
-
         return success;
     }
 }
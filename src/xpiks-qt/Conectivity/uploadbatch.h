@@ -27,11 +27,14 @@
 #include "uploadcontext.h"
 
 namespace Conectivity {
+    class ArchivesPipeline;
+
     class UploadBatch {
     public:
         UploadBatch(const std::shared_ptr<UploadContext> &context, const QStringList &filesList):
             m_FilesList(filesList),
-            m_UploadContext(context)
+            m_UploadContext(context),
+            m_ConsumerIndex(-1)
         {}
 
         virtual ~UploadBatch() { }
@@ -39,10 +42,21 @@ namespace Conectivity {
     public:
         const QStringList &getFilesToUpload() const { return m_FilesList; }
         UploadContext *getContext() const { return m_UploadContext.get(); }
+        // archives from the pipeline are uploaded in addition to the files list
+        const std::shared_ptr<ArchivesPipeline> &getArchivesPipeline() const { return m_ArchivesPipeline; }
+        int getConsumerIndex() const { return m_ConsumerIndex; }
+
+    public:
+        void setArchivesPipeline(const std::shared_ptr<ArchivesPipeline> &pipeline, int consumerIndex) {
+            m_ArchivesPipeline = pipeline;
+            m_ConsumerIndex = consumerIndex;
+        }
 
     private:
         QStringList m_FilesList;
         std::shared_ptr<UploadContext> m_UploadContext;
+        std::shared_ptr<ArchivesPipeline> m_ArchivesPipeline;
+        int m_ConsumerIndex;
     };
 }
 
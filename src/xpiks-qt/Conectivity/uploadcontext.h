@@ -32,6 +32,11 @@ namespace Models {
 namespace Conectivity {
     class UploadContext {
     public:
+        UploadContext():
+            m_RetriesCount(0),
+            m_MaxConnections(1)
+        { }
+
         ~UploadContext() {
             LOG_DEBUG << "destructor for host" << m_Host;
         }
@@ -45,6 +50,7 @@ namespace Conectivity {
         bool m_UsePassiveMode;
         bool m_UseEPSV;
         int m_RetriesCount;
+        int m_MaxConnections;
         int m_TimeoutSeconds;
         bool m_UseProxy;
         bool m_VerboseLogging;
@@ -386,7 +386,7 @@ Item {
                         visible: replaceModel.count == 0
 
                         StyledText {
-                            text: i18.n + qsTr("Nothing found")
+                            text: replaceModel.inProgress ? (i18.n + qsTr("Searching...")) : (i18.n + qsTr("Nothing found"))
                             anchors.centerIn: parent
                             color: Colors.selectedArtworkBackground
                         }
@@ -425,7 +425,7 @@ Item {
 
                     StyledButton {
                         text: i18.n + qsTr("Replace", "button")
-                        enabled: replaceModel.count > 0
+                        enabled: (replaceModel.count > 0) && !replaceModel.inProgress
                         width: 100
                         onClicked: {
                             replaceModel.replace()
@@ -646,6 +646,57 @@ ApplicationWindow {
                         }
                     }
 
+                    RowLayout {
+                        width: parent.width
+                        spacing: 10
+
+                        StyledText {
+                            horizontalAlignment: Text.AlignLeft
+                            text: i18.n + qsTr("Previews cache size:")
+                        }
+
+                        Rectangle {
+                            color: enabled ? Colors.inputBackgroundColor : Colors.inputInactiveBackground
+                            border.color: Colors.artworkActiveColor
+                            border.width: imagesCacheSize.activeFocus ? 1 : 0
+                            width: 115
+                            height: UIConfig.textInputHeight
+                            clip: true
+
+                            StyledTextInput {
+                                id: imagesCacheSize
+                                text: settingsModel.imagesCacheSize
+                                anchors.left: parent.left
+                                anchors.right: parent.right
+                                anchors.leftMargin: 5
+                                anchors.rightMargin: 5
+                                anchors.verticalCenter: parent.verticalCenter
+                                // smaller budget evicts previews so partial input is not applied
+                                onEditingFinished: {
+                                    settingsModel.imagesCacheSize = parseInt(text)
+                                }
+
+                                function onResetRequested() {
+                                    text = settingsModel.imagesCacheSize
+                                }
+
+                                Component.onCompleted: {
+                                    uxTab.resetRequested.connect(imagesCacheSize.onResetRequested)
+                                }
+
+                                validator: IntValidator {
+                                    bottom: 100
+                                    top: 100000
+                                }
+                            }
+                        }
+
+                        StyledText {
+                            text: i18.n + qsTr("(MB)")
+                            isActive: false
+                        }
+                    }
+
                     Item {
                         Layout.fillHeight: true
                     }
@@ -925,6 +976,7 @@ ApplicationWindow {
                                     uploadTab.resetRequested.connect(maxParallelUploads.onResetRequested)
                                 }
                                 KeyNavigation.backtab: timeoutSeconds
+                                KeyNavigation.tab: maxConnectionsPerHost
                                 validator: IntValidator {
                                     bottom: 1
                                     top: 4
@@ -938,6 +990,54 @@ ApplicationWindow {
                         }
                     }
 
+                    RowLayout {
+                        width: parent.width
+                        spacing: 10
+
+                        StyledText {
+                            Layout.preferredWidth: 130
+                            horizontalAlignment: Text.AlignRight
+                            text: i18.n + qsTr("Connections per host:")
+                        }
+
+                        Rectangle {
+                            color: enabled ? Colors.inputBackgroundColor : Colors.inputInactiveBackground
+                            border.width: maxConnectionsPerHost.activeFocus ? 1 : 0
+                            border.color: Colors.artworkActiveColor
+                            width: 115
+                            height: UIConfig.textInputHeight
+                            clip: true
+
+                            StyledTextInput {
+                                id: maxConnectionsPerHost
+                                text: settingsModel.maxConnectionsPerHost
+                                anchors.left: parent.left
+                                anchors.right: parent.right
+                                anchors.leftMargin: 5
+                                anchors.rightMargin: 5
+                                anchors.verticalCenter: parent.verticalCenter
+                                onTextChanged: {
+                                    if (text.length > 0) {
+                                        settingsModel.maxConnectionsPerHost = parseInt(text)
+                                    }
+                                }
+
+                                function onResetRequested() {
+                                    text = settingsModel.maxConnectionsPerHost
+                                }
+
+                                Component.onCompleted: {
+                                    uploadTab.resetRequested.connect(maxConnectionsPerHost.onResetRequested)
+                                }
+                                KeyNavigation.backtab: maxParallelUploads
+                                validator: IntValidator {
+                                    bottom: 1
+                                    top: 8
+                                }
+                            }
+                        }
+                    }
+
                     RowLayout {
                         width: parent.width
                         spacing: 10
@@ -75,7 +75,10 @@ Item {
     }
 
     function startUpload() {
-        if (artworkUploader.needCreateArchives()) {
+        if (artworkUploader.needCreateArchives() && artworkUploader.canPipelineArchives()) {
+            artworkUploader.resetModel()
+            artworkUploader.zipAndUploadArtworks()
+        } else if (artworkUploader.needCreateArchives()) {
             var callbackObject = {
                 afterZipped: function() {
                     mainAction();
@@ -77,11 +77,13 @@ namespace Constants {
     const char USE_AUTO_COMPLETE[] = "USE_AUTO_COMPLETE";
     const char USE_EXIFTOOL[] = "USE_EXIFTOOL";
     const char IMAGES_CACHE_DIR[] = "imagescache";
-    const char IMAGES_CACHE_INDEX[] = "imagescache.index";
+    const char IMAGES_CACHE_INDEX[] = "imagescache.v2.index";
+    const char IMAGES_CACHE_LEGACY_INDEX[] = "imagescache.index";
     const char CACHE_IMAGES_AUTOMATICALLY[] = "CACHE_IMAGES_AUTOMATICALLY";
     const char SCROLL_SPEED_SENSIVITY[] = "SCROLL_SPEED_SENSIVITY";
     const char AUTO_DOWNLOAD_UPDATES[] = "AUTO_DOWNLOAD_UPDATES";
     const char USER_DICT_FILENAME[] = "userdict.dic";
+    const char SPELL_SUGGESTIONS_CACHE_FILENAME[] = "spellsuggestions.cache";
     const char PATH_TO_UPDATE[] = "PATH_TO_UPDATE";
     const char AVAILABLE_UPDATE_VERSION[] = "AVAILABLE_UPDATE_VERSION";
     const char ARTWORK_EDIT_RIGHT_PANE_WIDTH[] = "ARTWORK_EDIT_RIGHT_PANE_WIDTH";
@@ -105,7 +107,8 @@ namespace Constants {
     const char USE_AUTO_COMPLETE[] = "DEBUG_USE_AUTO_COMPLETE";
     const char USE_EXIFTOOL[] = "DEBUG_USE_EXIFTOOL";
     const char IMAGES_CACHE_DIR[] = "debug_imagescache";
-    const char IMAGES_CACHE_INDEX[] = "debug_imagescache.index";
+    const char IMAGES_CACHE_INDEX[] = "debug_imagescache.v2.index";
+    const char IMAGES_CACHE_LEGACY_INDEX[] = "debug_imagescache.index";
     const char SCROLL_SPEED_SENSIVITY[] = "DEBUG_SCROLL_SPEED_SENSIVITY";
     const char AUTO_DOWNLOAD_UPDATES[] = "DEBUG_AUTO_DOWNLOAD_UPDATES";
     const char PATH_TO_UPDATE[] = "DEBUG_PATH_TO_UPDATE";
@@ -124,6 +127,7 @@ namespace Constants {
     const char RECENT_FILES[] = "INTEGRATION_RECENT_FILES";
     const char CACHE_IMAGES_AUTOMATICALLY[] = "INTEGRATION_CACHE_IMAGES_AUTOMATICALLY";
     const char USER_DICT_FILENAME[] = "userdict_debug_tests.dic";
+    const char SPELL_SUGGESTIONS_CACHE_FILENAME[] = "spellsuggestions_debug_tests.cache";
 #else
     const char LIBRARY_FILENAME[] = "xpiks.debug.v14.library";
     const char UPLOAD_HOSTS[] = "DEBUG_UPLOAD_HOSTS_HASH";
@@ -133,6 +137,7 @@ namespace Constants {
     const char RECENT_FILES[] = "DEBUG_RECENT_FILES";
     const char CACHE_IMAGES_AUTOMATICALLY[] = "DEBUG_CACHE_IMAGES_AUTOMATICALLY";
     const char USER_DICT_FILENAME[] = "userdict_debug.dic";
+    const char SPELL_SUGGESTIONS_CACHE_FILENAME[] = "spellsuggestions_debug.cache";
 #endif
 #endif // QT_NO_DEBUG
 
@@ -165,6 +170,7 @@ namespace Constants {
     const char recentDirectories[] = "recentDirectories";
     const char recentFiles[] = "recentFiles";
     const char maxParallelUploads[] = "maxParallelUploads";
+    const char maxConnectionsPerHost[] = "maxConnectionsPerHost";
     const char useSpellCheck[] = "useSpellCheck";
     const char userAgentId[] = "userAgentId";
     const char installedVersion[] = "installedVersion";
@@ -174,6 +180,7 @@ namespace Constants {
     const char useAutoComplete[] = "useAutoComplete";
     const char useExifTool[] = "useExifTool";
     const char cacheImagesAutomatically[] = "cacheImagesAutomatically";
+    const char imagesCacheSize[] = "imagesCacheSize";
     const char scrollSpeedSensivity[] = "scrollSpeedSensivity";
     const char autoDownloadUpdates[] = "autoDownloadUpdates";
     const char pathToUpdate[] = "pathToUpdate";
@@ -67,7 +67,7 @@ namespace Helpers {
 
     qint64 findLogFiles(const QString &logsDir, QVector<FileInfoHolder> &logFiles) {
         Helpers::Logger &logger = Helpers::Logger::getInstance();
-        QString logFilePath = logger.getLogFilePath();
+        QStringList sessionLogFiles = logger.getLogFilePathes();
         QDirIterator it(logsDir, QStringList() << "xpiks-qt-*.log", QDir::Files);
         QDateTime currentTime = QDateTime::currentDateTime();
         qint64 logsSizeBytes = 0;
@@ -75,7 +75,7 @@ namespace Helpers {
         while (it.hasNext()) {
             QString fileNameFull = it.next();
 
-            if (fileNameFull == logFilePath) {
+            if (sessionLogFiles.contains(fileNameFull)) {
                 continue;
             }
 
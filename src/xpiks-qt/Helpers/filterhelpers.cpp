@@ -26,6 +26,7 @@
 #include "../Common/basickeywordsmodel.h"
 #include "../Common/flags.h"
 #include "../Common/defines.h"
+#include "stringhelper.h"
 
 namespace Helpers {
     bool fitsSpecialKeywords(const QString &searchTerm, Models::ArtworkMetadata *metadata) {
@@ -210,4 +211,20 @@ namespace Helpers {
         return hasMatch;
     }
 
+    QString replaceInText(const QString &text, const QString &replaceWhat,
+                          const QString &replaceTo, Common::SearchFlags flags) {
+        const bool wholeWords = Common::HasFlag(flags, Common::SearchFlags::WholeWords);
+        const bool caseSensitive = Common::HasFlag(flags, Common::SearchFlags::CaseSensitive);
+        const Qt::CaseSensitivity caseSensivity = caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+        QString result;
+        if (!wholeWords) {
+            result = text;
+            result.replace(replaceWhat, replaceTo, caseSensivity);
+        } else {
+            result = Helpers::replaceWholeWords(text, replaceWhat, replaceTo, caseSensivity);
+        }
+
+        return result;
+    }
 }
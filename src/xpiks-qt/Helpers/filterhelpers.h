@@ -31,6 +31,9 @@ namespace Models {
 
 namespace Helpers {
     bool hasSearchMatch(const QString &searchTerm, Models::ArtworkMetadata *metadata, Common::SearchFlags searchFlags);
+    // replaces in description or title respecting case and whole words flags
+    QString replaceInText(const QString &text, const QString &replaceWhat,
+                          const QString &replaceTo, Common::SearchFlags flags);
 }
 
 #endif // FILTERHELPERS_H
@@ -20,6 +20,10 @@
  */
 
 #include "globalimageprovider.h"
+#include <QImageReader>
+#include <QFileInfo>
+#include <QDateTime>
+#include "../QMLExtensions/decodedimagecache.h"
 
 namespace Helpers {
     QImage GlobalImageProvider::requestImage(const QString &url, QSize *size, const QSize &requestedSize) {
@@ -32,14 +36,37 @@ namespace Helpers {
             id = url;
         }
 
-        QImage image(id);
         QImage result;
+        QString decodedKey;
 
-        if (requestedSize.isValid()) {
+        if (m_DecodedImageCache != NULL) {
+            // originals can be changed while they are shown
+            const qint64 lastModified = QFileInfo(id).lastModified().toMSecsSinceEpoch();
+            decodedKey = QMLExtensions::DecodedImageCache::makeKey(id, requestedSize) + QString(":%1").arg(lastModified);
+
+            if (m_DecodedImageCache->tryGet(decodedKey, result)) {
+                *size = result.size();
+                return result;
+            }
+        }
+
+        QImageReader reader(id);
+        const QSize originalSize = reader.size();
+
+        if (requestedSize.isValid() && originalSize.isValid()) {
+            // reader scales while decoding so the full original is never materialized
+            reader.setScaledSize(originalSize.scaled(requestedSize, Qt::KeepAspectRatio));
+            reader.read(&result);
+        } else if (requestedSize.isValid()) {
+            QImage image = reader.read();
             result = image.scaled(requestedSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
         }
         else {
-            result = image;
+            result = reader.read();
+        }
+
+        if (m_DecodedImageCache != NULL) {
+            m_DecodedImageCache->insert(decodedKey, result);
         }
 
         *size = result.size();
@@ -24,18 +24,31 @@
 
 #include <QQuickImageProvider>
 
+namespace QMLExtensions {
+    class DecodedImageCache;
+}
+
 namespace Helpers {
     class GlobalImageProvider : public QObject, public QQuickImageProvider
     {
         Q_OBJECT
     public:
         GlobalImageProvider(ImageType type, Flags flags = 0) :
-            QQuickImageProvider(type, flags)
+            QQuickImageProvider(type, flags),
+            m_DecodedImageCache(NULL)
         {}
 
         virtual ~GlobalImageProvider() {}
 
         virtual QImage requestImage(const QString &url, QSize *size, const QSize& requestedSize) override;
+
+    public:
+        void setDecodedImageCache(QMLExtensions::DecodedImageCache *decodedImageCache) {
+            m_DecodedImageCache = decodedImageCache;
+        }
+
+    private:
+        QMLExtensions::DecodedImageCache *m_DecodedImageCache;
     };
 }
 #endif // GLOBALIMAGEPROVIDER_H
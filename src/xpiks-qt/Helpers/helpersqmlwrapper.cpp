@@ -89,7 +89,8 @@ namespace Helpers {
 
     void HelpersQmlWrapper::revealLogFile() {
         LOG_DEBUG << "#";
-        QString logFilePath = Logger::getInstance().getLogFilePath();
+        // other segments of the session are in the same directory
+        QString logFilePath = Logger::getInstance().getBaseLogFilePath();
         HelpersQmlWrapper::revealFile(logFilePath);
     }
 
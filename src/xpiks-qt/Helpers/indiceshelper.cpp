@@ -92,6 +92,18 @@ namespace Helpers {
         return sum;
     }
 
+    void rangesToIndices(const QVector<QPair<int, int> > &ranges, QVector<int> &indices) {
+        indices.reserve(indices.size() + getRangesLength(ranges));
+
+        int length = ranges.length();
+        for (int i = 0; i < length; ++i) {
+            const QPair<int, int> &pair = ranges[i];
+            for (int j = pair.first; j <= pair.second; ++j) {
+                indices.append(j);
+            }
+        }
+    }
+
     bool segmentsOverlap(const std::pair<int, int> &a, const std::pair<int, int> &b) {
         if (a.first <= b.first) {
             return b.first <= a.second;
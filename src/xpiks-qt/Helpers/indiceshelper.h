@@ -35,6 +35,7 @@ namespace Helpers {
 
     void indicesToRanges(const QVector<int> &indices, QVector<QPair<int, int> > &ranges);
     int getRangesLength(const QVector<QPair<int, int> > &ranges);
+    void rangesToIndices(const QVector<QPair<int, int> > &ranges, QVector<int> &indices);
     RangesVector unionRanges(RangesVector &ranges);
 }
 
@@ -26,21 +26,38 @@
 #include <QMutexLocker>
 #include <QMutex>
 #include <QFile>
+#include <QFileInfo>
 #include <QTextStream>
-#include <QTimer>
 #include <QDir>
-#include <QDateTime>
-#include <QStandardPaths>
-#include <QElapsedTimer>
 #include <iostream>
 #include <string>
-#include <ctime>
 #include "../Common/defines.h"
 
-#define MIN_FIRE_SIZE 20
-#define LOGGING_TIMEOUT 5
+#define LOGGING_TIMEOUT_MS 200
+// current log is continued in the next file after this size
+#define LOG_FILE_MAX_SIZE (10*1024*1024)
 
 namespace Helpers {
+    // xpiks-qt-<time>.log continues in xpiks-qt-<time>-1.log
+    QString getLogSegmentPath(const QString &baseLogFilepath, int rotationIndex) {
+        if (rotationIndex == 0) { return baseLogFilepath; }
+
+        QFileInfo fi(baseLogFilepath);
+        QString filename = QString("%1-%2.%3").arg(fi.completeBaseName()).arg(rotationIndex).arg(fi.suffix());
+        return fi.dir().filePath(filename);
+    }
+
+    QStringList Logger::getLogFilePathes() {
+        QMutexLocker locker(&m_FilepathMutex);
+        QStringList logFilePathes;
+
+        for (int i = 0; i <= m_RotationIndex; ++i) {
+            logFilePathes.append(getLogSegmentPath(m_BaseLogFilepath, i));
+        }
+
+        return logFilePathes;
+    }
+
     void Logger::log(const QString &message) {
         if (!m_Stopped) {
             doLog(message);
@@ -52,72 +69,116 @@ namespace Helpers {
 
         QMutexLocker flushLocker(&m_FlushMutex);
 
-        while (m_QueueFlushFrom->isEmpty()) {
-            QMutexLocker logLocker(&m_LogMutex);
+        if (writePendingLogs() == 0) {
+            m_FlusherSleeping.storeRelease(1);
+            m_AnyLogsToFlush.wait(&m_FlushMutex, LOGGING_TIMEOUT_MS);
+            m_FlusherSleeping.storeRelease(0);
 
-            if (m_QueueLogTo->isEmpty()) {
-                m_AnyLogsToFlush.wait(&m_LogMutex);
-            } else {
-                qSwap(m_QueueLogTo, m_QueueFlushFrom);
-            }
+            writePendingLogs();
         }
-
-        Q_ASSERT(m_QueueFlushFrom->length() > 0);
-        flushStream(m_QueueFlushFrom);
     }
 
     void Logger::stop() {
         m_Stopped = true;
 
         // will make waiting flush() call unblocked if any
-        doLog("Stop message");
+        m_AnyLogsToFlush.wakeOne();
 
         QMutexLocker flushLocker(&m_FlushMutex);
-        flushStream(m_QueueFlushFrom);
-
-        {
-            QMutexLocker logLocker(&m_LogMutex);
+        writePendingLogs();
+        closeLogFile();
+    }
 
-            if (!m_QueueLogTo->isEmpty()) {
-                qSwap(m_QueueLogTo, m_QueueFlushFrom);
-            }
+    void Logger::doLog(const QString &message) {
+        // keep the order while the overflow is not written
+        if ((m_OverflowCount.loadAcquire() > 0) || !m_LogsQueue.tryPush(message)) {
+            QMutexLocker locker(&m_OverflowMutex);
+            m_OverflowLogs.append(message);
+            m_OverflowCount.storeRelease(m_OverflowLogs.size());
         }
 
-        flushStream(m_QueueFlushFrom);
+        if (m_FlusherSleeping.loadAcquire() != 0) {
+            m_AnyLogsToFlush.wakeOne();
+        }
     }
 
-    void Logger::doLog(const QString &message) {
-        QMutexLocker locker(&m_LogMutex);
-        m_QueueLogTo->append(message);
-        m_AnyLogsToFlush.wakeOne();
-    }
+    int Logger::writePendingLogs() {
+        int count = 0;
+        QString line;
 
-    void Logger::flushStream(QStringList *logItems) {
-        Q_ASSERT(logItems != nullptr);
-        if (logItems->empty()) { return; }
+        while (m_LogsQueue.tryPop(line)) {
+            writeLine(line);
+            count++;
+        }
 
-#ifdef WITH_LOGS
-        QFile outFile(m_LogFilepath);
-        if (outFile.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Append)) {
-            QTextStream ts(&outFile);
-            ts.setCodec("UTF-8");
-
-            int size = logItems->size();
-            for (int i = 0; i < size; ++i) {
-                const QString &line = logItems->at(i);
-                ts << line;
-                endl(ts);
+        if (m_OverflowCount.loadAcquire() > 0) {
+            QStringList overflowLogs;
+
+            {
+                QMutexLocker locker(&m_OverflowMutex);
+                overflowLogs.swap(m_OverflowLogs);
+                m_OverflowCount.storeRelease(0);
+            }
+
+            for (const QString &overflowLine: overflowLogs) {
+                writeLine(overflowLine);
             }
+
+            count += overflowLogs.size();
         }
+
+        if (count > 0) {
+#ifdef WITH_LOGS
+            m_LogStream.flush();
+            rotateLogFileIfNeeded();
 #else
-        int size = logItems->size();
-        for (int i = 0; i < size; ++i) {
-            const QString &line = logItems->at(i);
-            std::cout << line.toLocal8Bit().data() << std::endl;
+            std::cout.flush();
+#endif
+        }
+
+        return count;
+    }
+
+    void Logger::writeLine(const QString &line) {
+#ifdef WITH_LOGS
+        if (!m_LogFile.isOpen()) {
+            openLogFile();
         }
 
-        std::cout.flush();
+        if (m_LogFile.isOpen()) {
+            m_LogStream << line << '\n';
+        }
+#else
+        std::cout << line.toLocal8Bit().data() << '\n';
 #endif
-        logItems->clear();
+    }
+
+    void Logger::openLogFile() {
+        m_LogFile.setFileName(getLogFilePath());
+
+        if (m_LogFile.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Append)) {
+            m_LogStream.setDevice(&m_LogFile);
+            m_LogStream.setCodec("UTF-8");
+        } else {
+            std::cerr << "Failed to open log file" << std::endl;
+        }
+    }
+
+    void Logger::rotateLogFileIfNeeded() {
+        if (!m_LogFile.isOpen() || (m_LogFile.size() < LOG_FILE_MAX_SIZE)) { return; }
+
+        closeLogFile();
+
+        QMutexLocker locker(&m_FilepathMutex);
+        m_RotationIndex++;
+        m_LogFilepath = getLogSegmentPath(m_BaseLogFilepath, m_RotationIndex);
+    }
+
+    void Logger::closeLogFile() {
+        if (m_LogFile.isOpen()) {
+            m_LogStream.flush();
+            m_LogStream.setDevice(nullptr);
+            m_LogFile.close();
+        }
     }
 }
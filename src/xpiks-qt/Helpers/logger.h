@@ -26,6 +26,13 @@
 #include <QString>
 #include <QWaitCondition>
 #include <QMutex>
+#include <QAtomicInt>
+#include <QFile>
+#include <QTextStream>
+#include "../Common/boundedmpmcqueue.h"
+
+// lines which do not fit to the ring go to the overflow list
+#define LOGS_QUEUE_CAPACITY 4096
 
 namespace Helpers {
     class Logger
@@ -40,10 +47,26 @@ namespace Helpers {
 
     public:
         void setLogFilePath(const QString &filepath) {
+            QMutexLocker locker(&m_FilepathMutex);
             m_LogFilepath = filepath;
+            m_BaseLogFilepath = filepath;
+            m_RotationIndex = 0;
+        }
+
+        // segment which is written now
+        QString getLogFilePath() {
+            QMutexLocker locker(&m_FilepathMutex);
+            return m_LogFilepath;
         }
 
-        QString getLogFilePath() const { return m_LogFilepath; }
+        // first segment of the session
+        QString getBaseLogFilePath() {
+            QMutexLocker locker(&m_FilepathMutex);
+            return m_BaseLogFilepath;
+        }
+
+        // all segments of the session from the oldest
+        QStringList getLogFilePathes();
 
         void log(const QString &message);
         void flush();
@@ -51,13 +74,20 @@ namespace Helpers {
 
     private:
         void doLog(const QString &message);
-        void flushStream(QStringList *logItems);
+        int writePendingLogs();
+        void writeLine(const QString &line);
+        void openLogFile();
+        void rotateLogFileIfNeeded();
+        void closeLogFile();
 
     private:
-        Logger() {
-            m_QueueLogTo = &m_LogsStorage[0];
-            m_QueueFlushFrom = &m_LogsStorage[1];
-            m_Stopped = false;
+        Logger():
+            m_LogsQueue(LOGS_QUEUE_CAPACITY),
+            m_RotationIndex(0),
+            m_OverflowCount(0),
+            m_FlusherSleeping(0),
+            m_Stopped(false)
+        {
         }
 
         Logger(Logger const&);
@@ -65,10 +95,18 @@ namespace Helpers {
 
     private:
         QString m_LogFilepath;
-        QStringList m_LogsStorage[2];
-        QStringList *m_QueueFlushFrom;
-        QStringList *m_QueueLogTo;
-        QMutex m_LogMutex;
+        QString m_BaseLogFilepath;
+        QMutex m_FilepathMutex;
+        // producers do not lock anything unless the ring is full
+        Common::BoundedMPMCQueue<QString> m_LogsQueue;
+        QStringList m_OverflowLogs;
+        QMutex m_OverflowMutex;
+        // file is kept open between flushes and accessed only under m_FlushMutex
+        QFile m_LogFile;
+        QTextStream m_LogStream;
+        int m_RotationIndex;
+        QAtomicInt m_OverflowCount;
+        QAtomicInt m_FlusherSleeping;
         QMutex m_FlushMutex;
         QWaitCondition m_AnyLogsToFlush;
         volatile bool m_Stopped;
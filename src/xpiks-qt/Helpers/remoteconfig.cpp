@@ -20,7 +20,6 @@
  */
 
 #include "remoteconfig.h"
-#include <QThread>
 #include "../Common/defines.h"
 #include "../Conectivity/simplecurlrequest.h"
 #include "../Models/proxysettings.h"
@@ -41,20 +40,11 @@ namespace Helpers {
         Conectivity::SimpleCurlRequest *request = new Conectivity::SimpleCurlRequest(configUrl);
         request->setProxySettings(proxySettings);
 
-        QThread *thread = new QThread();
-
-        request->moveToThread(thread);
-
-        QObject::connect(thread, SIGNAL(started()), request, SLOT(process()));
-        QObject::connect(request, SIGNAL(stopped()), thread, SLOT(quit()));
-
         QObject::connect(request, SIGNAL(stopped()), request, SLOT(deleteLater()));
-        QObject::connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
-
         QObject::connect(request, SIGNAL(requestFinished(bool)), this, SLOT(requestFinishedHandler(bool)));
 
-        thread->start(QThread::LowPriority);
-        LOG_INFO << "Started request thread for" << configUrl;
+        request->sendRequestAsync();
+        LOG_INFO << "Submitted request for" << configUrl;
     }
 
     void RemoteConfig::requestFinishedHandler(bool success) {
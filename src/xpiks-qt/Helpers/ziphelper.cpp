@@ -20,36 +20,153 @@
  */
 
 #include "ziphelper.h"
+#include <QFile>
 #include <QFileInfo>
-#include <quazip/JlCompress.h>
+#include <QDir>
+#include <QSemaphore>
+#include <QThread>
+#include <QByteArray>
+#include <quazip/quazip.h>
+#include <quazip/quazipfile.h>
+#include <quazip/quazipnewinfo.h>
 #include "filenameshelpers.h"
 #include "../Common/defines.h"
 
+#define ZIP_COPY_BUFFER_SIZE (256*1024)
+#define STORED_METHOD 0
+// less than MAX_ZIPPING_THREADS so other zipping threads keep copying stored entries
+#define MAX_DEFLATING_THREADS 2
+
 namespace Helpers {
-    QStringList zipFiles(QStringList filepathes) {
-        QString zipFilePath;
-        zipArtworkAndVector(filepathes, zipFilePath);
-        return filepathes;
+    // deflate is CPU bound and should not take all zipping threads
+    QSemaphore &getDeflateSemaphore() {
+        static QSemaphore deflateSemaphore(qBound(1, QThread::idealThreadCount() / 2, MAX_DEFLATING_THREADS));
+        return deflateSemaphore;
     }
 
-    bool zipArtworkAndVector(const QStringList &filepathes, QString &zipFilePath) {
-        QString anyFile = filepathes.first();
-        QString archivePath = getArchivePath(anyFile);
+    bool isAlreadyCompressed(const QString &filepath) {
+        const QString suffix = QFileInfo(filepath).suffix().toLower();
+        return (suffix == QLatin1String("jpg")) ||
+                (suffix == QLatin1String("jpeg")) ||
+                (suffix == QLatin1String("png")) ||
+                (suffix == QLatin1String("gif")) ||
+                (suffix == QLatin1String("mp4")) ||
+                (suffix == QLatin1String("mov")) ||
+                (suffix == QLatin1String("zip"));
+    }
+
+    bool copyToZipFile(QFile &source, QuaZipFile &target) {
+        QByteArray buffer(ZIP_COPY_BUFFER_SIZE, Qt::Uninitialized);
+        bool success = true;
+
+        while (!source.atEnd()) {
+            const qint64 read = source.read(buffer.data(), buffer.size());
+            if (read < 0) { success = false; break; }
+
+            if (target.write(buffer.constData(), read) != read) {
+                success = false;
+                break;
+            }
+        }
+
+        return success;
+    }
+
+    bool addFileToZip(QuaZip &zip, const QString &filepath) {
+        QFile source(filepath);
+        if (!source.open(QIODevice::ReadOnly)) {
+            LOG_WARNING << "Failed to open" << filepath;
+            return false;
+        }
+
+        QuaZipNewInfo newInfo(QFileInfo(filepath).fileName(), filepath);
+        QuaZipFile target(&zip);
+
+        // deflating jpegs takes a lot of time and gives nothing
+        const bool store = isAlreadyCompressed(filepath);
+        const int method = store ? STORED_METHOD : Z_DEFLATED;
+        const int level = store ? 0 : Z_DEFAULT_COMPRESSION;
+
+        if (!target.open(QIODevice::WriteOnly, newInfo, NULL, 0, method, level)) {
+            LOG_WARNING << "Failed to create zip entry for" << filepath << "error" << target.getZipError();
+            return false;
+        }
+
+        bool success = false;
+
+        if (store) {
+            success = copyToZipFile(source, target);
+        } else {
+            QSemaphore &deflateSemaphore = getDeflateSemaphore();
+            deflateSemaphore.acquire();
+            success = copyToZipFile(source, target);
+            deflateSemaphore.release();
+        }
+
+        target.close();
+        success = success && (target.getZipError() == UNZ_OK);
+
+        LOG_DEBUG << (store ? "Stored" : "Deflated") << filepath << "success:" << success;
+        return success;
+    }
+
+    QString zipFiles(QStringList filepathes) {
+        QString zipFilePath;
+        if (!zipArtworkAndVector(filepathes, zipFilePath)) {
+            zipFilePath.clear();
+        }
+
+        return zipFilePath;
+    }
 
+    bool createArchive(const QStringList &filepathes, const QString &archivePath) {
         bool result = false;
         try {
-            result = JlCompress::compressFiles(archivePath, filepathes);
+            QuaZip zip(archivePath);
+            if (zip.open(QuaZip::mdCreate)) {
+                result = true;
+
+                for (auto &filepath: filepathes) {
+                    if (!addFileToZip(zip, filepath)) {
+                        result = false;
+                        break;
+                    }
+                }
+
+                zip.close();
+                result = result && (zip.getZipError() == UNZ_OK);
+            }
         } catch (...) {
             LOG_WARNING << "Exception while zipping with QuaZip";
+            result = false;
         }
 
         if (!result) {
             LOG_WARNING << "Failed to create zip" << archivePath;
+            QFile::remove(archivePath);
         }
 
-        zipFilePath = archivePath;
         return result;
     }
-}
 
+    QString zipFilesToDirectory(const QStringList &filepathes, const QString &directory) {
+        QString archiveName = QFileInfo(getArchivePath(filepathes.first())).fileName();
+        QString archivePath = QDir(directory).filePath(archiveName);
+
+        if (!createArchive(filepathes, archivePath)) {
+            archivePath.clear();
+        }
 
+        return archivePath;
+    }
+
+    bool zipArtworkAndVector(const QStringList &filepathes, QString &zipFilePath) {
+        QString anyFile = filepathes.first();
+        QString archivePath = getArchivePath(anyFile);
+
+        bool result = createArchive(filepathes, archivePath);
+
+        zipFilePath = archivePath;
+        return result;
+    }
+}
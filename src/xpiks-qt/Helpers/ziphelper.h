@@ -26,7 +26,10 @@ class QStringList;
 class QString;
 
 namespace Helpers {
-    QStringList zipFiles(QStringList filepathes);
+    // returns path of the created archive or empty string
+    QString zipFiles(QStringList filepathes);
+    // archive is created in the directory instead of next to the files
+    QString zipFilesToDirectory(const QStringList &filepathes, const QString &directory);
     bool zipArtworkAndVector(const QStringList &filepathes, QString &zipFilePath);
 }
 
@@ -36,4 +36,10 @@ namespace MetadataIO {
         MetadataSavingCopy copy(metadata->getBasicModel());
         copy.saveToFile(metadata->getFilepath());
     }
+
+    bool BackupSaverWorker::getCoalescingKey(const std::shared_ptr<SaverWorkerJobItem> &item, Common::CoalescingKey &key) const {
+        // backup is made from the current state of artwork so one job per artwork is enough
+        key = qMakePair((quintptr)item->getMetadata(), 0);
+        return true;
+    }
 }
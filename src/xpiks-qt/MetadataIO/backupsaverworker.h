@@ -33,6 +33,7 @@ namespace MetadataIO {
     protected:
         virtual bool initWorker() override;
         virtual void processOneItem(std::shared_ptr<SaverWorkerJobItem> &item) override;
+        virtual bool getCoalescingKey(const std::shared_ptr<SaverWorkerJobItem> &item, Common::CoalescingKey &key) const override;
 
     protected:
         virtual void notifyQueueIsEmpty() override { emit queueIsEmpty(); }
@@ -0,0 +1,67 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "backupslookup.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QStringList>
+#include <QMutexLocker>
+#include "../Helpers/constants.h"
+#include "../Common/defines.h"
+
+namespace MetadataIO {
+    QString normalizeBackupName(const QString &filename) {
+#ifdef Q_OS_WIN
+        return filename.toLower();
+#else
+        return filename;
+#endif
+    }
+
+    bool BackupsLookup::hasBackup(const QString &filepath) {
+        QFileInfo fi(filepath);
+        const QString backupName = normalizeBackupName(fi.fileName() + Constants::METADATA_BACKUP_EXTENSION);
+
+        QMutexLocker locker(&m_LookupMutex);
+        const QSet<QString> &backups = getDirectoryBackups(fi.absolutePath());
+        return backups.contains(backupName);
+    }
+
+    const QSet<QString> &BackupsLookup::getDirectoryBackups(const QString &directory) {
+        auto it = m_BackupsByDirectory.find(directory);
+        if (it != m_BackupsByDirectory.end()) {
+            return it.value();
+        }
+
+        QSet<QString> backups;
+        QDir dir(directory);
+        const QStringList filters = QStringList() << (QString("*") + Constants::METADATA_BACKUP_EXTENSION);
+        const QStringList entries = dir.entryList(filters, QDir::Files | QDir::Hidden);
+        for (const QString &entry: entries) {
+            backups.insert(normalizeBackupName(entry));
+        }
+
+        LOG_DEBUG << backups.size() << "backups found in" << directory;
+
+        it = m_BackupsByDirectory.insert(directory, backups);
+        return it.value();
+    }
+}
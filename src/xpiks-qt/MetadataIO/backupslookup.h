@@ -0,0 +1,50 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BACKUPSLOOKUP_H
+#define BACKUPSLOOKUP_H
+
+#include <QString>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+
+namespace MetadataIO {
+    // lists every directory once to find out which artworks have backups
+    // instead of trying to open a backup file for each of them
+    class BackupsLookup
+    {
+    public:
+        BackupsLookup() {}
+
+    public:
+        bool hasBackup(const QString &filepath);
+
+    private:
+        const QSet<QString> &getDirectoryBackups(const QString &directory);
+
+    private:
+        QMutex m_LookupMutex;
+        QHash<QString, QSet<QString> > m_BackupsByDirectory;
+    };
+}
+
+#endif // BACKUPSLOOKUP_H
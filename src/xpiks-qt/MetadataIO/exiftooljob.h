@@ -0,0 +1,104 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXIFTOOLJOB_H
+#define EXIFTOOLJOB_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QAtomicInt>
+
+namespace MetadataIO {
+    // one exiftool command per item executed by any of exiftool workers
+    // all methods are called concurrently from the workers
+    class ExiftoolJob
+    {
+    public:
+        ExiftoolJob(const QString &exiftoolPath, int itemsCount):
+            m_ExiftoolPath(exiftoolPath),
+            m_ItemsCount(itemsCount),
+            m_NextIndex(0),
+            m_WorkersLeft(0),
+            m_AliveWorkers(0),
+            m_ErrorsCount(0),
+            m_Cancelled(0)
+        {
+            static QAtomicInt jobsCounter(0);
+            m_JobID = jobsCounter.fetchAndAddOrdered(1) + 1;
+        }
+
+        virtual ~ExiftoolJob() { }
+
+    public:
+        int getJobID() const { return m_JobID; }
+        const QString &getExiftoolPath() const { return m_ExiftoolPath; }
+        bool isCancelled() const { return m_Cancelled.loadAcquire() != 0; }
+        bool isSuccessful() const { return m_ErrorsCount.loadAcquire() == 0; }
+        void cancel() { m_Cancelled.storeRelease(1); }
+
+    public:
+        void setWorkersCount(int count) {
+            m_WorkersLeft.storeRelease(count);
+            m_AliveWorkers.storeRelease(count);
+        }
+
+        bool tryTakeNext(int &index) {
+            if (isCancelled()) { return false; }
+
+            const int next = m_NextIndex.fetchAndAddOrdered(1);
+            if (next >= m_ItemsCount) { return false; }
+
+            index = next;
+            return true;
+        }
+
+        // returns true for the last worker without running exiftool
+        // which then has to fail items nobody is going to take
+        bool workerFailed() {
+            return m_AliveWorkers.fetchAndAddOrdered(-1) == 1;
+        }
+
+        // returns true for the last worker done with the job
+        bool workerFinished(int errorsCount) {
+            m_ErrorsCount.fetchAndAddOrdered(errorsCount);
+            return m_WorkersLeft.fetchAndAddOrdered(-1) == 1;
+        }
+
+    public:
+        virtual QStringList getArguments(int index) const = 0;
+        // output is empty if exiftool failed for the item
+        // returns true if the receiver should be notified about new results
+        virtual bool processOutput(int index, bool success, const QByteArray &output) = 0;
+
+    private:
+        QString m_ExiftoolPath;
+        int m_JobID;
+        int m_ItemsCount;
+        QAtomicInt m_NextIndex;
+        QAtomicInt m_WorkersLeft;
+        QAtomicInt m_AliveWorkers;
+        QAtomicInt m_ErrorsCount;
+        QAtomicInt m_Cancelled;
+    };
+}
+
+#endif // EXIFTOOLJOB_H
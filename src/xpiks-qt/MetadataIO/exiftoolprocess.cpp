@@ -0,0 +1,170 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "exiftoolprocess.h"
+#include <QProcess>
+#include <QElapsedTimer>
+#include "../Common/defines.h"
+
+#define EXIFTOOL_START_TIMEOUT 5000
+#define EXIFTOOL_STOP_TIMEOUT 3000
+
+namespace MetadataIO {
+    ExiftoolProcess::ExiftoolProcess():
+        m_ExecuteID(0)
+    {
+    }
+
+    ExiftoolProcess::~ExiftoolProcess() {
+        stop();
+    }
+
+    bool ExiftoolProcess::ensureStarted(const QString &exiftoolPath) {
+        if (isRunning()) {
+            if (m_ExiftoolPath == exiftoolPath) { return true; }
+
+            LOG_INFO << "Exiftool path changed. Restarting...";
+            stop();
+        }
+
+        m_Process.reset(new QProcess());
+        m_ExiftoolPath = exiftoolPath;
+
+        QStringList arguments;
+        arguments << "-stay_open" << "True" << "-@" << "-";
+
+        LOG_INFO << "Starting exiftool process:" << exiftoolPath;
+        m_Process->start(exiftoolPath, arguments);
+
+        bool started = m_Process->waitForStarted(EXIFTOOL_START_TIMEOUT);
+        if (!started) {
+            LOG_WARNING << "Failed to start exiftool:" << m_Process->errorString();
+            m_Process.reset();
+        }
+
+        return started;
+    }
+
+    bool ExiftoolProcess::execute(const QStringList &arguments, int timeoutMsecs, QByteArray &output) {
+        if (!isRunning()) { return false; }
+
+        for (const QString &argument: arguments) {
+            // every line of the -@ input is a separate argument
+            if (argument.contains(QLatin1Char('\n')) || argument.contains(QLatin1Char('\r'))) {
+                LOG_WARNING << "Line break in argument" << argument;
+                return false;
+            }
+        }
+
+        const int executeID = ++m_ExecuteID;
+
+        QByteArray command;
+        for (const QString &argument: arguments) {
+            command.append(argument.toUtf8());
+            command.append('\n');
+        }
+
+        command.append(QString("-execute%1\n").arg(executeID).toLatin1());
+        writeCommand(command);
+
+        // exiftool prints {readyNUM} after the output of each command
+        const QByteArray readyMarker = QString("{ready%1}").arg(executeID).toLatin1();
+        QByteArray stdoutBuffer;
+        bool ready = false;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        while (!ready) {
+            const qint64 timeLeft = timeoutMsecs - timer.elapsed();
+            stdoutBuffer.append(readOutput((int)qMax(timeLeft, (qint64)0)));
+
+            const int markerIndex = stdoutBuffer.indexOf(readyMarker);
+            if (markerIndex != -1) {
+                output = stdoutBuffer.left(markerIndex);
+                ready = true;
+                break;
+            }
+
+            if ((timeLeft <= 0) || !isRunning()) { break; }
+        }
+
+        logErrors();
+
+        if (!ready) {
+            // the state of the process is unknown so it has to go
+            LOG_WARNING << "Exiftool did not respond to command" << executeID << "in" << timer.elapsed() << "ms";
+            kill();
+        }
+
+        return ready;
+    }
+
+    void ExiftoolProcess::stop() {
+        if (!m_Process) { return; }
+
+        if (isRunning()) {
+            LOG_DEBUG << "Stopping exiftool...";
+            m_Process->write("-stay_open\nFalse\n");
+            m_Process->closeWriteChannel();
+
+            if (!m_Process->waitForFinished(EXIFTOOL_STOP_TIMEOUT)) {
+                kill();
+            }
+        }
+
+        m_Process.reset();
+    }
+
+    bool ExiftoolProcess::isRunning() const {
+        return m_Process && (m_Process->state() == QProcess::Running);
+    }
+
+    void ExiftoolProcess::writeCommand(const QByteArray &command) {
+        m_Process->write(command);
+    }
+
+    QByteArray ExiftoolProcess::readOutput(int timeoutMsecs) {
+        if ((m_Process->bytesAvailable() == 0) && (timeoutMsecs > 0)) {
+            m_Process->waitForReadyRead(timeoutMsecs);
+        }
+
+        return m_Process->readAllStandardOutput();
+    }
+
+    void ExiftoolProcess::logErrors() {
+        if (!m_Process) { return; }
+
+        QByteArray stderrByteArray = m_Process->readAllStandardError();
+        if (!stderrByteArray.isEmpty()) {
+            LOG_DEBUG << "STDERR [Exiftool]:" << QString::fromUtf8(stderrByteArray);
+        }
+    }
+
+    void ExiftoolProcess::kill() {
+        if (!m_Process) { return; }
+
+        m_Process->kill();
+        m_Process->waitForFinished(EXIFTOOL_STOP_TIMEOUT);
+        m_Process.reset();
+        LOG_INFO << "Exiftool process killed";
+    }
+}
@@ -0,0 +1,62 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXIFTOOLPROCESS_H
+#define EXIFTOOLPROCESS_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <memory>
+
+class QProcess;
+
+namespace MetadataIO {
+    // exiftool running with -stay_open which reads commands from stdin
+    // must be used only from the thread where it was started
+    class ExiftoolProcess
+    {
+    public:
+        ExiftoolProcess();
+        virtual ~ExiftoolProcess();
+
+    public:
+        virtual bool ensureStarted(const QString &exiftoolPath);
+        bool execute(const QStringList &arguments, int timeoutMsecs, QByteArray &output);
+        virtual void stop();
+
+    protected:
+        // communication with the process is replaced in tests
+        virtual bool isRunning() const;
+        virtual void writeCommand(const QByteArray &command);
+        // waits up to timeout if nothing is available yet
+        virtual QByteArray readOutput(int timeoutMsecs);
+        virtual void logErrors();
+        virtual void kill();
+
+    private:
+        std::unique_ptr<QProcess> m_Process;
+        QString m_ExiftoolPath;
+        int m_ExecuteID;
+    };
+}
+
+#endif // EXIFTOOLPROCESS_H
@@ -0,0 +1,93 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "exiftoolservice.h"
+#include <QThread>
+#include "exiftoolworker.h"
+#include "exiftooljob.h"
+#include "../Common/defines.h"
+
+#define MAX_EXIFTOOL_PROCESSES 4
+#define MIN_EXIFTOOL_PROCESSES 1
+
+namespace MetadataIO {
+    ExiftoolService::ExiftoolService(QObject *parent) :
+        QObject(parent),
+        m_IsStopped(false)
+    {
+    }
+
+    void ExiftoolService::startService() {
+        Q_ASSERT(m_ExiftoolWorkers.isEmpty());
+
+        // every process is a perl interpreter so their number is kept low
+        int processesCount = qMin(qMax(QThread::idealThreadCount() - 1, MIN_EXIFTOOL_PROCESSES), MAX_EXIFTOOL_PROCESSES);
+        m_ExiftoolWorkers.reserve(processesCount);
+
+        for (int i = 0; i < processesCount; ++i) {
+            ExiftoolWorker *worker = new ExiftoolWorker(i);
+
+            QThread *thread = new QThread();
+            worker->moveToThread(thread);
+
+            QObject::connect(thread, SIGNAL(started()), worker, SLOT(process()));
+            QObject::connect(worker, SIGNAL(stopped()), thread, SLOT(quit()));
+
+            QObject::connect(worker, SIGNAL(stopped()), worker, SLOT(deleteLater()));
+            QObject::connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
+
+            QObject::connect(worker, SIGNAL(jobResultsAvailable(int)), this, SIGNAL(jobResultsAvailable(int)));
+            QObject::connect(worker, SIGNAL(jobFinished(int,bool)), this, SIGNAL(jobFinished(int,bool)));
+
+            m_ExiftoolWorkers.append(worker);
+
+            thread->start();
+        }
+
+        LOG_INFO << "Started" << processesCount << "exiftool workers";
+    }
+
+    void ExiftoolService::stopService() {
+        LOG_DEBUG << "#";
+
+        if (!m_ExiftoolWorkers.isEmpty()) {
+            m_IsStopped = true;
+            for (auto *worker: m_ExiftoolWorkers) {
+                worker->stopWorking();
+            }
+        } else {
+            LOG_WARNING << "Exiftool workers were not started";
+        }
+    }
+
+    void ExiftoolService::submitJob(const std::shared_ptr<ExiftoolJob> &job) {
+        if (m_IsStopped) { return; }
+
+        Q_ASSERT(!m_ExiftoolWorkers.isEmpty());
+        LOG_INFO << "Job" << job->getJobID();
+
+        job->setWorkersCount(m_ExiftoolWorkers.size());
+
+        for (auto *worker: m_ExiftoolWorkers) {
+            worker->submitItem(job);
+        }
+    }
+}
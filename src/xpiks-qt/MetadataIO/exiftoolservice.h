@@ -0,0 +1,59 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXIFTOOLSERVICE_H
+#define EXIFTOOLSERVICE_H
+
+#include <QObject>
+#include <QVector>
+#include <memory>
+
+namespace MetadataIO {
+    class ExiftoolWorker;
+    class ExiftoolJob;
+
+    // pool of long-living exiftool processes
+    // items of each job are shared between all of them
+    class ExiftoolService : public QObject
+    {
+        Q_OBJECT
+    public:
+        explicit ExiftoolService(QObject *parent = 0);
+
+    public:
+        void startService();
+        void stopService();
+        bool isStarted() const { return !m_ExiftoolWorkers.isEmpty(); }
+
+    public:
+        void submitJob(const std::shared_ptr<ExiftoolJob> &job);
+
+    signals:
+        void jobResultsAvailable(int jobID);
+        void jobFinished(int jobID, bool success);
+
+    private:
+        QVector<ExiftoolWorker *> m_ExiftoolWorkers;
+        volatile bool m_IsStopped;
+    };
+}
+
+#endif // EXIFTOOLSERVICE_H
@@ -0,0 +1,97 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "exiftoolworker.h"
+#include "../Common/defines.h"
+
+#define EXIFTOOL_EXECUTE_TIMEOUT 30000
+
+namespace MetadataIO {
+    ExiftoolWorker::ExiftoolWorker(int workerIndex, QObject *parent):
+        QObject(parent),
+        m_Exiftool(new ExiftoolProcess()),
+        m_WorkerIndex(workerIndex)
+    {
+    }
+
+    ExiftoolWorker::ExiftoolWorker(int workerIndex, ExiftoolProcess *exiftool, QObject *parent):
+        QObject(parent),
+        m_Exiftool(exiftool),
+        m_WorkerIndex(workerIndex)
+    {
+        Q_ASSERT(exiftool != NULL);
+    }
+
+    bool ExiftoolWorker::initWorker() {
+        LOG_INFO << "#" << m_WorkerIndex;
+        return true;
+    }
+
+    void ExiftoolWorker::processOneItem(std::shared_ptr<ExiftoolJob> &item) {
+        const int jobID = item->getJobID();
+        // exiftool is started lazily and kept alive between jobs
+        bool isStarted = m_Exiftool->ensureStarted(item->getExiftoolPath());
+        int errorsCount = 0;
+        int index = 0;
+
+        // items are taken only while exiftool is running
+        while (isStarted && item->tryTakeNext(index)) {
+            QByteArray output;
+            bool success = m_Exiftool->execute(item->getArguments(index), EXIFTOOL_EXECUTE_TIMEOUT, output);
+
+            if (!success) {
+                errorsCount++;
+                // exiftool is killed after a timeout
+                isStarted = m_Exiftool->ensureStarted(item->getExiftoolPath());
+            }
+
+            if (item->processOutput(index, success, output)) {
+                emit jobResultsAvailable(jobID);
+            }
+        }
+
+        if (!isStarted) {
+            LOG_WARNING << "Exiftool is not running in worker #" << m_WorkerIndex;
+
+            if (item->workerFailed()) {
+                // other workers are not running either
+                while (item->tryTakeNext(index)) {
+                    errorsCount++;
+
+                    if (item->processOutput(index, false, QByteArray())) {
+                        emit jobResultsAvailable(jobID);
+                    }
+                }
+            }
+        }
+
+        LOG_INFO << "Worker #" << m_WorkerIndex << "done with job" << jobID << "errors:" << errorsCount;
+
+        if (item->workerFinished(errorsCount)) {
+            emit jobFinished(jobID, item->isSuccessful());
+        }
+    }
+
+    void ExiftoolWorker::workerStopped() {
+        m_Exiftool->stop();
+        emit stopped();
+    }
+}
@@ -25,6 +25,11 @@
 #include <QDateTime>
 #include <QImageReader>
 #include <QStringList>
+#include <QMutexLocker>
+#include <QFile>
+#include <QBuffer>
+#include <QByteArray>
+#include <climits>
 #include <sstream>
 #include <string>
 #include "../Models/artworkmetadata.h"
@@ -501,37 +506,46 @@ namespace MetadataIO {
         return dateTime;
     }
 
-    Exiv2ReadingWorker::Exiv2ReadingWorker(int index, QVector<Models::ArtworkMetadata *> itemsToRead, QObject *parent):
+    Exiv2ReadingWorker::Exiv2ReadingWorker(int index,
+                                           const std::shared_ptr<ReadingWorkQueue> &workQueue,
+                                           const std::shared_ptr<BackupsLookup> &backupsLookup,
+                                           QObject *parent):
         QObject(parent),
-        m_ItemsToRead(itemsToRead),
+        m_WorkQueue(workQueue),
+        m_BackupsLookup(backupsLookup),
         m_WorkerIndex(index),
-        m_Stopped(false)
+        m_ReadCount(0)
     {
-        Q_ASSERT(!itemsToRead.isEmpty());
-        LOG_INFO << "Worker [" << index << "]:" << itemsToRead.size() << "items to read";
+        Q_ASSERT(workQueue);
+        Q_ASSERT(backupsLookup);
+        // deleted with deleteLater() after finished()
+        setAutoDelete(false);
     }
 
     Exiv2ReadingWorker::~Exiv2ReadingWorker() {
         LOG_INFO << "Reading worker" << m_WorkerIndex << "destroyed";
     }
 
-    void Exiv2ReadingWorker::process() {
+    void Exiv2ReadingWorker::takeReadResults(ReadResults &results) {
+        QMutexLocker locker(&m_ResultsMutex);
+        results.swap(m_ReadResults);
+        m_ReadResults.clear();
+    }
+
+    void Exiv2ReadingWorker::run() {
         LOG_INFO << "Worker #" << m_WorkerIndex << "started";
 
         bool anyError = false;
+        int index = 0;
+        Models::ArtworkMetadata *artwork = NULL;
 
-        int size = m_ItemsToRead.size();
-        for (int i = 0; i < size; ++i) {
-            if (m_Stopped) { break; }
-
-            Models::ArtworkMetadata *artwork = m_ItemsToRead.at(i);
+        while (m_WorkQueue->tryTakeNext(index, artwork)) {
             const QString &filepath = artwork->getFilepath();
             ImportDataResult importResult;
 
             try {
                 if (readMetadata(artwork, importResult)) {
-                    Q_ASSERT(!m_ImportResult.contains(filepath));
-                    m_ImportResult.insert(filepath, importResult);
+                    addReadResult(index, importResult);
                 }
             }
             catch(Exiv2::Error &error) {
@@ -544,30 +558,68 @@ namespace MetadataIO {
             }
         }
 
-        LOG_INFO << "Worker #" << m_WorkerIndex << "finished";
+        LOG_INFO << "Worker #" << m_WorkerIndex << "finished. Items read:" << m_ReadCount;
 
         emit finished(anyError);
     }
 
-    void Exiv2ReadingWorker::cancel() {
-        m_Stopped = true;
+    void Exiv2ReadingWorker::addReadResult(int index, const ImportDataResult &importResult) {
+        bool wasEmpty = false;
+
+        m_ResultsMutex.lock();
+        {
+            wasEmpty = m_ReadResults.isEmpty();
+            m_ReadResults.append(qMakePair(index, importResult));
+        }
+        m_ResultsMutex.unlock();
+
+        m_ReadCount++;
+
+        // results pile up until the receiver takes them so the
+        // number of signals is bound by how fast they are consumed
+        if (wasEmpty) {
+            emit resultsAvailable();
+        }
     }
 
     bool Exiv2ReadingWorker::readMetadata(Models::ArtworkMetadata *artwork, ImportDataResult &importResult) {
         const QString &filepath = artwork->getFilepath();
 
-        QImageReader imageReader(filepath);
-        QString format = QString::fromLatin1(imageReader.format().toLower());
-        if (format != QLatin1String("jpeg") &&
-            format != QLatin1String("tiff")) {
+        // the file is opened once: the mapping is paged in lazily so only
+        // the parts Exiv2 actually parses are read from the disk
+        QFile file(filepath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            LOG_WARNING << "Failed to open" << filepath;
             return false;
         }
 
+        const qint64 fileSize = file.size();
+        const uchar *data = (fileSize > 0) && (fileSize <= LONG_MAX) ? file.map(0, fileSize) : NULL;
+
+        Exiv2::Image::AutoPtr image;
+        if (data != NULL) {
+            int imageType = Exiv2::ImageFactory::getType(data, (long)fileSize);
+            if ((imageType != Exiv2::ImageType::jpeg) &&
+                (imageType != Exiv2::ImageType::tiff)) {
+                return false;
+            }
+
+            image = Exiv2::ImageFactory::open(data, (long)fileSize);
+        } else {
+            LOG_DEBUG << "Failed to map" << filepath << "Falling back to reading";
+            file.close();
+
 #if defined(Q_OS_WIN)
-        Exiv2::Image::AutoPtr image = Exiv2::ImageFactory::open(filepath.toStdWString());
+            image = Exiv2::ImageFactory::open(filepath.toStdWString());
 #else
-        Exiv2::Image::AutoPtr image = Exiv2::ImageFactory::open(filepath.toStdString());
+            image = Exiv2::ImageFactory::open(filepath.toStdString());
 #endif
+            const std::string mimeType = image->mimeType();
+            if ((mimeType != "image/jpeg") && (mimeType != "image/tiff")) {
+                return false;
+            }
+        }
+
         Q_ASSERT(image.get() != NULL);
         image->readMetadata();
 
@@ -584,17 +636,29 @@ namespace MetadataIO {
         importResult.Keywords = retrieveKeywords(xmpData, exifData, iptcData, isIptcUtf8);
         importResult.DateTimeOriginal = retrieveDateTime(xmpData, exifData, iptcData, isIptcUtf8);
 
-        MetadataSavingCopy copy;
-        if (copy.readFromFile(filepath)) {
-            importResult.BackupDict = copy.getInfo();
+        if (m_BackupsLookup->hasBackup(filepath)) {
+            MetadataSavingCopy copy;
+            if (copy.readFromFile(filepath)) {
+                importResult.BackupDict = copy.getInfo();
+            }
         }
 
-        QFileInfo fi(filepath);
-        importResult.FileSize = fi.size();
+        importResult.FileSize = fileSize;
 
         Models::ImageArtwork *imageArtwork = dynamic_cast<Models::ImageArtwork*>(artwork);
-        if (imageArtwork != NULL) {            
-            importResult.ImageSize = imageReader.size();
+        if (imageArtwork != NULL) {
+            QSize imageSize(image->pixelWidth(), image->pixelHeight());
+
+            // pixel size is not always known to Exiv2 (e.g. tiles)
+            if (imageSize.isEmpty() && (data != NULL)) {
+                QByteArray rawData = QByteArray::fromRawData((const char *)data, (int)qMin(fileSize, (qint64)INT_MAX));
+                QBuffer buffer(&rawData);
+                buffer.open(QIODevice::ReadOnly);
+                QImageReader imageReader(&buffer);
+                imageSize = imageReader.size();
+            }
+
+            importResult.ImageSize = imageSize;
         }
 
         return true;
@@ -23,45 +23,56 @@
 #define EXIV2READINGWORKER_H
 
 #include <QObject>
+#include <QRunnable>
 #include <QVector>
-#include <QHash>
+#include <QPair>
+#include <QMutex>
+#include <memory>
 #include "importdataresult.h"
+#include "../Common/sharedworkqueue.h"
+#include "backupslookup.h"
 
 namespace Models {
     class ArtworkMetadata;
 }
 
 namespace MetadataIO {
-    class Exiv2ReadingWorker : public QObject
+    typedef Common::SharedWorkQueue<Models::ArtworkMetadata *> ReadingWorkQueue;
+
+    class Exiv2ReadingWorker : public QObject, public QRunnable
     {
         Q_OBJECT
     public:
-        explicit Exiv2ReadingWorker(int index, QVector<Models::ArtworkMetadata *> itemsToRead, QObject *parent = 0);
+        explicit Exiv2ReadingWorker(int index,
+                                    const std::shared_ptr<ReadingWorkQueue> &workQueue,
+                                    const std::shared_ptr<BackupsLookup> &backupsLookup,
+                                    QObject *parent = 0);
         virtual ~Exiv2ReadingWorker();
 
     public:
-        const QHash<QString, ImportDataResult> &getImportResult() const { return m_ImportResult; }
         int getWorkerIndex() const { return m_WorkerIndex; }
+        // results are accumulated while nobody takes them
+        // indices are positions in the work queue
+        void takeReadResults(ReadResults &results);
 
     public:
-        void dismiss() { emit stopped(); }
-
-    public slots:
-        void process();
-        void cancel();
+        virtual void run() override;
 
     signals:
-        void stopped();
+        void resultsAvailable();
         void finished(bool anyError);
 
     private:
+        void addReadResult(int index, const ImportDataResult &importResult);
         bool readMetadata(Models::ArtworkMetadata *artwork, ImportDataResult &importResult);
 
     private:
-        QVector<Models::ArtworkMetadata *> m_ItemsToRead;
-        QHash<QString, ImportDataResult> m_ImportResult;
+        std::shared_ptr<ReadingWorkQueue> m_WorkQueue;
+        std::shared_ptr<BackupsLookup> m_BackupsLookup;
+        QMutex m_ResultsMutex;
+        ReadResults m_ReadResults;
         int m_WorkerIndex;
-        volatile bool m_Stopped;
+        int m_ReadCount;
     };
 }
 
@@ -22,6 +22,8 @@
 #include "exiv2writingworker.h"
 #include <QStringList>
 #include <QTextCodec>
+#include <QMutexLocker>
+#include <QFile>
 #include "../Models/artworkmetadata.h"
 #include "../Common/defines.h"
 #include "../Helpers/stringhelper.h"
@@ -33,9 +35,18 @@
 #endif
 #include <exiv2/exiv2.hpp>
 
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#include <cstdio>
+#endif
+
 #define X_DEFAULT QString::fromLatin1("x-default")
 #define IPTC_MAX_DESCRIPTION_LEN 2000
 #define IPTC_MAX_TITLE_LEN 64
+#define WRITING_TEMP_SUFFIX ".xpks-tmp"
 
 namespace MetadataIO {
     typedef QMap<QString, QString> AltLangMap;
@@ -323,27 +334,99 @@ namespace MetadataIO {
         Q_UNUSED(exifData);
     }
 
-    Exiv2WritingWorker::Exiv2WritingWorker(int index, QVector<Models::ArtworkMetadata *> itemsToWrite, QObject *parent) :
+    void writeImageMetadata(Models::ArtworkMetadata *artwork, const QString &imagePath) {
+        // exiv2 streams the file through own temporary file instead of holding it in memory
+#if defined(Q_OS_WIN)
+        Exiv2::Image::AutoPtr image = Exiv2::ImageFactory::open(imagePath.toStdWString());
+#else
+        Exiv2::Image::AutoPtr image = Exiv2::ImageFactory::open(imagePath.toStdString());
+#endif
+        Q_ASSERT(image.get() != NULL);
+
+        image->readMetadata();
+
+        Exiv2::XmpData &xmpData = image->xmpData();
+        Exiv2::ExifData &exifData = image->exifData();
+        Exiv2::IptcData &iptcData = image->iptcData();
+
+        QString description = artwork->getDescription();
+        setArtworkDescription(xmpData, exifData, iptcData, description);
+
+        QString title = artwork->getTitle();
+        if (title.trimmed().isEmpty()) {
+            title = description;
+        }
+        setArtworkTitle(xmpData, exifData, iptcData, title);
+
+        QStringList keywords = artwork->getKeywords();
+        setArtworkKeywords(xmpData, exifData, iptcData, keywords);
+
+        image->writeMetadata();
+    }
+
+    bool syncFile(const QString &filepath) {
+        QFile file(filepath);
+        if (!file.open(QIODevice::ReadWrite)) {
+            return false;
+        }
+
+#if defined(Q_OS_WIN)
+        bool success = _commit(file.handle()) == 0;
+#else
+        bool success = ::fsync(file.handle()) == 0;
+#endif
+
+        file.close();
+        return success;
+    }
+
+    // unlike QFile::rename() it replaces existing file in one step
+    bool replaceFile(const QString &from, const QString &to) {
+#if defined(Q_OS_WIN)
+        return MoveFileExW((LPCWSTR)from.utf16(), (LPCWSTR)to.utf16(),
+                           MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        return ::rename(QFile::encodeName(from).constData(), QFile::encodeName(to).constData()) == 0;
+#endif
+    }
+
+    Exiv2WritingWorker::Exiv2WritingWorker(int index, const std::shared_ptr<WritingWorkQueue> &workQueue, QObject *parent) :
         QObject(parent),
-        m_ItemsToWrite(itemsToWrite),
+        m_WorkQueue(workQueue),
         m_WorkerIndex(index),
-        m_Stopped(false)
+        m_WrittenCount(0)
     {
-        Q_ASSERT(!itemsToWrite.isEmpty());
-        LOG_INFO << "Worker [" << index << "]:" << itemsToWrite.size() << "items to write";
+        Q_ASSERT(workQueue);
+        // deleted with deleteLater() after finished()
+        setAutoDelete(false);
     }
 
-    void Exiv2WritingWorker::process() {
-        bool anyError = false;
-        int size = m_ItemsToWrite.size();
+    Exiv2WritingWorker::~Exiv2WritingWorker() {
+        LOG_INFO << "Writing worker" << m_WorkerIndex << "destroyed";
+    }
 
-        for (int i = 0; i < size; ++i) {
-            if (m_Stopped) { break; }
+    void Exiv2WritingWorker::takeWrittenIndices(QVector<int> &indices) {
+        QMutexLocker locker(&m_WrittenMutex);
+        indices.swap(m_WrittenIndices);
+        m_WrittenIndices.clear();
+    }
+
+    void Exiv2WritingWorker::run() {
+        LOG_INFO << "Worker #" << m_WorkerIndex << "started";
 
-            Models::ArtworkMetadata *artwork = m_ItemsToWrite.at(i);
+        bool anyError = false;
+        int index = 0;
+        Models::ArtworkMetadata *artwork = NULL;
+
+        while (m_WorkQueue->tryTakeNext(index, artwork)) {
+            const QString &filepath = artwork->getFilepath();
 
             try {
-                writeMetadata(artwork);
+                if (writeMetadata(artwork)) {
+                    addWrittenIndex(index);
+                } else {
+                    anyError = true;
+                }
             }
             catch(Exiv2::Error &error) {
                 anyError = true;
@@ -351,46 +434,72 @@ namespace MetadataIO {
             }
             catch(...) {
                 anyError = true;
-                LOG_WARNING << "Worker" << m_WorkerIndex << "Writing error for item" << artwork->getFilepath();
+                LOG_WARNING << "Worker" << m_WorkerIndex << "Writing error for item" << filepath;
             }
         }
 
-        LOG_INFO << "Worker #" << m_WorkerIndex << "finished";
+        LOG_INFO << "Worker #" << m_WorkerIndex << "finished. Items written:" << m_WrittenCount;
 
         emit finished(anyError);
     }
 
-    void Exiv2WritingWorker::cancel() {
-        m_Stopped = true;
+    void Exiv2WritingWorker::addWrittenIndex(int index) {
+        bool wasEmpty = false;
+
+        m_WrittenMutex.lock();
+        {
+            wasEmpty = m_WrittenIndices.isEmpty();
+            m_WrittenIndices.append(index);
+        }
+        m_WrittenMutex.unlock();
+
+        m_WrittenCount++;
+
+        // indices pile up until the receiver takes them
+        if (wasEmpty) {
+            emit itemsWritten();
+        }
     }
 
-    void Exiv2WritingWorker::writeMetadata(Models::ArtworkMetadata *artwork) {
+    bool Exiv2WritingWorker::writeMetadata(Models::ArtworkMetadata *artwork) {
         const QString &filepath = artwork->getFilepath();
-#if defined(Q_OS_WIN)
-        Exiv2::Image::AutoPtr image = Exiv2::ImageFactory::open(filepath.toStdWString());
-#else
-        Exiv2::Image::AutoPtr image = Exiv2::ImageFactory::open(filepath.toStdString());
-#endif
-        Q_ASSERT(image.get() != NULL);
+        const QString tempPath = filepath + QLatin1String(WRITING_TEMP_SUFFIX);
 
-        image->readMetadata();
+        // metadata is written to a sibling copy so the original stays intact until the rename
+        if (QFile::exists(tempPath)) {
+            QFile::remove(tempPath);
+        }
 
-        Exiv2::XmpData &xmpData = image->xmpData();
-        Exiv2::ExifData &exifData = image->exifData();
-        Exiv2::IptcData &iptcData = image->iptcData();
+        if (!QFile::copy(filepath, tempPath)) {
+            LOG_WARNING << "Failed to copy" << filepath << "to temporary file";
+            return false;
+        }
 
-        QString description = artwork->getDescription();
-        setArtworkDescription(xmpData, exifData, iptcData, description);
+        bool success = false;
 
-        QString title = artwork->getTitle();
-        if (title.trimmed().isEmpty()) {
-            title = description;
+        try {
+            writeImageMetadata(artwork, tempPath);
+            success = syncFile(tempPath);
+            if (!success) {
+                LOG_WARNING << "Failed to sync" << tempPath;
+            }
+        }
+        catch (...) {
+            QFile::remove(tempPath);
+            throw;
         }
-        setArtworkTitle(xmpData, exifData, iptcData, title);
 
-        QStringList keywords = artwork->getKeywords();
-        setArtworkKeywords(xmpData, exifData, iptcData, keywords);
+        if (success) {
+            success = replaceFile(tempPath, filepath);
+            if (!success) {
+                LOG_WARNING << "Failed to replace" << filepath;
+            }
+        }
 
-        image->writeMetadata();
+        if (!success) {
+            QFile::remove(tempPath);
+        }
+
+        return success;
     }
 }
@@ -23,38 +23,48 @@
 #define EXIV2WRITINGWORKER_H
 
 #include <QObject>
+#include <QRunnable>
 #include <QVector>
+#include <QMutex>
+#include <memory>
+#include "../Common/sharedworkqueue.h"
 
 namespace Models {
     class ArtworkMetadata;
 }
 
 namespace MetadataIO {
-    class Exiv2WritingWorker : public QObject
+    typedef Common::SharedWorkQueue<Models::ArtworkMetadata *> WritingWorkQueue;
+
+    class Exiv2WritingWorker : public QObject, public QRunnable
     {
         Q_OBJECT
     public:
-        explicit Exiv2WritingWorker(int index, QVector<Models::ArtworkMetadata *> itemsToWrite, QObject *parent = 0);
+        explicit Exiv2WritingWorker(int index, const std::shared_ptr<WritingWorkQueue> &workQueue, QObject *parent = 0);
+        virtual ~Exiv2WritingWorker();
 
     public:
         int getWorkerIndex() const { return m_WorkerIndex; }
-        void dismiss() { emit stopped(); }
+        // indices are positions in the work queue
+        void takeWrittenIndices(QVector<int> &indices);
 
-    public slots:
-        void process();
-        void cancel();
+    public:
+        virtual void run() override;
 
     signals:
-        void stopped();
+        void itemsWritten();
         void finished(bool anyError);
 
     private:
-        void writeMetadata(Models::ArtworkMetadata *artwork);
+        void addWrittenIndex(int index);
+        bool writeMetadata(Models::ArtworkMetadata *artwork);
 
     private:
-        QVector<Models::ArtworkMetadata*> m_ItemsToWrite;
+        std::shared_ptr<WritingWorkQueue> m_WorkQueue;
+        QMutex m_WrittenMutex;
+        QVector<int> m_WrittenIndices;
         int m_WorkerIndex;
-        volatile bool m_Stopped;
+        int m_WrittenCount;
     };
 }
 
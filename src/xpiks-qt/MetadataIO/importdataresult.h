@@ -27,6 +27,8 @@
 #include <QSize>
 #include <QHash>
 #include <QDateTime>
+#include <QVector>
+#include <QPair>
 
 namespace MetadataIO {
     struct ImportDataResult {
@@ -39,6 +41,9 @@ namespace MetadataIO {
         QHash<QString, QString> BackupDict;
         QDateTime DateTimeOriginal;
     };
+
+    // results paired with indices of the items to read
+    typedef QVector<QPair<int, ImportDataResult> > ReadResults;
 }
 
 #endif // IMPORTDATARESULT_H
@@ -29,6 +29,7 @@
 #include "metadatareadingworker.h"
 #include "metadatawritingworker.h"
 #include "backupsaverservice.h"
+#include "exiftoolservice.h"
 #include "../Models/artworkmetadata.h"
 #include "../Models/settingsmodel.h"
 #include "../Commands/commandmanager.h"
@@ -37,9 +38,13 @@
 #include "../Models/settingsmodel.h"
 #include "../Common/defines.h"
 #include "../Models/imageartwork.h"
+#include "../Models/artitemsmodel.h"
+#include "../Helpers/indiceshelper.h"
 #include "readingorchestrator.h"
 #include "writingorchestrator.h"
 
+#define WRITTEN_ITEMS_UPDATE_INTERVAL 300
+
 namespace MetadataIO {
     bool tryGetExiftoolVersion(const QString &path, QString &version) {
         QProcess process;
@@ -64,6 +69,7 @@ namespace MetadataIO {
         Common::BaseEntity(),
         m_ReadingWorker(NULL),
         m_WritingWorker(NULL),
+        m_ExiftoolService(NULL),
         m_ProcessingItemsCount(0),
         m_IsImportInProgress(false),
         m_CanProcessResults(false),
@@ -71,6 +77,11 @@ namespace MetadataIO {
         m_HasErrors(false),
         m_ExiftoolNotFound(false)
     {
+        m_WrittenItemsTimer.setSingleShot(true);
+        m_WrittenItemsTimer.setInterval(WRITTEN_ITEMS_UPDATE_INTERVAL);
+        QObject::connect(&m_WrittenItemsTimer, SIGNAL(timeout()),
+                         this, SLOT(writtenItemsTimerTriggered()));
+
         m_ExiftoolDiscoveryFuture = new QFutureWatcher<void>(this);
         QObject::connect(m_ExiftoolDiscoveryFuture, SIGNAL(finished()),
                          this, SLOT(exiftoolDiscoveryFinished()));
@@ -78,6 +89,14 @@ namespace MetadataIO {
         LOG_INFO << "Supported image formats:" << QImageReader::supportedImageFormats();
     }
 
+    void MetadataIOCoordinator::readingWorkerItemsRead(const QVector<int> &indices) {
+        if (m_CanProcessResults) {
+            applyImportResults(indices);
+        } else {
+            m_PendingReadIndices << indices;
+        }
+    }
+
     void MetadataIOCoordinator::readingWorkerFinished(bool success) {
         LOG_INFO << "Success:" << success;
         setHasErrors(!success);
@@ -86,7 +105,7 @@ namespace MetadataIO {
         m_CommandManager->generatePreviews(itemsToRead);
 
         if (m_CanProcessResults) {
-            readingFinishedHandler(m_IgnoreBackupsAtImport);
+            readingFinishedHandler();
         } else {
             LOG_INFO << "Can't process results. Waiting for user interaction...";
         }
@@ -94,14 +113,33 @@ namespace MetadataIO {
         m_IsImportInProgress = false;
     }
 
+    void MetadataIOCoordinator::writingWorkerItemsWritten(const QVector<int> &indices) {
+        const QVector<Models::ArtworkMetadata*> &artworksToWrite = m_WritingWorker->getItemsToWrite();
+
+        foreach (int index, indices) {
+            m_WrittenItems.append(artworksToWrite.at(index));
+        }
+
+        if (!m_WrittenItemsTimer.isActive()) {
+            m_WrittenItemsTimer.start();
+        }
+    }
+
     void MetadataIOCoordinator::writingWorkerFinished(bool success) {
         LOG_INFO << success;
+        m_WrittenItemsTimer.stop();
+        flushWrittenItems();
+
         setHasErrors(!success);
         const QVector<Models::ArtworkMetadata*> &artworksToWrite = m_WritingWorker->getItemsToWrite();
         m_CommandManager->addToLibrary(artworksToWrite);
         emit metadataWritingFinished();
     }
 
+    void MetadataIOCoordinator::writtenItemsTimerTriggered() {
+        flushWrittenItems();
+    }
+
     void MetadataIOCoordinator::exiftoolDiscoveryFinished() {
         if (!m_ExiftoolNotFound && !m_RecommendedExiftoolPath.isEmpty()) {
             LOG_DEBUG << "Recommended exiftool path is" << m_RecommendedExiftoolPath;
@@ -122,25 +160,16 @@ namespace MetadataIO {
         MetadataReadingWorker *readingWorker = new MetadataReadingWorker(artworksToRead,
                                                     m_CommandManager->getSettingsModel(),
                                                     rangesToUpdate);
-        QThread *thread = new QThread();
-        readingWorker->moveToThread(thread);
-
-        QObject::connect(thread, SIGNAL(started()), readingWorker, SLOT(process()));
-        QObject::connect(readingWorker, SIGNAL(stopped()), thread, SLOT(quit()));
-
-        QObject::connect(readingWorker, SIGNAL(stopped()), readingWorker, SLOT(deleteLater()));
-        QObject::connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
 
+        QObject::connect(readingWorker, SIGNAL(itemsRead(QVector<int>)), this, SLOT(readingWorkerItemsRead(QVector<int>)));
         QObject::connect(readingWorker, SIGNAL(finished(bool)), this, SLOT(readingWorkerFinished(bool)));
-        QObject::connect(this, SIGNAL(metadataReadingFinished()), readingWorker, SIGNAL(stopped()));
-        QObject::connect(this, SIGNAL(discardReadingSignal()), readingWorker, SLOT(cancel()));
-
-        initializeImport(artworksToRead.count());
-
-        LOG_DEBUG << "Starting thread...";
-        thread->start();
+        QObject::connect(this, SIGNAL(metadataReadingFinished()), readingWorker, SLOT(dismiss()));
+        QObject::connect(this, SIGNAL(discardReadingSignal()), readingWorker, SLOT(dismiss()));
 
+        initializeImport(artworksToRead.count(), rangesToUpdate);
         m_ReadingWorker = readingWorker;
+
+        readingWorker->startReading(getExiftoolService());
     }
 
 #ifndef CORE_TESTS
@@ -148,11 +177,12 @@ namespace MetadataIO {
                                                   const QVector<QPair<int, int> > &rangesToUpdate) {
         ReadingOrchestrator *readingOrchestrator = new ReadingOrchestrator(artworksToRead, rangesToUpdate);
 
+        QObject::connect(readingOrchestrator, SIGNAL(itemsRead(QVector<int>)), this, SLOT(readingWorkerItemsRead(QVector<int>)));
         QObject::connect(readingOrchestrator, SIGNAL(allFinished(bool)), this, SLOT(readingWorkerFinished(bool)));
         QObject::connect(this, SIGNAL(metadataReadingFinished()), readingOrchestrator, SLOT(dismiss()));
         QObject::connect(this, SIGNAL(discardReadingSignal()), readingOrchestrator, SLOT(dismiss()));
 
-        initializeImport(artworksToRead.count());
+        initializeImport(artworksToRead.count(), rangesToUpdate);
         m_ReadingWorker = readingOrchestrator;
 
         readingOrchestrator->startReading();
@@ -163,28 +193,20 @@ namespace MetadataIO {
         MetadataWritingWorker *writingWorker = new MetadataWritingWorker(artworksToWrite,
                                                     m_CommandManager->getSettingsModel(),
                                                     useBackups);
-        QThread *thread = new QThread();
-        writingWorker->moveToThread(thread);
-
-        QObject::connect(thread, SIGNAL(started()), writingWorker, SLOT(process()));
-        QObject::connect(writingWorker, SIGNAL(stopped()), thread, SLOT(quit()));
-
-        QObject::connect(writingWorker, SIGNAL(stopped()), writingWorker, SLOT(deleteLater()));
-        QObject::connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
 
         QObject::connect(writingWorker, SIGNAL(finished(bool)), this, SLOT(writingWorkerFinished(bool)));
-        QObject::connect(this, SIGNAL(metadataWritingFinished()), writingWorker, SIGNAL(stopped()));
+        QObject::connect(this, SIGNAL(metadataWritingFinished()), writingWorker, SLOT(dismiss()));
         setProcessingItemsCount(artworksToWrite.length());
 
-        LOG_DEBUG << "Starting thread...";
         m_WritingWorker = writingWorker;
-        thread->start();
+        writingWorker->startWriting(getExiftoolService());
     }
 
 #ifndef CORE_TESTS
     void MetadataIOCoordinator::writeMetadataExiv2(const QVector<Models::ArtworkMetadata *> &artworksToWrite) {
         WritingOrchestrator *writingOrchestrator = new WritingOrchestrator(artworksToWrite);
 
+        QObject::connect(writingOrchestrator, SIGNAL(itemsWritten(QVector<int>)), this, SLOT(writingWorkerItemsWritten(QVector<int>)));
         QObject::connect(writingOrchestrator, SIGNAL(allFinished(bool)), this, SLOT(writingWorkerFinished(bool)));
         QObject::connect(this, SIGNAL(metadataWritingFinished()), writingOrchestrator, SLOT(dismiss()));
 
@@ -203,6 +225,12 @@ namespace MetadataIO {
                                                                existingExiftoolPath));
     }
 
+    void MetadataIOCoordinator::stopExiftool() {
+        if (m_ExiftoolService != NULL) {
+            m_ExiftoolService->stopService();
+        }
+    }
+
     void MetadataIOCoordinator::discardReading() {
         emit discardReadingSignal();
         LOG_DEBUG << "Reading results discarded";
@@ -210,13 +238,17 @@ namespace MetadataIO {
 
     void MetadataIOCoordinator::continueReading(bool ignoreBackups) {
         m_CanProcessResults = true;
+        m_IgnoreBackupsAtImport = ignoreBackups;
 
         LOG_DEBUG << "Is in progress:" << m_IsImportInProgress;
 
         if (!m_IsImportInProgress) {
-            readingFinishedHandler(ignoreBackups);
+            readingFinishedHandler();
         } else {
-            m_IgnoreBackupsAtImport = ignoreBackups;
+            // the rest will be applied as soon as it is read
+            QVector<int> pendingIndices;
+            pendingIndices.swap(m_PendingReadIndices);
+            applyImportResults(pendingIndices);
         }
     }
 
@@ -245,71 +277,104 @@ namespace MetadataIO {
         }
     }
 
-    void MetadataIOCoordinator::initializeImport(int itemsCount) {
+    void MetadataIOCoordinator::initializeImport(int itemsCount, const QVector<QPair<int, int> > &rangesToUpdate) {
         LOG_INFO << itemsCount;
         m_CanProcessResults = false;
         m_IgnoreBackupsAtImport = false;
         m_IsImportInProgress = true;
+
+        m_PendingReadIndices.clear();
+        m_AppliedImportResults.fill(false, itemsCount);
+        m_IndicesToUpdate.clear();
+        Helpers::rangesToIndices(rangesToUpdate, m_IndicesToUpdate);
+        if (m_IndicesToUpdate.size() != itemsCount) {
+            LOG_WARNING << "Ranges do not match items to read. Rows will be updated at the end";
+            m_IndicesToUpdate.clear();
+        }
+
         setProcessingItemsCount(itemsCount);
     }
 
-    void MetadataIOCoordinator::readingFinishedHandler(bool ignoreBackups) {
+    void MetadataIOCoordinator::applyImportResults(const QVector<int> &indices) {
         Q_ASSERT(m_CanProcessResults);
-        m_CanProcessResults = false;
+        if (indices.isEmpty()) { return; }
 
         const QHash<QString, ImportDataResult> &importResult = m_ReadingWorker->getImportResult();
         const QVector<Models::ArtworkMetadata*> &itemsToRead = m_ReadingWorker->getItemsToRead();
+        Models::SettingsModel *settingsModel = m_CommandManager->getSettingsModel();
+        const bool restoreBackups = !m_IgnoreBackupsAtImport && settingsModel->getSaveBackups();
+        const bool canUpdateRows = !m_IndicesToUpdate.isEmpty();
 
-        LOG_DEBUG  << "Setting imported metadata...";
-        int size = itemsToRead.size();
-        for (int i = 0; i < size; ++i) {
-            Models::ArtworkMetadata *metadata = itemsToRead.at(i);
-            const QString &filepath = metadata->getFilepath();
+        QVector<int> indicesToUpdate;
+        indicesToUpdate.reserve(indices.size());
 
-            if (importResult.contains(filepath)) {
-                const ImportDataResult &importResultItem = importResult.value(filepath);
-                metadata->initialize(importResultItem.Title,
-                                     importResultItem.Description,
-                                     importResultItem.Keywords);
+        for (int index: indices) {
+            Q_ASSERT((0 <= index) && (index < itemsToRead.size()));
+            if (m_AppliedImportResults.testBit(index)) { continue; }
 
-                Models::ImageArtwork *image = dynamic_cast<Models::ImageArtwork*>(metadata);
-                if (image != NULL) {
-                    image->setImageSize(importResultItem.ImageSize);
-                    image->setDateTimeOriginal(importResultItem.DateTimeOriginal);
-                }
+            Models::ArtworkMetadata *metadata = itemsToRead.at(index);
+            auto it = importResult.constFind(metadata->getFilepath());
+            if (it == importResult.constEnd()) { continue; }
 
-                metadata->setFileSize(importResultItem.FileSize);
+            m_AppliedImportResults.setBit(index);
+
+            const ImportDataResult &importResultItem = it.value();
+            metadata->initialize(importResultItem.Title,
+                                 importResultItem.Description,
+                                 importResultItem.Keywords);
+
+            Models::ImageArtwork *image = dynamic_cast<Models::ImageArtwork*>(metadata);
+            if (image != NULL) {
+                image->setImageSize(importResultItem.ImageSize);
+                image->setDateTimeOriginal(importResultItem.DateTimeOriginal);
+            }
+
+            metadata->setFileSize(importResultItem.FileSize);
+
+            if (restoreBackups) {
+                MetadataSavingCopy copy(importResultItem.BackupDict);
+                copy.saveToMetadata(metadata);
+            }
+
+            if (canUpdateRows) {
+                indicesToUpdate.append(m_IndicesToUpdate.at(index));
             }
         }
 
-        afterImportHandler(itemsToRead, ignoreBackups);
+        if (!indicesToUpdate.isEmpty()) {
+            m_CommandManager->updateArtworks(indicesToUpdate);
+        }
+    }
+
+    void MetadataIOCoordinator::readingFinishedHandler() {
+        Q_ASSERT(m_CanProcessResults);
+
+        const QVector<Models::ArtworkMetadata*> &itemsToRead = m_ReadingWorker->getItemsToRead();
+
+        LOG_DEBUG  << "Setting imported metadata...";
+        // everything which was not streamed yet
+        QVector<int> indices;
+        int size = itemsToRead.size();
+        indices.reserve(size);
+        for (int i = 0; i < size; ++i) {
+            if (!m_AppliedImportResults.testBit(i)) {
+                indices.append(i);
+            }
+        }
+
+        applyImportResults(indices);
+        m_PendingReadIndices.clear();
+        m_CanProcessResults = false;
+
+        afterImportHandler(itemsToRead);
 
         emit metadataReadingFinished();
         LOG_DEBUG << "Metadata import finished";
     }
 
-    void MetadataIOCoordinator::afterImportHandler(const QVector<Models::ArtworkMetadata*> &itemsToRead, bool ignoreBackups) {
-        Models::SettingsModel *settingsModel = m_CommandManager->getSettingsModel();
-        const QHash<QString, ImportDataResult> &importResult = m_ReadingWorker->getImportResult();
+    void MetadataIOCoordinator::afterImportHandler(const QVector<Models::ArtworkMetadata*> &itemsToRead) {
         const QVector<QPair<int, int> > &rangesToUpdate = m_ReadingWorker->getRangesToUpdate();
 
-        if (!ignoreBackups && settingsModel->getSaveBackups()) {
-            LOG_DEBUG << "Restoring the backups...";
-            int size = itemsToRead.size();
-            for (int i = 0; i < size; ++i) {
-                Models::ArtworkMetadata *metadata = itemsToRead.at(i);
-                const QString &filepath = metadata->getFilepath();
-
-                if (importResult.contains(filepath)) {
-                    const ImportDataResult &importResultItem = importResult.value(filepath);
-                    MetadataSavingCopy copy(importResultItem.BackupDict);
-                    copy.saveToMetadata(metadata);
-                }
-            }
-        } else {
-            LOG_DEBUG << "Skipped restoring the backups";
-        }
-
         if (!getHasErrors()) {
             m_CommandManager->addToLibrary(itemsToRead);
         }
@@ -319,6 +384,15 @@ namespace MetadataIO {
         m_CommandManager->submitForWarningsCheck(itemsToRead);
     }
 
+    void MetadataIOCoordinator::flushWrittenItems() {
+        if (m_WrittenItems.isEmpty()) { return; }
+
+        QVector<Models::ArtworkMetadata*> writtenItems;
+        writtenItems.swap(m_WrittenItems);
+
+        m_CommandManager->getArtItemsModel()->setItemsSaved(writtenItems);
+    }
+
     void MetadataIOCoordinator::tryToLaunchExiftool(const QString &settingsExiftoolPath) {
         LOG_DEBUG << "Default path is" << settingsExiftoolPath;
         // SHOULD BE UNDER DEFINE OS X
@@ -352,5 +426,14 @@ namespace MetadataIO {
         setExiftoolNotFound(exiftoolPath.isEmpty());
         m_RecommendedExiftoolPath = exiftoolPath;
     }
-}
 
+    ExiftoolService *MetadataIOCoordinator::getExiftoolService() {
+        if (m_ExiftoolService == NULL) {
+            // exiftool processes are started only when exiftool is used
+            m_ExiftoolService = new ExiftoolService(this);
+            m_ExiftoolService->startService();
+        }
+
+        return m_ExiftoolService;
+    }
+}
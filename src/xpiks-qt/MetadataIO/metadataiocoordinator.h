@@ -24,7 +24,9 @@
 
 #include <QObject>
 #include <QVector>
+#include <QBitArray>
 #include <QFutureWatcher>
+#include <QTimer>
 #include "../Common/baseentity.h"
 #include "../Common/defines.h"
 
@@ -36,6 +38,7 @@ namespace MetadataIO {
     class IMetadataReader;
     class IMetadataWriter;
     class MetadataWritingWorker;
+    class ExiftoolService;
 
     class MetadataIOCoordinator : public QObject, public Common::BaseEntity
     {
@@ -55,8 +58,11 @@ namespace MetadataIO {
         void exiftoolNotFoundChanged();
 
     private slots:
+        void readingWorkerItemsRead(const QVector<int> &indices);
         void readingWorkerFinished(bool success);
+        void writingWorkerItemsWritten(const QVector<int> &indices);
         void writingWorkerFinished(bool success);
+        void writtenItemsTimerTriggered();
         void exiftoolDiscoveryFinished();
 
     public:
@@ -95,21 +101,33 @@ namespace MetadataIO {
         void writeMetadataExiv2(const QVector<Models::ArtworkMetadata*> &artworksToWrite);
 #endif
         void autoDiscoverExiftool();
+        void stopExiftool();
         Q_INVOKABLE void discardReading();
         Q_INVOKABLE void continueReading(bool ignoreBackups);
         Q_INVOKABLE void continueWithoutReading();
 
     private:
-        void initializeImport(int itemsCount);
-        void readingFinishedHandler(bool ignoreBackups);
-        void afterImportHandler(const QVector<Models::ArtworkMetadata*> &itemsToRead, bool ignoreBackups);
+        void initializeImport(int itemsCount, const QVector<QPair<int, int> > &rangesToUpdate);
+        void applyImportResults(const QVector<int> &indices);
+        void readingFinishedHandler();
+        void afterImportHandler(const QVector<Models::ArtworkMetadata*> &itemsToRead);
+        void flushWrittenItems();
         void tryToLaunchExiftool(const QString &settingsExiftoolPath);
+        ExiftoolService *getExiftoolService();
 
     private:
         IMetadataReader *m_ReadingWorker;
         IMetadataWriter *m_WritingWorker;
         QFutureWatcher<void> *m_ExiftoolDiscoveryFuture;
+        ExiftoolService *m_ExiftoolService;
         QString m_RecommendedExiftoolPath;
+        // indices of items to read mapped to rows in the artworks model
+        QVector<int> m_IndicesToUpdate;
+        QVector<int> m_PendingReadIndices;
+        QBitArray m_AppliedImportResults;
+        // written items are marked saved together to scan artworks once per interval
+        QVector<Models::ArtworkMetadata*> m_WrittenItems;
+        QTimer m_WrittenItemsTimer;
         int m_ProcessingItemsCount;
         volatile bool m_IsImportInProgress;
         volatile bool m_CanProcessResults;
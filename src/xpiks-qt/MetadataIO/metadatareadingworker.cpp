@@ -23,24 +23,16 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
-#include <QFile>
-#include <QDir>
-#include <QTemporaryFile>
+#include <QFileInfo>
 #include <QImageReader>
+#include <QMutexLocker>
 #include "../Models/settingsmodel.h"
 #include "../Models/artworkmetadata.h"
 #include "../Helpers/constants.h"
 #include "saverworkerjobitem.h"
+#include "exiftoolservice.h"
 #include "../Common/defines.h"
 
-#ifdef Q_OS_WIN
-#define _X86_
-#include <fileapi.h>
-#include <io.h>
-#else
-#include <unistd.h>
-#endif
-
 #define SOURCEFILE QLatin1String("SourceFile")
 #define TITLE QLatin1String("Title")
 #define DESCRIPTION QLatin1String("Description")
@@ -144,214 +136,172 @@ namespace MetadataIO {
         }
     }
 
-    MetadataReadingWorker::MetadataReadingWorker(const QVector<Models::ArtworkMetadata *> &itemsToRead,
-                                                 Models::SettingsModel *settingsModel,
-                                                 const QVector<QPair<int, int> > &rangesToUpdate):
-        m_ItemsToRead(itemsToRead),
-        m_ExiftoolProcess(NULL),
-        m_RangesToUpdate(rangesToUpdate),
-        m_SettingsModel(settingsModel)
-    {
-    }
-
-    MetadataReadingWorker::~MetadataReadingWorker() {
-        LOG_DEBUG << "Reading worker destroyed";
+    QStringList createReadingArguments() {
+        QStringList arguments;
+#ifdef Q_OS_WIN
+        arguments << "-charset" << "FileName=UTF8";
+#endif
+        arguments << "-json" << "-ignoreMinorErrors" << "-e";
+        arguments << "-ObjectName" << "-Title";
+        arguments << "-ImageDescription" << "-Description" << "-Caption-Abstract";
+        arguments << "-Keywords" << "-Subject";
+        arguments << "-DateTimeOriginal" << "-TimeZoneOffset";
+        return arguments;
     }
 
-    void MetadataReadingWorker::process() {
-        bool success = false;
-        initWorker();
-
-        QTemporaryFile argumentsFile;
-
-        if (argumentsFile.open()) {
-            LOG_INFO << "Created arguments file" << argumentsFile.fileName();
+    bool parseExiftoolOutput(const QByteArray &output, ImportDataResult &result) {
+        bool parsed = false;
+        QJsonDocument document = QJsonDocument::fromJson(output);
 
-            QStringList exiftoolArguments = createArgumentsList();
-            foreach (const QString &line, exiftoolArguments) {
-                argumentsFile.write(line.toUtf8());
-#ifdef Q_OS_WIN
-                argumentsFile.write("\r\n");
-#else
-                argumentsFile.write("\n");
-#endif
+        if (document.isArray()) {
+            QJsonArray filesArray = document.array();
+            if (!filesArray.isEmpty()) {
+                const QJsonValue &fileJson = filesArray.at(0);
+                if (fileJson.isObject()) {
+                    QJsonObject fileObject = fileJson.toObject();
+                    jsonObjectToImportResult(fileObject, result);
+                    parsed = true;
+                }
             }
+        }
 
-            argumentsFile.flush();
-
-            LOG_DEBUG << "Waiting for tempfile bytes written...";
-#ifdef Q_OS_WIN
-            HANDLE fileHandle = (HANDLE)_get_osfhandle(argumentsFile.handle());
-            bool flushResult = FlushFileBuffers(fileHandle);
-            LOG_DEBUG << "Windows flush result:" << flushResult;
-#else
-            int fsyncResult = fsync(argumentsFile.handle());
-            LOG_DEBUG << "fsync result:" << fsyncResult;
-#endif
-            argumentsFile.close();
+        return parsed;
+    }
 
-            QString exiftoolPath = m_SettingsModel->getExifToolPath();
-            QStringList arguments;
-#ifdef Q_OS_WIN
-            arguments << "-charset" << "FileName=UTF8";
-
-            /*
-            QString exiftoolCommand = QString("\"\"%1\" -charset filename=UTF8 -@ \"%2\"\"").arg(exiftoolPath).arg(tempFilename);
-            LOG_DEBUG << "Windows command is:" << exiftoolCommand;
-            m_ExiftoolProcess->setTextModeEnabled(false);
-            m_ExiftoolProcess->setProgram("cmd.exe");
-            m_ExiftoolProcess->setArguments(QStringList() << "/U" << "/c");
-            m_ExiftoolProcess->setNativeArguments(exiftoolCommand);
-            m_ExiftoolProcess->start();
-            */
-#endif
-            arguments << "-@" << argumentsFile.fileName();
-            LOG_INFO << "Starting exiftool process:" << exiftoolPath;
-            m_ExiftoolProcess->start(exiftoolPath, arguments);
+    ExiftoolReadingJob::ExiftoolReadingJob(const QString &exiftoolPath, const QStringList &filepaths, bool readBackups):
+        ExiftoolJob(exiftoolPath, filepaths.size()),
+        m_Filepaths(filepaths),
+        m_ReadBackups(readBackups)
+    {
+    }
 
-            success = m_ExiftoolProcess->waitForFinished();
-            LOG_DEBUG << "Exiftool process finished.";
+    void ExiftoolReadingJob::takeReadResults(ReadResults &results) {
+        QMutexLocker locker(&m_ResultsMutex);
+        results.swap(m_ReadResults);
+        m_ReadResults.clear();
+    }
 
-            int exitCode = m_ExiftoolProcess->exitCode();
-            QProcess::ExitStatus exitStatus = m_ExiftoolProcess->exitStatus();
+    QStringList ExiftoolReadingJob::getArguments(int index) const {
+        // one file per command so results come back file by file
+        QStringList arguments = createReadingArguments();
+        arguments << m_Filepaths.at(index);
+        return arguments;
+    }
 
-            success = success &&
-                    (exitCode == 0) &&
-                    (exitStatus == QProcess::NormalExit);
+    bool ExiftoolReadingJob::processOutput(int index, bool success, const QByteArray &output) {
+        const QString &filepath = m_Filepaths.at(index);
+        ImportDataResult result;
 
-            LOG_INFO << "Exiftool exitcode =" << exitCode << "exitstatus =" << exitStatus;
-            LOG_DEBUG << "Temporary file:" << argumentsFile.fileName();
+        if (success && !parseExiftoolOutput(output, result)) {
+            LOG_WARNING << "Exiftool Output Parsing Error for" << filepath;
+        }
 
-            QByteArray stdoutByteArray = m_ExiftoolProcess->readAllStandardOutput();
-            parseExiftoolOutput(stdoutByteArray);
+        result.FilePath = filepath;
 
-            if (m_SettingsModel->getSaveBackups()) {
-                readBackupsAndSizes(success);
-            } else {
-                readSizes();
+        if (m_ReadBackups && m_BackupsLookup.hasBackup(filepath)) {
+            MetadataSavingCopy copy;
+            if (copy.readFromFile(filepath)) {
+                result.BackupDict = copy.getInfo();
             }
         }
 
-        emit finished(success);
-    }
+        QImageReader reader(filepath);
+        result.ImageSize = reader.size();
 
-    void MetadataReadingWorker::cancel() {
-        LOG_INFO << "Cancelling...";
+        QFileInfo fi(filepath);
+        result.FileSize = fi.size();
 
-        if (m_ExiftoolProcess && m_ExiftoolProcess->state() != QProcess::NotRunning) {
-            m_ExiftoolProcess->kill();
-            LOG_INFO << "Exiftool process killed";
+        bool wasEmpty = false;
+
+        m_ResultsMutex.lock();
+        {
+            wasEmpty = m_ReadResults.isEmpty();
+            m_ReadResults.append(qMakePair(index, result));
         }
-    }
+        m_ResultsMutex.unlock();
 
-    void MetadataReadingWorker::innerProcessFinished(int exitCode, QProcess::ExitStatus exitStatus) {
-        Q_UNUSED(exitStatus);
-        LOG_DEBUG << "Exiftool finished with exitcode" << exitCode;
+        return wasEmpty;
+    }
 
-        QByteArray stderrByteArray = m_ExiftoolProcess->readAllStandardError();
-        QString stderrText = QString::fromUtf8(stderrByteArray);
-        LOG_DEBUG << "STDERR [Exiftool]:" << stderrText;
+    MetadataReadingWorker::MetadataReadingWorker(const QVector<Models::ArtworkMetadata *> &itemsToRead,
+                                                 Models::SettingsModel *settingsModel,
+                                                 const QVector<QPair<int, int> > &rangesToUpdate,
+                                                 QObject *parent):
+        QObject(parent),
+        m_ItemsToRead(itemsToRead),
+        m_RangesToUpdate(rangesToUpdate),
+        m_SettingsModel(settingsModel)
+    {
     }
 
-    void MetadataReadingWorker::initWorker() {
-        m_ExiftoolProcess = new QProcess(this);
+    MetadataReadingWorker::~MetadataReadingWorker() {
+        if (m_ReadingJob) {
+            m_ReadingJob->cancel();
+        }
 
-        QObject::connect(m_ExiftoolProcess, SIGNAL(finished(int,QProcess::ExitStatus)),
-                         this, SLOT(innerProcessFinished(int,QProcess::ExitStatus)));
+        LOG_DEBUG << "Reading worker destroyed";
     }
 
-    QStringList MetadataReadingWorker::createArgumentsList() {
-        QStringList arguments;
-        arguments.reserve(m_ItemsToRead.length() + 10);
+    void MetadataReadingWorker::startReading(ExiftoolService *exiftoolService) {
+        Q_ASSERT(exiftoolService != NULL);
 
-        /*
-         * Related to the hack in windows for UTF8-encoded paths
-#ifdef Q_OS_WIN
-        arguments << "-charset" << "FileName=UTF8";
-#endif
-*/
-        arguments << "-json" << "-ignoreMinorErrors" << "-e";
-        arguments << "-ObjectName" << "-Title";
-        arguments << "-ImageDescription" << "-Description" << "-Caption-Abstract";
-        arguments << "-Keywords" << "-Subject";
-        arguments << "-DateTimeOriginal" << "-TimeZoneOffset";
-        int size = m_ItemsToRead.length();
-        for (int i = 0; i < size; ++i) {
-            Models::ArtworkMetadata *metadata = m_ItemsToRead.at(i);
-            arguments << metadata->getFilepath();
+        QStringList filepaths;
+        filepaths.reserve(m_ItemsToRead.size());
+        for (auto *metadata: m_ItemsToRead) {
+            filepaths.append(metadata->getFilepath());
         }
 
-        return arguments;
-    }
+        m_ReadingJob.reset(new ExiftoolReadingJob(m_SettingsModel->getExifToolPath(),
+                                                  filepaths,
+                                                  m_SettingsModel->getSaveBackups()));
 
-    void MetadataReadingWorker::parseExiftoolOutput(const QByteArray &output) {
-        LOG_DEBUG << "Parsing JSON output of exiftool...";
-        QJsonDocument document = QJsonDocument::fromJson(output);
-        if (document.isArray()) {
-            QJsonArray filesArray = document.array();
+        QObject::connect(exiftoolService, SIGNAL(jobResultsAvailable(int)), this, SLOT(onJobResultsAvailable(int)));
+        QObject::connect(exiftoolService, SIGNAL(jobFinished(int,bool)), this, SLOT(onJobFinished(int,bool)));
 
-            int size = filesArray.size();
-            for (int i = 0; i < size; ++i) {
-                const QJsonValue &fileJson = filesArray.at(i);
-                if (fileJson.isObject()) {
-                    QJsonObject fileObject = fileJson.toObject();
-                    ImportDataResult result;
-                    jsonObjectToImportResult(fileObject, result);
+        LOG_INFO << "Reading" << filepaths.size() << "items with exiftool";
+        exiftoolService->submitJob(m_ReadingJob);
+    }
 
-                    Q_ASSERT(!result.FilePath.isEmpty());
-                    Q_ASSERT(!m_ImportResult.contains(result.FilePath));
+    void MetadataReadingWorker::dismiss() {
+        LOG_DEBUG << "#";
 
-                    m_ImportResult.insert(result.FilePath, result);
-                    LOG_DEBUG << "Parsed file:" << result.FilePath;
-                }
-            }
-        } else {
-            LOG_WARNING << "Exiftool Output Parsing Error";
+        if (m_ReadingJob) {
+            m_ReadingJob->cancel();
         }
-    }
 
-    void MetadataReadingWorker::readBackupsAndSizes(bool exiftoolSuccess) {
-        LOG_DEBUG << "exiftool success is" << exiftoolSuccess;
-        int size = m_ItemsToRead.size();
-        for (int i = 0; i < size; ++i) {
-            Models::ArtworkMetadata *metadata = m_ItemsToRead.at(i);
-            const QString &filepath = metadata->getFilepath();
+        this->deleteLater();
+    }
 
-            MetadataSavingCopy copy;
-            if (copy.readFromFile(filepath)) {
-                if (exiftoolSuccess) {
-                    Q_ASSERT(m_ImportResult.contains(filepath));
-                }
+    void MetadataReadingWorker::onJobResultsAvailable(int jobID) {
+        if (!m_ReadingJob || (m_ReadingJob->getJobID() != jobID)) { return; }
 
-                m_ImportResult[filepath].BackupDict = copy.getInfo();
-            }
+        mergeReadResults();
+    }
 
-            ImportDataResult &importResultItem = m_ImportResult[filepath];
+    void MetadataReadingWorker::onJobFinished(int jobID, bool success) {
+        if (!m_ReadingJob || (m_ReadingJob->getJobID() != jobID)) { return; }
 
-            QImageReader reader(filepath);
-            importResultItem.ImageSize = reader.size();
+        LOG_INFO << "Exiftool job finished. Success:" << success;
+        mergeReadResults();
 
-            QFileInfo fi(filepath);
-            importResultItem.FileSize = fi.size();
-        }
+        emit finished(success);
     }
 
-    void MetadataReadingWorker::readSizes() {
-        LOG_DEBUG << "#";
-        int size = m_ItemsToRead.size();
-        for (int i = 0; i < size; ++i) {
-            Models::ArtworkMetadata *metadata = m_ItemsToRead.at(i);
-            const QString &filepath = metadata->getFilepath();
+    void MetadataReadingWorker::mergeReadResults() {
+        ReadResults readResults;
+        m_ReadingJob->takeReadResults(readResults);
 
-            Q_ASSERT(m_ImportResult.contains(filepath));
-            ImportDataResult &importResultItem = m_ImportResult[filepath];
+        if (readResults.isEmpty()) { return; }
 
-            QImageReader reader(filepath);
-            importResultItem.ImageSize = reader.size();
+        QVector<int> indices;
+        indices.reserve(readResults.size());
 
-            QFileInfo fi(filepath);
-            importResultItem.FileSize = fi.size();
+        for (const auto &readResult: readResults) {
+            const ImportDataResult &importResult = readResult.second;
+            m_ImportResult.insert(importResult.FilePath, importResult);
+            indices.append(readResult.first);
         }
+
+        emit itemsRead(indices);
     }
 }
-
@@ -26,13 +26,14 @@
 #include <QVector>
 #include <QHash>
 #include <QString>
-#include <QProcess>
 #include <QStringList>
 #include <QByteArray>
-#include <QHash>
-#include <QSize>
+#include <QMutex>
+#include <memory>
 #include "importdataresult.h"
 #include "imetadatareader.h"
+#include "exiftooljob.h"
+#include "backupslookup.h"
 
 namespace Models {
     class ArtworkMetadata;
@@ -40,26 +41,51 @@ namespace Models {
 }
 
 namespace MetadataIO {
-    class BackupSaverService;
+    class ExiftoolService;
+
+    class ExiftoolReadingJob : public ExiftoolJob
+    {
+    public:
+        ExiftoolReadingJob(const QString &exiftoolPath, const QStringList &filepaths, bool readBackups);
+
+    public:
+        void takeReadResults(ReadResults &results);
+
+    public:
+        virtual QStringList getArguments(int index) const override;
+        virtual bool processOutput(int index, bool success, const QByteArray &output) override;
+
+    private:
+        const QStringList m_Filepaths;
+        BackupsLookup m_BackupsLookup;
+        QMutex m_ResultsMutex;
+        ReadResults m_ReadResults;
+        bool m_ReadBackups;
+    };
 
     class MetadataReadingWorker : public QObject, public IMetadataReader
     {
         Q_OBJECT
     public:
         explicit MetadataReadingWorker(const QVector<Models::ArtworkMetadata *> &itemsToRead,
-                                       Models::SettingsModel *settingsModel, const QVector<QPair<int, int> > &rangesToUpdate);
+                                       Models::SettingsModel *settingsModel, const QVector<QPair<int, int> > &rangesToUpdate,
+                                       QObject *parent = 0);
         virtual ~MetadataReadingWorker();
 
+    public:
+        void startReading(ExiftoolService *exiftoolService);
+
     signals:
-        void stopped();
+        // indices of getItemsToRead() which just got into getImportResult()
+        void itemsRead(const QVector<int> &indices);
         void finished(bool success);
 
     public slots:
-        void process();
-        void cancel();
+        void dismiss();
 
     private slots:
-        void innerProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+        void onJobResultsAvailable(int jobID);
+        void onJobFinished(int jobID, bool success);
 
     public:
         virtual const QHash<QString, ImportDataResult> &getImportResult() const override { return m_ImportResult; }
@@ -67,17 +93,13 @@ namespace MetadataIO {
         virtual const QVector<QPair<int, int> > &getRangesToUpdate() const override { return m_RangesToUpdate; }
 
     private:
-        void initWorker();
-        QStringList createArgumentsList();
-        void parseExiftoolOutput(const QByteArray &output);
-        void readBackupsAndSizes(bool exiftoolSuccess);
-        void readSizes();
+        void mergeReadResults();
 
     private:
         QVector<Models::ArtworkMetadata *> m_ItemsToRead;
         QHash<QString, ImportDataResult> m_ImportResult;
-        QProcess *m_ExiftoolProcess;
         QVector<QPair<int, int> > m_RangesToUpdate;
+        std::shared_ptr<ExiftoolReadingJob> m_ReadingJob;
         Models::SettingsModel *m_SettingsModel;
     };
 }
@@ -20,82 +20,63 @@
  */
 
 #include "metadatawritingworker.h"
-#include "../Common/defines.h"
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
-#include <QFile>
-#include <QDir>
-#include <QTemporaryFile>
-#include <QTextStream>
 #include "../Models/artworkmetadata.h"
 #include "../Models/settingsmodel.h"
+#include "exiftoolservice.h"
 #include "../Common/defines.h"
 
-#ifdef Q_OS_WIN
-#define _X86_
-#include <fileapi.h>
-#include <io.h>
-#else
-#include <unistd.h>
-#endif
-
-#define SOURCEFILE QLatin1String("SourceFile")
-#define XMP_TITLE QLatin1String("XMP:Title")
-#define IPTC_OBJECTNAME QLatin1String("IPTC:ObjectName")
-#define XMP_DESCRIPTION QLatin1String("XMP:Description")
-#define EXIF_IMAGEDESCRIPTION QLatin1String("EXIF:ImageDescription")
-#define IPTC_CAPTIONABSTRACT QLatin1String("IPTC:Caption-Abstract")
-#define IPTC_KEYWORDS QLatin1String("IPTC:Keywords")
-#define XMP_SUBJECT QLatin1String("XMP:Subject")
+#define XMP_TITLE QLatin1String("-XMP:Title=")
+#define IPTC_OBJECTNAME QLatin1String("-IPTC:ObjectName=")
+#define XMP_DESCRIPTION QLatin1String("-XMP:Description=")
+#define EXIF_IMAGEDESCRIPTION QLatin1String("-EXIF:ImageDescription=")
+#define IPTC_CAPTIONABSTRACT QLatin1String("-IPTC:Caption-Abstract=")
+#define IPTC_KEYWORDS QLatin1String("-IPTC:Keywords=")
+#define XMP_SUBJECT QLatin1String("-XMP:Subject=")
 
 namespace MetadataIO {
-    void keywordsToJsonArray(const QStringList &keywords, QJsonArray &array) {
-        int size = keywords.size();
-        for (int i = 0; i < size; ++i) {
-            array.append(QJsonValue(keywords.at(i)));
-        }
-    }
+    void appendListTagArguments(const QString &tagAssignment, const QStringList &values, QStringList &arguments) {
+        bool anyValue = false;
 
-    void metadataToJsonObject(Models::ArtworkMetadata *metadata, QJsonObject &jsonObject) {
-        QString title = metadata->getTitle().simplified();
-        QString description = metadata->getDescription().simplified();
+        for (const QString &value: values) {
+            // same as title and description: line breaks would split the argument
+            const QString simplifiedValue = value.simplified();
+            if (simplifiedValue.isEmpty()) { continue; }
 
-        if (title.isEmpty()) {
-            title = description;
+            arguments << (tagAssignment + simplifiedValue);
+            anyValue = true;
         }
 
-        jsonObject.insert(SOURCEFILE, QJsonValue(metadata->getFilepath()));
-
-        QJsonValue titleValue(title);
-        jsonObject.insert(XMP_TITLE, titleValue);
-        jsonObject.insert(IPTC_OBJECTNAME, titleValue);
-
-        QJsonValue descriptionValue(description);
-        jsonObject.insert(XMP_DESCRIPTION, descriptionValue);
-        jsonObject.insert(EXIF_IMAGEDESCRIPTION, descriptionValue);
-        jsonObject.insert(IPTC_CAPTIONABSTRACT, descriptionValue);
+        if (!anyValue) {
+            // clears the tag
+            arguments << tagAssignment;
+        }
+    }
 
-        QStringList keywords = metadata->getKeywords();
-        QJsonArray keywordsArray;
-        keywordsToJsonArray(keywords, keywordsArray);
-        jsonObject.insert(IPTC_KEYWORDS, keywordsArray);
-        jsonObject.insert(XMP_SUBJECT, keywordsArray);
+    ExiftoolWritingJob::ExiftoolWritingJob(const QString &exiftoolPath, const QVector<QStringList> &argumentsList):
+        ExiftoolJob(exiftoolPath, argumentsList.size()),
+        m_ArgumentsList(argumentsList)
+    {
     }
 
-    void artworksToJsonArray(const QVector<Models::ArtworkMetadata *> &itemsToWrite, QJsonArray &array) {
-        int size = itemsToWrite.size();
-        for (int i = 0; i < size; ++i) {
-            QJsonObject artworkObject;
-            metadataToJsonObject(itemsToWrite.at(i), artworkObject);
-            array.append(artworkObject);
+    bool ExiftoolWritingJob::processOutput(int index, bool success, const QByteArray &output) {
+        Q_UNUSED(index);
+
+        if (success) {
+            if (!output.contains("1 image files updated") &&
+                    !output.contains("1 image files unchanged")) {
+                LOG_WARNING << "Unexpected exiftool output:" << QString::fromUtf8(output).trimmed();
+            }
         }
+
+        // nothing is streamed back
+        return false;
     }
 
     MetadataWritingWorker::MetadataWritingWorker(const QVector<Models::ArtworkMetadata *> &itemsToWrite,
-                                                 Models::SettingsModel *settingsModel, bool useBackups):
+                                                 Models::SettingsModel *settingsModel, bool useBackups,
+                                                 QObject *parent):
+        QObject(parent),
         m_ItemsToWrite(itemsToWrite),
-        m_ExiftoolProcess(NULL),
         m_SettingsModel(settingsModel),
         m_UseBackups(useBackups)
     {
@@ -105,121 +86,66 @@ namespace MetadataIO {
         LOG_DEBUG << "destroyed";
     }
 
-    void MetadataWritingWorker::process() {
-        bool success = false;
-
-        initWorker();
-
-        QTemporaryFile jsonFile;
-        if (jsonFile.open()) {
-            LOG_INFO << "Serializing artworks to json" << jsonFile.fileName();
-            QJsonArray objectsToSave;
-            artworksToJsonArray(m_ItemsToWrite, objectsToSave);
-            QJsonDocument document(objectsToSave);
-            jsonFile.write(document.toJson());
-            jsonFile.flush();
-            jsonFile.close();
-
-            int numberOfItems = m_ItemsToWrite.length();
-
-            QTemporaryFile argumentsFile;
-            if (argumentsFile.open()) {
-                QStringList exiftoolArguments = createArgumentsList(jsonFile.fileName());
-
-                foreach (const QString &line, exiftoolArguments) {
-                    argumentsFile.write(line.toUtf8());
-#ifdef Q_OS_WIN
-                    argumentsFile.write("\r\n");
-#else
-                    argumentsFile.write("\n");
-#endif
-                }
-                argumentsFile.flush();
-
-                LOG_DEBUG << "Waiting for tempfile bytes written...";
-    #ifdef Q_OS_WIN
-                HANDLE fileHandle = (HANDLE)_get_osfhandle(argumentsFile.handle());
-                bool flushResult = FlushFileBuffers(fileHandle);
-                LOG_DEBUG << "Windows flush result:" << flushResult;
-    #else
-                int fsyncResult = fsync(argumentsFile.handle());
-                LOG_DEBUG << "fsync result:" << fsyncResult;
-    #endif
-                argumentsFile.close();
-
-                QString exiftoolPath = m_SettingsModel->getExifToolPath();
-                QStringList arguments;
-#ifdef Q_OS_WIN
-                arguments << "-charset" << "FileName=UTF8";
-#endif
-                arguments << "-IPTC:CodedCharacterSet=UTF8" << "-@" << argumentsFile.fileName();
-
-                LOG_DEBUG << "Starting exiftool process:" << exiftoolPath;
-
-                m_ExiftoolProcess->start(exiftoolPath, arguments);
-                const int oneFileTimeout = 5000;
-                success = m_ExiftoolProcess->waitForFinished(oneFileTimeout*numberOfItems);
-
-                LOG_DEBUG << "Exiftool process finished.";
-
-                int exitCode = m_ExiftoolProcess->exitCode();
-                QProcess::ExitStatus exitStatus = m_ExiftoolProcess->exitStatus();
+    void MetadataWritingWorker::startWriting(ExiftoolService *exiftoolService) {
+        Q_ASSERT(exiftoolService != NULL);
 
-                success = success &&
-                        (exitCode == 0) &&
-                        (exitStatus == QProcess::NormalExit);
+        // metadata is serialized here since artworks belong to the UI thread
+        QVector<QStringList> argumentsList;
+        argumentsList.reserve(m_ItemsToWrite.size());
+        for (auto *metadata: m_ItemsToWrite) {
+            argumentsList.append(createArgumentsList(metadata));
+        }
 
-                LOG_INFO << "Exiftool exitcode =" << exitCode << "exitstatus =" << exitStatus;
-                LOG_DEBUG << "Temporary file:" << argumentsFile.fileName();
+        m_WritingJob.reset(new ExiftoolWritingJob(m_SettingsModel->getExifToolPath(), argumentsList));
 
-                if (!success) {
-                    LOG_WARNING << "Exiftool error string:" << m_ExiftoolProcess->errorString();
-                }
-            }
-        }
+        QObject::connect(exiftoolService, SIGNAL(jobFinished(int,bool)), this, SLOT(onJobFinished(int,bool)));
 
-        emit finished(success);
+        LOG_INFO << "Writing" << argumentsList.size() << "items with exiftool";
+        exiftoolService->submitJob(m_WritingJob);
     }
 
-    void MetadataWritingWorker::innerProcessFinished(int exitCode, QProcess::ExitStatus exitStatus) {
-        Q_UNUSED(exitStatus);
-        LOG_DEBUG << "Exiftool finished with exitcode" << exitCode;
+    void MetadataWritingWorker::dismiss() {
+        this->deleteLater();
+    }
 
-        QByteArray stdoutByteArray = m_ExiftoolProcess->readAllStandardOutput();
-        QString stdoutText = QString::fromUtf8(stdoutByteArray);
-        LOG_DEBUG << "STDOUT [ExifTool]:" << stdoutText;
+    void MetadataWritingWorker::onJobFinished(int jobID, bool success) {
+        if (!m_WritingJob || (m_WritingJob->getJobID() != jobID)) { return; }
 
-        QByteArray stderrByteArray = m_ExiftoolProcess->readAllStandardError();
-        QString stderrText = QString::fromUtf8(stderrByteArray);
-        LOG_DEBUG << "STDERR [Exiftool]:" << stderrText;
+        LOG_INFO << "Exiftool job finished. Success:" << success;
+        emit finished(success);
     }
 
-    void MetadataWritingWorker::initWorker() {
-        m_ExiftoolProcess = new QProcess(this);
+    QStringList MetadataWritingWorker::createArgumentsList(Models::ArtworkMetadata *metadata) const {
+        QString title = metadata->getTitle().simplified();
+        QString description = metadata->getDescription().simplified();
+        QStringList keywords = metadata->getKeywords();
 
-        QObject::connect(m_ExiftoolProcess, SIGNAL(finished(int,QProcess::ExitStatus)),
-                         this, SLOT(innerProcessFinished(int,QProcess::ExitStatus)));
-    }
+        if (title.isEmpty()) {
+            title = description;
+        }
 
-    QStringList MetadataWritingWorker::createArgumentsList(const QString &jsonFilePath) {
         QStringList arguments;
-        arguments.reserve(m_ItemsToWrite.length() + 5);
+        arguments.reserve(keywords.size() * 2 + 15);
 
-//#ifdef Q_OS_WIN
-//        arguments << "-charset" << "FileName=UTF8";
-//#endif
+#ifdef Q_OS_WIN
+        arguments << "-charset" << "FileName=UTF8";
+#endif
         // ignore minor warnings
-        arguments << "-m" << "-j=" + jsonFilePath;
+        arguments << "-m" << "-IPTC:CodedCharacterSet=UTF8";
 
         if (!m_UseBackups) {
             arguments << "-overwrite_original";
         }
 
-        int size = m_ItemsToWrite.length();
-        for (int i = 0; i < size; ++i) {
-            Models::ArtworkMetadata *metadata = m_ItemsToWrite.at(i);
-            arguments << metadata->getFilepath();
-        }
+        arguments << (XMP_TITLE + title) << (IPTC_OBJECTNAME + title);
+        arguments << (XMP_DESCRIPTION + description);
+        arguments << (EXIF_IMAGEDESCRIPTION + description);
+        arguments << (IPTC_CAPTIONABSTRACT + description);
+
+        appendListTagArguments(IPTC_KEYWORDS, keywords, arguments);
+        appendListTagArguments(XMP_SUBJECT, keywords, arguments);
+
+        arguments << metadata->getFilepath();
 
         return arguments;
     }
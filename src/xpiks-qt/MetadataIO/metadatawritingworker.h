@@ -24,8 +24,10 @@
 
 #include <QObject>
 #include <QVector>
-#include <QProcess>
+#include <QStringList>
+#include <memory>
 #include "imetadatawriter.h"
+#include "exiftooljob.h"
 
 namespace Models {
     class ArtworkMetadata;
@@ -33,36 +35,52 @@ namespace Models {
 }
 
 namespace MetadataIO {
+    class ExiftoolService;
+
+    class ExiftoolWritingJob : public ExiftoolJob
+    {
+    public:
+        ExiftoolWritingJob(const QString &exiftoolPath, const QVector<QStringList> &argumentsList);
+
+    public:
+        virtual QStringList getArguments(int index) const override { return m_ArgumentsList.at(index); }
+        virtual bool processOutput(int index, bool success, const QByteArray &output) override;
+
+    private:
+        const QVector<QStringList> m_ArgumentsList;
+    };
+
     class MetadataWritingWorker : public QObject, public IMetadataWriter
     {
         Q_OBJECT
     public:
         explicit MetadataWritingWorker(const QVector<Models::ArtworkMetadata*> &itemsToWrite,
                                        Models::SettingsModel *settingsModel,
-                                       bool useBackups);
+                                       bool useBackups,
+                                       QObject *parent = 0);
         virtual ~MetadataWritingWorker();
 
+    public:
+        void startWriting(ExiftoolService *exiftoolService);
+
     signals:
-        void stopped();
         void finished(bool success);
 
     public:
         virtual const QVector<Models::ArtworkMetadata *> &getItemsToWrite() const override { return m_ItemsToWrite; }
 
     public slots:
-        void process();
-        //void cancel();
+        void dismiss();
 
     private slots:
-        void innerProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+        void onJobFinished(int jobID, bool success);
 
     private:
-        void initWorker();
-        QStringList createArgumentsList(const QString &jsonFilePath);
+        QStringList createArgumentsList(Models::ArtworkMetadata *metadata) const;
 
     private:
         QVector<Models::ArtworkMetadata*> m_ItemsToWrite;
-        QProcess *m_ExiftoolProcess;
+        std::shared_ptr<ExiftoolWritingJob> m_WritingJob;
         Models::SettingsModel *m_SettingsModel;
         bool m_UseBackups;
     };
@@ -21,12 +21,10 @@
 
 #include "readingorchestrator.h"
 #include <QThread>
+#include <QThreadPool>
 #include <QVector>
-#include <QMutexLocker>
 #include "../Models/artworkmetadata.h"
 #include "../Common/defines.h"
-#include "../Helpers/indiceshelper.h"
-#include "exiv2readingworker.h"
 
 #if defined(TRAVIS_CI)
 #define MIN_SPLIT_COUNT 100
@@ -42,12 +40,21 @@
 #define MIN_READING_THREADS 1
 
 namespace MetadataIO {
+    QThreadPool *getReadingThreadPool() {
+        // threads are kept alive between imports for the expiry timeout
+        static QThreadPool readingThreadPool;
+        readingThreadPool.setMaxThreadCount(MAX_READING_THREADS);
+        return &readingThreadPool;
+    }
+
     ReadingOrchestrator::ReadingOrchestrator(const QVector<Models::ArtworkMetadata *> &itemsToRead,
                                              const QVector<QPair<int, int> > &rangesToUpdate,
                                              QObject *parent) :
         QObject(parent),
         m_ItemsToRead(itemsToRead),
         m_RangesToUpdate(rangesToUpdate),
+        m_WorkQueue(new ReadingWorkQueue(itemsToRead)),
+        m_BackupsLookup(new BackupsLookup()),
         m_ThreadsCount(MIN_READING_THREADS),
         m_FinishedCount(0),
         m_AnyError(false)
@@ -55,75 +62,86 @@ namespace MetadataIO {
         int size = itemsToRead.size();
         if (size >= MIN_SPLIT_COUNT) {
 #ifdef QT_DEBUG
-            m_ThreadsCount = size;
+            m_ThreadsCount = qMin(size, MAX_READING_THREADS);
 #else
             int idealThreadCount = qMin(qMax(QThread::idealThreadCount(), MIN_READING_THREADS), MAX_READING_THREADS);
             m_ThreadsCount = qMin(size, idealThreadCount);
 #endif
-
-            m_ThreadsCount = Helpers::splitIntoChunks<Models::ArtworkMetadata*>(itemsToRead, m_ThreadsCount, m_SlicedItemsToRead);
-        } else {
-            m_SlicedItemsToRead.push_back(itemsToRead);
         }
 
         LOG_INFO << "Using" << m_ThreadsCount << "threads for" << size << "items to read";
     }
 
     ReadingOrchestrator::~ReadingOrchestrator() {
+        // workers still running will drain the queue without reading
+        m_WorkQueue->cancel();
         LOG_DEBUG << "destroyed";
     }
 
     void ReadingOrchestrator::startReading() {
         LOG_DEBUG << "#";
 
-        int size = m_SlicedItemsToRead.size();
-        for (int i = 0; i < size; ++i) {
-            const QVector<Models::ArtworkMetadata *> &itemsToRead = m_SlicedItemsToRead.at(i);
-
-            Exiv2ReadingWorker *worker = new Exiv2ReadingWorker(i, itemsToRead);
-
-            QThread *thread = new QThread();
-            worker->moveToThread(thread);
-
-            QObject::connect(thread, SIGNAL(started()), worker, SLOT(process()));
-            QObject::connect(worker, SIGNAL(stopped()), thread, SLOT(quit()));
+        QThreadPool *threadPool = getReadingThreadPool();
 
-            QObject::connect(worker, SIGNAL(stopped()), worker, SLOT(deleteLater()));
-            QObject::connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
+        for (int i = 0; i < m_ThreadsCount; ++i) {
+            Exiv2ReadingWorker *worker = new Exiv2ReadingWorker(i, m_WorkQueue, m_BackupsLookup);
 
+            QObject::connect(worker, SIGNAL(resultsAvailable()), this, SLOT(onWorkerResultsAvailable()));
             QObject::connect(worker, SIGNAL(finished(bool)), this, SLOT(onWorkerFinished(bool)));
+            QObject::connect(worker, SIGNAL(finished(bool)), worker, SLOT(deleteLater()));
 
-            thread->start();
+            threadPool->start(worker);
 
             LOG_INFO << "Started worker" << i;
         }
 
-        Q_ASSERT(m_SlicedItemsToRead.size() == m_ThreadsCount);
-
         emit allStarted();
     }
 
     void ReadingOrchestrator::dismiss() {
+        m_WorkQueue->cancel();
         this->deleteLater();
     }
 
+    void ReadingOrchestrator::onWorkerResultsAvailable() {
+        Exiv2ReadingWorker *worker = qobject_cast<Exiv2ReadingWorker *>(sender());
+        Q_ASSERT(worker != NULL);
+
+        mergeReadResults(worker);
+    }
+
     void ReadingOrchestrator::onWorkerFinished(bool anyError) {
         Exiv2ReadingWorker *worker = qobject_cast<Exiv2ReadingWorker *>(sender());
         Q_ASSERT(worker != NULL);
 
         LOG_INTEGR_TESTS_OR_DEBUG << "#" << worker->getWorkerIndex() << "[" << m_FinishedCount << "out of" << m_ThreadsCount << "] anyError:" << anyError;
 
-        {
-            QMutexLocker locker(&m_ImportMutex);
-            m_ImportResult.unite(worker->getImportResult());
-            m_AnyError = m_AnyError || anyError;
-        }
-
-        worker->dismiss();
+        mergeReadResults(worker);
+        m_AnyError = m_AnyError || anyError;
 
-        if (m_FinishedCount.fetchAndAddOrdered(1) == (m_ThreadsCount - 1)) {
+        m_FinishedCount++;
+        if (m_FinishedCount == m_ThreadsCount) {
             LOG_DEBUG << "Last worker finished";
             emit allFinished(!m_AnyError);
         }
     }
+
+    void ReadingOrchestrator::mergeReadResults(Exiv2ReadingWorker *worker) {
+        ReadResults readResults;
+        worker->takeReadResults(readResults);
+
+        if (readResults.isEmpty()) { return; }
+
+        QVector<int> indices;
+        indices.reserve(readResults.size());
+
+        for (const auto &readResult: readResults) {
+            const ImportDataResult &importResult = readResult.second;
+            Q_ASSERT(!m_ImportResult.contains(importResult.FilePath));
+            m_ImportResult.insert(importResult.FilePath, importResult);
+            indices.append(readResult.first);
+        }
+
+        emit itemsRead(indices);
+    }
 }
@@ -24,10 +24,10 @@
 
 #include <QObject>
 #include <QVector>
-#include <QAtomicInt>
-#include <QMutex>
+#include <memory>
 #include "importdataresult.h"
 #include "imetadatareader.h"
+#include "exiv2readingworker.h"
 
 namespace Models {
     class ArtworkMetadata;
@@ -53,23 +53,29 @@ namespace MetadataIO {
 
     signals:
         void allStarted();
+        // indices of getItemsToRead() which just got into getImportResult()
+        void itemsRead(const QVector<int> &indices);
         void allFinished(bool anyError);
 
     public slots:
         void dismiss();
 
     private slots:
+        void onWorkerResultsAvailable();
         void onWorkerFinished(bool anyError);
 
+    private:
+        void mergeReadResults(Exiv2ReadingWorker *worker);
+
     private:
         QVector<Models::ArtworkMetadata *> m_ItemsToRead;
-        QVector<QVector<Models::ArtworkMetadata *> > m_SlicedItemsToRead;
         QVector<QPair<int, int> > m_RangesToUpdate;
-        QMutex m_ImportMutex;
+        std::shared_ptr<ReadingWorkQueue> m_WorkQueue;
+        std::shared_ptr<BackupsLookup> m_BackupsLookup;
         QHash<QString, ImportDataResult> m_ImportResult;
-        volatile int m_ThreadsCount;
-        QAtomicInt m_FinishedCount;
-        volatile bool m_AnyError;
+        int m_ThreadsCount;
+        int m_FinishedCount;
+        bool m_AnyError;
     };
 }
 
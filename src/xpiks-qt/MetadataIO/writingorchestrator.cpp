@@ -22,10 +22,9 @@
 #include "writingorchestrator.h"
 #include <QVector>
 #include <QThread>
-#include "../Helpers/indiceshelper.h"
+#include <QThreadPool>
 #include "../Models/artworkmetadata.h"
 #include "../Common/defines.h"
-#include "exiv2writingworker.h"
 
 #if defined(TRAVIS_CI)
 #define MIN_SPLIT_COUNT 100
@@ -37,14 +36,23 @@
 #endif
 #endif
 
-#define MAX_WRITING_THREADS 10
+// writing is bound by disk and not by cpu so more
+// concurrent writers only make spinning disks seek
+#define MAX_WRITING_THREADS 4
 #define MIN_WRITING_THREADS 1
 
 namespace MetadataIO {
+    QThreadPool *getWritingThreadPool() {
+        static QThreadPool writingThreadPool;
+        writingThreadPool.setMaxThreadCount(MAX_WRITING_THREADS);
+        return &writingThreadPool;
+    }
+
     WritingOrchestrator::WritingOrchestrator(const QVector<Models::ArtworkMetadata *> &itemsToWrite,
                                              QObject *parent) :
         QObject(parent),
         m_ItemsToWrite(itemsToWrite),
+        m_WorkQueue(new WritingWorkQueue(itemsToWrite)),
         m_ThreadsCount(MIN_WRITING_THREADS),
         m_FinishedCount(0),
         m_AnyError(false)
@@ -53,40 +61,30 @@ namespace MetadataIO {
         if (size >= MIN_SPLIT_COUNT) {
             int idealThreadCount = qMin(qMax(QThread::idealThreadCount(), MIN_WRITING_THREADS), MAX_WRITING_THREADS);
             m_ThreadsCount = qMin(size, idealThreadCount);
-
-            m_ThreadsCount = Helpers::splitIntoChunks<Models::ArtworkMetadata*>(itemsToWrite, m_ThreadsCount, m_SlicedItemsToWrite);
-        } else {
-            m_SlicedItemsToWrite.push_back(itemsToWrite);
         }
 
-        LOG_INFO << "Using" << m_ThreadsCount << "threads for" << size << "items to read";
+        LOG_INFO << "Using" << m_ThreadsCount << "threads for" << size << "items to write";
     }
 
     WritingOrchestrator::~WritingOrchestrator() {
+        // workers still running will drain the queue without writing
+        m_WorkQueue->cancel();
         LOG_DEBUG << "destroyed";
     }
 
     void WritingOrchestrator::startWriting() {
         LOG_DEBUG << "#";
 
-        int size = m_SlicedItemsToWrite.size();
-        for (int i = 0; i < size; ++i) {
-            const QVector<Models::ArtworkMetadata *> &itemsToWrite = m_SlicedItemsToWrite.at(i);
-
-            Exiv2WritingWorker *worker = new Exiv2WritingWorker(i, itemsToWrite);
+        QThreadPool *threadPool = getWritingThreadPool();
 
-            QThread *thread = new QThread();
-            worker->moveToThread(thread);
-
-            QObject::connect(thread, SIGNAL(started()), worker, SLOT(process()));
-            QObject::connect(worker, SIGNAL(stopped()), thread, SLOT(quit()));
-
-            QObject::connect(worker, SIGNAL(stopped()), worker, SLOT(deleteLater()));
-            QObject::connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
+        for (int i = 0; i < m_ThreadsCount; ++i) {
+            Exiv2WritingWorker *worker = new Exiv2WritingWorker(i, m_WorkQueue);
 
+            QObject::connect(worker, SIGNAL(itemsWritten()), this, SLOT(onWorkerItemsWritten()));
             QObject::connect(worker, SIGNAL(finished(bool)), this, SLOT(onWorkerFinished(bool)));
+            QObject::connect(worker, SIGNAL(finished(bool)), worker, SLOT(deleteLater()));
 
-            thread->start();
+            threadPool->start(worker);
 
             LOG_INFO << "Started worker" << i;
         }
@@ -98,17 +96,35 @@ namespace MetadataIO {
         this->deleteLater();
     }
 
+    void WritingOrchestrator::onWorkerItemsWritten() {
+        Exiv2WritingWorker *worker = qobject_cast<Exiv2WritingWorker *>(sender());
+        Q_ASSERT(worker != NULL);
+
+        mergeWrittenIndices(worker);
+    }
+
     void WritingOrchestrator::onWorkerFinished(bool anyError) {
         Exiv2WritingWorker *worker = qobject_cast<Exiv2WritingWorker *>(sender());
         Q_ASSERT(worker != NULL);
 
         LOG_INFO << "#" << worker->getWorkerIndex() << "anyError:" << anyError;
 
-        worker->dismiss();
+        mergeWrittenIndices(worker);
+        m_AnyError = m_AnyError || anyError;
 
-        if (m_FinishedCount.fetchAndAddOrdered(1) == (m_ThreadsCount - 1)) {
+        m_FinishedCount++;
+        if (m_FinishedCount == m_ThreadsCount) {
             LOG_DEBUG << "Last worker finished";
             emit allFinished(!m_AnyError);
         }
     }
+
+    void WritingOrchestrator::mergeWrittenIndices(Exiv2WritingWorker *worker) {
+        QVector<int> indices;
+        worker->takeWrittenIndices(indices);
+
+        if (!indices.isEmpty()) {
+            emit itemsWritten(indices);
+        }
+    }
 }
@@ -24,8 +24,9 @@
 
 #include <QObject>
 #include <QVector>
-#include <QAtomicInt>
+#include <memory>
 #include "imetadatawriter.h"
+#include "exiv2writingworker.h"
 
 namespace Models {
     class ArtworkMetadata;
@@ -45,20 +46,26 @@ namespace MetadataIO {
 
     signals:
         void allStarted();
+        // indices of getItemsToWrite() which were just saved to disk
+        void itemsWritten(const QVector<int> &indices);
         void allFinished(bool anyError);
 
     public slots:
         void dismiss();
 
     private slots:
+        void onWorkerItemsWritten();
         void onWorkerFinished(bool anyError);
 
+    private:
+        void mergeWrittenIndices(Exiv2WritingWorker *worker);
+
     private:
         QVector<Models::ArtworkMetadata*> m_ItemsToWrite;
-        QVector<QVector<Models::ArtworkMetadata *> > m_SlicedItemsToWrite;
+        std::shared_ptr<WritingWorkQueue> m_WorkQueue;
         int m_ThreadsCount;
-        QAtomicInt m_FinishedCount;
-        volatile bool m_AnyError;
+        int m_FinishedCount;
+        bool m_AnyError;
     };
 }
 
@@ -47,14 +47,25 @@
 #include "../Helpers/constants.h"
 #include "../Helpers/stringhelper.h"
 #include "../QuickBuffer/quickbuffer.h"
+#include "../UndoRedo/addartworksitem.h"
 
 namespace Models {
     ArtItemsModel::ArtItemsModel(QObject *parent):
         AbstractListModel(parent),
         Common::BaseEntity(),
+        m_ScannedVectorsCount(0),
+        m_ScanCommandID(-1),
+        m_FilesUnavailableDuringScan(false),
         // all items before 1024 are reserved for internal models
         m_LastID(1024)
-    {}
+    {
+        QObject::connect(&m_DirectoryScanner, SIGNAL(filesFound(QStringList,QStringList,QStringList)),
+                         this, SLOT(onScannedFilesFound(QStringList,QStringList,QStringList)));
+        QObject::connect(&m_DirectoryScanner, SIGNAL(scanningFinished()),
+                         this, SLOT(onDirectoriesScanned()));
+        QObject::connect(&m_DirectoryScanner, SIGNAL(inProgressChanged()),
+                         this, SIGNAL(isScanningDirectoriesChanged()));
+    }
 
     ArtItemsModel::~ArtItemsModel() {
         for (auto *artwork: m_ArtworkList) {
@@ -330,17 +341,23 @@ namespace Models {
         }
 
         QStringList filesToImport;
-        filesToImport.reserve(files.size() + directories.size() * 10);
+        filesToImport.reserve(files.size());
 
         foreach(const QUrl &fileUrl, files) {
             filesToImport.append(fileUrl.toLocalFile());
         }
 
+        QStringList directoriesToScan;
+        directoriesToScan.reserve(directories.size());
+
         foreach(const QUrl &dirUrl, directories) {
-            doAddDirectory(dirUrl.toLocalFile(), filesToImport);
+            directoriesToScan.append(dirUrl.toLocalFile());
         }
 
-        int importedCount = addFiles(filesToImport);
+        // files from directories are added asynchronously
+        addDirectories(directoriesToScan);
+
+        int importedCount = filesToImport.isEmpty() ? 0 : addFiles(filesToImport);
         return importedCount;
     }
 
@@ -358,6 +375,30 @@ namespace Models {
         emit artworksChanged(false);
     }
 
+    void ArtItemsModel::setItemsSaved(const QVector<ArtworkMetadata *> &artworks) {
+        LOG_INFO << "Setting" << artworks.length() << "written item(s) saved";
+        QSet<ArtworkMetadata *> savedArtworks;
+        savedArtworks.reserve(artworks.size());
+        foreach (ArtworkMetadata *artwork, artworks) {
+            savedArtworks.insert(artwork);
+        }
+
+        QVector<int> indices;
+        indices.reserve(artworks.size());
+
+        const size_t size = m_ArtworkList.size();
+        for (size_t i = 0; i < size; ++i) {
+            if (savedArtworks.contains(m_ArtworkList.at(i))) {
+                indices.append((int)i);
+            }
+        }
+
+        // artworks could have been removed while writing
+        if (!indices.isEmpty()) {
+            setSelectedItemsSaved(indices);
+        }
+    }
+
     void ArtItemsModel::removeSelectedArtworks(QVector<int> &selectedIndices) {
         doRemoveItemsAtIndices(selectedIndices);
     }
@@ -510,6 +551,11 @@ namespace Models {
         return filesAdded;
     }
 
+    void ArtItemsModel::cancelDirectoriesScanning() {
+        LOG_DEBUG << "#";
+        m_DirectoryScanner.cancelScanning();
+    }
+
     int ArtItemsModel::addRecentFile(const QString &file) {
         LOG_INFO << file;
         int filesAdded = addFiles(QStringList() << file);
@@ -998,39 +1044,88 @@ namespace Models {
 
     int ArtItemsModel::addDirectories(const QStringList &directories) {
         LOG_INFO << directories;
-        int filesCount = 0;
-        QStringList files;
+        if (directories.isEmpty()) { return 0; }
+
+        // files are added in batches and directoriesAdded() is emitted in the end
+        m_DirectoryScanner.scanDirectories(directories);
+        return directories.count();
+    }
 
-        foreach(const QString &directory, directories) {
-            doAddDirectory(directory, files);
+    void ArtItemsModel::onScannedFilesFound(const QStringList &images, const QStringList &vectors, const QStringList &directories) {
+        LOG_INFO << images.length() << "file(s)";
+        Q_ASSERT(images.length() == vectors.length());
+        Q_ASSERT(images.length() == directories.length());
+
+        QHash<QString, QString> matchedVectors;
+        const int size = images.length();
+        for (int i = 0; i < size; ++i) {
+            const QString &vectorPath = vectors.at(i);
+            if (!vectorPath.isEmpty()) {
+                matchedVectors.insert(images.at(i), vectorPath);
+            }
         }
 
-        if (files.count() > 0) {
-            filesCount = addFiles(files);
+        std::shared_ptr<Commands::AddArtworksCommand> addArtworksCommand(new Commands::AddArtworksCommand(images, directories, matchedVectors));
+        std::shared_ptr<Commands::ICommandResult> result = m_CommandManager->processCommand(addArtworksCommand);
+        std::shared_ptr<Commands::AddArtworksCommandResult> addArtworksResult = std::dynamic_pointer_cast<Commands::AddArtworksCommandResult>(result);
+
+        if (addArtworksResult->m_NewFilesAdded == 0) { return; }
+
+        if (m_ScanCommandID == -1) {
+            m_ScanCommandID = addArtworksCommand->getCommandID();
         }
 
-        return filesCount;
+        m_ScannedArtworks += addArtworksResult->m_ArtworksToImport;
+        m_ScannedFiles += addArtworksResult->m_AddedFiles;
+        m_ScannedVectorsCount += addArtworksResult->m_AttachedVectorsCount;
+
+        for (auto &range: addArtworksResult->m_AddedRanges) {
+            if (!m_ScannedRanges.isEmpty() && (m_ScannedRanges.last().second + 1 == range.first)) {
+                m_ScannedRanges.last().second = range.second;
+            } else {
+                m_ScannedRanges.append(range);
+            }
+        }
     }
 
-    void ArtItemsModel::doAddDirectory(const QString &directory, QStringList &filesList) {
-        QDir dir(directory);
+    void ArtItemsModel::onDirectoriesScanned() {
+        const int filesCount = m_ScannedArtworks.size();
+        LOG_INFO << filesCount << "file(s) added from directories";
 
-        dir.setFilter(QDir::NoDotAndDotDot | QDir::Files);
+        if (filesCount > 0) {
+            // one import and one history item for the whole scan
+            m_CommandManager->readMetadata(m_ScannedArtworks, m_ScannedRanges);
 
-        QFileInfoList items = dir.entryInfoList();
-        int size = items.size();
-        filesList.reserve(filesList.size() + size);
+            std::unique_ptr<UndoRedo::IHistoryItem> addArtworksItem(new UndoRedo::AddArtworksHistoryItem(m_ScanCommandID, m_ScannedRanges));
+            m_CommandManager->recordHistoryItem(addArtworksItem);
 
-        for (int i = 0; i < size; ++i) {
-            QString filepath = items.at(i).absoluteFilePath();
-            filesList.append(filepath);
+            m_CommandManager->addToRecentFiles(m_ScannedFiles);
         }
 
-        LOG_INFO << filesList.length() << "file(s) found";
+        raiseArtworksAdded(filesCount, m_ScannedVectorsCount);
+
+        m_ScannedArtworks.clear();
+        m_ScannedRanges.clear();
+        m_ScannedFiles.clear();
+        m_ScannedVectorsCount = 0;
+        m_ScanCommandID = -1;
+
+        emit directoriesAdded(filesCount);
+
+        if (m_FilesUnavailableDuringScan) {
+            m_FilesUnavailableDuringScan = false;
+            onFilesUnavailableHandler();
+        }
     }
 
     int ArtItemsModel::addFiles(const QStringList &rawFilenames) {
         LOG_INFO << rawFilenames.length() << "file(s)";
+        if (getIsScanningDirectories()) {
+            // import of scanned files would be overwritten
+            LOG_WARNING << "Cannot add files while scanning directories";
+            return 0;
+        }
+
         QStringList filenames, vectors;
         filenames.reserve(rawFilenames.length());
         vectors.reserve(rawFilenames.length());
@@ -1183,6 +1278,12 @@ namespace Models {
     }
 
     void ArtItemsModel::doRemoveItemsInRanges(const QVector<QPair<int, int> > &rangesToRemove) {
+        if (getIsScanningDirectories()) {
+            // ranges of scanned artworks would be invalidated
+            LOG_WARNING << "Cannot remove artworks while scanning directories";
+            return;
+        }
+
         std::shared_ptr<Commands::RemoveArtworksCommand> removeArtworksCommand(new Commands::RemoveArtworksCommand(rangesToRemove));
 
         m_CommandManager->processCommand(removeArtworksCommand);
@@ -1206,6 +1307,12 @@ namespace Models {
 
     void ArtItemsModel::onFilesUnavailableHandler() {
         LOG_DEBUG << "#";
+        if (getIsScanningDirectories()) {
+            LOG_INFO << "Postponed until directories are scanned";
+            m_FilesUnavailableDuringScan = true;
+            return;
+        }
+
         Models::ArtworksRepository *artworksRepository = m_CommandManager->getArtworksRepository();
         size_t count = getArtworksCount();
 
@@ -37,6 +37,7 @@
 #include "../Common/ibasicartwork.h"
 #include "../Common/iartworkssource.h"
 #include "../Helpers/ifilenotavailablemodel.h"
+#include "directoryscanner.h"
 
 namespace Common {
     class BasicMetadataModel;
@@ -54,6 +55,7 @@ namespace Models {
     {
     Q_OBJECT
     Q_PROPERTY(int modifiedArtworksCount READ getModifiedArtworksCount NOTIFY modifiedArtworksCountChanged)
+    Q_PROPERTY(bool isScanningDirectories READ getIsScanningDirectories NOTIFY isScanningDirectoriesChanged)
 
     public:
         ArtItemsModel(QObject *parent=0);
@@ -82,6 +84,7 @@ namespace Models {
 
     public:
         int getModifiedArtworksCount();
+        bool getIsScanningDirectories() const { return m_DirectoryScanner.getInProgress(); }
 
         void updateModifiedCount() { emit modifiedArtworksCountChanged(); }
         void updateItems(const QVector<int> &indices, const QVector<int> &roles);
@@ -104,6 +107,7 @@ namespace Models {
         Q_INVOKABLE int dropFiles(const QList<QUrl> &urls);
 
         /*Q_INVOKABLE*/ void setSelectedItemsSaved(const QVector<int> &selectedIndices);
+        void setItemsSaved(const QVector<ArtworkMetadata *> &artworks);
 
         /*Q_INVOKABLE*/ void removeSelectedArtworks(QVector<int> &selectedIndices);
 
@@ -122,6 +126,7 @@ namespace Models {
         Q_INVOKABLE QString getArtworkDateTaken(int metadataIndex) const;
 
         Q_INVOKABLE int addRecentDirectory(const QString &directory);
+        Q_INVOKABLE void cancelDirectoriesScanning();
         Q_INVOKABLE int addRecentFile(const QString &file);
         Q_INVOKABLE void initDescriptionHighlighting(int metadataIndex, QQuickTextDocument *document);
         Q_INVOKABLE void initTitleHighlighting(int metadataIndex, QQuickTextDocument *document);
@@ -157,6 +162,10 @@ namespace Models {
         void userDictUpdateHandler(const QStringList &keywords, bool overwritten);
         void userDictClearedHandler();
 
+    private slots:
+        void onScannedFilesFound(const QStringList &images, const QStringList &vectors, const QStringList &directories);
+        void onDirectoriesScanned();
+
     public:
         virtual void removeItemsAtIndices(const QVector<QPair<int, int> > &ranges) override;
         void beginAccountingFiles(int filesCount);
@@ -185,7 +194,6 @@ namespace Models {
     private:
         void updateItemAtIndex(int metadataIndex);
         int addDirectories(const QStringList &directories);
-        void doAddDirectory(const QString &directory, QStringList &filesList);
         int addFiles(const QStringList &filepath);
 
     private:
@@ -195,6 +203,8 @@ namespace Models {
         void modifiedArtworksCountChanged();
         void artworksChanged(bool needToMoveCurrentItem);
         void artworksAdded(int imagesCount, int vectorsCount);
+        void directoriesAdded(int filesCount);
+        void isScanningDirectoriesChanged();
         void selectedArtworksRemoved(int count);
         void fileWithIndexUnavailable(int index);
         void unavailableArtworksFound();
@@ -230,6 +240,14 @@ namespace Models {
 #ifdef QT_DEBUG
         std::deque<ArtworkMetadata *> m_DestroyedList;
 #endif
+        DirectoryScanner m_DirectoryScanner;
+        // artworks added from scanned directories waiting for one import
+        QVector<ArtworkMetadata *> m_ScannedArtworks;
+        QVector<QPair<int, int> > m_ScannedRanges;
+        QStringList m_ScannedFiles;
+        int m_ScannedVectorsCount;
+        int m_ScanCommandID;
+        bool m_FilesUnavailableDuringScan;
         qint64 m_LastID;
     };
 }
@@ -33,10 +33,13 @@ namespace Models {
     ArtworksRepository::ArtworksRepository(QObject *parent) :
         AbstractListModel(parent),
         m_LastUnavailableFilesCount(0),
-        m_LastID(0)
+        m_LastID(0),
+        m_SourcesCountChanged(false)
     {
-        QObject::connect(&m_FilesWatcher, SIGNAL(fileChanged(const QString &)),
-                     this, SLOT(checkFileUnavailable(const QString &)));
+        QObject::connect(&m_FilesMonitor, SIGNAL(filesUnavailable(QStringList)),
+                         this, SLOT(onFilesUnavailable(QStringList)));
+        QObject::connect(&m_FilesMonitor, SIGNAL(directoriesChanged(QStringList)),
+                         this, SIGNAL(filesChangedInDirectories(QStringList)));
 
         m_Timer.setInterval(4000); //4 sec
         m_Timer.setSingleShot(true); //single shot
@@ -74,22 +77,66 @@ namespace Models {
     void ArtworksRepository::stopListeningToUnavailableFiles() {
         LOG_DEBUG << "#";
 
-        QStringList files = m_FilesWatcher.files();
-        if (!files.isEmpty()) {
-            m_FilesWatcher.removePaths(files);
+        m_FilesMonitor.clear();
+    }
+
+    void ArtworksRepository::prepareFiles(const QStringList &items, PreparedFiles &preparedFiles) const {
+        LOG_DEBUG << items.size() << "item(s)";
+
+        QSet<QString> batchSet, newDirectories;
+        batchSet.reserve(items.size());
+        QString directory;
+
+        foreach (const QString &filepath, items) {
+            if (m_FilesSet.contains(filepath) || batchSet.contains(filepath)) { continue; }
+
+            batchSet.insert(filepath);
+            if (!checkFileExists(filepath, directory)) { continue; }
+
+            appendPreparedFile(filepath, directory, newDirectories, preparedFiles);
         }
 
-        QStringList directories = m_FilesWatcher.directories();
-        if (!directories.isEmpty()) {
-            m_FilesWatcher.removePaths(directories);
+        preparedFiles.m_NewDirectoriesCount = newDirectories.size();
+    }
+
+    void ArtworksRepository::prepareScannedFiles(const QStringList &items, const QStringList &directories, PreparedFiles &preparedFiles) const {
+        Q_ASSERT(items.size() == directories.size());
+        const int size = items.size();
+        LOG_DEBUG << size << "item(s)";
+
+        QSet<QString> batchSet, newDirectories;
+        batchSet.reserve(size);
+
+        for (int i = 0; i < size; ++i) {
+            const QString &filepath = items.at(i);
+            if (m_FilesSet.contains(filepath) || batchSet.contains(filepath)) { continue; }
+
+            batchSet.insert(filepath);
+            appendPreparedFile(filepath, directories.at(i), newDirectories, preparedFiles);
+        }
+
+        preparedFiles.m_NewDirectoriesCount = newDirectories.size();
+    }
+
+    void ArtworksRepository::appendPreparedFile(const QString &filepath, const QString &directory,
+                                                QSet<QString> &newDirectories, PreparedFiles &preparedFiles) const {
+        preparedFiles.m_Filepaths.append(filepath);
+        preparedFiles.m_Directories.append(directory);
+
+        if (!m_DirectoryPathToIndex.contains(directory)) {
+            newDirectories.insert(directory);
         }
     }
 
     bool ArtworksRepository::beginAccountingFiles(const QStringList &items) {
         int count = getNewDirectoriesCount(items);
-        bool shouldAccountFiles = count > 0;
+        return beginAccountingDirectories(count);
+    }
+
+    bool ArtworksRepository::beginAccountingDirectories(int newDirectoriesCount) {
+        bool shouldAccountFiles = newDirectoriesCount > 0;
         if (shouldAccountFiles) {
-            beginInsertRows(QModelIndex(), rowCount(), rowCount() + count - 1);
+            beginInsertRows(QModelIndex(), rowCount(), rowCount() + newDirectoriesCount - 1);
         }
 
         return shouldAccountFiles;
@@ -99,36 +146,19 @@ namespace Models {
         if (filesWereAccounted) {
             endInsertRows();
         }
+
+        // accountFile() publishes new directories right away
+        if (m_SourcesCountChanged) {
+            m_SourcesCountChanged = false;
+            emit artworksSourcesCountChanged();
+        }
     }
 
     /*virtual */
     int ArtworksRepository::getNewDirectoriesCount(const QStringList &items) const {
-        QSet<QString> filteredFiles;
-
-        foreach (const QString &filepath, items) {
-            if (!m_FilesSet.contains(filepath)) {
-                filteredFiles.insert(filepath);
-            }
-        }
-
-        QSet<QString> filteredDirectories;
-
-        foreach (const QString &filepath, filteredFiles) {
-            QString directory;
-            if (checkFileExists(filepath, directory)) {
-                filteredDirectories.insert(directory);
-            }
-        }
-
-        int count = 0;
-        size_t phony;
-        foreach (const QString &directory, filteredDirectories) {
-            if (!tryFindDirectory(directory, phony)) {
-                count++;
-            }
-        }
-
-        return count;
+        PreparedFiles preparedFiles;
+        prepareFiles(items, preparedFiles);
+        return preparedFiles.m_NewDirectoriesCount;
     }
 
     int ArtworksRepository::getNewFilesCount(const QStringList &items) const {
@@ -159,9 +189,35 @@ namespace Models {
         bool wasModified = false;
         QString absolutePath;
 
-        if (this->checkFileExists(filepath, absolutePath) &&
-                !m_FilesSet.contains(filepath)) {
+        if (!m_FilesSet.contains(filepath) &&
+                this->checkFileExists(filepath, absolutePath)) {
+            bool isNewDirectory = false;
+            wasModified = doAccountFile(filepath, absolutePath, directoryID, isNewDirectory);
 
+            if (isNewDirectory) {
+                emit artworksSourcesCountChanged();
+            }
+        }
+
+        return wasModified;
+    }
+
+    bool ArtworksRepository::accountPreparedFile(const QString &filepath, const QString &directory, qint64 &directoryID) {
+        // sources count is published once in endAccountingFiles()
+        bool isNewDirectory = false;
+        bool wasModified = doAccountFile(filepath, directory, directoryID, isNewDirectory);
+
+        if (isNewDirectory) {
+            m_SourcesCountChanged = true;
+        }
+
+        return wasModified;
+    }
+
+    bool ArtworksRepository::doAccountFile(const QString &filepath, const QString &absolutePath, qint64 &directoryID, bool &isNewDirectory) {
+        bool wasModified = false;
+
+        if (!m_FilesSet.contains(filepath)) {
             int occurances = 0;
             size_t index;
             bool alreadyExists = tryFindDirectory(absolutePath, index);
@@ -172,8 +228,9 @@ namespace Models {
                 m_DirectoriesList.emplace_back(absolutePath, id, 0, true);
                 index = m_DirectoriesList.size() - 1;
                 m_DirectoryIdToIndex[id] = index;
+                m_DirectoryPathToIndex[absolutePath] = index;
                 directoryID = id;
-                emit artworksSourcesCountChanged();
+                isNewDirectory = true;
 #ifdef CORE_TESTS
                 if (m_CommandManager != nullptr)
 #endif
@@ -207,7 +264,7 @@ namespace Models {
             auto existingIndex = m_DirectoryIdToIndex[directoryID];
             auto &item = m_DirectoriesList[existingIndex];
             item.m_FilesCount--;
-            m_FilesWatcher.removePath(filepath);
+            m_FilesMonitor.unwatchFile(filepath);
             m_FilesSet.remove(filepath);
             result = true;
         }
@@ -216,7 +273,7 @@ namespace Models {
     }
 
     void ArtworksRepository::removeVector(const QString &vectorPath) {
-        m_FilesWatcher.removePath(vectorPath);
+        m_FilesMonitor.unwatchFile(vectorPath);
     }
 
     void ArtworksRepository::purgeUnavailableFiles() {
@@ -228,7 +285,7 @@ namespace Models {
     void ArtworksRepository::watchFilePaths(const QStringList &filePaths) {
 #ifndef CORE_TESTS
         if (!filePaths.empty()) {
-            m_FilesWatcher.addPaths(filePaths);
+            m_FilesMonitor.watchFiles(filePaths);
         }
 #else
         Q_UNUSED(filePaths);
@@ -238,7 +295,7 @@ namespace Models {
     void ArtworksRepository::unwatchFilePaths(const QStringList &filePaths) {
 #ifndef CORE_TESTS
         if (!filePaths.empty()) {
-            m_FilesWatcher.removePaths(filePaths);
+            m_FilesMonitor.unwatchFiles(filePaths);
         }
 #else
         Q_UNUSED(filePaths);
@@ -263,7 +320,7 @@ namespace Models {
 
     void ArtworksRepository::watchFilePath(const QString &filepath) {
 #ifndef CORE_TESTS
-        m_FilesWatcher.addPath(filepath);
+        m_FilesMonitor.watchFile(filepath);
 #else
         Q_UNUSED(filepath);
 #endif
@@ -291,6 +348,7 @@ namespace Models {
         m_DirectoriesList.clear();
         m_FilesSet.clear();
         m_DirectoryIdToIndex.clear();
+        m_DirectoryPathToIndex.clear();
     }
 #endif
 
@@ -426,20 +484,29 @@ namespace Models {
 
     bool ArtworksRepository::tryFindDirectory(const QString &directoryPath, size_t &index) const {
         bool found = false;
-        const size_t size = m_DirectoriesList.size();
+        auto it = m_DirectoryPathToIndex.constFind(directoryPath);
 
-        for (size_t i = 0; i < size; ++i) {
-            auto &item = m_DirectoriesList[i];
-            if (item.m_AbsolutePath == directoryPath) {
-                found = true;
-                index = i;
-                break;
-            }
+        if (it != m_DirectoryPathToIndex.constEnd()) {
+            index = it.value();
+            Q_ASSERT(m_DirectoriesList[index].m_AbsolutePath == directoryPath);
+            found = true;
         }
 
         return found;
     }
 
+    void ArtworksRepository::rebuildDirectoriesIndex() {
+        m_DirectoryIdToIndex.clear();
+        m_DirectoryPathToIndex.clear();
+
+        const size_t size = m_DirectoriesList.size();
+        for (size_t i = 0; i < size; ++i) {
+            auto &item = m_DirectoriesList[i];
+            m_DirectoryIdToIndex[item.m_Id] = i;
+            m_DirectoryPathToIndex[item.m_AbsolutePath] = i;
+        }
+    }
+
     QHash<int, QByteArray> ArtworksRepository::roleNames() const {
         QHash<int, QByteArray> roles;
         roles[PathRole] = "path";
@@ -466,16 +533,15 @@ namespace Models {
         return exists;
     }
 
-    void ArtworksRepository::checkFileUnavailable(const QString &path) {
-        LOG_INFO << "File changed:" << path;
+    void ArtworksRepository::onFilesUnavailable(const QStringList &filepaths) {
+        LOG_INFO << filepaths.size() << "file(s) became unavailable";
 
-        QFileInfo fi(path);
-        if (!fi.exists()) {
-            LOG_INFO << "File become unavailable:" << path;
-            m_UnavailableFiles.insert(fi.absoluteFilePath());
-            LOG_DEBUG << "Starting availability timer...";
-            m_Timer.start();
+        foreach (const QString &filepath, filepaths) {
+            m_UnavailableFiles.insert(filepath);
         }
+
+        LOG_DEBUG << "Starting availability timer...";
+        m_Timer.start();
     }
 
     void ArtworksRepository::onAvailabilityTimer() {
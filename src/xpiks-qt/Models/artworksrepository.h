@@ -27,13 +27,14 @@
 #include <QList>
 #include <QPair>
 #include <QSet>
+#include <QHash>
 #include <QTimer>
-#include <QFileSystemWatcher>
 
 #include <vector>
 
 #include "../Common/abstractlistmodel.h"
 #include "../Common/baseentity.h"
+#include "fileschangemonitor.h"
 
 namespace Models {
     class ArtworksRepository : public Common::AbstractListModel, public Common::BaseEntity {
@@ -57,7 +58,19 @@ namespace Models {
         void stopListeningToUnavailableFiles();
 
     public:
+        struct PreparedFiles {
+            // new existing files in original order with their directories
+            QStringList m_Filepaths;
+            QStringList m_Directories;
+            int m_NewDirectoriesCount = 0;
+        };
+
+    public:
+        void prepareFiles(const QStringList &items, PreparedFiles &preparedFiles) const;
+        // files found by directory scanner exist already and their directories are known
+        void prepareScannedFiles(const QStringList &items, const QStringList &directories, PreparedFiles &preparedFiles) const;
         bool beginAccountingFiles(const QStringList &items);
+        bool beginAccountingDirectories(int newDirectoriesCount);
         void endAccountingFiles(bool filesWereAccounted);
 
     public:
@@ -71,6 +84,7 @@ namespace Models {
         void artworksSourcesCountChanged();
         void fileChanged(const QString & path);
         void filesUnavailable();
+        void filesChangedInDirectories(const QStringList &directories);
 
 #ifdef CORE_TESTS
     public:
@@ -81,11 +95,12 @@ namespace Models {
 #endif
 
     private slots:
-        void checkFileUnavailable(const QString & path);
+        void onFilesUnavailable(const QStringList &filepaths);
         void onAvailabilityTimer();
 
     public:
         bool accountFile(const QString &filepath, qint64 &directoryID);
+        bool accountPreparedFile(const QString &filepath, const QString &directory, qint64 &directoryID);
         void accountVector(const QString &vectorPath);
         bool removeFile(const QString &filepath, qint64 directoryID);
         void removeVector(const QString &vectorPath);
@@ -96,6 +111,9 @@ namespace Models {
         void updateSelectedState();
 
     private:
+        bool doAccountFile(const QString &filepath, const QString &absolutePath, qint64 &directoryID, bool &isNewDirectory);
+        void appendPreparedFile(const QString &filepath, const QString &directory,
+                                QSet<QString> &newDirectories, PreparedFiles &preparedFiles) const;
         void watchFilePath(const QString &filepath);
         qint64 generateNextID() { qint64 id = m_LastID; m_LastID++; return id; }
 
@@ -130,6 +148,7 @@ namespace Models {
             changeSelectedState(index, newIsSelected, oldIsSelected);
             m_DirectoriesList.erase(m_DirectoriesList.begin() + index);
             m_DirectoryIdToIndex.remove(idToRemove);
+            rebuildDirectoriesIndex();
             emit artworksSourcesCountChanged();
         }
 
@@ -144,6 +163,7 @@ namespace Models {
         size_t retrieveSelectedDirsCount() const;
         bool allAreSelected() const;
         bool tryFindDirectory(const QString &directoryPath, size_t &index) const;
+        void rebuildDirectoriesIndex();
 
     private:
         struct RepoDir {
@@ -161,12 +181,15 @@ namespace Models {
     private:
         std::vector<RepoDir> m_DirectoriesList;
         QHash<qint64, size_t> m_DirectoryIdToIndex;
+        QHash<QString, size_t> m_DirectoryPathToIndex;
         QSet<QString> m_FilesSet;
-        QFileSystemWatcher m_FilesWatcher;
+        FilesChangeMonitor m_FilesMonitor;
         QTimer m_Timer;
         QSet<QString> m_UnavailableFiles;
         int m_LastUnavailableFilesCount;
         qint64 m_LastID;
+        // new directories of prepared files are published in endAccountingFiles()
+        bool m_SourcesCountChanged;
     };
 }
 
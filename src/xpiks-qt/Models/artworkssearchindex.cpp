@@ -0,0 +1,401 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "artworkssearchindex.h"
+#include "artworkmetadata.h"
+#include "../Common/basicmetadatamodel.h"
+#include "../Helpers/filterhelpers.h"
+#include "../Common/defines.h"
+
+namespace Models {
+    void splitToWords(const QString &text, QSet<QString> &words) {
+        const int size = text.size();
+        int start = -1;
+
+        for (int i = 0; i < size; ++i) {
+            if (text.at(i).isLetterOrNumber()) {
+                if (start == -1) { start = i; }
+            } else if (start != -1) {
+                words.insert(text.mid(start, i - start));
+                start = -1;
+            }
+        }
+
+        if (start != -1) {
+            words.insert(text.mid(start));
+        }
+    }
+
+    bool isSingleWord(const QString &term) {
+        bool anyFault = false;
+
+        for (const QChar &c: term) {
+            if (!c.isLetterOrNumber()) {
+                anyFault = true;
+                break;
+            }
+        }
+
+        return !anyFault;
+    }
+
+    ArtworksSearchIndex::ArtworksSearchIndex():
+        m_SearchFlags(Common::SearchFlags::None),
+        m_ResultsValid(false),
+        m_CanRefine(false),
+        m_CanUseIndex(false)
+    {
+    }
+
+    void ArtworksSearchIndex::setQuery(const QString &searchTerm, Common::SearchFlags searchFlags) {
+        const bool hadResults = m_CanUseIndex && m_ResultsValid;
+        const Common::SearchFlags previousFlags = m_SearchFlags;
+
+        QVector<QueryTerm> previousTerms;
+        previousTerms.swap(m_QueryTerms);
+
+        m_SearchTerm = searchTerm;
+        m_SearchFlags = searchFlags;
+        m_CanUseIndex = !Common::HasFlag(searchFlags, Common::SearchFlags::CaseSensitive) &&
+                !Common::HasFlag(searchFlags, Common::SearchFlags::IncludeSpaces);
+
+        const bool checkReserved = Common::HasFlag(searchFlags, Common::SearchFlags::ReservedTerms);
+        const QStringList parts = searchTerm.split(QChar::Space, QString::SkipEmptyParts);
+
+        for (const QString &part: parts) {
+            if (checkReserved && part.startsWith(QLatin1String("x:"))) {
+                // reserved terms depend on the state of artworks, not only on metadata
+                m_CanUseIndex = false;
+            }
+
+            QueryTerm term;
+            term.m_Term = part.toCaseFolded();
+            term.m_WholeKeyword = (term.m_Term.length() > 1) && (term.m_Term[0] == QLatin1Char('!'));
+            term.m_KeywordTerm = term.m_WholeKeyword ? term.m_Term.mid(1) : term.m_Term;
+            term.m_IsSingleWord = isSingleWord(term.m_Term);
+            m_QueryTerms.append(term);
+        }
+
+        m_CanRefine = m_CanUseIndex && hadResults &&
+                (previousFlags == searchFlags) &&
+                isRefinementOf(m_QueryTerms, previousTerms);
+
+        if (m_CanRefine) {
+            m_RefinedResults.swap(m_Results);
+        } else {
+            m_RefinedResults.clear();
+        }
+
+        m_Results.clear();
+        m_ResultsValid = false;
+
+        LOG_DEBUG << "Terms:" << m_QueryTerms.size() << "use index:" << m_CanUseIndex << "refine:" << m_CanRefine;
+    }
+
+    bool ArtworksSearchIndex::hasMatch(ArtworkMetadata *artwork) {
+        Q_ASSERT(artwork != NULL);
+
+        if (!m_CanUseIndex) {
+            return Helpers::hasSearchMatch(m_SearchTerm, artwork, m_SearchFlags);
+        }
+
+        auto it = m_Artworks.find(artwork);
+
+        if ((it == m_Artworks.end()) ||
+                (it->m_Revision != artwork->getBasicModel()->getRevision())) {
+            // new or edited artworks are checked right away
+            if (it == m_Artworks.end()) {
+                it = m_Artworks.insert(artwork, IndexedArtwork());
+            } else {
+                removePostings(artwork, *it);
+            }
+
+            reindexArtwork(artwork, *it);
+            const bool isMatch = matchesQuery(*it);
+
+            if (m_ResultsValid) {
+                if (isMatch) {
+                    m_Results.insert(artwork);
+                } else {
+                    m_Results.remove(artwork);
+                }
+            } else if (m_CanRefine) {
+                // previous results do not know about the new content
+                m_RefinedResults.insert(artwork);
+            }
+
+            return isMatch;
+        }
+
+        if (!m_ResultsValid) {
+            computeResults();
+        }
+
+        return m_Results.contains(artwork);
+    }
+
+    void ArtworksSearchIndex::removeArtwork(ArtworkMetadata *artwork) {
+        Q_ASSERT(artwork != NULL);
+
+        auto it = m_Artworks.find(artwork);
+        if (it != m_Artworks.end()) {
+            removePostings(artwork, *it);
+            m_Artworks.erase(it);
+        }
+
+        m_Results.remove(artwork);
+        m_RefinedResults.remove(artwork);
+    }
+
+    void ArtworksSearchIndex::clear() {
+        LOG_DEBUG << "#";
+        m_Artworks.clear();
+        m_Postings.clear();
+        m_Results.clear();
+        m_RefinedResults.clear();
+        m_ResultsValid = false;
+        m_CanRefine = false;
+    }
+
+    void ArtworksSearchIndex::indexArtwork(ArtworkMetadata *artwork, IndexedArtwork &indexed) {
+        Common::BasicMetadataModel *basicModel = artwork->getBasicModel();
+
+        // revision is read before the data so concurrent edit leaves the entry stale
+        indexed.m_Revision = basicModel->getRevision();
+        indexed.m_Description = artwork->getDescription().toCaseFolded();
+        indexed.m_Title = artwork->getTitle().toCaseFolded();
+        indexed.m_Filepath = artwork->getFilepath().toCaseFolded();
+
+        indexed.m_Keywords = artwork->getKeywords();
+        for (QString &keyword: indexed.m_Keywords) {
+            keyword = keyword.toCaseFolded();
+        }
+
+        QSet<QString> words;
+        splitToWords(indexed.m_Description, words);
+        splitToWords(indexed.m_Title, words);
+        splitToWords(indexed.m_Filepath, words);
+        for (const QString &keyword: indexed.m_Keywords) {
+            splitToWords(keyword, words);
+        }
+
+        indexed.m_Words = words.toList();
+    }
+
+    void ArtworksSearchIndex::addPostings(ArtworkMetadata *artwork, const IndexedArtwork &indexed) {
+        for (const QString &word: indexed.m_Words) {
+            m_Postings[word].insert(artwork);
+        }
+    }
+
+    void ArtworksSearchIndex::removePostings(ArtworkMetadata *artwork, const IndexedArtwork &indexed) {
+        for (const QString &word: indexed.m_Words) {
+            auto it = m_Postings.find(word);
+            if (it == m_Postings.end()) { continue; }
+
+            it->remove(artwork);
+            if (it->isEmpty()) {
+                m_Postings.erase(it);
+            }
+        }
+    }
+
+    void ArtworksSearchIndex::reindexArtwork(ArtworkMetadata *artwork, IndexedArtwork &indexed) {
+        indexArtwork(artwork, indexed);
+        addPostings(artwork, indexed);
+    }
+
+    void ArtworksSearchIndex::refreshChangedArtworks(QSet<ArtworkMetadata *> &changedArtworks) {
+        auto it = m_Artworks.begin();
+        auto itEnd = m_Artworks.end();
+
+        for (; it != itEnd; ++it) {
+            ArtworkMetadata *artwork = it.key();
+            IndexedArtwork &indexed = it.value();
+            if (indexed.m_Revision == artwork->getBasicModel()->getRevision()) { continue; }
+
+            removePostings(artwork, indexed);
+            reindexArtwork(artwork, indexed);
+            changedArtworks.insert(artwork);
+        }
+
+        if (!changedArtworks.isEmpty()) {
+            LOG_DEBUG << "Reindexed" << changedArtworks.size() << "artworks";
+        }
+    }
+
+    void ArtworksSearchIndex::computeResults() {
+        QSet<ArtworkMetadata *> changedArtworks;
+        refreshChangedArtworks(changedArtworks);
+
+        QSet<ArtworkMetadata *> candidates;
+
+        if (m_CanRefine) {
+            candidates.swap(m_RefinedResults);
+            candidates.unite(changedArtworks);
+        } else {
+            const bool searchUsingAnd = Common::HasFlag(m_SearchFlags, Common::SearchFlags::AllTerms);
+            bool isFirst = true;
+
+            for (const QueryTerm &term: m_QueryTerms) {
+                QSet<ArtworkMetadata *> termCandidates;
+                collectCandidates(term, termCandidates);
+
+                if (isFirst) {
+                    candidates.swap(termCandidates);
+                    isFirst = false;
+                } else if (searchUsingAnd) {
+                    candidates.intersect(termCandidates);
+                } else {
+                    candidates.unite(termCandidates);
+                }
+            }
+        }
+
+        m_Results.clear();
+        m_Results.reserve(candidates.size());
+
+        for (ArtworkMetadata *artwork: candidates) {
+            auto it = m_Artworks.constFind(artwork);
+            if (it == m_Artworks.constEnd()) { continue; }
+
+            if (matchesQuery(it.value())) {
+                m_Results.insert(artwork);
+            }
+        }
+
+        m_ResultsValid = true;
+        LOG_DEBUG << "Checked" << candidates.size() << "of" << m_Artworks.size() << "artworks," << m_Results.size() << "match";
+    }
+
+    void ArtworksSearchIndex::collectCandidates(const QueryTerm &term, QSet<ArtworkMetadata *> &candidates) const {
+        if (!term.m_IsSingleWord) {
+            // such terms may span several words or contain punctuation
+            for (auto it = m_Artworks.constBegin(), itEnd = m_Artworks.constEnd(); it != itEnd; ++it) {
+                candidates.insert(it.key());
+            }
+
+            return;
+        }
+
+        for (auto it = m_Postings.constBegin(), itEnd = m_Postings.constEnd(); it != itEnd; ++it) {
+            if (it.key().contains(term.m_Term)) {
+                candidates.unite(it.value());
+            }
+        }
+    }
+
+    bool ArtworksSearchIndex::matchesTerm(const IndexedArtwork &indexed, const QueryTerm &term) const {
+        if (Common::HasFlag(m_SearchFlags, Common::SearchFlags::Description) &&
+                indexed.m_Description.contains(term.m_Term)) {
+            return true;
+        }
+
+        if (Common::HasFlag(m_SearchFlags, Common::SearchFlags::Title) &&
+                indexed.m_Title.contains(term.m_Term)) {
+            return true;
+        }
+
+        if (Common::HasFlag(m_SearchFlags, Common::SearchFlags::Filepath) &&
+                indexed.m_Filepath.contains(term.m_Term)) {
+            return true;
+        }
+
+        bool hasMatch = false;
+
+        if (Common::HasFlag(m_SearchFlags, Common::SearchFlags::Keywords)) {
+            for (const QString &keyword: indexed.m_Keywords) {
+                hasMatch = term.m_WholeKeyword ?
+                            (keyword == term.m_KeywordTerm) :
+                            keyword.contains(term.m_KeywordTerm);
+                if (hasMatch) { break; }
+            }
+        }
+
+        return hasMatch;
+    }
+
+    bool ArtworksSearchIndex::matchesQuery(const IndexedArtwork &indexed) const {
+        const bool searchUsingAnd = Common::HasFlag(m_SearchFlags, Common::SearchFlags::AllTerms);
+        bool hasMatch = searchUsingAnd;
+
+        for (const QueryTerm &term: m_QueryTerms) {
+            const bool termMatches = matchesTerm(indexed, term);
+
+            if (searchUsingAnd && !termMatches) {
+                hasMatch = false;
+                break;
+            }
+
+            if (!searchUsingAnd && termMatches) {
+                hasMatch = true;
+                break;
+            }
+        }
+
+        return hasMatch;
+    }
+
+    bool ArtworksSearchIndex::isRefinementOf(const QVector<QueryTerm> &terms, const QVector<QueryTerm> &previousTerms) const {
+        if (terms.isEmpty() || previousTerms.isEmpty()) { return false; }
+
+        for (const QueryTerm &term: terms) {
+            if (term.m_WholeKeyword) { return false; }
+        }
+
+        for (const QueryTerm &term: previousTerms) {
+            if (term.m_WholeKeyword) { return false; }
+        }
+
+        // a term containing another term can match only where the other one does
+        if (Common::HasFlag(m_SearchFlags, Common::SearchFlags::AllTerms)) {
+            // every previous term is implied by some of the new terms
+            for (const QueryTerm &previous: previousTerms) {
+                bool anyImplies = false;
+
+                for (const QueryTerm &term: terms) {
+                    if (term.m_Term.contains(previous.m_Term)) {
+                        anyImplies = true;
+                        break;
+                    }
+                }
+
+                if (!anyImplies) { return false; }
+            }
+        } else {
+            // every new term implies some of the previous terms
+            for (const QueryTerm &term: terms) {
+                bool anyImplied = false;
+
+                for (const QueryTerm &previous: previousTerms) {
+                    if (term.m_Term.contains(previous.m_Term)) {
+                        anyImplied = true;
+                        break;
+                    }
+                }
+
+                if (!anyImplied) { return false; }
+            }
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,103 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARTWORKSSEARCHINDEX_H
+#define ARTWORKSSEARCHINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include "../Common/flags.h"
+
+namespace Models {
+    class ArtworkMetadata;
+
+    /*
+     * Case-folded metadata of artworks with postings from words to artworks.
+     * Only artworks whose metadata revision changed are reindexed, and
+     * a query extending the previous one checks only previous results.
+     * Matching is the same as in Helpers::hasSearchMatch().
+    */
+    class ArtworksSearchIndex
+    {
+    public:
+        ArtworksSearchIndex();
+
+    public:
+        void setQuery(const QString &searchTerm, Common::SearchFlags searchFlags);
+        bool hasMatch(ArtworkMetadata *artwork);
+        void removeArtwork(ArtworkMetadata *artwork);
+        void clear();
+
+#ifdef CORE_TESTS
+        int getIndexedCount() const { return m_Artworks.size(); }
+#endif
+
+    private:
+        struct IndexedArtwork {
+            int m_Revision;
+            QString m_Description;
+            QString m_Title;
+            QString m_Filepath;
+            QStringList m_Keywords;
+            QStringList m_Words;
+        };
+
+        struct QueryTerm {
+            // as typed and case-folded
+            QString m_Term;
+            // term to check keywords with
+            QString m_KeywordTerm;
+            bool m_WholeKeyword;
+            // such terms cannot span words so they can be found from postings
+            bool m_IsSingleWord;
+        };
+
+    private:
+        void indexArtwork(ArtworkMetadata *artwork, IndexedArtwork &indexed);
+        void addPostings(ArtworkMetadata *artwork, const IndexedArtwork &indexed);
+        void removePostings(ArtworkMetadata *artwork, const IndexedArtwork &indexed);
+        void reindexArtwork(ArtworkMetadata *artwork, IndexedArtwork &indexed);
+        void refreshChangedArtworks(QSet<ArtworkMetadata *> &changedArtworks);
+        void computeResults();
+        void collectCandidates(const QueryTerm &term, QSet<ArtworkMetadata *> &candidates) const;
+        bool matchesTerm(const IndexedArtwork &indexed, const QueryTerm &term) const;
+        bool matchesQuery(const IndexedArtwork &indexed) const;
+        bool isRefinementOf(const QVector<QueryTerm> &terms, const QVector<QueryTerm> &previousTerms) const;
+
+    private:
+        QHash<ArtworkMetadata *, IndexedArtwork> m_Artworks;
+        QHash<QString, QSet<ArtworkMetadata *> > m_Postings;
+        QVector<QueryTerm> m_QueryTerms;
+        QSet<ArtworkMetadata *> m_Results;
+        // results of the previous query if the current one only narrows it
+        QSet<ArtworkMetadata *> m_RefinedResults;
+        QString m_SearchTerm;
+        Common::SearchFlags m_SearchFlags;
+        bool m_ResultsValid;
+        bool m_CanRefine;
+        bool m_CanUseIndex;
+    };
+}
+
+#endif // ARTWORKSSEARCHINDEX_H
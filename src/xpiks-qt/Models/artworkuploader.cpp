@@ -35,11 +35,16 @@
 #include "../Conectivity/uploadcontext.h"
 #include "../Models/imageartwork.h"
 #include "../Conectivity/ftphelpers.h"
+#include "../Conectivity/archivespipeline.h"
+#include "../Models/ziparchiver.h"
 
 #ifndef CORE_TESTS
 #include "../Conectivity/ftpcoordinator.h"
 #endif
 
+// max archives created but not yet uploaded to all hosts
+#define ARCHIVES_PIPELINE_DEPTH 4
+
 namespace Models {
     ArtworkUploader::ArtworkUploader(Conectivity::IFtpCoordinator *ftpCoordinator, QObject *parent):
         ArtworksProcessor(parent),
@@ -85,6 +90,17 @@ namespace Models {
 
     void ArtworkUploader::allFinished(bool anyError) {
         LOG_INFO << "anyError =" << anyError;
+
+        if (m_ArchivesPipeline) {
+            int failedArchives = m_ArchivesPipeline->getFailedCount();
+            if (failedArchives > 0) {
+                LOG_WARNING << failedArchives << "archive(s) were not created";
+                anyError = true;
+            }
+
+            m_ArchivesPipeline.reset();
+        }
+
         setIsError(anyError);
         endProcessing();
         m_Percent = 100;
@@ -176,6 +192,72 @@ namespace Models {
         return needCreate;
     }
 
+    bool ArtworkUploader::canPipelineArchives() const {
+        const UploadInfoRepository *uploadInfoRepository = m_CommandManager->getUploadInfoRepository();
+        auto &infos = uploadInfoRepository->getUploadInfos();
+        int selectedHostsCount = 0, zipHostsCount = 0;
+
+        for (auto &info: infos) {
+            if (!info->getIsSelected()) { continue; }
+
+            selectedHostsCount++;
+            if (info->getZipBeforeUpload()) {
+                zipHostsCount++;
+            }
+        }
+
+        // every zip host has to be uploading at the same time
+        // otherwise waiting one will block archives in the pipeline
+        // and hosts without zipping take parallel uploads as well
+        Conectivity::FtpCoordinator *coordinator = dynamic_cast<Conectivity::FtpCoordinator *>(m_FtpCoordinator);
+        Q_ASSERT(coordinator != NULL);
+        bool canPipeline = (zipHostsCount > 0) && (selectedHostsCount <= coordinator->getMaxParallelUploads());
+
+        LOG_DEBUG << "hosts:" << selectedHostsCount << "zip hosts:" << zipHostsCount << "can pipeline:" << canPipeline;
+        return canPipeline;
+    }
+
+    void ArtworkUploader::zipAndUploadArtworks() {
+        const QVector<ArtworkMetadata *> &artworkList = getArtworkList();
+        if (artworkList.isEmpty()) {
+            return;
+        }
+
+        UploadInfoRepository *uploadInfoRepository = m_CommandManager->getUploadInfoRepository();
+        std::vector<std::shared_ptr<Models::UploadInfo> > selectedInfos = std::move(uploadInfoRepository->retrieveSelectedUploadInfos());
+
+        int zipHostsCount = 0;
+        for (auto &info: selectedInfos) {
+            if (info->getZipBeforeUpload()) {
+                zipHostsCount++;
+            }
+        }
+
+        if (zipHostsCount == 0) {
+            LOG_WARNING << "No hosts need archives";
+            doUploadArtworks(artworkList);
+            return;
+        }
+
+        ZipArchiver *zipArchiver = m_CommandManager->getZipArchiver();
+        zipArchiver->setArtworks(artworkList);
+        int archivesCount = zipArchiver->getItemsCount();
+
+        LOG_INFO << "Pipelining" << archivesCount << "archive(s) to" << zipHostsCount << "host(s)";
+        m_ArchivesPipeline.reset(new Conectivity::ArchivesPipeline(ARCHIVES_PIPELINE_DEPTH, zipHostsCount, archivesCount));
+
+        uploadInfoRepository->resetPercents();
+        uploadInfoRepository->updatePercentages();
+
+        // uploaders should wait for archives before zipping starts
+        m_FtpCoordinator->uploadArtworks(artworkList, selectedInfos, m_ArchivesPipeline);
+        m_CommandManager->reportUserAction(Conectivity::UserAction::Upload);
+
+        zipArchiver->resetModel();
+        zipArchiver->setArchivesPipeline(m_ArchivesPipeline);
+        zipArchiver->archiveArtworks();
+    }
+
     void ArtworkUploader::initializeStocksList() {
         QTimer::singleShot(1000, this, SLOT(updateStocksList()));
     }
@@ -198,6 +280,10 @@ namespace Models {
     }
 
     void ArtworkUploader::cancelProcessing() {
+        if (m_ArchivesPipeline) {
+            m_ArchivesPipeline->cancel();
+        }
+
         m_FtpCoordinator->cancelUpload();
     }
 
@@ -25,6 +25,7 @@
 #include <QAbstractListModel>
 #include <QStringList>
 #include <QFutureWatcher>
+#include <memory>
 #include "artworksprocessor.h"
 #include "../Conectivity/testconnection.h"
 #include "../AutoComplete/stringfilterproxymodel.h"
@@ -37,6 +38,7 @@ namespace Helpers {
 
 namespace Conectivity {
     class IFtpCoordinator;
+    class ArchivesPipeline;
 }
 
 namespace Commands {
@@ -78,6 +80,9 @@ namespace Models {
 
     public:
         Q_INVOKABLE void uploadArtworks();
+        // archives are created and uploaded at the same time
+        Q_INVOKABLE bool canPipelineArchives() const;
+        Q_INVOKABLE void zipAndUploadArtworks();
         Q_INVOKABLE void checkCredentials(const QString &host, const QString &username,
                                           const QString &password, bool disablePassiveMode, bool disableEPSV) const;
         Q_INVOKABLE bool needCreateArchives() const;
@@ -108,6 +113,7 @@ namespace Models {
         AutoComplete::StringFilterProxyModel m_StocksCompletionSource;
         AutoComplete::StocksFtpListModel m_StocksFtpList;
         QFutureWatcher<Conectivity::ContextValidationResult> *m_TestingCredentialWatcher;
+        std::shared_ptr<Conectivity::ArchivesPipeline> m_ArchivesPipeline;
         int m_Percent;
     };
 }
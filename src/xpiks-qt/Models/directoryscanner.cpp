@@ -0,0 +1,225 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "directoryscanner.h"
+#include <QtConcurrent>
+#include <QDir>
+#include <QHash>
+#include "../Common/defines.h"
+
+#define SCANNED_FILES_BATCH_SIZE 500
+
+namespace Models {
+    ScannedDirectory scanDirectory(const QString &directory) {
+        ScannedDirectory result;
+        QDir dir(directory);
+
+        // one listing per directory instead of a stat per candidate
+        const QStringList entries = dir.entryList(QDir::Files | QDir::NoDotAndDotDot, QDir::Name);
+        const int size = entries.size();
+
+        QStringList images;
+        images.reserve(size);
+        QHash<QString, QString> vectorsByBasename;
+
+        for (const QString &name: entries) {
+            const int dotIndex = name.lastIndexOf(QLatin1Char('.'));
+            if (dotIndex == -1) { continue; }
+
+            const QString suffix = name.mid(dotIndex + 1).toLower();
+
+            if ((suffix == QLatin1String("jpg")) || (suffix == QLatin1String("jpeg")) ||
+                    (suffix == QLatin1String("tiff")) || (suffix == QLatin1String("tif"))) {
+                images.append(name);
+            } else if ((suffix == QLatin1String("eps")) || (suffix == QLatin1String("ai"))) {
+                const QString basename = name.section(QLatin1Char('.'), 0, 0).toLower();
+                // eps wins over ai same as in vectors autodetection
+                if ((suffix == QLatin1String("eps")) || !vectorsByBasename.contains(basename)) {
+                    vectorsByBasename.insert(basename, name);
+                }
+            }
+        }
+
+        result.m_Images.reserve(images.size());
+        result.m_Vectors.reserve(images.size());
+        result.m_Directories.reserve(images.size());
+
+        const QString absoluteDirectory = dir.absolutePath();
+
+        for (const QString &name: images) {
+            result.m_Images.append(dir.absoluteFilePath(name));
+            result.m_Directories.append(absoluteDirectory);
+
+            const QString basename = name.section(QLatin1Char('.'), 0, 0).toLower();
+            auto it = vectorsByBasename.constFind(basename);
+            if (it != vectorsByBasename.constEnd()) {
+                result.m_Vectors.append(dir.absoluteFilePath(it.value()));
+            } else {
+                result.m_Vectors.append(QString());
+            }
+        }
+
+        LOG_INFO << result.m_Images.size() << "image(s) found in" << directory;
+        return result;
+    }
+
+    DirectoryScanner::DirectoryScanner(QObject *parent):
+        QObject(parent),
+        m_ScanWatcher(NULL),
+        m_PendingOffset(0),
+        m_InProgress(false)
+    {
+        m_BatchTimer.setInterval(0);
+        m_BatchTimer.setSingleShot(false);
+        QObject::connect(&m_BatchTimer, SIGNAL(timeout()), this, SLOT(onBatchTimer()));
+    }
+
+    DirectoryScanner::~DirectoryScanner() {
+        stopWatcher();
+    }
+
+    void DirectoryScanner::scanDirectories(const QStringList &directories) {
+        LOG_INFO << directories.size() << "directory(ies)";
+        if (directories.isEmpty()) { return; }
+
+        setInProgress(true);
+
+        if (m_ScanWatcher != NULL) {
+            LOG_DEBUG << "Scan is in progress. Queueing directories";
+            m_QueuedDirectories.append(directories);
+        } else {
+            startScanning(directories);
+        }
+    }
+
+    void DirectoryScanner::cancelScanning() {
+        LOG_INFO << "#";
+        if (!m_InProgress) { return; }
+
+        stopWatcher();
+        m_BatchTimer.stop();
+        m_QueuedDirectories.clear();
+        m_PendingImages.clear();
+        m_PendingVectors.clear();
+        m_PendingDirectories.clear();
+        m_PendingOffset = 0;
+
+        setInProgress(false);
+        emit scanningFinished();
+    }
+
+    void DirectoryScanner::onDirectoryScanned(int index) {
+        QFutureWatcher<ScannedDirectory> *watcher = qobject_cast<QFutureWatcher<ScannedDirectory> *>(sender());
+        if ((watcher == NULL) || (watcher != m_ScanWatcher)) { return; }
+
+        const ScannedDirectory &scanned = watcher->resultAt(index);
+        if (scanned.m_Images.isEmpty()) { return; }
+
+        m_PendingImages.append(scanned.m_Images);
+        m_PendingVectors.append(scanned.m_Vectors);
+        m_PendingDirectories.append(scanned.m_Directories);
+
+        if (!m_BatchTimer.isActive()) {
+            m_BatchTimer.start();
+        }
+    }
+
+    void DirectoryScanner::onAllScanned() {
+        QFutureWatcher<ScannedDirectory> *watcher = qobject_cast<QFutureWatcher<ScannedDirectory> *>(sender());
+        if ((watcher == NULL) || (watcher != m_ScanWatcher)) { return; }
+
+        LOG_DEBUG << "#";
+        m_ScanWatcher = NULL;
+        watcher->deleteLater();
+
+        if (!m_QueuedDirectories.isEmpty()) {
+            QStringList directories;
+            directories.swap(m_QueuedDirectories);
+            startScanning(directories);
+        } else {
+            finishIfDone();
+        }
+    }
+
+    void DirectoryScanner::onBatchTimer() {
+        const int pendingCount = m_PendingImages.size() - m_PendingOffset;
+        if (pendingCount <= 0) {
+            m_BatchTimer.stop();
+            finishIfDone();
+            return;
+        }
+
+        const int batchSize = qMin(pendingCount, SCANNED_FILES_BATCH_SIZE);
+        QStringList images = m_PendingImages.mid(m_PendingOffset, batchSize);
+        QStringList vectors = m_PendingVectors.mid(m_PendingOffset, batchSize);
+        QStringList directories = m_PendingDirectories.mid(m_PendingOffset, batchSize);
+        m_PendingOffset += batchSize;
+
+        if (m_PendingOffset == m_PendingImages.size()) {
+            m_PendingImages.clear();
+            m_PendingVectors.clear();
+            m_PendingDirectories.clear();
+            m_PendingOffset = 0;
+        }
+
+        LOG_DEBUG << "Handing out" << batchSize << "file(s)";
+        emit filesFound(images, vectors, directories);
+    }
+
+    void DirectoryScanner::startScanning(const QStringList &directories) {
+        Q_ASSERT(m_ScanWatcher == NULL);
+
+        // new watcher for every run so results of a cancelled one never arrive
+        m_ScanWatcher = new QFutureWatcher<ScannedDirectory>(this);
+        QObject::connect(m_ScanWatcher, SIGNAL(resultReadyAt(int)), this, SLOT(onDirectoryScanned(int)));
+        QObject::connect(m_ScanWatcher, SIGNAL(finished()), this, SLOT(onAllScanned()));
+
+        m_ScanWatcher->setFuture(QtConcurrent::mapped(directories, scanDirectory));
+    }
+
+    void DirectoryScanner::stopWatcher() {
+        if (m_ScanWatcher == NULL) { return; }
+
+        QFutureWatcher<ScannedDirectory> *watcher = m_ScanWatcher;
+        m_ScanWatcher = NULL;
+
+        watcher->disconnect(this);
+        watcher->cancel();
+        watcher->waitForFinished();
+        watcher->deleteLater();
+    }
+
+    void DirectoryScanner::finishIfDone() {
+        const bool anyPending = m_PendingOffset < m_PendingImages.size();
+        if ((m_ScanWatcher == NULL) && !anyPending && m_InProgress) {
+            LOG_INFO << "Scanning finished";
+            setInProgress(false);
+            emit scanningFinished();
+        }
+    }
+
+    void DirectoryScanner::setInProgress(bool value) {
+        if (m_InProgress != value) {
+            m_InProgress = value;
+            emit inProgressChanged();
+        }
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DIRECTORYSCANNER_H
+#define DIRECTORYSCANNER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <QFutureWatcher>
+
+namespace Models {
+    struct ScannedDirectory {
+        QStringList m_Images;
+        // attached vector for every image or empty string
+        QStringList m_Vectors;
+        // absolute directory of every image so the GUI thread does not stat them
+        QStringList m_Directories;
+    };
+
+    ScannedDirectory scanDirectory(const QString &directory);
+
+    /*
+     * Lists directories in parallel on the thread pool and matches
+     * images with vectors from the same listing. Found files are
+     * handed out in batches from the event loop so that adding them
+     * does not block the UI for the whole scan.
+    */
+    class DirectoryScanner : public QObject
+    {
+        Q_OBJECT
+    public:
+        explicit DirectoryScanner(QObject *parent=0);
+        virtual ~DirectoryScanner();
+
+    public:
+        bool getInProgress() const { return m_InProgress; }
+        void scanDirectories(const QStringList &directories);
+        void cancelScanning();
+
+    signals:
+        void filesFound(const QStringList &images, const QStringList &vectors, const QStringList &directories);
+        void scanningFinished();
+        void inProgressChanged();
+
+    private slots:
+        void onDirectoryScanned(int index);
+        void onAllScanned();
+        void onBatchTimer();
+
+    private:
+        void startScanning(const QStringList &directories);
+        void stopWatcher();
+        void finishIfDone();
+        void setInProgress(bool value);
+
+    private:
+        QFutureWatcher<ScannedDirectory> *m_ScanWatcher;
+        QTimer m_BatchTimer;
+        QStringList m_QueuedDirectories;
+        QStringList m_PendingImages;
+        QStringList m_PendingVectors;
+        QStringList m_PendingDirectories;
+        int m_PendingOffset;
+        bool m_InProgress;
+    };
+}
+
+#endif // DIRECTORYSCANNER_H
@@ -0,0 +1,180 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fileschangemonitor.h"
+#include <QFileInfo>
+#include <QDir>
+#include "../Common/defines.h"
+
+#define CHANGES_COALESCE_INTERVAL 500
+
+namespace Models {
+    FilesChangeMonitor::FilesChangeMonitor(QObject *parent):
+        QObject(parent),
+        m_WatchedFilesCount(0)
+    {
+        m_CoalesceTimer.setInterval(CHANGES_COALESCE_INTERVAL);
+        m_CoalesceTimer.setSingleShot(true);
+
+        QObject::connect(&m_CoalesceTimer, SIGNAL(timeout()), this, SLOT(onCoalesceTimer()));
+        QObject::connect(&m_Watcher, SIGNAL(directoryChanged(QString)), this, SLOT(onDirectoryChanged(QString)));
+    }
+
+    void FilesChangeMonitor::watchFiles(const QStringList &filepaths) {
+        QStringList newDirectories;
+
+        foreach (const QString &filepath, filepaths) {
+            addFile(filepath, newDirectories);
+        }
+
+        if (!newDirectories.isEmpty()) {
+            LOG_DEBUG << "Watching" << newDirectories.size() << "new directory(ies)";
+            m_Watcher.addPaths(newDirectories);
+        }
+    }
+
+    void FilesChangeMonitor::unwatchFiles(const QStringList &filepaths) {
+        QStringList emptyDirectories;
+
+        foreach (const QString &filepath, filepaths) {
+            removeFile(filepath, emptyDirectories);
+        }
+
+        if (!emptyDirectories.isEmpty()) {
+            LOG_DEBUG << "Unwatching" << emptyDirectories.size() << "directory(ies)";
+            m_Watcher.removePaths(emptyDirectories);
+        }
+    }
+
+    void FilesChangeMonitor::watchFile(const QString &filepath) {
+        watchFiles(QStringList() << filepath);
+    }
+
+    void FilesChangeMonitor::unwatchFile(const QString &filepath) {
+        unwatchFiles(QStringList() << filepath);
+    }
+
+    void FilesChangeMonitor::clear() {
+        LOG_DEBUG << "#";
+        m_CoalesceTimer.stop();
+        m_ChangedDirectories.clear();
+
+        QStringList directories = m_Watcher.directories();
+        if (!directories.isEmpty()) {
+            m_Watcher.removePaths(directories);
+        }
+
+        m_WatchedFiles.clear();
+        m_WatchedFilesCount = 0;
+    }
+
+    void FilesChangeMonitor::onDirectoryChanged(const QString &directory) {
+        m_ChangedDirectories.insert(directory);
+
+        if (!m_CoalesceTimer.isActive()) {
+            m_CoalesceTimer.start();
+        }
+    }
+
+    void FilesChangeMonitor::onCoalesceTimer() {
+        LOG_DEBUG << m_ChangedDirectories.size() << "directory(ies) changed";
+
+        QSet<QString> changedDirectories;
+        changedDirectories.swap(m_ChangedDirectories);
+
+        QStringList unavailableFiles;
+        QStringList watchedDirectories;
+        foreach (const QString &directory, changedDirectories) {
+            if (!m_WatchedFiles.contains(directory)) { continue; }
+
+            watchedDirectories.append(directory);
+            checkDirectory(directory, unavailableFiles);
+        }
+
+        if (!watchedDirectories.isEmpty()) {
+            emit directoriesChanged(watchedDirectories);
+        }
+
+        if (!unavailableFiles.isEmpty()) {
+            LOG_INFO << unavailableFiles.size() << "file(s) became unavailable";
+            // same as QFileSystemWatcher stops watching removed files
+            unwatchFiles(unavailableFiles);
+            emit filesUnavailable(unavailableFiles);
+        }
+    }
+
+    bool FilesChangeMonitor::addFile(const QString &filepath, QStringList &newDirectories) {
+        QFileInfo fi(filepath);
+        const QString directory = fi.absolutePath();
+
+        auto it = m_WatchedFiles.find(directory);
+        if (it == m_WatchedFiles.end()) {
+            it = m_WatchedFiles.insert(directory, QHash<QString, QString>());
+            newDirectories.append(directory);
+        }
+
+        QHash<QString, QString> &files = it.value();
+        const QString filename = fi.fileName();
+        if (files.contains(filename)) { return false; }
+
+        files.insert(filename, filepath);
+        m_WatchedFilesCount++;
+        return true;
+    }
+
+    bool FilesChangeMonitor::removeFile(const QString &filepath, QStringList &emptyDirectories) {
+        QFileInfo fi(filepath);
+        const QString directory = fi.absolutePath();
+
+        auto it = m_WatchedFiles.find(directory);
+        if (it == m_WatchedFiles.end()) { return false; }
+
+        QHash<QString, QString> &files = it.value();
+        if (files.remove(fi.fileName()) == 0) { return false; }
+
+        m_WatchedFilesCount--;
+
+        if (files.isEmpty()) {
+            m_WatchedFiles.erase(it);
+            emptyDirectories.append(directory);
+        }
+
+        return true;
+    }
+
+    void FilesChangeMonitor::checkDirectory(const QString &directory, QStringList &unavailableFiles) {
+        auto it = m_WatchedFiles.constFind(directory);
+        if (it == m_WatchedFiles.constEnd()) { return; }
+
+        const QHash<QString, QString> &files = it.value();
+
+        // one listing instead of a stat for every watched file
+        QDir dir(directory);
+        const QStringList entries = dir.entryList(QDir::Files | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+        const QSet<QString> existingFiles = QSet<QString>::fromList(entries);
+
+        for (auto fileIt = files.constBegin(), end = files.constEnd(); fileIt != end; ++fileIt) {
+            if (!existingFiles.contains(fileIt.key())) {
+                unavailableFiles.append(fileIt.value());
+            }
+        }
+    }
+}
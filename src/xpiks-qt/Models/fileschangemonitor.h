@@ -0,0 +1,81 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FILESCHANGEMONITOR_H
+#define FILESCHANGEMONITOR_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QFileSystemWatcher>
+
+namespace Models {
+    /*
+     * Watches containing directories instead of every single file so
+     * the number of OS watches depends on directories count. Changes
+     * are coalesced and each changed directory is listed once to find
+     * which of the watched files disappeared.
+    */
+    class FilesChangeMonitor : public QObject
+    {
+        Q_OBJECT
+    public:
+        explicit FilesChangeMonitor(QObject *parent=0);
+
+    public:
+        void watchFiles(const QStringList &filepaths);
+        void unwatchFiles(const QStringList &filepaths);
+        void watchFile(const QString &filepath);
+        void unwatchFile(const QString &filepath);
+        void clear();
+
+    public:
+        int getWatchedFilesCount() const { return m_WatchedFilesCount; }
+        int getWatchedDirectoriesCount() const { return m_WatchedFiles.size(); }
+
+    signals:
+        void filesUnavailable(const QStringList &filepaths);
+        // files in these directories were added, removed or modified
+        void directoriesChanged(const QStringList &directories);
+
+    private slots:
+        void onDirectoryChanged(const QString &directory);
+        void onCoalesceTimer();
+
+    private:
+        bool addFile(const QString &filepath, QStringList &newDirectories);
+        bool removeFile(const QString &filepath, QStringList &emptyDirectories);
+        void checkDirectory(const QString &directory, QStringList &unavailableFiles);
+
+    private:
+        QFileSystemWatcher m_Watcher;
+        QTimer m_CoalesceTimer;
+        // directory -> file name -> filepath as it was watched
+        QHash<QString, QHash<QString, QString> > m_WatchedFiles;
+        QSet<QString> m_ChangedDirectories;
+        int m_WatchedFilesCount;
+    };
+}
+
+#endif // FILESCHANGEMONITOR_H
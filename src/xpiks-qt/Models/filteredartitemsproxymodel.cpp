@@ -54,6 +54,27 @@ namespace Models {
         m_SearchFlags = searchUsingAnd ? Common::SearchFlags::AllTermsEverything :
                                     Common::SearchFlags::AnyTermsEverything;
         Common::ApplyFlag(m_SearchFlags, searchByFilepath, Common::SearchFlags::Filepath);
+        m_SearchIndex.setQuery(m_SearchTerm, m_SearchFlags);
+    }
+
+    void FilteredArtItemsProxyModel::setSourceModel(QAbstractItemModel *sourceModel) {
+        QAbstractItemModel *previousModel = this->sourceModel();
+        if (previousModel != NULL) {
+            QObject::disconnect(previousModel, SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)),
+                                this, SLOT(onSourceRowsAboutToBeRemoved(QModelIndex,int,int)));
+            QObject::disconnect(previousModel, SIGNAL(modelAboutToBeReset()),
+                                this, SLOT(onSourceModelAboutToBeReset()));
+        }
+
+        m_SearchIndex.clear();
+        QSortFilterProxyModel::setSourceModel(sourceModel);
+
+        if (sourceModel != NULL) {
+            QObject::connect(sourceModel, SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)),
+                             this, SLOT(onSourceRowsAboutToBeRemoved(QModelIndex,int,int)));
+            QObject::connect(sourceModel, SIGNAL(modelAboutToBeReset()),
+                             this, SLOT(onSourceModelAboutToBeReset()));
+        }
     }
 
     void FilteredArtItemsProxyModel::setSearchTerm(const QString &value) {
@@ -485,6 +506,24 @@ namespace Models {
         invalidateFilter();
     }
 
+    void FilteredArtItemsProxyModel::onSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last) {
+        Q_UNUSED(parent);
+        ArtItemsModel *artItemsModel = getArtItemsModel();
+        if (artItemsModel == NULL) { return; }
+
+        for (int row = first; row <= last; ++row) {
+            ArtworkMetadata *metadata = artItemsModel->getArtwork(row);
+            if (metadata != NULL) {
+                m_SearchIndex.removeArtwork(metadata);
+            }
+        }
+    }
+
+    void FilteredArtItemsProxyModel::onSourceModelAboutToBeReset() {
+        LOG_DEBUG << "#";
+        m_SearchIndex.clear();
+    }
+
     void FilteredArtItemsProxyModel::removeMetadataInItems(std::vector<MetadataElement> &itemsToClear, Common::CombinedEditFlags flags) const {
         LOG_INFO << itemsToClear.size() << "item(s) with flags =" << (int)flags;
         std::shared_ptr<Commands::CombinedEditCommand> combinedEditCommand(new Commands::CombinedEditCommand(
@@ -661,7 +700,7 @@ namespace Models {
                 hasMatch = true;
 
                 if (!m_SearchTerm.trimmed().isEmpty()) {
-                    hasMatch = Helpers::hasSearchMatch(m_SearchTerm, metadata, m_SearchFlags);
+                    hasMatch = m_SearchIndex.hasMatch(metadata);
                 }
             }
         }
@@ -726,4 +765,10 @@ namespace Models {
         },
             [] (ArtworkMetadata *metadata, int index, int) { return PreviewMetadataElement(metadata, index); });
     }
+
+    std::vector<PreviewMetadataElement> FilteredArtItemsProxyModel::getAllPreviewOriginalItems() const {
+        return getFilteredOriginalItems<PreviewMetadataElement>(
+            [](ArtworkMetadata *) { return true; },
+            [] (ArtworkMetadata *metadata, int index, int) { return PreviewMetadataElement(metadata, index); });
+    }
 }
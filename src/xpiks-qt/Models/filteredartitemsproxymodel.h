@@ -28,6 +28,7 @@
 #include <functional>
 #include "../Common/flags.h"
 #include "../Common/baseentity.h"
+#include "artworkssearchindex.h"
 
 namespace Models {
     class ArtworkMetadata;
@@ -46,6 +47,8 @@ namespace Models {
         FilteredArtItemsProxyModel(QObject *parent=0);
 
     public:
+        virtual void setSourceModel(QAbstractItemModel *sourceModel) override;
+
         const QString &getSearchTerm() const { return m_SearchTerm; }
         void setSearchTerm(const QString &value);
 
@@ -56,6 +59,8 @@ namespace Models {
 
         std::vector<PreviewMetadataElement> getSearchablePreviewOriginalItems(const QString &searchTerm, Common::SearchFlags flags) const;
 
+        std::vector<PreviewMetadataElement> getAllPreviewOriginalItems() const;
+
 #ifdef CORE_TESTS
         int retrieveNumberOfSelectedItems();
 #endif
@@ -111,6 +116,10 @@ namespace Models {
         void onSpellCheckerAvailable(bool afterRestart);
         void onSettingsUpdated();
 
+    private slots:
+        void onSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+        void onSourceModelAboutToBeReset();
+
     signals:
         void searchTermChanged(const QString &searchTerm);
         void selectedArtworksCountChanged();
@@ -151,6 +160,8 @@ namespace Models {
         // ignore default regexp from proxymodel
         QString m_SearchTerm;
         Common::SearchFlags m_SearchFlags;
+        // filterAcceptsRow() is const but the index is lazily updated
+        mutable ArtworksSearchIndex m_SearchIndex;
         volatile int m_SelectedArtworksCount;
         volatile bool m_SortingEnabled;
     };
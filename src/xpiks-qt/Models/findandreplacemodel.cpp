@@ -21,6 +21,7 @@
 
 #include "findandreplacemodel.h"
 #include <QAbstractListModel>
+#include <QtConcurrent>
 #include "../Models/artworkmetadata.h"
 #include "../Models/artitemsmodel.h"
 #include "../Models/settingsmodel.h"
@@ -64,17 +65,102 @@ QString searchFlagsToString(Common::SearchFlags flags) {
     return items.join(" | ");
 }
 
+#define PREVIEW_MATCH_BATCH_SIZE 200
+
 namespace Models {
+    static bool fillPreviewMatches(Models::PreviewMetadataElement &preview, const QString &replaceFrom, Common::SearchFlags searchFlags) {
+        Models::ArtworkMetadata *metadata = preview.getOrigin();
+        if (!Helpers::hasSearchMatch(replaceFrom, metadata, searchFlags)) {
+            return false;
+        }
+
+        bool hasMatch = false;
+        Common::SearchFlags flags = Common::SearchFlags::None;
+
+        if (Common::HasFlag(searchFlags, Common::SearchFlags::Title)) {
+            flags = searchFlags;
+            Common::UnsetFlag(flags, Common::SearchFlags::Description);
+            Common::UnsetFlag(flags, Common::SearchFlags::Keywords);
+
+            hasMatch = Helpers::hasSearchMatch(replaceFrom, metadata, flags);
+            preview.setHasTitleMatch(hasMatch);
+        }
+
+        if (Common::HasFlag(searchFlags, Common::SearchFlags::Description)) {
+            flags = searchFlags;
+            Common::UnsetFlag(flags, Common::SearchFlags::Title);
+            Common::UnsetFlag(flags, Common::SearchFlags::Keywords);
+
+            hasMatch = Helpers::hasSearchMatch(replaceFrom, metadata, flags);
+            preview.setHasDescriptionMatch(hasMatch);
+        }
+
+        if (Common::HasFlag(searchFlags, Common::SearchFlags::Keywords)) {
+            flags = searchFlags;
+            Common::UnsetFlag(flags, Common::SearchFlags::Description);
+            Common::UnsetFlag(flags, Common::SearchFlags::Title);
+
+            hasMatch = Helpers::hasSearchMatch(replaceFrom, metadata, flags);
+            preview.setHasKeywordsMatch(hasMatch);
+        }
+
+        return true;
+    }
+
+    // checks a range of candidates and returns indices of matched ones
+    struct PreviewMatcher {
+        typedef QVector<int> result_type;
+
+        PreviewMatcher(std::vector<Models::PreviewMetadataElement> *candidates,
+                       const QString &replaceFrom, Common::SearchFlags flags):
+            m_Candidates(candidates),
+            m_ReplaceFrom(replaceFrom),
+            m_Flags(flags)
+        {}
+
+        QVector<int> operator()(const QPair<int, int> &range) const {
+            QVector<int> matched;
+
+            for (int i = range.first; i < range.second; ++i) {
+                if (fillPreviewMatches(m_Candidates->at(i), m_ReplaceFrom, m_Flags)) {
+                    matched.append(i);
+                }
+            }
+
+            return matched;
+        }
+
+        std::vector<Models::PreviewMetadataElement> *m_Candidates;
+        QString m_ReplaceFrom;
+        Common::SearchFlags m_Flags;
+    };
+
     FindAndReplaceModel::FindAndReplaceModel(QMLExtensions::ColorsModel *colorsModel, QObject *parent):
         QAbstractListModel(parent),
         Common::BaseEntity(),
+        m_PreviewWatcher(nullptr),
+        m_ReplaceWatcher(nullptr),
         m_ColorsModel(colorsModel),
-        m_Flags(Common::SearchFlags::None)
+        m_Flags(Common::SearchFlags::None),
+        m_NextBatchIndex(0),
+        m_InProgress(false)
     {
         Q_ASSERT(colorsModel != nullptr);
         initDefaultFlags();
     }
 
+    FindAndReplaceModel::~FindAndReplaceModel() {
+        if (m_PreviewWatcher != nullptr) {
+            m_PreviewWatcher->cancel();
+            m_PreviewWatcher->waitForFinished();
+        }
+
+        if (m_ReplaceWatcher != nullptr) {
+            m_ReplaceWatcher->cancel();
+            m_ReplaceWatcher->waitForFinished();
+        }
+    }
+
     void FindAndReplaceModel::initArtworksList() {
         LOG_INFO << "Flags:" << searchFlagsToString(m_Flags);
         LOG_INFO << "ReplaceFrom: [" << m_ReplaceFrom << "]";
@@ -86,44 +172,28 @@ namespace Models {
         }
 
         normalizeSearchCriteria();
+        clearArtworks();
 
         Models::FilteredArtItemsProxyModel *filteredItemsModel = m_CommandManager->getFilteredArtItemsModel();
-        m_ArtworksList = std::move(filteredItemsModel->getSearchablePreviewOriginalItems(m_ReplaceFrom, m_Flags));
+        m_PreviewCandidates = filteredItemsModel->getAllPreviewOriginalItems();
 
-        LOG_INFO << "Found" << m_ArtworksList.size() << "item(s)";
+        const int size = (int)m_PreviewCandidates.size();
+        LOG_INFO << "Searching in" << size << "item(s)";
 
-        for (auto &preview: m_ArtworksList) {
-            Models::ArtworkMetadata *metadata = preview.getOrigin();
-            bool hasMatch = false;
-            Common::SearchFlags flags = Common::SearchFlags::None;
-
-            if (getSearchInTitle()) {
-                flags = m_Flags;
-                Common::UnsetFlag(flags, Common::SearchFlags::Description);
-                Common::UnsetFlag(flags, Common::SearchFlags::Keywords);
-
-                hasMatch = Helpers::hasSearchMatch(m_ReplaceFrom, metadata, flags);
-                preview.setHasTitleMatch(hasMatch);
-            }
-
-            if (getSearchInDescription()) {
-                flags = m_Flags;
-                Common::UnsetFlag(flags, Common::SearchFlags::Title);
-                Common::UnsetFlag(flags, Common::SearchFlags::Keywords);
+        QList<QPair<int, int> > ranges;
+        for (int start = 0; start < size; start += PREVIEW_MATCH_BATCH_SIZE) {
+            ranges.append(qMakePair(start, qMin(size, start + PREVIEW_MATCH_BATCH_SIZE)));
+        }
 
-                hasMatch = Helpers::hasSearchMatch(m_ReplaceFrom, metadata, flags);
-                preview.setHasDescriptionMatch(hasMatch);
-            }
+        m_PreviewWatcher = new QFutureWatcher<QVector<int> >(this);
+        QObject::connect(m_PreviewWatcher, SIGNAL(resultReadyAt(int)), this, SLOT(onPreviewBatchReady(int)));
+        QObject::connect(m_PreviewWatcher, SIGNAL(finished()), this, SLOT(onPreviewFinished()));
 
-            if (getSearchInKeywords()) {
-                flags = m_Flags;
-                Common::UnsetFlag(flags, Common::SearchFlags::Description);
-                Common::UnsetFlag(flags, Common::SearchFlags::Title);
+        m_ReadyBatches.clear();
+        m_NextBatchIndex = 0;
 
-                hasMatch = Helpers::hasSearchMatch(m_ReplaceFrom, metadata, flags);
-                preview.setHasKeywordsMatch(hasMatch);
-            }
-        }
+        setInProgress(true);
+        m_PreviewWatcher->setFuture(QtConcurrent::mapped(ranges, PreviewMatcher(&m_PreviewCandidates, m_ReplaceFrom, m_Flags)));
     }
 
     int FindAndReplaceModel::rowCount(const QModelIndex &parent) const {
@@ -297,13 +367,26 @@ namespace Models {
     void FindAndReplaceModel::replace() {
         LOG_INFO << "Flags:" << searchFlagsToString(m_Flags);
 
-        std::shared_ptr<Commands::FindAndReplaceCommand> replaceCommand(new Commands::FindAndReplaceCommand(m_ArtworksList, m_ReplaceFrom,
-                                                                                                            m_ReplaceTo,
-                                                                                                            m_Flags));
+        if (m_ReplaceWatcher != nullptr) {
+            LOG_WARNING << "Replace is already in progress";
+            return;
+        }
 
-        m_CommandManager->processCommand(replaceCommand);
+        if (m_InProgress) {
+            LOG_INFO << "Replacing only in" << m_ArtworksList.size() << "item(s) found so far";
+            cancelPreview();
+        }
 
-        emit replaceSucceeded();
+        const QVector<int> selected = Commands::getSelectedElements(m_ArtworksList);
+
+        m_ReplaceWatcher = new QFutureWatcher<Commands::ReplacePlan>(this);
+        QObject::connect(m_ReplaceWatcher, SIGNAL(finished()), this, SLOT(onReplaceFinished()));
+
+        setInProgress(true);
+        // new values are computed in the background and artworks are modified in onReplaceFinished()
+        m_ReplaceWatcher->setFuture(QtConcurrent::mapped(selected,
+                                                         Commands::ReplacePlanner(&m_ArtworksList, m_ReplaceFrom,
+                                                                                  m_ReplaceTo, m_Flags)));
     }
 
     bool FindAndReplaceModel::anySearchDestination() const {
@@ -325,9 +408,114 @@ namespace Models {
 
     void FindAndReplaceModel::clearArtworks() {
         LOG_DEBUG << "#";
+        cancelReplace();
+        cancelPreview();
+
         beginResetModel();
         m_ArtworksList.clear();
         endResetModel();
+
+        emit countChanged(0);
+    }
+
+    void FindAndReplaceModel::onPreviewBatchReady(int index) {
+        Q_ASSERT(m_PreviewWatcher != nullptr);
+        // batches finish in any order but rows should follow the order of artworks
+        m_ReadyBatches.insert(index, m_PreviewWatcher->resultAt(index));
+
+        QVector<int> matched;
+        auto it = m_ReadyBatches.find(m_NextBatchIndex);
+        while (it != m_ReadyBatches.end()) {
+            matched += it.value();
+            m_ReadyBatches.erase(it);
+            m_NextBatchIndex++;
+            it = m_ReadyBatches.find(m_NextBatchIndex);
+        }
+
+        if (matched.isEmpty()) { return; }
+
+        const int size = (int)m_ArtworksList.size();
+        beginInsertRows(QModelIndex(), size, size + matched.size() - 1);
+        {
+            for (int i: matched) {
+                m_ArtworksList.emplace_back(std::move(m_PreviewCandidates.at(i)));
+            }
+        }
+        endInsertRows();
+
+        emit countChanged(getArtworksCount());
+    }
+
+    void FindAndReplaceModel::onPreviewFinished() {
+        LOG_INFO << "Found" << m_ArtworksList.size() << "item(s)";
+        // releases artworks which did not match
+        m_PreviewCandidates.clear();
+        m_ReadyBatches.clear();
+
+        if (m_PreviewWatcher != nullptr) {
+            // finished() is still being delivered by the watcher
+            m_PreviewWatcher->deleteLater();
+            m_PreviewWatcher = nullptr;
+        }
+
+        setInProgress(false);
+        emit previewFinished();
+    }
+
+    void FindAndReplaceModel::onReplaceFinished() {
+        Q_ASSERT(m_ReplaceWatcher != nullptr);
+        // mapped() keeps results in the order of selected items
+        const QVector<Commands::ReplacePlan> plans = m_ReplaceWatcher->future().results().toVector();
+
+        // finished() is still being delivered by the watcher
+        m_ReplaceWatcher->deleteLater();
+        m_ReplaceWatcher = nullptr;
+
+        setInProgress(false);
+
+        // keywords models are bound to views so edits and undo backups are done in GUI thread
+        std::shared_ptr<Commands::FindAndReplaceCommand> replaceCommand(new Commands::FindAndReplaceCommand(m_ArtworksList, plans,
+                                                                                                            m_ReplaceFrom,
+                                                                                                            m_ReplaceTo,
+                                                                                                            m_Flags));
+
+        m_CommandManager->processCommand(replaceCommand);
+
+        emit replaceSucceeded();
+    }
+
+    void FindAndReplaceModel::cancelReplace() {
+        if (m_ReplaceWatcher != nullptr) {
+            LOG_DEBUG << "#";
+            QObject::disconnect(m_ReplaceWatcher, 0, this, 0);
+            m_ReplaceWatcher->cancel();
+            m_ReplaceWatcher->waitForFinished();
+            m_ReplaceWatcher->deleteLater();
+            m_ReplaceWatcher = nullptr;
+        }
+    }
+
+    void FindAndReplaceModel::cancelPreview() {
+        if (m_PreviewWatcher != nullptr) {
+            LOG_DEBUG << "#";
+            // events already posted for this watcher should not reach the model
+            QObject::disconnect(m_PreviewWatcher, 0, this, 0);
+            m_PreviewWatcher->cancel();
+            m_PreviewWatcher->waitForFinished();
+            m_PreviewWatcher->deleteLater();
+            m_PreviewWatcher = nullptr;
+        }
+
+        m_PreviewCandidates.clear();
+        m_ReadyBatches.clear();
+        setInProgress(false);
+    }
+
+    void FindAndReplaceModel::setInProgress(bool value) {
+        if (m_InProgress != value) {
+            m_InProgress = value;
+            emit inProgressChanged();
+        }
     }
 
     QString FindAndReplaceModel::filterText(const QString &text) {
@@ -25,10 +25,18 @@
 #include "../Common/baseentity.h"
 #include <QObject>
 #include <QQuickTextDocument>
+#include <QFutureWatcher>
+#include <QVector>
+#include <QHash>
+#include <vector>
 #include "../Models/previewmetadataelement.h"
 #include "../Common/flags.h"
 #include "../Common/iflagsprovider.h"
 
+namespace Commands {
+    struct ReplacePlan;
+}
+
 namespace Models {
     class FindAndReplaceModel:
         public QAbstractListModel,
@@ -44,17 +52,19 @@ namespace Models {
         Q_PROPERTY(bool caseSensitive READ getCaseSensitive WRITE setCaseSensitive NOTIFY caseSensitiveChanged)
         Q_PROPERTY(bool searchWholeWords READ getSearchWholeWords WRITE setSearchWholeWords NOTIFY searchWholeWordsChanged)
         Q_PROPERTY(int count READ getArtworksCount NOTIFY countChanged)
+        Q_PROPERTY(bool inProgress READ getInProgress NOTIFY inProgressChanged)
 
     public:
         FindAndReplaceModel(QMLExtensions::ColorsModel *colorsModel, QObject *parent=0);
 
-        virtual ~FindAndReplaceModel() {}
+        virtual ~FindAndReplaceModel();
 
     public:
         virtual int getFlags() const override { return (int)m_Flags; }
         const QString &getReplaceFrom() const{ return m_ReplaceFrom; }
         const QString &getReplaceTo() const { return m_ReplaceTo; }
         int getArtworksCount() const { return (int)m_ArtworksList.size(); }
+        bool getInProgress() const { return m_InProgress; }
 
         void setReplaceFrom(const QString &value) {
             if (value != m_ReplaceFrom) {
@@ -178,8 +188,18 @@ namespace Models {
         void countChanged(int value);
         void allSelectedChanged();
         void replaceSucceeded();
+        void inProgressChanged();
+        void previewFinished();
+
+    private slots:
+        void onPreviewBatchReady(int index);
+        void onPreviewFinished();
+        void onReplaceFinished();
 
     private:
+        void cancelPreview();
+        void cancelReplace();
+        void setInProgress(bool value);
         QString filterText(const QString &text);
         void setAllSelected(bool isSelected);
         void initDefaultFlags();
@@ -187,10 +207,18 @@ namespace Models {
 
     private:
         std::vector<Models::PreviewMetadataElement> m_ArtworksList;
+        // all filtered artworks while the preview is being searched
+        std::vector<Models::PreviewMetadataElement> m_PreviewCandidates;
+        // batches finished out of order wait here until all previous ones are shown
+        QHash<int, QVector<int> > m_ReadyBatches;
+        QFutureWatcher<QVector<int> > *m_PreviewWatcher;
+        QFutureWatcher<Commands::ReplacePlan> *m_ReplaceWatcher;
         QString m_ReplaceFrom;
         QString m_ReplaceTo;
         QMLExtensions::ColorsModel *m_ColorsModel;
         Common::SearchFlags m_Flags;
+        int m_NextBatchIndex;
+        bool m_InProgress;
     };
 }
 #endif // FINDANDREPLACEMODEL_H
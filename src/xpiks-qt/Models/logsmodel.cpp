@@ -71,17 +71,25 @@ namespace Models {
         QString result;
 #ifdef WITH_LOGS
         Helpers::Logger &logger = Helpers::Logger::getInstance();
-        QString logFilePath = logger.getLogFilePath();
-        QFile f(logFilePath);
-
-        if (f.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            // 1000 - do not load the UI
-            // advanced users will open logs it notepad
-            int numberOfLines = moreLogs ? 1000 : 100;
-            QString text = QString::fromUtf8(f.readAll());
-            result = Helpers::getLastNLines(text, numberOfLines);
-            f.close();
+        QStringList logFilePathes = logger.getLogFilePathes();
+        // 1000 - do not load the UI
+        // advanced users will open logs it notepad
+        int numberOfLines = moreLogs ? 1000 : 100;
+        QString text;
+
+        // the newest segment can be too short after the rotation
+        for (int i = logFilePathes.size() - 1; i >= 0; --i) {
+            QFile f(logFilePathes.at(i));
+
+            if (f.open(QIODevice::ReadOnly | QIODevice::Text)) {
+                text.prepend(QString::fromUtf8(f.readAll()));
+                f.close();
+            }
+
+            if (text.count(QChar('\n')) >= numberOfLines) { break; }
         }
+
+        result = Helpers::getLastNLines(text, numberOfLines);
 #else
         Q_UNUSED(moreLogs);
         result = QString::fromLatin1("Logs are not available in this version");
@@ -46,6 +46,7 @@
 #define DEFAULT_KEYWORD_SIZE_SCALE 1.0
 #define DEFAULT_DISMISS_DURATION 10
 #define DEFAULT_MAX_PARALLEL_UPLOADS 2
+#define DEFAULT_MAX_CONNECTIONS_PER_HOST 3
 #define DEFAULT_FIT_SMALL_PREVIEW false
 #define DEFAULT_SEARCH_USING_AND true
 #define DEFAULT_SEARCH_BY_FILEPATH true
@@ -67,6 +68,7 @@
 #define DEFAULT_PROXY_HOST ""
 #define DEFAULT_ARTWORK_EDIT_RIGHT_PANE_WIDTH 300
 #define DEFAULT_SELECTED_DICT_INDEX -1
+#define DEFAULT_IMAGES_CACHE_SIZE 2048
 
 #ifndef INTEGRATION_TESTS
 #define DEFAULT_AUTO_CACHE_IMAGES true
@@ -88,6 +90,8 @@ namespace Models {
         m_UploadTimeout(DEFAULT_UPLOAD_TIMEOUT),
         m_DismissDuration(DEFAULT_DISMISS_DURATION),
         m_MaxParallelUploads(DEFAULT_MAX_PARALLEL_UPLOADS),
+        m_MaxConnectionsPerHost(DEFAULT_MAX_CONNECTIONS_PER_HOST),
+        m_ImagesCacheSize(DEFAULT_IMAGES_CACHE_SIZE),
         m_SelectedThemeIndex(DEFAULT_SELECTED_THEME_INDEX),
         m_SelectedDictIndex(DEFAULT_SELECTED_DICT_INDEX),
         m_MustUseMasterPassword(DEFAULT_USE_MASTERPASSWORD),
@@ -195,6 +199,7 @@ namespace Models {
         setValue(keywordSizeScale, m_KeywordSizeScale);
         setValue(dismissDuration, m_DismissDuration);
         setValue(maxParallelUploads, m_MaxParallelUploads);
+        setValue(maxConnectionsPerHost, m_MaxConnectionsPerHost);
         setValue(fitSmallPreview, m_FitSmallPreview);
         setValue(searchUsingAnd, m_SearchUsingAnd);
         setValue(searchByFilepath, m_SearchByFilepath);
@@ -210,6 +215,7 @@ namespace Models {
         setValue(useProxy, m_UseProxy);
         setValue(proxyHost, serializeProxyForSettings(m_ProxySettings));
         setValue(cacheImagesAutomatically, m_AutoCacheImages);
+        setValue(imagesCacheSize, m_ImagesCacheSize);
         setValue(artworkEditRightPaneWidth, m_ArtworkEditRightPaneWidth);
         setValue(verboseUpload, m_VerboseUpload);
 
@@ -266,6 +272,7 @@ namespace Models {
         setKeywordSizeScale(doubleValue(keywordSizeScale, DEFAULT_KEYWORD_SIZE_SCALE));
         setDismissDuration(intValue(dismissDuration, DEFAULT_DISMISS_DURATION));
         setMaxParallelUploads(intValue(maxParallelUploads, DEFAULT_MAX_PARALLEL_UPLOADS));
+        setMaxConnectionsPerHost(intValue(maxConnectionsPerHost, DEFAULT_MAX_CONNECTIONS_PER_HOST));
         setFitSmallPreview(boolValue(fitSmallPreview, DEFAULT_FIT_SMALL_PREVIEW));
         setSearchUsingAnd(boolValue(searchUsingAnd, DEFAULT_SEARCH_USING_AND));
         setSearchByFilepath(boolValue(searchByFilepath, DEFAULT_SEARCH_BY_FILEPATH));
@@ -285,6 +292,7 @@ namespace Models {
         deserializeProxyFromSettings(stringValue(proxyHost, DEFAULT_PROXY_HOST));
 
         setAutoCacheImages(boolValue(cacheImagesAutomatically, DEFAULT_AUTO_CACHE_IMAGES));
+        setImagesCacheSize(intValue(imagesCacheSize, DEFAULT_IMAGES_CACHE_SIZE));
 
         setArtworkEditRightPaneWidth(intValue(artworkEditRightPaneWidth, DEFAULT_ARTWORK_EDIT_RIGHT_PANE_WIDTH));
         setSelectedDictIndex(intValue(translatorSelectedDictIndex, DEFAULT_SELECTED_DICT_INDEX));
@@ -304,6 +312,7 @@ namespace Models {
         setKeywordSizeScale(DEFAULT_KEYWORD_SIZE_SCALE);
         setDismissDuration(DEFAULT_DISMISS_DURATION);
         setMaxParallelUploads(DEFAULT_MAX_PARALLEL_UPLOADS);
+        setMaxConnectionsPerHost(DEFAULT_MAX_CONNECTIONS_PER_HOST);
         setFitSmallPreview(DEFAULT_FIT_SMALL_PREVIEW);
         setSearchUsingAnd(DEFAULT_SEARCH_USING_AND);
         setSearchByFilepath(DEFAULT_SEARCH_BY_FILEPATH);
@@ -320,6 +329,7 @@ namespace Models {
         setUseProxy(DEFAULT_USE_PROXY);
         resetProxySetting();
         setAutoCacheImages(DEFAULT_AUTO_CACHE_IMAGES);
+        setImagesCacheSize(DEFAULT_IMAGES_CACHE_SIZE);
         setArtworkEditRightPaneWidth(DEFAULT_ARTWORK_EDIT_RIGHT_PANE_WIDTH);
         setSelectedDictIndex(DEFAULT_SELECTED_DICT_INDEX);
         setVerboseUpload(DEFAULT_VERBOSE_UPLOAD);
@@ -57,6 +57,7 @@ namespace Models {
         Q_PROPERTY(double keywordSizeScale READ getKeywordSizeScale WRITE setKeywordSizeScale NOTIFY keywordSizeScaleChanged)
         Q_PROPERTY(int dismissDuration READ getDismissDuration WRITE setDismissDuration NOTIFY dismissDurationChanged)
         Q_PROPERTY(int maxParallelUploads READ getMaxParallelUploads WRITE setMaxParallelUploads NOTIFY maxParallelUploadsChanged)
+        Q_PROPERTY(int maxConnectionsPerHost READ getMaxConnectionsPerHost WRITE setMaxConnectionsPerHost NOTIFY maxConnectionsPerHostChanged)
         Q_PROPERTY(bool fitSmallPreview READ getFitSmallPreview WRITE setFitSmallPreview NOTIFY fitSmallPreviewChanged)
         Q_PROPERTY(bool searchUsingAnd READ getSearchUsingAnd WRITE setSearchUsingAnd NOTIFY searchUsingAndChanged)
         Q_PROPERTY(bool searchByFilepath READ getSearchByFilepath WRITE setSearchByFilepath NOTIFY searchByFilepathChanged)
@@ -77,6 +78,7 @@ namespace Models {
         Q_PROPERTY(QString proxyPassword READ getProxyPassword NOTIFY proxyPasswordChanged)
         Q_PROPERTY(QString proxyPort READ getProxyPort NOTIFY proxyPortChanged)
         Q_PROPERTY(bool autoCacheImages READ getAutoCacheImages WRITE setAutoCacheImages NOTIFY autoCacheImagesChanged)
+        Q_PROPERTY(int imagesCacheSize READ getImagesCacheSize WRITE setImagesCacheSize NOTIFY imagesCacheSizeChanged)
         Q_PROPERTY(int artworkEditRightPaneWidth READ getArtworkEditRightPaneWidth WRITE setArtworkEditRightPaneWidth NOTIFY artworkEditRightPaneWidthChanged)
         Q_PROPERTY(bool verboseUpload READ getVerboseUpload WRITE setVerboseUpload NOTIFY verboseUploadChanged)
 
@@ -302,6 +304,7 @@ namespace Models {
         double getKeywordSizeScale() const { return m_KeywordSizeScale; }
         int getDismissDuration() const { return m_DismissDuration; }
         int getMaxParallelUploads() const { return m_MaxParallelUploads; }
+        int getMaxConnectionsPerHost() const { return m_MaxConnectionsPerHost; }
         bool getFitSmallPreview() const { return m_FitSmallPreview; }
         bool getSearchUsingAnd() const { return m_SearchUsingAnd; }
         bool getSearchByFilepath() const { return m_SearchByFilepath; }
@@ -323,6 +326,7 @@ namespace Models {
         QString getProxyPort() const { return m_ProxySettings.m_Port; }
         ProxySettings *getProxySettings() { return &m_ProxySettings; }
         bool getAutoCacheImages() const { return m_AutoCacheImages; }
+        int getImagesCacheSize() const { return m_ImagesCacheSize; }
         int getArtworkEditRightPaneWidth() const { return m_ArtworkEditRightPaneWidth; }
         int getSelectedDictIndex() const { return m_SelectedDictIndex; }
         bool getVerboseUpload() const { return m_VerboseUpload; }
@@ -338,6 +342,7 @@ namespace Models {
         void keywordSizeScaleChanged(double value);
         void dismissDurationChanged(int value);
         void maxParallelUploadsChanged(int value);
+        void maxConnectionsPerHostChanged(int value);
         void fitSmallPreviewChanged(bool value);
         void searchUsingAndChanged(bool value);
         void searchByFilepathChanged(bool value);
@@ -358,6 +363,7 @@ namespace Models {
         void proxyPasswordChanged(QString value);
         void proxyPortChanged(QString value);
         void autoCacheImagesChanged(bool value);
+        void imagesCacheSizeChanged(int value);
         void artworkEditRightPaneWidthChanged(int value);
         void selectedDictIndexChanged(int value);        
         void verboseUploadChanged(bool verboseUpload);
@@ -427,6 +433,14 @@ namespace Models {
             emit maxParallelUploadsChanged(m_MaxParallelUploads);
         }
 
+        void setMaxConnectionsPerHost(int value) {
+            if (m_MaxConnectionsPerHost == value)
+                return;
+
+            m_MaxConnectionsPerHost = ensureInBounds(value, 1, 8);
+            emit maxConnectionsPerHostChanged(m_MaxConnectionsPerHost);
+        }
+
         void setFitSmallPreview(bool value) {
             if (m_FitSmallPreview == value)
                 return;
@@ -548,6 +562,14 @@ namespace Models {
             }
         }
 
+        void setImagesCacheSize(int value) {
+            if (m_ImagesCacheSize == value)
+                return;
+
+            m_ImagesCacheSize = ensureInBounds(value, 100, 100000);
+            emit imagesCacheSizeChanged(m_ImagesCacheSize);
+        }
+
         void setArtworkEditRightPaneWidth(int value) {
             if (value != m_ArtworkEditRightPaneWidth) {
                 m_ArtworkEditRightPaneWidth = value;
@@ -600,6 +622,8 @@ namespace Models {
         int m_UploadTimeout; // in seconds
         int m_DismissDuration;
         int m_MaxParallelUploads;
+        int m_MaxConnectionsPerHost;
+        int m_ImagesCacheSize; // in megabytes
         int m_SelectedThemeIndex;
         int m_SelectedDictIndex;
         bool m_MustUseMasterPassword;
@@ -24,22 +24,75 @@
 #include <QFileInfo>
 #include <QRegExp>
 #include <QDir>
+#include <QThreadPool>
 #include "../Models/artworkmetadata.h"
 #include "../Models/imageartwork.h"
 #include "../Helpers/filenameshelpers.h"
 #include "../Common/defines.h"
+#include "../Conectivity/archivespipeline.h"
 
 #ifndef CORE_TESTS
 #include "../Helpers/ziphelper.h"
 #endif
 
+// archives are written to the same disk so more writers only add seeks
+#define MAX_ZIPPING_THREADS 4
+
 namespace Models {
-    ZipArchiver::ZipArchiver() {
-        m_ArchiveCreator = new QFutureWatcher<QStringList>(this);
+#ifndef CORE_TESTS
+    // zipping tasks wait for uploaders in the pipeline so they
+    // should not take threads of the global pool from others
+    static QThreadPool *getPipelinedZippingThreadPool() {
+        static QThreadPool zippingThreadPool;
+        zippingThreadPool.setMaxThreadCount(MAX_ZIPPING_THREADS);
+        return &zippingThreadPool;
+    }
+
+    struct PipelinedZipper {
+        PipelinedZipper(const std::shared_ptr<Conectivity::ArchivesPipeline> &pipeline):
+            m_Pipeline(pipeline)
+        { }
+
+        typedef QString result_type;
+
+        QString operator()(const QStringList &filepathes) {
+            // waits until uploaders free space in the pipeline
+            if (!m_Pipeline->reserveSlot()) {
+                return QString();
+            }
+
+            QString archivePath = Helpers::zipFilesToDirectory(filepathes, m_Pipeline->getArchivesDirectory());
+
+            if (archivePath.isEmpty()) {
+                m_Pipeline->cancelReservation();
+            } else {
+                m_Pipeline->pushArchive(archivePath);
+            }
+
+            return archivePath;
+        }
+
+        std::shared_ptr<Conectivity::ArchivesPipeline> m_Pipeline;
+    };
+#endif
+
+    ZipArchiver::ZipArchiver():
+        m_PipelinedLeftCount(0)
+    {
+        m_ArchiveCreator = new QFutureWatcher<QString>(this);
         connect(m_ArchiveCreator, SIGNAL(resultReadyAt(int)), SLOT(archiveCreated(int)));
         connect(m_ArchiveCreator, SIGNAL(finished()), SLOT(allFinished()));
     }
 
+    ZipArchiver::~ZipArchiver() {
+        if (m_ArchivesPipeline) {
+            // wakes zipping tasks waiting for a free slot
+            m_ArchivesPipeline->cancel();
+        }
+
+        delete m_ArchiveCreator;
+    }
+
     int ZipArchiver::getItemsCount() const {
         const QVector<Models::ArtworkMetadata *> items = getArtworkList();
         int size = items.size(), count = 0;
@@ -53,12 +106,36 @@ namespace Models {
         return count;
     }
 
-    void ZipArchiver::archiveCreated(int) {
-        incProgress();
+    void ZipArchiver::archiveCreated(int index) {
+        QString archivePath = m_ArchiveCreator->resultAt(index);
+        reportArchive(archivePath);
+    }
+
+    void ZipArchiver::pipelinedArchiveCreated() {
+        QFutureWatcher<QString> *watcher = qobject_cast<QFutureWatcher<QString> *>(sender());
+        Q_ASSERT(watcher != NULL);
+
+        QString archivePath = watcher->result();
+        watcher->deleteLater();
+
+        reportArchive(archivePath);
+
+        Q_ASSERT(m_PipelinedLeftCount > 0);
+        m_PipelinedLeftCount--;
+
+        if (m_PipelinedLeftCount == 0) {
+            allFinished();
+        }
     }
 
     void ZipArchiver::allFinished() {
         LOG_INFO << "#";
+
+        if (m_ArchivesPipeline) {
+            m_ArchivesPipeline->finishProducing();
+            m_ArchivesPipeline.reset();
+        }
+
         endProcessing();
     }
 
@@ -69,21 +146,31 @@ namespace Models {
 
         if (itemsWithSameName.empty()) {
             LOG_INFO << "No items to zip. Exiting...";
-            endProcessing();
+            allFinished();
             return;
         }
 
         beginProcessing();
-        restrictMaxThreads();
 
         QList<QStringList> items = itemsWithSameName.values();
 
         LOG_INFO << "Creating zip archives for" << items.length() << "item(s)";
 #ifndef CORE_TESTS
-        m_ArchiveCreator->setFuture(QtConcurrent::mapped(items, Helpers::zipFiles));
+        if (m_ArchivesPipeline) {
+            startPipelinedZipping(items);
+        } else {
+            restrictMaxThreads();
+            m_ArchiveCreator->setFuture(QtConcurrent::mapped(items, Helpers::zipFiles));
+        }
 #endif
     }
 
+    void ZipArchiver::restrictMaxThreads() {
+        // deflating is bounded by the number of cores separately
+        LOG_DEBUG << (int)MAX_ZIPPING_THREADS;
+        QThreadPool::globalInstance()->setMaxThreadCount(MAX_ZIPPING_THREADS);
+    }
+
     void ZipArchiver::fillFilenamesHash(QHash<QString, QStringList> &hash) {
         QVector<Models::ArtworkMetadata*> artworksList = getArtworkList();
 
@@ -105,5 +192,33 @@ namespace Models {
             }
         }
     }
+
+    void ZipArchiver::startPipelinedZipping(const QList<QStringList> &items) {
+#ifndef CORE_TESTS
+        QThreadPool *threadPool = getPipelinedZippingThreadPool();
+        PipelinedZipper zipper(m_ArchivesPipeline);
+        m_PipelinedLeftCount = items.size();
+
+        for (auto &filepathes: items) {
+            QFutureWatcher<QString> *watcher = new QFutureWatcher<QString>(this);
+            connect(watcher, SIGNAL(finished()), SLOT(pipelinedArchiveCreated()));
+            watcher->setFuture(QtConcurrent::run(threadPool, zipper, filepathes));
+        }
+#else
+        Q_UNUSED(items);
+#endif
+    }
+
+    void ZipArchiver::reportArchive(const QString &archivePath) {
+        if (!archivePath.isEmpty()) {
+            LOG_INFO << "Created" << archivePath;
+            emit archiveReady(archivePath);
+        } else {
+            LOG_WARNING << "Failed to create archive";
+            setIsError(true);
+        }
+
+        incProgress();
+    }
 }
 
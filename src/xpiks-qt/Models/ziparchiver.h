@@ -25,35 +25,54 @@
 #include <QFutureWatcher>
 #include <QPair>
 #include <QVector>
+#include <memory>
 #include "artworksprocessor.h"
 
 class QStringList;
 class QString;
 
+namespace Conectivity {
+    class ArchivesPipeline;
+}
+
 namespace Models {
     class ZipArchiver : public ArtworksProcessor
     {
         Q_OBJECT
     public:
         ZipArchiver();
-        virtual ~ZipArchiver() { delete m_ArchiveCreator; }
+        virtual ~ZipArchiver();
 
     public:
         virtual int getItemsCount() const override;
+        // created archives are handed over to the uploaders
+        void setArchivesPipeline(const std::shared_ptr<Conectivity::ArchivesPipeline> &pipeline) { m_ArchivesPipeline = pipeline; }
 
     public slots:
-        void archiveCreated(int);
+        void archiveCreated(int index);
+        void pipelinedArchiveCreated();
         void allFinished();
 
+    signals:
+        // archives can be uploaded before all of them are created
+        void archiveReady(const QString &archivePath);
+
     public:
         Q_INVOKABLE void archiveArtworks();
         virtual void cancelProcessing() override { /*BUMP*/ }
 
+    protected:
+        virtual void restrictMaxThreads() override;
+
     private:
         void fillFilenamesHash(QHash<QString, QStringList> &hash);
+        void startPipelinedZipping(const QList<QStringList> &items);
+        void reportArchive(const QString &archivePath);
 
     private:
-        QFutureWatcher<QStringList> *m_ArchiveCreator;
+        QFutureWatcher<QString> *m_ArchiveCreator;
+        std::shared_ptr<Conectivity::ArchivesPipeline> m_ArchivesPipeline;
+        int m_PipelinedLeftCount;
     };
 }
 
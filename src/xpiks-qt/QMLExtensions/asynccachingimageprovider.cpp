@@ -0,0 +1,94 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "asynccachingimageprovider.h"
+
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 6, 0))
+
+#include <QUrl>
+#include <QMetaObject>
+#include "../Common/defines.h"
+#include "imagecachingservice.h"
+
+#define RECACHE true
+
+namespace QMLExtensions {
+    CachedImageResponse::CachedImageResponse(const QString &filepath, const QSize &requestedSize,
+                                             ImageCachingService *cachingService):
+        QQuickImageResponse(),
+        m_Filepath(filepath),
+        m_RequestedSize(requestedSize),
+        m_ImageCachingService(cachingService)
+    {
+        Q_ASSERT(cachingService != nullptr);
+    }
+
+    QQuickTextureFactory *CachedImageResponse::textureFactory() const {
+        return QQuickTextureFactory::textureFactoryForImage(m_Image);
+    }
+
+    void CachedImageResponse::cancel() {
+        // delegate was scrolled out of view
+        if (m_ImageCachingService->cancelPreview(this)) {
+            LOG_INTEGR_TESTS_OR_DEBUG << "Cancelled preview for" << m_Filepath;
+            emit finished();
+        }
+    }
+
+    void CachedImageResponse::finishWithImage(const QImage &image) {
+        m_Image = image;
+        // loader connects to the response only after it is returned so finish is always queued
+        QMetaObject::invokeMethod(this, "finished", Qt::QueuedConnection);
+    }
+
+    QQuickImageResponse *AsyncCachingImageProvider::requestImageResponse(const QString &url, const QSize &requestedSize) {
+        QString id;
+
+        if (url.contains(QChar('%'))) {
+            QUrl initialUrl(url);
+            id = initialUrl.path();
+        } else {
+            id = url;
+        }
+
+        CachedImageResponse *response = new CachedImageResponse(id, requestedSize, m_ImageCachingService);
+
+        bool needsUpdate = false;
+        QImage cachedImage;
+
+        if (m_ImageCachingService->tryGetCachedImage(id, requestedSize, cachedImage, needsUpdate)) {
+            if (needsUpdate) {
+                // outdated thumbnail is shown until the next request
+                LOG_INFO << "Recaching image" << id;
+                m_ImageCachingService->cacheImage(id, requestedSize, RECACHE);
+            }
+
+            response->finishWithImage(cachedImage);
+        } else {
+            LOG_INTEGR_TESTS_OR_DEBUG << "Not found cached:" << id;
+            m_ImageCachingService->requestPreview(response);
+        }
+
+        return response;
+    }
+}
+
+#endif
@@ -0,0 +1,88 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ASYNCCACHINGIMAGEPROVIDER_H
+#define ASYNCCACHINGIMAGEPROVIDER_H
+
+#include <QtGlobal>
+
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 6, 0))
+
+#include <QQuickAsyncImageProvider>
+#include <QQuickImageResponse>
+#include <QImage>
+#include <QString>
+#include <QSize>
+
+namespace QMLExtensions {
+    class ImageCachingService;
+
+    class CachedImageResponse : public QQuickImageResponse
+    {
+        Q_OBJECT
+    public:
+        CachedImageResponse(const QString &filepath, const QSize &requestedSize, ImageCachingService *cachingService);
+
+    public:
+        virtual QQuickTextureFactory *textureFactory() const override;
+
+    public slots:
+        virtual void cancel() override;
+
+    public:
+        const QString &getFilepath() const { return m_Filepath; }
+        const QSize &getRequestedSize() const { return m_RequestedSize; }
+        // can be called from any thread but only once
+        void finishWithImage(const QImage &image);
+
+    private:
+        QString m_Filepath;
+        QSize m_RequestedSize;
+        QImage m_Image;
+        ImageCachingService *m_ImageCachingService;
+    };
+
+    // serves previews without decoding anything on the QML loader threads
+    class AsyncCachingImageProvider : public QQuickAsyncImageProvider
+    {
+    public:
+        AsyncCachingImageProvider():
+            QQuickAsyncImageProvider(),
+            m_ImageCachingService(NULL)
+        {}
+
+        virtual ~AsyncCachingImageProvider() {}
+
+        virtual QQuickImageResponse *requestImageResponse(const QString &url, const QSize &requestedSize) override;
+
+    public:
+        void setImageCachingService(QMLExtensions::ImageCachingService *cachingService) {
+            m_ImageCachingService = cachingService;
+        }
+
+    private:
+        QMLExtensions::ImageCachingService *m_ImageCachingService;
+    };
+}
+
+#endif
+
+#endif // ASYNCCACHINGIMAGEPROVIDER_H
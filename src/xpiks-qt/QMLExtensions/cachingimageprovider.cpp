@@ -20,6 +20,7 @@
  */
 
 #include "cachingimageprovider.h"
+#include <QImageReader>
 #include "../Common/defines.h"
 #include "../QMLExtensions/imagecachingservice.h"
 
@@ -36,31 +37,41 @@ namespace QMLExtensions {
             id = url;
         }
 
-        QString cachedPath;
         bool needsUpdate = false;
 
-        if (m_ImageCachingService->tryGetCachedImage(id, requestedSize, cachedPath, needsUpdate)) {
-            QImage image(cachedPath);
-            *size = image.size();
+        QImage cachedImage;
+        m_ImageCachingService->tryGetCachedImage(id, requestedSize, cachedImage, needsUpdate);
+
+        if (!cachedImage.isNull()) {
+            *size = cachedImage.size();
 
             if (needsUpdate) {
                 LOG_INFO << "Recaching image" << id;
                 m_ImageCachingService->cacheImage(id, requestedSize, RECACHE);
             }
 
-            return image;
+            return cachedImage;
         } else {
             LOG_INTEGR_TESTS_OR_DEBUG << "Not found cached:" << id;
 
-            QImage image(id);
+            QImageReader reader(id);
             QImage result;
 
             if (requestedSize.isValid()) {
                 m_ImageCachingService->cacheImage(id, requestedSize);
-                result = image.scaled(requestedSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+                // decode straight into the small size instead of the full original
+                const QSize originalSize = reader.size();
+                if (originalSize.isValid()) {
+                    reader.setScaledSize(originalSize.scaled(requestedSize, Qt::KeepAspectRatio));
+                    reader.read(&result);
+                } else {
+                    QImage image = reader.read();
+                    result = image.scaled(requestedSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+                }
             } else {
                 LOG_WARNING << "Size is invalid:" << requestedSize.width() << "x" << requestedSize.height();
-                result = image;
+                result = reader.read();
             }
 
             *size = result.size();
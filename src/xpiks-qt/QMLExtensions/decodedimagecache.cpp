@@ -0,0 +1,165 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "decodedimagecache.h"
+#include <QMutexLocker>
+#include "../Common/defines.h"
+
+// hit ratio is logged once in so many lookups
+#define HIT_RATIO_LOG_PERIOD 500
+
+namespace QMLExtensions {
+    DecodedImageCache::DecodedImageCache(qint64 maxBytes):
+        m_MaxBytes(maxBytes),
+        m_UsedBytes(0),
+        m_HitsCount(0),
+        m_MissesCount(0)
+    {
+        Q_ASSERT(maxBytes > 0);
+    }
+
+    QString DecodedImageCache::makeKey(const QString &filepath, const QSize &requestedSize) {
+        return QString("%1x%2:%3").arg(requestedSize.width()).arg(requestedSize.height()).arg(filepath);
+    }
+
+    bool DecodedImageCache::tryGet(const QString &key, QImage &image) {
+        QMutexLocker locker(&m_CacheMutex);
+        Q_UNUSED(locker);
+
+        auto it = m_Cache.find(key);
+        const bool found = it != m_Cache.end();
+
+        if (found) {
+            CachedImage &cached = it.value();
+            m_UsageOrder.splice(m_UsageOrder.begin(), m_UsageOrder, cached.m_UsageIt);
+            // implicitly shared so nothing is copied
+            image = cached.m_Image;
+        }
+
+        accountLookup(found);
+
+        return found;
+    }
+
+    void DecodedImageCache::insert(const QString &key, const QImage &image) {
+        if (image.isNull()) { return; }
+
+        const qint64 imageBytes = image.byteCount();
+        // one huge image should not flush everything else
+        if (imageBytes > m_MaxBytes / 4) { return; }
+
+        QMutexLocker locker(&m_CacheMutex);
+        Q_UNUSED(locker);
+
+        auto it = m_Cache.find(key);
+        if (it != m_Cache.end()) {
+            CachedImage &cached = it.value();
+            m_UsedBytes -= cached.m_Image.byteCount();
+            cached.m_Image = image;
+            m_UsageOrder.splice(m_UsageOrder.begin(), m_UsageOrder, cached.m_UsageIt);
+        } else {
+            m_UsageOrder.push_front(key);
+            m_Cache.insert(key, CachedImage{image, m_UsageOrder.begin()});
+        }
+
+        m_UsedBytes += imageBytes;
+        evictIfNeeded();
+    }
+
+    void DecodedImageCache::remove(const QString &key) {
+        QMutexLocker locker(&m_CacheMutex);
+        Q_UNUSED(locker);
+
+        auto it = m_Cache.find(key);
+        if (it != m_Cache.end()) {
+            m_UsedBytes -= it->m_Image.byteCount();
+            m_UsageOrder.erase(it->m_UsageIt);
+            m_Cache.erase(it);
+        }
+    }
+
+    void DecodedImageCache::clear() {
+        QMutexLocker locker(&m_CacheMutex);
+        Q_UNUSED(locker);
+
+        m_Cache.clear();
+        m_UsageOrder.clear();
+        m_UsedBytes = 0;
+    }
+
+    int DecodedImageCache::size() {
+        QMutexLocker locker(&m_CacheMutex);
+        Q_UNUSED(locker);
+
+        return m_Cache.size();
+    }
+
+    qint64 DecodedImageCache::getUsedBytes() {
+        QMutexLocker locker(&m_CacheMutex);
+        Q_UNUSED(locker);
+
+        return m_UsedBytes;
+    }
+
+    int DecodedImageCache::getHitsCount() {
+        QMutexLocker locker(&m_CacheMutex);
+        Q_UNUSED(locker);
+
+        return m_HitsCount;
+    }
+
+    int DecodedImageCache::getMissesCount() {
+        QMutexLocker locker(&m_CacheMutex);
+        Q_UNUSED(locker);
+
+        return m_MissesCount;
+    }
+
+    double DecodedImageCache::getHitRatio() {
+        QMutexLocker locker(&m_CacheMutex);
+        Q_UNUSED(locker);
+
+        const int lookups = m_HitsCount + m_MissesCount;
+        return lookups > 0 ? (double)m_HitsCount / lookups : 0.0;
+    }
+
+    void DecodedImageCache::evictIfNeeded() {
+        // m_CacheMutex should be locked
+        while ((m_UsedBytes > m_MaxBytes) && !m_UsageOrder.empty()) {
+            auto it = m_Cache.find(m_UsageOrder.back());
+            Q_ASSERT(it != m_Cache.end());
+            m_UsedBytes -= it->m_Image.byteCount();
+            m_Cache.erase(it);
+            m_UsageOrder.pop_back();
+        }
+    }
+
+    void DecodedImageCache::accountLookup(bool hit) {
+        // m_CacheMutex should be locked
+        if (hit) { m_HitsCount++; } else { m_MissesCount++; }
+
+        const int lookups = m_HitsCount + m_MissesCount;
+        if (lookups % HIT_RATIO_LOG_PERIOD == 0) {
+            LOG_INFO << "Hit ratio" << (double)m_HitsCount / lookups << "for" << lookups << "lookups." <<
+                        m_Cache.size() << "images use" << m_UsedBytes << "of" << m_MaxBytes << "bytes";
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DECODEDIMAGECACHE_H
+#define DECODEDIMAGECACHE_H
+
+#include <list>
+#include <QString>
+#include <QImage>
+#include <QSize>
+#include <QHash>
+#include <QMutex>
+
+namespace QMLExtensions {
+    /*
+     * Recently shown previews which are already decoded.
+     * Cache is bounded by the bytes of images with LRU eviction
+     * and is shared between image providers.
+    */
+    class DecodedImageCache
+    {
+    public:
+        DecodedImageCache(qint64 maxBytes);
+
+    public:
+        static QString makeKey(const QString &filepath, const QSize &requestedSize);
+
+    public:
+        bool tryGet(const QString &key, QImage &image);
+        void insert(const QString &key, const QImage &image);
+        void remove(const QString &key);
+        void clear();
+
+    public:
+        int size();
+        qint64 getUsedBytes();
+        qint64 getMaxBytes() const { return m_MaxBytes; }
+        int getHitsCount();
+        int getMissesCount();
+        double getHitRatio();
+
+    private:
+        void evictIfNeeded();
+        void accountLookup(bool hit);
+
+    private:
+        struct CachedImage {
+            QImage m_Image;
+            // position in the usage list
+            std::list<QString>::iterator m_UsageIt;
+        };
+
+    private:
+        QMutex m_CacheMutex;
+        QHash<QString, CachedImage> m_Cache;
+        // most recently used images go first
+        std::list<QString> m_UsageOrder;
+        qint64 m_MaxBytes;
+        qint64 m_UsedBytes;
+        int m_HitsCount;
+        int m_MissesCount;
+    };
+}
+
+#endif // DECODEDIMAGECACHE_H
@@ -0,0 +1,624 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "imagecacheindex.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QSet>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <QMutexLocker>
+#include <algorithm>
+#include <utility>
+#include "../Common/defines.h"
+#include "../Helpers/constants.h"
+
+#define INDEX_MAGIC 0x58504943
+#define INDEX_VERSION 2
+#define INDEX_STREAM_VERSION QDataStream::Qt_5_2
+#define FLUSH_RECORDS_EVERY 50
+#define COMPACTION_MIN_RECORDS 1000
+#define EVICTION_TARGET_RATIO 0.9
+#define DEFAULT_MAX_CACHE_SIZE (2048LL * 1024 * 1024)
+
+namespace QMLExtensions {
+    enum IndexRecordType {
+        RecordPut = 1,
+        RecordTouch = 2,
+        RecordRemove = 3
+    };
+
+    void writePutRecord(QDataStream &out, const QString &key, const CachedImage &cachedImage) {
+        out << (quint8)RecordPut << key << cachedImage.m_Filename
+            << (qint64)cachedImage.m_LastModified.toMSecsSinceEpoch()
+            << cachedImage.m_Size << cachedImage.m_FileSize;
+    }
+
+    void writeKeyRecord(QDataStream &out, IndexRecordType recordType, const QString &key) {
+        out << (quint8)recordType << key;
+    }
+
+    ImageCacheIndex::ImageCacheIndex():
+        m_TotalCacheSize(0),
+        m_MaxCacheSize(DEFAULT_MAX_CACHE_SIZE),
+        m_RequestsServedCount(0),
+        m_LogRecordsCount(0),
+        m_PendingRecordsCount(0),
+        m_IsInitialized(false)
+    {
+    }
+
+    void ImageCacheIndex::setMaxCacheSize(qint64 maxCacheSize) {
+        LOG_INFO << maxCacheSize;
+        Q_ASSERT(maxCacheSize > 0);
+
+        // index could be read at the same time
+        QMutexLocker initLocker(&m_InitMutex);
+        Q_UNUSED(initLocker);
+
+        QStringList evictedKeys, evictedFiles;
+        {
+            QWriteLocker locker(&m_CacheLock);
+            Q_UNUSED(locker);
+            m_MaxCacheSize = maxCacheSize;
+
+            if (m_IsInitialized) {
+                evictIfNeeded(evictedKeys, evictedFiles);
+            }
+        }
+
+        if (evictedKeys.isEmpty()) { return; }
+
+        LOG_INFO << "Evicted" << evictedKeys.size() << "image(s) after budget change";
+        removeCachedFiles(evictedFiles);
+
+        QMutexLocker logLocker(&m_LogMutex);
+        Q_UNUSED(logLocker);
+
+        appendRemoveRecords(evictedKeys);
+        flushRecords();
+    }
+
+    void ImageCacheIndex::initialize() {
+        QString appDataPath = XPIKS_USERDATA_PATH;
+        initialize(appDataPath);
+    }
+
+    void ImageCacheIndex::initialize(const QString &appDataPath) {
+        QMutexLocker initLocker(&m_InitMutex);
+        Q_UNUSED(initLocker);
+
+        if (m_IsInitialized) { return; }
+
+        LOG_DEBUG << appDataPath;
+
+        if (!appDataPath.isEmpty()) {
+            m_ImagesCacheDir = QDir::cleanPath(appDataPath + QDir::separator() + Constants::IMAGES_CACHE_DIR);
+            QDir appDataDir(appDataPath);
+            m_IndexFilepath = appDataDir.filePath(Constants::IMAGES_CACHE_INDEX);
+
+            QDir imagesCacheDir(m_ImagesCacheDir);
+            if (!imagesCacheDir.exists()) {
+                LOG_INFO << "Creating cache dir" << m_ImagesCacheDir;
+                QDir().mkpath(m_ImagesCacheDir);
+            }
+
+            migrateLegacyIndex(appDataDir.filePath(Constants::IMAGES_CACHE_LEGACY_INDEX));
+        } else {
+            m_ImagesCacheDir = QDir::currentPath();
+            m_IndexFilepath = Constants::IMAGES_CACHE_INDEX;
+        }
+
+        LOG_INFO << "Using" << m_ImagesCacheDir << "for images cache";
+
+        QMutexLocker logLocker(&m_LogMutex);
+        Q_UNUSED(logLocker);
+
+        const bool canAppend = readIndex();
+
+        // budget could have been decreased since last run
+        QStringList evictedKeys, evictedFiles;
+        {
+            QWriteLocker locker(&m_CacheLock);
+            Q_UNUSED(locker);
+            evictIfNeeded(evictedKeys, evictedFiles);
+        }
+
+        removeCachedFiles(evictedFiles);
+
+        if (!canAppend || !evictedKeys.isEmpty() || needsCompaction()) {
+            compactIndex();
+        }
+
+        m_IsInitialized = true;
+    }
+
+    bool ImageCacheIndex::tryGetCachedImage(const QString &key, const QSize &requestedSize,
+                                            QString &cachedPath, bool &needsUpdate, bool &needsVerification) {
+        bool found = false;
+
+        QReadLocker locker(&m_CacheLock);
+        Q_UNUSED(locker);
+
+        auto it = m_CacheIndex.constFind(key);
+        if (it != m_CacheIndex.constEnd()) {
+            const CachedImage &cachedImage = it.value();
+
+            // exact LRU order is not needed so counters are relaxed
+            cachedImage.m_RequestsServed.fetchAndAddRelaxed(1);
+            cachedImage.m_LastRequestIndex.store(m_RequestsServedCount.fetchAndAddRelaxed(1) + 1);
+
+            if (cachedImage.m_IsTouched.testAndSetRelaxed(0, 1)) {
+                QMutexLocker touchedLocker(&m_TouchedMutex);
+                Q_UNUSED(touchedLocker);
+                m_TouchedKeys.append(key);
+            }
+
+            cachedPath = QDir::cleanPath(m_ImagesCacheDir + QDir::separator() + cachedImage.m_Filename);
+            needsUpdate = (cachedImage.m_Size != requestedSize);
+            // edited sources are found by the worker which verifies the entry
+            needsVerification = !cachedImage.m_IsVerified;
+
+            found = true;
+        }
+
+        return found;
+    }
+
+    bool ImageCacheIndex::isUpToDate(const QString &key, const QSize &requestedSize) {
+        QString cachedPath;
+        QDateTime lastModified;
+        QSize cachedSize;
+        bool isVerified = false;
+
+        {
+            QReadLocker locker(&m_CacheLock);
+            Q_UNUSED(locker);
+
+            auto it = m_CacheIndex.constFind(key);
+            if (it == m_CacheIndex.constEnd()) { return false; }
+
+            const CachedImage &cachedImage = it.value();
+            cachedPath = QDir::cleanPath(m_ImagesCacheDir + QDir::separator() + cachedImage.m_Filename);
+            lastModified = cachedImage.m_LastModified;
+            cachedSize = cachedImage.m_Size;
+            isVerified = cachedImage.m_IsVerified;
+        }
+
+        if (cachedSize != requestedSize) { return false; }
+        if (!isVerified && !QFileInfo(cachedPath).exists()) { return false; }
+
+        const bool upToDate = (QFileInfo(key).lastModified() <= lastModified);
+
+        if (upToDate && !isVerified) {
+            QWriteLocker locker(&m_CacheLock);
+            Q_UNUSED(locker);
+
+            auto it = m_CacheIndex.find(key);
+            if (it != m_CacheIndex.end()) {
+                it.value().m_IsVerified = true;
+            }
+        }
+
+        return upToDate;
+    }
+
+    void ImageCacheIndex::splitToCachedAndNot(const std::vector<std::shared_ptr<ImageCacheRequest> > &allRequests,
+                                              std::vector<std::shared_ptr<ImageCacheRequest> > &unknownRequests,
+                                              std::vector<std::shared_ptr<ImageCacheRequest> > &knownRequests) {
+        size_t size = allRequests.size();
+        if (size == 0) { return; }
+
+        LOG_DEBUG << "#";
+
+        QReadLocker locker(&m_CacheLock);
+        Q_UNUSED(locker);
+
+        knownRequests.reserve(size);
+        unknownRequests.reserve(size);
+
+        for (size_t i = 0; i < size; ++i) {
+            auto &item = allRequests.at(i);
+
+            if (m_CacheIndex.contains(item->getFilepath())) {
+                knownRequests.push_back(item);
+            } else {
+                unknownRequests.push_back(item);
+            }
+        }
+
+        LOG_DEBUG << knownRequests.size() << "known and" << unknownRequests.size() << "unknown";
+    }
+
+    void ImageCacheIndex::updateCachedImage(const QString &originalPath, CachedImage &cachedImage) {
+        QStringList evictedKeys, evictedFiles;
+
+        {
+            QWriteLocker locker(&m_CacheLock);
+            Q_UNUSED(locker);
+
+            auto it = m_CacheIndex.find(originalPath);
+            if (it != m_CacheIndex.end()) {
+                cachedImage.m_RequestsServed.store(it.value().m_RequestsServed.load() + 1);
+                cachedImage.m_IsTouched.store(it.value().m_IsTouched.load());
+                m_TotalCacheSize -= it.value().m_FileSize;
+            } else {
+                cachedImage.m_RequestsServed.store(1);
+            }
+
+            cachedImage.m_LastRequestIndex.store(m_RequestsServedCount.fetchAndAddRelaxed(1) + 1);
+            cachedImage.m_IsVerified = true;
+
+            m_CacheIndex.insert(originalPath, cachedImage);
+            m_TotalCacheSize += cachedImage.m_FileSize;
+
+            evictIfNeeded(evictedKeys, evictedFiles);
+        }
+
+        removeCachedFiles(evictedFiles);
+
+        QMutexLocker logLocker(&m_LogMutex);
+        Q_UNUSED(logLocker);
+
+        appendPutRecord(originalPath, cachedImage);
+        appendRemoveRecords(evictedKeys);
+
+        if (m_PendingRecordsCount >= FLUSH_RECORDS_EVERY) {
+            flushRecords();
+        }
+    }
+
+    void ImageCacheIndex::invalidateDirectories(const QStringList &directories) {
+        if (directories.isEmpty()) { return; }
+
+        const QSet<QString> directoriesSet = directories.toSet();
+        int invalidatedCount = 0;
+
+        QWriteLocker locker(&m_CacheLock);
+        Q_UNUSED(locker);
+
+        auto itEnd = m_CacheIndex.end();
+        for (auto it = m_CacheIndex.begin(); it != itEnd; ++it) {
+            CachedImage &cachedImage = it.value();
+            if (!cachedImage.m_IsVerified) { continue; }
+
+            if (directoriesSet.contains(QFileInfo(it.key()).absolutePath())) {
+                cachedImage.m_IsVerified = false;
+                invalidatedCount++;
+            }
+        }
+
+        LOG_DEBUG << invalidatedCount << "cached image(s) need verification";
+    }
+
+    void ImageCacheIndex::sync() {
+        if (!m_IsInitialized) { return; }
+
+        LOG_DEBUG << "#";
+
+        QMutexLocker logLocker(&m_LogMutex);
+        Q_UNUSED(logLocker);
+
+        flushRecords();
+
+        if (needsCompaction()) {
+            compactIndex();
+        }
+    }
+
+    void ImageCacheIndex::migrateLegacyIndex(const QString &legacyIndexPath) {
+        if (QFileInfo(m_IndexFilepath).exists() ||
+                !QFileInfo(legacyIndexPath).exists()) {
+            return;
+        }
+
+        // files of the legacy cache are not accounted in the budget so they are dropped
+        LOG_INFO << "Removing legacy images cache";
+
+        QDir imagesCacheDir(m_ImagesCacheDir);
+        const QStringList cachedFiles = imagesCacheDir.entryList(QDir::Files);
+        for (auto &filename: cachedFiles) {
+            imagesCacheDir.remove(filename);
+        }
+
+        QFile::remove(legacyIndexPath);
+    }
+
+    bool ImageCacheIndex::readIndex() {
+        QFile file(m_IndexFilepath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            LOG_WARNING << "File not found:" << m_IndexFilepath;
+            return false;
+        }
+
+        const qint64 fileSize = file.size();
+        uchar *mappedData = (fileSize > 0) ? file.map(0, fileSize) : nullptr;
+
+        QByteArray data;
+        if (mappedData != nullptr) {
+            data = QByteArray::fromRawData((const char *)mappedData, (int)fileSize);
+        } else {
+            data = file.readAll();
+        }
+
+        QDataStream in(data);
+        in.setVersion(INDEX_STREAM_VERSION);
+
+        quint32 magic = 0, version = 0;
+        in >> magic >> version;
+        if ((in.status() != QDataStream::Ok) || (magic != INDEX_MAGIC) || (version != INDEX_VERSION)) {
+            LOG_WARNING << "Unsupported images cache index format";
+            return false;
+        }
+
+        QHash<QString, CachedImage> cacheIndex;
+        qint64 totalCacheSize = 0;
+        quint64 requestsServedCount = 0;
+        int recordsCount = 0;
+        bool isLogValid = true;
+
+        // records come in the order of usage so LRU order is restored by replaying them
+        while (!in.atEnd()) {
+            quint8 recordType = 0;
+            QString key;
+            in >> recordType >> key;
+
+            if (recordType == RecordPut) {
+                QString filename;
+                qint64 lastModified = 0;
+                QSize size;
+                qint64 cachedFileSize = 0;
+                in >> filename >> lastModified >> size >> cachedFileSize;
+
+                if (in.status() != QDataStream::Ok) { isLogValid = false; break; }
+
+                CachedImage &cachedImage = cacheIndex[key];
+                totalCacheSize -= cachedImage.m_FileSize;
+
+                cachedImage.m_Filename = filename;
+                cachedImage.m_LastModified = QDateTime::fromMSecsSinceEpoch(lastModified);
+                cachedImage.m_Size = size;
+                cachedImage.m_FileSize = cachedFileSize;
+                cachedImage.m_LastRequestIndex.store(++requestsServedCount);
+
+                totalCacheSize += cachedFileSize;
+            } else if (recordType == RecordTouch) {
+                if (in.status() != QDataStream::Ok) { isLogValid = false; break; }
+
+                auto it = cacheIndex.find(key);
+                if (it != cacheIndex.end()) {
+                    it.value().m_LastRequestIndex.store(++requestsServedCount);
+                }
+            } else if (recordType == RecordRemove) {
+                if (in.status() != QDataStream::Ok) { isLogValid = false; break; }
+
+                auto it = cacheIndex.find(key);
+                if (it != cacheIndex.end()) {
+                    totalCacheSize -= it.value().m_FileSize;
+                    cacheIndex.erase(it);
+                }
+            } else {
+                isLogValid = false;
+                break;
+            }
+
+            recordsCount++;
+        }
+
+        if (!isLogValid) {
+            LOG_WARNING << "Images cache index is truncated after" << recordsCount << "records";
+        }
+
+        if (mappedData != nullptr) {
+            data.clear();
+            file.unmap(mappedData);
+        }
+
+        file.close();
+
+        {
+            QWriteLocker locker(&m_CacheLock);
+            Q_UNUSED(locker);
+
+            m_CacheIndex.swap(cacheIndex);
+            m_TotalCacheSize = totalCacheSize;
+            m_RequestsServedCount.store(requestsServedCount);
+        }
+
+        m_LogRecordsCount = recordsCount;
+
+        LOG_INFO << "Images cache index read:" << m_CacheIndex.size() << "entries," << totalCacheSize << "bytes";
+
+        return isLogValid;
+    }
+
+    void ImageCacheIndex::evictIfNeeded(QStringList &evictedKeys, QStringList &evictedFiles) {
+        // m_CacheLock should be locked for writing
+        if (m_TotalCacheSize <= m_MaxCacheSize) { return; }
+
+        const qint64 targetCacheSize = (qint64)(m_MaxCacheSize * EVICTION_TARGET_RATIO);
+
+        std::vector<std::pair<quint64, QString> > usageOrder;
+        usageOrder.reserve(m_CacheIndex.size());
+
+        auto itEnd = m_CacheIndex.constEnd();
+        for (auto it = m_CacheIndex.constBegin(); it != itEnd; ++it) {
+            usageOrder.emplace_back(it.value().m_LastRequestIndex.load(), it.key());
+        }
+
+        std::sort(usageOrder.begin(), usageOrder.end(),
+                  [](const std::pair<quint64, QString> &a, const std::pair<quint64, QString> &b) {
+            return a.first < b.first;
+        });
+
+        for (auto &usage: usageOrder) {
+            if (m_TotalCacheSize <= targetCacheSize) { break; }
+
+            auto it = m_CacheIndex.find(usage.second);
+            Q_ASSERT(it != m_CacheIndex.end());
+
+            m_TotalCacheSize -= it.value().m_FileSize;
+            evictedFiles.append(it.value().m_Filename);
+            evictedKeys.append(usage.second);
+            m_CacheIndex.erase(it);
+        }
+
+        LOG_INFO << "Evicted" << evictedKeys.size() << "images from cache";
+    }
+
+    void ImageCacheIndex::removeCachedFiles(const QStringList &filenames) {
+        if (filenames.isEmpty()) { return; }
+
+        QDir imagesCacheDir(m_ImagesCacheDir);
+        for (auto &filename: filenames) {
+            if (!imagesCacheDir.remove(filename)) {
+                LOG_WARNING << "Failed to remove cached image" << filename;
+            }
+        }
+    }
+
+    void ImageCacheIndex::appendPutRecord(const QString &key, const CachedImage &cachedImage) {
+        // m_LogMutex should be locked
+        QDataStream out(&m_PendingRecords, QIODevice::WriteOnly | QIODevice::Append);
+        out.setVersion(INDEX_STREAM_VERSION);
+        writePutRecord(out, key, cachedImage);
+        m_PendingRecordsCount++;
+    }
+
+    void ImageCacheIndex::appendRemoveRecords(const QStringList &keys) {
+        // m_LogMutex should be locked
+        if (keys.isEmpty()) { return; }
+
+        QDataStream out(&m_PendingRecords, QIODevice::WriteOnly | QIODevice::Append);
+        out.setVersion(INDEX_STREAM_VERSION);
+
+        for (auto &key: keys) {
+            writeKeyRecord(out, RecordRemove, key);
+        }
+
+        m_PendingRecordsCount += keys.size();
+    }
+
+    void ImageCacheIndex::flushRecords() {
+        // m_LogMutex should be locked
+        QStringList touchedKeys;
+
+        {
+            QWriteLocker locker(&m_CacheLock);
+            Q_UNUSED(locker);
+
+            // no hits can happen while cache is locked for writing
+            touchedKeys.swap(m_TouchedKeys);
+            for (auto &key: touchedKeys) {
+                auto it = m_CacheIndex.find(key);
+                if (it != m_CacheIndex.end()) {
+                    it.value().m_IsTouched.store(0);
+                }
+            }
+        }
+
+        if (!touchedKeys.isEmpty()) {
+            QDataStream out(&m_PendingRecords, QIODevice::WriteOnly | QIODevice::Append);
+            out.setVersion(INDEX_STREAM_VERSION);
+
+            for (auto &key: touchedKeys) {
+                writeKeyRecord(out, RecordTouch, key);
+            }
+
+            m_PendingRecordsCount += touchedKeys.size();
+        }
+
+        if (m_PendingRecords.isEmpty()) { return; }
+
+        QFile file(m_IndexFilepath);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            file.write(m_PendingRecords);
+            file.close();
+            m_LogRecordsCount += m_PendingRecordsCount;
+            LOG_DEBUG << "Appended" << m_PendingRecordsCount << "records to images cache index";
+        } else {
+            LOG_WARNING << "Failed to open" << m_IndexFilepath;
+        }
+
+        m_PendingRecords.clear();
+        m_PendingRecordsCount = 0;
+    }
+
+    void ImageCacheIndex::compactIndex() {
+        // m_LogMutex should be locked
+        LOG_DEBUG << "#";
+
+        QSaveFile file(m_IndexFilepath);
+        if (!file.open(QIODevice::WriteOnly)) {
+            LOG_WARNING << "Failed to open" << m_IndexFilepath;
+            return;
+        }
+
+        int recordsCount = 0;
+
+        {
+            QDataStream out(&file);
+            out.setVersion(INDEX_STREAM_VERSION);
+            out << (quint32)INDEX_MAGIC << (quint32)INDEX_VERSION;
+
+            QReadLocker locker(&m_CacheLock);
+            Q_UNUSED(locker);
+
+            std::vector<std::pair<quint64, QString> > usageOrder;
+            usageOrder.reserve(m_CacheIndex.size());
+
+            auto itEnd = m_CacheIndex.constEnd();
+            for (auto it = m_CacheIndex.constBegin(); it != itEnd; ++it) {
+                usageOrder.emplace_back(it.value().m_LastRequestIndex.load(), it.key());
+            }
+
+            // least recently used go first so the order is restored on replay
+            std::sort(usageOrder.begin(), usageOrder.end(),
+                      [](const std::pair<quint64, QString> &a, const std::pair<quint64, QString> &b) {
+                return a.first < b.first;
+            });
+
+            for (auto &usage: usageOrder) {
+                writePutRecord(out, usage.second, m_CacheIndex.value(usage.second));
+            }
+
+            recordsCount = (int)usageOrder.size();
+        }
+
+        if (file.commit()) {
+            // everything pending is already reflected in the compacted index
+            m_PendingRecords.clear();
+            m_PendingRecordsCount = 0;
+            m_LogRecordsCount = recordsCount;
+            LOG_INFO << "Images cache index compacted:" << recordsCount << "entries";
+        } else {
+            LOG_WARNING << "Failed to save" << m_IndexFilepath;
+        }
+    }
+
+    bool ImageCacheIndex::needsCompaction() const {
+        return (m_LogRecordsCount > COMPACTION_MIN_RECORDS) &&
+                (m_LogRecordsCount > 2 * m_CacheIndex.size());
+    }
+}
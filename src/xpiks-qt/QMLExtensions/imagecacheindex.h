@@ -0,0 +1,134 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef IMAGECACHEINDEX_H
+#define IMAGECACHEINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QDateTime>
+#include <QByteArray>
+#include <QSize>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QReadLocker>
+#include <QAtomicInt>
+#include <QAtomicInteger>
+#include <memory>
+#include <vector>
+#include "imagecacherequest.h"
+
+namespace QMLExtensions {
+    struct CachedImage {
+        CachedImage():
+            m_FileSize(0),
+            m_RequestsServed(0),
+            m_LastRequestIndex(0),
+            m_IsTouched(0),
+            m_IsVerified(false)
+        { }
+
+        QDateTime m_LastModified;
+        QString m_Filename;
+        QSize m_Size;
+        qint64 m_FileSize;
+        // hits only update usage counters so they are served under read lock
+        mutable QAtomicInteger<quint64> m_RequestsServed;
+        // value of total requests served counter at the moment of last hit
+        mutable QAtomicInteger<quint64> m_LastRequestIndex;
+        // was hit since the last flush of the index log
+        mutable QAtomicInt m_IsTouched;
+        // source and cached files were checked during this session
+        // reset when files in the source directory change on disk
+        bool m_IsVerified;
+    };
+
+    /*
+     * Index is shared between all caching workers of the pool.
+     * It is persisted as an append-only log of put/touch/remove records
+     * which is compacted only when it gets much bigger than the index itself.
+     * The cache directory is bounded by bytes budget with LRU eviction.
+    */
+    class ImageCacheIndex
+    {
+    public:
+        ImageCacheIndex();
+
+    public:
+        const QString &getImagesCacheDir() const { return m_ImagesCacheDir; }
+        void setMaxCacheSize(qint64 maxCacheSize);
+
+    public:
+        // safe to call from every worker: only the first call reads the index
+        void initialize();
+        void initialize(const QString &appDataPath);
+        // does not access disk, so it can be used from image provider
+        bool tryGetCachedImage(const QString &key, const QSize &requestedSize,
+                               QString &cached, bool &needsUpdate, bool &needsVerification);
+        // checks source and cached files on disk, should be used from workers only
+        bool isUpToDate(const QString &key, const QSize &requestedSize);
+        void splitToCachedAndNot(const std::vector<std::shared_ptr<ImageCacheRequest> > &allRequests,
+                                 std::vector<std::shared_ptr<ImageCacheRequest> > &unknownRequests,
+                                 std::vector<std::shared_ptr<ImageCacheRequest> > &knownRequests);
+        void updateCachedImage(const QString &originalPath, CachedImage &cachedImage);
+        // sources in these directories will be checked by workers on next hit
+        void invalidateDirectories(const QStringList &directories);
+        void sync();
+
+#ifdef CORE_TESTS
+        bool getIsCached(const QString &key) { QReadLocker locker(&m_CacheLock); Q_UNUSED(locker); return m_CacheIndex.contains(key); }
+        int getCachedImagesCount() { QReadLocker locker(&m_CacheLock); Q_UNUSED(locker); return m_CacheIndex.size(); }
+        qint64 getTotalCacheSize() { QReadLocker locker(&m_CacheLock); Q_UNUSED(locker); return m_TotalCacheSize; }
+        const QString &getIndexFilepath() const { return m_IndexFilepath; }
+#endif
+
+    private:
+        void migrateLegacyIndex(const QString &legacyIndexPath);
+        bool readIndex();
+        void evictIfNeeded(QStringList &evictedKeys, QStringList &evictedFiles);
+        void removeCachedFiles(const QStringList &filenames);
+        void appendPutRecord(const QString &key, const CachedImage &cachedImage);
+        void appendRemoveRecords(const QStringList &keys);
+        void flushRecords();
+        void compactIndex();
+        bool needsCompaction() const;
+
+    private:
+        QMutex m_InitMutex;
+        QMutex m_LogMutex;
+        QMutex m_TouchedMutex;
+        QString m_ImagesCacheDir;
+        QString m_IndexFilepath;
+        QReadWriteLock m_CacheLock;
+        QHash<QString, CachedImage> m_CacheIndex;
+        QStringList m_TouchedKeys;
+        QByteArray m_PendingRecords;
+        qint64 m_TotalCacheSize;
+        qint64 m_MaxCacheSize;
+        QAtomicInteger<quint64> m_RequestsServedCount;
+        int m_LogRecordsCount;
+        int m_PendingRecordsCount;
+        volatile bool m_IsInitialized;
+    };
+}
+
+#endif // IMAGECACHEINDEX_H
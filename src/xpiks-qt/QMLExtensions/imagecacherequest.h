@@ -24,6 +24,7 @@
 
 #include <QString>
 #include <QSize>
+#include <QAtomicInt>
 
 namespace QMLExtensions {    
 
@@ -32,11 +33,12 @@ namespace QMLExtensions {
 
     class ImageCacheRequest {
     public:
-        ImageCacheRequest(const QString &filepath, const QSize &requestedSize, bool recache, bool withDelay=false):
+        ImageCacheRequest(const QString &filepath, const QSize &requestedSize, bool recache, bool withNotification=false):
             m_Filepath(filepath),
             m_RequestedSize(requestedSize),
+            m_Cancelled(0),
             m_Recache(recache),
-            m_WithDelay(withDelay)
+            m_WithNotification(withNotification)
         {
         }
 
@@ -44,13 +46,17 @@ namespace QMLExtensions {
         const QString &getFilepath() const { return m_Filepath; }
         const QSize &getRequestedSize() const { return m_RequestedSize; }
         bool getNeedRecache() const { return m_Recache; }
-        bool getWithDelay() const { return m_WithDelay; }
+        // somebody waits for this preview and has to be notified
+        bool getWithNotification() const { return m_WithNotification; }
+        bool getIsCancelled() const { return m_Cancelled.loadAcquire() != 0; }
+        void cancel() { m_Cancelled.storeRelease(1); }
 
     private:
         QString m_Filepath;
         QSize m_RequestedSize;
+        QAtomicInt m_Cancelled;
         bool m_Recache;
-        bool m_WithDelay;
+        bool m_WithNotification;
     };
 }
 
@@ -22,69 +22,117 @@
 #include "imagecachingservice.h"
 #include <QThread>
 #include <QScreen>
+#include <QHash>
+#include <QImage>
 #include "imagecachingworker.h"
 #include "imagecacherequest.h"
+#include "imagecacheindex.h"
+#include "decodedimagecache.h"
 #include "../Models/artworkmetadata.h"
+#include "../Common/defines.h"
+
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 6, 0))
+#include "asynccachingimageprovider.h"
+#endif
+
+#define MAX_CACHING_THREADS 4
+#define MIN_CACHING_THREADS 1
 
 namespace QMLExtensions {
     ImageCachingService::ImageCachingService(QObject *parent) :
         QObject(parent),
-        m_CachingWorker(NULL),
+        m_CacheIndex(new ImageCacheIndex()),
+        m_DecodedImageCache(NULL),
         m_IsCancelled(false),
         m_Scale(1.0)
     {
     }
 
     void ImageCachingService::startService() {
-        m_CachingWorker = new ImageCachingWorker();
+        // leave one core for the UI and other services
+        int threadsCount = qMin(qMax(QThread::idealThreadCount() - 1, MIN_CACHING_THREADS), MAX_CACHING_THREADS);
+        m_CachingWorkers.reserve(threadsCount);
+
+        for (int i = 0; i < threadsCount; ++i) {
+            ImageCachingWorker *worker = new ImageCachingWorker(i, m_CacheIndex);
+            worker->setScale(m_Scale);
+
+            QThread *thread = new QThread();
+            worker->moveToThread(thread);
+
+            QObject::connect(thread, SIGNAL(started()), worker, SLOT(process()));
+            QObject::connect(worker, SIGNAL(stopped()), thread, SLOT(quit()));
 
-        QThread *thread = new QThread();
-        m_CachingWorker->moveToThread(thread);
+            QObject::connect(worker, SIGNAL(stopped()), worker, SLOT(deleteLater()));
+            QObject::connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
 
-        QObject::connect(thread, SIGNAL(started()), m_CachingWorker, SLOT(process()));
-        QObject::connect(m_CachingWorker, SIGNAL(stopped()), thread, SLOT(quit()));
+            // previews are delivered right from the caching thread
+            QObject::connect(worker, SIGNAL(imageCached(QString,QSize)),
+                             this, SLOT(imageCachedHandler(QString,QSize)),
+                             Qt::DirectConnection);
 
-        QObject::connect(m_CachingWorker, SIGNAL(stopped()), m_CachingWorker, SLOT(deleteLater()));
-        QObject::connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
+            m_CachingWorkers.append(worker);
 
-        LOG_DEBUG << "starting low priority thread...";
-        thread->start(QThread::LowPriority);
+            thread->start(QThread::LowPriority);
+        }
+
+        LOG_INFO << "Started" << threadsCount << "low priority caching threads";
     }
 
     void ImageCachingService::stopService() {
         LOG_DEBUG << "#";
 
-        if (m_CachingWorker != NULL) {
+        if (!m_CachingWorkers.isEmpty()) {
             m_IsCancelled = true;
-            m_CachingWorker->stopWorking();
+            for (auto *worker: m_CachingWorkers) {
+                worker->stopWorking();
+            }
         } else {
-            LOG_WARNING << "Caching Worker was NULL";
+            LOG_WARNING << "Caching Workers were not started";
         }
+
+        finishPendingPreviews();
     }
 
     void ImageCachingService::setScale(qreal scale) {
         LOG_INFO << scale;
         if ((0.99f < scale) && (scale < 5.0f)) {
             m_Scale = scale;
-            if (m_CachingWorker != nullptr) {
-                m_CachingWorker->setScale(scale);
+            for (auto *worker: m_CachingWorkers) {
+                worker->setScale(scale);
             }
             LOG_INFO << "Scale is now" << m_Scale;
         }
     }
 
+    void ImageCachingService::setMaxCacheSize(qint64 maxCacheSize) {
+        m_CacheIndex->setMaxCacheSize(maxCacheSize);
+    }
+
+    void ImageCachingService::imagesCacheSizeChangedHandler(int sizeMB) {
+        LOG_INFO << sizeMB << "MB";
+        setMaxCacheSize((qint64)sizeMB * 1024 * 1024);
+    }
+
+    void ImageCachingService::filesChangedHandler(const QStringList &directories) {
+        LOG_DEBUG << directories.size() << "directory(ies)";
+        // edited sources will be recached after verification on next hit
+        m_CacheIndex->invalidateDirectories(directories);
+    }
+
     void ImageCachingService::cacheImage(const QString &key, const QSize &requestedSize, bool recache) {
         if (m_IsCancelled) { return; }
 
-        Q_ASSERT(m_CachingWorker != NULL);
+        Q_ASSERT(!m_CachingWorkers.isEmpty());
         std::shared_ptr<ImageCacheRequest> request(new ImageCacheRequest(key, requestedSize, recache));
-        m_CachingWorker->submitFirst(request);
+        // requests from image provider are for visible items so they go first
+        getWorker(key)->submitFirst(request);
     }
 
     void ImageCachingService::generatePreviews(const QVector<Models::ArtworkMetadata *> &items) {
         if (m_IsCancelled) { return; }
 
-        Q_ASSERT(m_CachingWorker != NULL);
+        Q_ASSERT(!m_CachingWorkers.isEmpty());
         LOG_INFO << "generating for" << items.size() << "items";
 
         std::vector<std::shared_ptr<ImageCacheRequest> > requests;
@@ -93,29 +141,209 @@ namespace QMLExtensions {
         const bool recache = false;
 
         for (int i = 0; i < size; ++i) {
-            bool withDelay = i % 2;
             Models::ArtworkMetadata *artwork = items.at(i);
             requests.emplace_back(new ImageCacheRequest(artwork->getFilepath(),
                                                         QSize(DEFAULT_THUMB_WIDTH * m_Scale, DEFAULT_THUMB_HEIGHT * m_Scale),
-                                                        recache,
-                                                        withDelay));
+                                                        recache));
         }
 
         std::vector<std::shared_ptr<ImageCacheRequest> > knownRequests;
         std::vector<std::shared_ptr<ImageCacheRequest> > unknownRequests;
-        m_CachingWorker->splitToCachedAndNot(requests, unknownRequests, knownRequests);
+        m_CacheIndex->splitToCachedAndNot(requests, unknownRequests, knownRequests);
+
+        const int workersCount = m_CachingWorkers.size();
+        std::vector<std::vector<std::shared_ptr<ImageCacheRequest> > > requestsPerWorker(workersCount);
+
+        // unknown go before known but after requests of the visible items
+        for (auto &request: unknownRequests) {
+            requestsPerWorker[qHash(request->getFilepath()) % workersCount].push_back(request);
+        }
+
+        for (auto &request: knownRequests) {
+            requestsPerWorker[qHash(request->getFilepath()) % workersCount].push_back(request);
+        }
 
-        m_CachingWorker->submitFirst(unknownRequests);
-        m_CachingWorker->submitItems(knownRequests);
+        for (int i = 0; i < workersCount; ++i) {
+            m_CachingWorkers[i]->submitItems(requestsPerWorker[i]);
+        }
     }
 
     bool ImageCachingService::tryGetCachedImage(const QString &key, const QSize &requestedSize,
                                                 QString &cached, bool &needsUpdate) {
-        if (!m_IsCancelled && m_CachingWorker != NULL) {
-            return m_CachingWorker->tryGetCachedImage(key, requestedSize, cached, needsUpdate);
-        } else {
+        bool needsVerification = false;
+        return tryGetCachedImage(key, requestedSize, cached, needsUpdate, needsVerification);
+    }
+
+    bool ImageCachingService::tryGetCachedImage(const QString &key, const QSize &requestedSize,
+                                                QImage &image, bool &needsUpdate) {
+        QString cachedPath;
+        bool needsVerification = false;
+        if (!tryGetCachedImage(key, requestedSize, cachedPath, needsUpdate, needsVerification)) { return false; }
+
+        const QString decodedKey = DecodedImageCache::makeKey(key, requestedSize);
+        // decoded image could be made from the source before it was edited
+        const bool canUseDecoded = !needsUpdate && !needsVerification;
+
+        if (m_DecodedImageCache != NULL) {
+            if (!canUseDecoded) {
+                m_DecodedImageCache->remove(decodedKey);
+            } else if (m_DecodedImageCache->tryGet(decodedKey, image)) {
+                return true;
+            }
+        }
+
+        if (!image.load(cachedPath)) {
+            LOG_WARNING << "Failed to load cached preview" << cachedPath;
             return false;
         }
+
+        // outdated previews are shown only until they are recached
+        if ((m_DecodedImageCache != NULL) && canUseDecoded) {
+            m_DecodedImageCache->insert(decodedKey, image);
+        }
+
+        return true;
+    }
+
+    bool ImageCachingService::tryGetCachedImage(const QString &key, const QSize &requestedSize, QString &cached,
+                                                bool &needsUpdate, bool &needsVerification) {
+        if (m_IsCancelled || m_CachingWorkers.isEmpty()) { return false; }
+
+        bool found = m_CacheIndex->tryGetCachedImage(key, requestedSize, cached, needsUpdate, needsVerification);
+
+        if (found && !needsUpdate && needsVerification) {
+            // file system checks are done by the worker in the background
+            std::shared_ptr<ImageCacheRequest> request(new ImageCacheRequest(key, requestedSize, false));
+            getWorker(key)->submitItem(request);
+        }
+
+        return found;
+    }
+
+    void ImageCachingService::requestPreview(CachedImageResponse *response) {
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 6, 0))
+        Q_ASSERT(response != nullptr);
+
+        if (m_IsCancelled || m_CachingWorkers.isEmpty()) {
+            response->finishWithImage(QImage());
+            return;
+        }
+
+        const QString &filepath = response->getFilepath();
+        const QSize &requestedSize = response->getRequestedSize();
+        const QString key = DecodedImageCache::makeKey(filepath, requestedSize);
+
+        std::shared_ptr<ImageCacheRequest> request;
+
+        m_PendingPreviewsMutex.lock();
+        {
+            auto it = m_PendingPreviews.find(key);
+            if (it != m_PendingPreviews.end()) {
+                it->m_Responses.append(response);
+            } else {
+                request.reset(new ImageCacheRequest(filepath, requestedSize, false, true));
+                PendingPreview &pending = m_PendingPreviews[key];
+                pending.m_Request = request;
+                pending.m_Responses.append(response);
+            }
+        }
+        m_PendingPreviewsMutex.unlock();
+
+        if (request) {
+            // requests from image provider are for visible items so they go first
+            getWorker(filepath)->submitFirst(request);
+        } else {
+            LOG_INTEGR_TESTS_OR_DEBUG << "Preview is already requested for" << filepath;
+        }
+#else
+        Q_UNUSED(response);
+#endif
+    }
+
+    bool ImageCachingService::cancelPreview(CachedImageResponse *response) {
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 6, 0))
+        Q_ASSERT(response != nullptr);
+        const QString key = DecodedImageCache::makeKey(response->getFilepath(), response->getRequestedSize());
+        bool removed = false;
+
+        QMutexLocker locker(&m_PendingPreviewsMutex);
+
+        auto it = m_PendingPreviews.find(key);
+        if (it != m_PendingPreviews.end()) {
+            removed = it->m_Responses.removeOne(response);
+
+            if (it->m_Responses.isEmpty()) {
+                // nobody else needs it so worker can skip decoding
+                it->m_Request->cancel();
+                m_PendingPreviews.erase(it);
+            }
+        }
+
+        return removed;
+#else
+        Q_UNUSED(response);
+        return false;
+#endif
+    }
+
+    void ImageCachingService::imageCachedHandler(const QString &filepath, const QSize &requestedSize) {
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 6, 0))
+        const QString key = DecodedImageCache::makeKey(filepath, requestedSize);
+        QVector<CachedImageResponse *> responses;
+
+        m_PendingPreviewsMutex.lock();
+        {
+            auto it = m_PendingPreviews.find(key);
+            if (it != m_PendingPreviews.end()) {
+                responses.swap(it->m_Responses);
+                m_PendingPreviews.erase(it);
+            }
+        }
+        m_PendingPreviewsMutex.unlock();
+
+        if (responses.isEmpty()) { return; }
+
+        bool needsUpdate = false;
+        QImage image;
+
+        if (!tryGetCachedImage(filepath, requestedSize, image, needsUpdate)) {
+            LOG_WARNING << "Preview was not cached for" << filepath;
+        }
+
+        for (auto *response: responses) {
+            response->finishWithImage(image);
+        }
+#else
+        Q_UNUSED(filepath);
+        Q_UNUSED(requestedSize);
+#endif
+    }
+
+    void ImageCachingService::finishPendingPreviews() {
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 6, 0))
+        QHash<QString, PendingPreview> pendingPreviews;
+
+        m_PendingPreviewsMutex.lock();
+        {
+            pendingPreviews.swap(m_PendingPreviews);
+        }
+        m_PendingPreviewsMutex.unlock();
+
+        LOG_DEBUG << pendingPreviews.size() << "pending preview(s)";
+
+        for (auto &pending: pendingPreviews) {
+            pending.m_Request->cancel();
+            for (auto *response: pending.m_Responses) {
+                response->finishWithImage(QImage());
+            }
+        }
+#endif
+    }
+
+    ImageCachingWorker *ImageCachingService::getWorker(const QString &key) const {
+        // same file always goes to the same worker so duplicate requests are skipped as already processed
+        const int index = qHash(key) % m_CachingWorkers.size();
+        return m_CachingWorkers.at(index);
     }
 
     void ImageCachingService::screenChangedHandler(QScreen *screen) {
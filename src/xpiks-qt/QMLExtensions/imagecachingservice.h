@@ -24,16 +24,26 @@
 
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QVector>
+#include <QHash>
+#include <QMutex>
+#include <QSize>
+#include <memory>
 
 namespace Models {
     class ArtworkMetadata;
 }
 
 class QScreen;
+class QImage;
 
 namespace QMLExtensions {
     class ImageCachingWorker;
+    class ImageCacheIndex;
+    class ImageCacheRequest;
+    class CachedImageResponse;
+    class DecodedImageCache;
 
     class ImageCachingService : public QObject
     {
@@ -47,16 +57,43 @@ namespace QMLExtensions {
 
     public:
         void setScale(qreal scale);
+        void setMaxCacheSize(qint64 maxCacheSize);
         void cacheImage(const QString &key, const QSize &requestedSize, bool recache=false);
         void generatePreviews(const QVector<Models::ArtworkMetadata *> &items);
         bool tryGetCachedImage(const QString &key, const QSize &requestedSize, QString &cached, bool &needsUpdate);
+        bool tryGetCachedImage(const QString &key, const QSize &requestedSize, QImage &image, bool &needsUpdate);
+        void setDecodedImageCache(DecodedImageCache *decodedImageCache) { m_DecodedImageCache = decodedImageCache; }
+        void requestPreview(CachedImageResponse *response);
+        bool cancelPreview(CachedImageResponse *response);
+
+    private:
+        bool tryGetCachedImage(const QString &key, const QSize &requestedSize, QString &cached,
+                               bool &needsUpdate, bool &needsVerification);
+        ImageCachingWorker *getWorker(const QString &key) const;
+        void finishPendingPreviews();
 
     public slots:
         void screenChangedHandler(QScreen *screen);
         void dpiChanged(qreal someDPI);
+        void imagesCacheSizeChangedHandler(int sizeMB);
+        void filesChangedHandler(const QStringList &directories);
+
+    private slots:
+        void imageCachedHandler(const QString &filepath, const QSize &requestedSize);
+
+    private:
+        // all responses waiting for the same preview share one caching request
+        struct PendingPreview {
+            std::shared_ptr<ImageCacheRequest> m_Request;
+            QVector<CachedImageResponse *> m_Responses;
+        };
 
     private:
-        ImageCachingWorker *m_CachingWorker;
+        std::shared_ptr<ImageCacheIndex> m_CacheIndex;
+        QVector<ImageCachingWorker *> m_CachingWorkers;
+        QHash<QString, PendingPreview> m_PendingPreviews;
+        QMutex m_PendingPreviewsMutex;
+        DecodedImageCache *m_DecodedImageCache;
         volatile bool m_IsCancelled;
         qreal m_Scale;
     };
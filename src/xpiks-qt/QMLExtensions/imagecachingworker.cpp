@@ -21,76 +21,75 @@
 
 #include "imagecachingworker.h"
 #include <QDir>
-#include <QFile>
 #include <QImage>
+#include <QImageReader>
 #include <QString>
 #include <QFileInfo>
 #include <QByteArray>
-#include <QDataStream>
-#include <QReadLocker>
-#include <QWriteLocker>
 #include <QCryptographicHash>
 #include "../Common/defines.h"
-#include "../Helpers/constants.h"
 #include "imagecacherequest.h"
+#include "imagecacheindex.h"
+
+#ifdef Q_OS_WIN32
+#define _X86_
+#endif
+#include <exiv2/exiv2.hpp>
+
+// embedded thumbnail is used only if its aspect ratio is close to the original
+#define PREVIEW_ASPECT_RATIO_TOLERANCE 0.02
 
 namespace QMLExtensions {
     QString getPathHash(const QString &path) {
         return QString::fromLatin1(QCryptographicHash::hash(path.toUtf8(), QCryptographicHash::Sha256).toHex());
     }
 
-    QDataStream &operator<<(QDataStream &out, const CachedImage &v) {
-        out << v.m_Filename << v.m_LastModified << v.m_Size << v.m_RequestsServed << v.m_AdditionalData;
-        return out;
-    }
+    bool isPreviewAspectRatioValid(const QSize &originalSize, int previewWidth, int previewHeight) {
+        if ((originalSize.height() <= 0) || (previewHeight <= 0)) { return false; }
+
+        const double originalRatio = (double)originalSize.width() / (double)originalSize.height();
+        const double previewRatio = (double)previewWidth / (double)previewHeight;
 
-    QDataStream &operator>>(QDataStream &in, CachedImage &v) {
-        in >> v.m_Filename >> v.m_LastModified >> v.m_Size >> v.m_RequestsServed >> v.m_AdditionalData;
-        return in;
+        return qAbs(originalRatio - previewRatio) <= PREVIEW_ASPECT_RATIO_TOLERANCE * originalRatio;
     }
 
-    ImageCachingWorker::ImageCachingWorker(QObject *parent):
+    ImageCachingWorker::ImageCachingWorker(int workerIndex, const std::shared_ptr<ImageCacheIndex> &cacheIndex, QObject *parent):
         QObject(parent),
-        m_ProcessedItemsCount(0),
+        m_CacheIndex(cacheIndex),
+        m_WorkerIndex(workerIndex),
         m_Scale(1.0)
     {
+        Q_ASSERT(cacheIndex);
     }
 
     bool ImageCachingWorker::initWorker() {
-        LOG_DEBUG << "#";
+        LOG_DEBUG << "Worker #" << m_WorkerIndex;
 
-        m_ProcessedItemsCount = 0;
-        QString appDataPath = XPIKS_USERDATA_PATH;
+        m_CacheIndex->initialize();
 
-        if (!appDataPath.isEmpty()) {
-            m_ImagesCacheDir = QDir::cleanPath(appDataPath + QDir::separator() + Constants::IMAGES_CACHE_DIR);
-            QDir appDataDir(appDataPath);
-            m_IndexFilepath = appDataDir.filePath(Constants::IMAGES_CACHE_INDEX);
+        return true;
+    }
 
-            QDir imagesCacheDir(m_ImagesCacheDir);
-            if (!imagesCacheDir.exists()) {
-                LOG_INFO << "Creating cache dir" << m_ImagesCacheDir;
-                QDir().mkpath(m_ImagesCacheDir);
-            }
-        } else {
-            m_ImagesCacheDir = QDir::currentPath();
-            m_IndexFilepath = Constants::IMAGES_CACHE_INDEX;
+    void ImageCachingWorker::processOneItem(std::shared_ptr<ImageCacheRequest> &item) {
+        if (item->getIsCancelled()) {
+            LOG_INTEGR_TESTS_OR_DEBUG << "Skipping cancelled request for" << item->getFilepath();
+            return;
         }
 
-        LOG_INFO << "Using" << m_ImagesCacheDir << "for images cache";
-
-        readIndex();
+        cacheImage(item);
 
-        return true;
+        if (item->getWithNotification()) {
+            emit imageCached(item->getFilepath(), item->getRequestedSize());
+        }
     }
 
-    void ImageCachingWorker::processOneItem(std::shared_ptr<ImageCacheRequest> &item) {
+    void ImageCachingWorker::cacheImage(std::shared_ptr<ImageCacheRequest> &item) {
         if (isProcessed(item)) { return; }
 
         const QString &originalPath = item->getFilepath();
         QSize requestedSize = item->getRequestedSize();
 
-        LOG_INFO << (item->getNeedRecache() ? "Recaching" : "Caching") << originalPath << "with size" << requestedSize;
+        LOG_INFO << "#" << m_WorkerIndex << (item->getNeedRecache() ? "Recaching" : "Caching") << originalPath << "with size" << requestedSize;
 
         if (!requestedSize.isValid()) {
             LOG_WARNING << "Invalid requestedSize for" << originalPath;
@@ -98,144 +97,125 @@ namespace QMLExtensions {
             requestedSize.setWidth(DEFAULT_THUMB_WIDTH * m_Scale);
         }
 
-        QImage img(originalPath);
-        QImage resizedImage = img.scaled(requestedSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        QImage resizedImage;
+        if (!decodeThumbnail(originalPath, requestedSize, resizedImage)) {
+            LOG_WARNING << "Failed to decode image" << originalPath;
+            return;
+        }
 
         QFileInfo fi(originalPath);
         QString pathHash = getPathHash(originalPath) + "." + fi.suffix();
-        QString cachedFilepath = QDir::cleanPath(m_ImagesCacheDir + QDir::separator() + pathHash);
+        QString cachedFilepath = QDir::cleanPath(m_CacheIndex->getImagesCacheDir() + QDir::separator() + pathHash);
 
         if (resizedImage.save(cachedFilepath)) {
             CachedImage cachedImage;
             cachedImage.m_Filename = pathHash;
             cachedImage.m_LastModified = fi.lastModified();
             cachedImage.m_Size = requestedSize;
+            cachedImage.m_FileSize = QFileInfo(cachedFilepath).size();
 
-            {
-                QWriteLocker locker(&m_CacheLock);
-                Q_UNUSED(locker);
-
-                if (m_CacheIndex.contains(originalPath)) {
-                    cachedImage.m_RequestsServed = m_CacheIndex[originalPath].m_RequestsServed + 1;
-                } else {
-                    cachedImage.m_RequestsServed = 1;
-                }
-
-                m_CacheIndex.insert(originalPath, cachedImage);
-            }
-
-            m_ProcessedItemsCount++;
+            m_CacheIndex->updateCachedImage(originalPath, cachedImage);
         } else {
             LOG_WARNING << "Failed to save image. Path:" << cachedFilepath << "size" << requestedSize;
         }
-
-        if (m_ProcessedItemsCount % 50 == 0) {
-            saveIndex();
-        }
-
-        if (item->getWithDelay()) {
-            // force context switch for more imporant tasks
-            QThread::msleep(500);
-        }
     }
 
-    bool ImageCachingWorker::tryGetCachedImage(const QString &key, const QSize &requestedSize,
-                                               QString &cachedPath, bool &needsUpdate) {
-        bool found = false;
-        QReadLocker locker(&m_CacheLock);
-        Q_UNUSED(locker);
-
-        if (m_CacheIndex.contains(key)) {
-            CachedImage &cachedImage = m_CacheIndex[key];
-            QString cachedValue = QDir::cleanPath(m_ImagesCacheDir + QDir::separator() + cachedImage.m_Filename);
-
-            QFileInfo fi(cachedValue);
-
-            if (fi.exists()) {
-                cachedImage.m_RequestsServed++;
-                cachedPath = cachedValue;
-                needsUpdate = (QFileInfo(key).lastModified() > cachedImage.m_LastModified) || (cachedImage.m_Size != requestedSize);
-
-                found = true;
-            }
-        }
-
-        return found;
+    void ImageCachingWorker::workerStopped() {
+        m_CacheIndex->sync();
+        emit stopped();
     }
 
-    void ImageCachingWorker::splitToCachedAndNot(const std::vector<std::shared_ptr<ImageCacheRequest> > allRequests,
-                                                 std::vector<std::shared_ptr<ImageCacheRequest> > &unknownRequests,
-                                                 std::vector<std::shared_ptr<ImageCacheRequest> > &knownRequests) {
-        size_t size = allRequests.size();
-        if (size == 0) { return; }
-
-        LOG_DEBUG << "#";
+    bool ImageCachingWorker::isProcessed(std::shared_ptr<ImageCacheRequest> &item) {
+        if (item->getNeedRecache()) { return false; }
 
-        QReadLocker locker(&m_CacheLock);
-        Q_UNUSED(locker);
+        const QString &originalPath = item->getFilepath();
+        const QSize &requestedSize = item->getRequestedSize();
 
-        knownRequests.reserve(size);
-        unknownRequests.reserve(size);
+        bool isAlreadyProcessed = m_CacheIndex->isUpToDate(originalPath, requestedSize);
+        return isAlreadyProcessed;
+    }
 
-        for (size_t i = 0; i < size; ++i) {
-            auto &item = allRequests.at(i);
+    bool ImageCachingWorker::decodeThumbnail(const QString &originalPath, const QSize &requestedSize, QImage &thumbnail) {
+        QImageReader reader(originalPath);
+        const QSize originalSize = reader.size();
+        const QByteArray format = reader.format().toLower();
 
-            if (m_CacheIndex.contains(item->getFilepath())) {
-                knownRequests.push_back(item);
-            } else {
-                unknownRequests.push_back(item);
+        if (originalSize.isValid() &&
+                ((format == "jpeg") || (format == "jpg") || (format == "tiff"))) {
+            if (tryReadEmbeddedPreview(originalPath, originalSize, requestedSize, thumbnail)) {
+                return true;
             }
         }
 
-        LOG_DEBUG << knownRequests.size() << "known and" << unknownRequests.size() << "unknown";
-    }
+        const bool canDownscale = originalSize.isValid() &&
+                ((originalSize.width() > requestedSize.width()) || (originalSize.height() > requestedSize.height()));
 
-    void ImageCachingWorker::readIndex() {
-        QFile file(m_IndexFilepath);
-        if (file.open(QIODevice::ReadOnly)) {
-            QHash<QString, CachedImage> cacheIndex;
+        if (canDownscale) {
+            // jpeg handler decodes straight into the scaled size (DCT-domain scaling)
+            // so most of the original pixels are never materialized
+            reader.setScaledSize(originalSize.scaled(requestedSize, Qt::KeepAspectRatio));
+        }
 
-            QDataStream in(&file);   // read the data
-            in >> cacheIndex;
-            file.close();
+        QImage image;
+        if (!reader.read(&image)) {
+            LOG_WARNING << "Failed to read" << originalPath << ":" << reader.errorString();
+            return false;
+        }
 
-            m_CacheIndex.swap(cacheIndex);
-            LOG_INFO << "Images cache index read:" << m_CacheIndex.size() << "entries";
+        if (canDownscale) {
+            thumbnail.swap(image);
         } else {
-            LOG_WARNING << "File not found:" << m_IndexFilepath;
+            thumbnail = image.scaled(requestedSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
         }
-    }
-
-    void ImageCachingWorker::saveIndex() {
-        LOG_DEBUG << "#";
-
-        QFile file(m_IndexFilepath);
 
-        if (file.open(QIODevice::WriteOnly)) {
-            QReadLocker locker(&m_CacheLock);
-            Q_UNUSED(locker);
-
-            QDataStream out(&file);   // write the data
-            out << m_CacheIndex;
-            file.close();
-            LOG_INFO << "Images cache index saved:" << m_CacheIndex.size() << "entries";
-        }
+        return true;
     }
 
-    bool ImageCachingWorker::isProcessed(std::shared_ptr<ImageCacheRequest> &item) {
-        if (item->getNeedRecache()) { return false; }
-
-        const QString &originalPath = item->getFilepath();
-        const QSize &requestedSize = item->getRequestedSize();
-
-        bool isAlreadyProcessed = false;
+    bool ImageCachingWorker::tryReadEmbeddedPreview(const QString &originalPath, const QSize &originalSize,
+                                                    const QSize &requestedSize, QImage &preview) {
+        const QSize targetSize = originalSize.scaled(requestedSize, Qt::KeepAspectRatio);
+        bool success = false;
+
+        try {
+#if defined(Q_OS_WIN)
+            Exiv2::Image::AutoPtr image = Exiv2::ImageFactory::open(originalPath.toStdWString());
+#else
+            Exiv2::Image::AutoPtr image = Exiv2::ImageFactory::open(originalPath.toStdString());
+#endif
+            Q_ASSERT(image.get() != NULL);
+            image->readMetadata();
+
+            Exiv2::PreviewManager previewManager(*image);
+            Exiv2::PreviewPropertiesList propertiesList = previewManager.getPreviewProperties();
+
+            // list is sorted by preview size so the first suitable one is the cheapest
+            for (auto &properties: propertiesList) {
+                const int width = (int)properties.width_;
+                const int height = (int)properties.height_;
+
+                if ((width < targetSize.width()) || (height < targetSize.height())) { continue; }
+                if (!isPreviewAspectRatioValid(originalSize, width, height)) { continue; }
+
+                Exiv2::PreviewImage previewImage = previewManager.getPreviewImage(properties);
+                QImage image;
+                if (image.loadFromData((const uchar*)previewImage.pData(), (int)previewImage.size())) {
+                    preview = image.scaled(requestedSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+                    LOG_INTEGR_TESTS_OR_DEBUG << "Using embedded" << width << "x" << height << "preview for" << originalPath;
+                    success = true;
+                }
 
-        QString cachedPath;
-        bool needsUpdate = false;
-        if (this->tryGetCachedImage(originalPath, requestedSize, cachedPath, needsUpdate)) {
-            isAlreadyProcessed = !needsUpdate;
+                break;
+            }
+        }
+        catch (Exiv2::Error &e) {
+            LOG_WARNING << "Exiv2 error:" << e.what();
+            success = false;
+        }
+        catch (...) {
+            LOG_WARNING << "Exception while reading preview of" << originalPath;
+            success = false;
         }
 
-        return isAlreadyProcessed;
+        return success;
     }
 }
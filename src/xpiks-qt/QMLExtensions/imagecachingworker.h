@@ -24,30 +24,19 @@
 
 #include "../Common/itemprocessingworker.h"
 #include <QString>
-#include <QHash>
-#include <QDateTime>
+#include <QImage>
 #include <QSize>
-#include <QReadWriteLock>
+#include <memory>
 #include "imagecacherequest.h"
 
 namespace QMLExtensions {
-    struct CachedImage {
-        QDateTime m_LastModified;
-        QString m_Filename;
-        QSize m_Size;
-        quint64 m_RequestsServed;
-        // reserved for future demands
-        QHash<qint32, QByteArray> m_AdditionalData;
-    };
-
-    QDataStream &operator<<(QDataStream &out, const CachedImage &v);
-    QDataStream &operator>>(QDataStream &in, CachedImage &v);
+    class ImageCacheIndex;
 
     class ImageCachingWorker : public QObject, public Common::ItemProcessingWorker<ImageCacheRequest>
     {
         Q_OBJECT
     public:
-        ImageCachingWorker(QObject *parent=0);
+        ImageCachingWorker(int workerIndex, const std::shared_ptr<ImageCacheIndex> &cacheIndex, QObject *parent=0);
 
     protected:
         virtual bool initWorker() override;
@@ -55,7 +44,7 @@ namespace QMLExtensions {
 
     protected:
         virtual void notifyQueueIsEmpty() override { emit queueIsEmpty(); }
-        virtual void workerStopped() override { saveIndex(); emit stopped(); }
+        virtual void workerStopped() override;
 
     public slots:
         void process() { doWork(); }
@@ -64,27 +53,23 @@ namespace QMLExtensions {
     signals:
         void stopped();
         void queueIsEmpty();
+        void imageCached(const QString &filepath, const QSize &requestedSize);
 
     public:
+        int getWorkerIndex() const { return m_WorkerIndex; }
         void setScale(qreal scale) { m_Scale = scale; }
-        bool tryGetCachedImage(const QString &key, const QSize &requestedSize,
-                               QString &cached, bool &needsUpdate);
-        void splitToCachedAndNot(const std::vector<std::shared_ptr<ImageCacheRequest> > allRequests,
-                                 std::vector<std::shared_ptr<ImageCacheRequest> > &unknownRequests,
-                                 std::vector<std::shared_ptr<ImageCacheRequest> > &knownRequests);
 
     private:
-        void readIndex();
-        void saveIndex();
+        void cacheImage(std::shared_ptr<ImageCacheRequest> &item);
         bool isProcessed(std::shared_ptr<ImageCacheRequest> &item);
+        bool decodeThumbnail(const QString &originalPath, const QSize &requestedSize, QImage &thumbnail);
+        bool tryReadEmbeddedPreview(const QString &originalPath, const QSize &originalSize,
+                                    const QSize &requestedSize, QImage &preview);
 
     private:
-        volatile int m_ProcessedItemsCount;
+        std::shared_ptr<ImageCacheIndex> m_CacheIndex;
+        int m_WorkerIndex;
         qreal m_Scale;
-        QString m_ImagesCacheDir;
-        QString m_IndexFilepath;
-        QReadWriteLock m_CacheLock;
-        QHash<QString, CachedImage> m_CacheIndex;
     };
 }
 
@@ -29,17 +29,35 @@
 #include <QCoreApplication>
 #include <QStandardPaths>
 #include <QThread>
+#include <QtConcurrent>
+#include <QFuture>
 #include "spellcheckitem.h"
+#include "suggestionscache.h"
+#include "suggestionsworker.h"
 #include "../Common/defines.h"
 #include <hunspell/hunspell.hxx>
 
 #define EN_HUNSPELL_DIC "en_US.dic"
 #define EN_HUNSPELL_AFF "en_US.aff"
+// words of all queued items are deduplicated within a batch
+#define MAX_SPELLCHECK_BATCH_SIZE 1000
+#define MAX_SPELLCHECK_THREADS 4
+// smaller batches are faster to check on the worker thread
+#define PARALLEL_SPELLCHECK_MIN_WORDS 200
+#define MAX_CACHED_SUGGESTIONS 5000
+// cache is dropped at once, hunspell answers are cheap to get again
+#define MAX_CACHED_SPELLINGS 100000
+// items are submitted for every keyword edit
+#define SPELLCHECK_QUEUE_CAPACITY 4096
 
 namespace SpellCheck {
     SpellCheckWorker::SpellCheckWorker(Models::SettingsModel *settingsModel, QObject *parent):
         QObject(parent),
+        Common::ItemProcessingWorker<ISpellCheckItem>(1, SPELLCHECK_QUEUE_CAPACITY),
         m_SettingsModel(settingsModel),
+        m_SuggestionsCache(new SuggestionsCache(MAX_CACHED_SUGGESTIONS)),
+        m_SuggestionsWorker(NULL),
+        m_SuggestionsThread(NULL),
         m_Hunspell(NULL),
         m_Codec(NULL),
         m_UserDictionaryPath("")
@@ -48,6 +66,9 @@ namespace SpellCheck {
     }
 
     SpellCheckWorker::~SpellCheckWorker() {
+        m_SpellingThreadPool.waitForDone();
+        qDeleteAll(m_HunspellPool);
+
         if (m_Hunspell != NULL) {
             delete m_Hunspell;
         }
@@ -95,6 +116,18 @@ namespace SpellCheck {
 
 #endif
 
+        bool initResult = initHunspell(affPath, dicPath);
+
+        initUserDictionary();
+
+        if (initResult) {
+            startSuggestionsWorker();
+        }
+
+        return initResult;
+    }
+
+    bool SpellCheckWorker::initHunspell(QString affPath, QString dicPath) {
         bool initResult = false;
 
         if (QFileInfo(affPath).exists() && QFileInfo(dicPath).exists()) {
@@ -108,6 +141,8 @@ namespace SpellCheck {
                 m_Hunspell = new Hunspell(affPath.toUtf8().constData(),
                                           dicPath.toUtf8().constData());
                 LOG_DEBUG << "Hunspell initialized with AFF" << affPath << "and DIC" << dicPath;
+                m_AffPath = affPath;
+                m_DicPath = dicPath;
                 initResult = true;
                 m_Encoding = QString::fromLatin1(m_Hunspell->get_dic_encoding());
                 m_Codec = QTextCodec::codecForName(m_Encoding.toLatin1().constData());
@@ -119,8 +154,6 @@ namespace SpellCheck {
             LOG_WARNING << "DIC or AFF file not found." << dicPath << "||" << affPath;
         }
 
-        initUserDictionary();
-
         return initResult;
     }
 
@@ -138,40 +171,156 @@ namespace SpellCheck {
         }
     }
 
+    size_t SpellCheckWorker::getMaxBatchSize() const {
+        return MAX_SPELLCHECK_BATCH_SIZE;
+    }
+
+    void SpellCheckWorker::processBatch(std::vector<std::shared_ptr<ISpellCheckItem> > &items) {
+        std::vector<std::shared_ptr<SpellCheckItem> > queryItems;
+        queryItems.reserve(items.size());
+
+        for (auto &item: items) {
+            if (isCancelled()) { break; }
+
+            auto queryItem = std::dynamic_pointer_cast<SpellCheckItem>(item);
+            if (queryItem) {
+                queryItems.push_back(queryItem);
+            } else {
+                // other items should see results of everything queued before them
+                processQueryItems(queryItems);
+                queryItems.clear();
+
+                processOneItem(item);
+            }
+        }
+
+        processQueryItems(queryItems);
+    }
+
+    void SpellCheckWorker::workerStopped() {
+        stopSuggestionsWorker();
+        emit stopped();
+    }
+
     void SpellCheckWorker::processSeparatorItem(std::shared_ptr<SpellCheckSeparatorItem> &item) {
         Q_UNUSED(item);
         emit queueIsEmpty();
     }
 
     void SpellCheckWorker::processQueryItem(std::shared_ptr<SpellCheckItem> &item) {
-        bool neededSuggestions = item->needsSuggestions();
-        auto &queryItems = item->getQueries();
-        bool anyWrong = false;
-
-        if (!neededSuggestions) {
-            size_t size = queryItems.size();
-            for (size_t i = 0; i < size; ++i) {
-                auto &queryItem = queryItems.at(i);
-                bool isOk = checkWordSpelling(queryItem);
-                item->accountResultAt((int)i);
-                anyWrong = anyWrong || !isOk;
-            }
+        submitQueryResult(item);
+    }
 
-            item->submitSpellCheckResult();
-        } else {
+    void SpellCheckWorker::processQueryItems(std::vector<std::shared_ptr<SpellCheckItem> > &items) {
+        if (items.empty()) { return; }
+
+        QSet<QString> uniqueWords;
+        QStringList wordsToCheck;
+
+        for (auto &item: items) {
+            auto &queryItems = item->getQueries();
             for (auto &queryItem: queryItems) {
-                if (!queryItem->m_IsCorrect) {
-                    findSuggestions(queryItem->m_Word);
+                const QString &word = queryItem->m_Word;
+                if (uniqueWords.contains(word)) { continue; }
+
+                uniqueWords.insert(word);
+
+                if (!m_SpellingCache.contains(word) && !m_UserDictionary.contains(word)) {
+                    wordsToCheck.append(word);
                 }
             }
         }
 
-        if (anyWrong) {
-            item->requestSuggestions();
-            this->submitItem(item);
+        LOG_DEBUG << items.size() << "item(s) with" << uniqueWords.size() << "unique word(s)," << wordsToCheck.size() << "new";
+
+        checkWordsSpelling(wordsToCheck);
+
+        for (auto &item: items) {
+            submitQueryResult(item);
         }
     }
 
+    void SpellCheckWorker::submitQueryResult(std::shared_ptr<SpellCheckItem> &item) {
+        auto &queryItems = item->getQueries();
+        QStringList wrongWords;
+
+        size_t size = queryItems.size();
+        for (size_t i = 0; i < size; ++i) {
+            auto &queryItem = queryItems.at(i);
+            bool isOk = checkWordSpelling(queryItem);
+            item->accountResultAt((int)i);
+
+            if (!isOk) {
+                wrongWords.append(queryItem->m_Word);
+            }
+        }
+
+        item->submitSpellCheckResult();
+
+        if (!wrongWords.isEmpty() && (m_SuggestionsWorker != NULL)) {
+            m_SuggestionsWorker->submitWords(wrongWords, item->getIsOnlyOneKeyword());
+        }
+    }
+
+    void SpellCheckWorker::startSuggestionsWorker() {
+        LOG_DEBUG << "#";
+
+        QString appDataPath = XPIKS_USERDATA_PATH;
+        QDir dir(appDataPath);
+        m_SuggestionsCache->setStorage(dir.filePath(QLatin1String(Constants::SPELL_SUGGESTIONS_CACHE_FILENAME)),
+                                       getSuggestionsDictionaryID());
+        m_SuggestionsCache->load();
+
+        m_SuggestionsWorker = new SuggestionsWorker(m_AffPath, m_DicPath,
+                                                    m_UserDictionary.getWords(),
+                                                    m_SuggestionsCache);
+        m_SuggestionsThread = new QThread();
+        m_SuggestionsWorker->moveToThread(m_SuggestionsThread);
+
+        QObject::connect(m_SuggestionsThread, SIGNAL(started()), m_SuggestionsWorker, SLOT(process()));
+        // this thread waits for the suggestions thread so it cannot deliver queued calls
+        QObject::connect(m_SuggestionsWorker, SIGNAL(stopped()), m_SuggestionsThread, SLOT(quit()), Qt::DirectConnection);
+
+        m_SuggestionsThread->start(QThread::LowPriority);
+    }
+
+    QString SpellCheckWorker::getSuggestionsDictionaryID() const {
+        QFileInfo dicInfo(m_DicPath);
+        QStringList userWords = m_UserDictionary.getWords();
+        userWords.sort();
+
+        // suggestions are not valid anymore if any dictionary changes
+        QString dictionaryID = QString("%1:%2:%3:%4")
+                .arg(dicInfo.absoluteFilePath())
+                .arg(dicInfo.size())
+                .arg(dicInfo.lastModified().toMSecsSinceEpoch())
+                .arg(qHash(userWords.join(QChar('\n'))));
+
+        return dictionaryID;
+    }
+
+    void SpellCheckWorker::updateSuggestionsUserDict(const QStringList &words, bool overwrite) {
+        if (m_SuggestionsWorker == NULL) { return; }
+
+        m_SuggestionsWorker->updateUserDictionary(words, overwrite, getSuggestionsDictionaryID());
+    }
+
+    void SpellCheckWorker::stopSuggestionsWorker() {
+        if (m_SuggestionsWorker == NULL) { return; }
+
+        LOG_DEBUG << "#";
+
+        // worker is owned here so it cannot outlive the cache users
+        m_SuggestionsWorker->stopWorking();
+        m_SuggestionsThread->wait();
+
+        delete m_SuggestionsWorker;
+        m_SuggestionsWorker = NULL;
+
+        delete m_SuggestionsThread;
+        m_SuggestionsThread = NULL;
+    }
+
     void SpellCheckWorker::processChangeUserDict(std::shared_ptr<ModifyUserDictItem> &item) {
         LOG_INTEGRATION_TESTS << item->getKeywordsToAdd();
 
@@ -194,40 +343,26 @@ namespace SpellCheck {
     }
 
     QStringList SpellCheckWorker::retrieveCorrections(const QString &word) {
-        QReadLocker locker(&m_SuggestionsLock);
         QStringList result;
-
-        auto it = m_Suggestions.find(word);
-        if (it != m_Suggestions.end()) {
-            result = it.value();
-        }
-
+        m_SuggestionsCache->tryGet(word, result);
         return result;
     }
 
-    QStringList SpellCheckWorker::suggestCorrections(const QString &word) {
-        QStringList suggestions;
-        std::vector<std::string> suggestWordList;
-
-        try {
-            // Encode from Unicode to the encoding used by current dictionary
-            std::string encodedWord = m_Codec->fromUnicode(word).toStdString();
-            suggestWordList = m_Hunspell->suggest(encodedWord);
-            LOG_INTEGRATION_TESTS << "Found" << suggestWordList.size() << "suggestions for" << word;
-            QString lowerWord = word.toLower();
+#ifdef INTEGRATION_TESTS
+    int SpellCheckWorker::getSuggestionsCount() const {
+        return m_SuggestionsCache->size();
+    }
+#endif
 
-            for (size_t i = 0; i < suggestWordList.size(); ++i) {
-                QString suggestion = m_Codec->toUnicode(QByteArray::fromStdString(suggestWordList[i]));
+#ifdef CORE_TESTS
+    int SpellCheckWorker::getParallelSpellCheckMinWords() {
+        return PARALLEL_SPELLCHECK_MIN_WORDS;
+    }
 
-                if (suggestion.toLower() != lowerWord) {
-                    suggestions << suggestion;
-                }
-            }
-        } catch (...) {
-            LOG_WARNING << "Error for keyword:" << word;
-        }
-        return suggestions;
+    int SpellCheckWorker::getMaxCachedSpellings() {
+        return MAX_CACHED_SPELLINGS;
     }
+#endif
 
     bool SpellCheckWorker::checkWordSpelling(const std::shared_ptr<SpellCheckQueryItem> &queryItem) {
         bool isOk = false;
@@ -242,56 +377,118 @@ namespace SpellCheck {
     }
 
     bool SpellCheckWorker::checkWordSpelling(const QString &word) {
-        bool isOk = false;
+        auto it = m_SpellingCache.constFind(word);
+        if (it != m_SpellingCache.constEnd()) {
+            return it.value();
+        }
 
-        const bool isCached = m_WrongWords.contains(word);
+        const bool isOk = isWordSpellingCorrect(m_Hunspell, word);
+        ensureSpellingCacheFits(1);
+        m_SpellingCache.insert(word, isOk);
 
-        if (!isCached) {
-            isOk = isHunspellSpellingCorrect(word);
+        return isOk;
+    }
 
-            if (!isOk) {
-                QString capitalized = word;
-                capitalized[0] = capitalized[0].toUpper();
+    void SpellCheckWorker::checkWordsSpelling(const QStringList &words) {
+        const int size = words.size();
 
-                if (isHunspellSpellingCorrect(capitalized)) {
-                    isOk = true;
-                }
+        if ((size < PARALLEL_SPELLCHECK_MIN_WORDS) || !initHunspellPool()) {
+            for (auto &word: words) {
+                checkWordSpelling(word);
             }
+
+            return;
         }
 
-        if (!isOk) {
-            m_WrongWords.insert(word);
+        // every Hunspell instance is used by one thread only
+        QVector<char> results(size, 0);
+        Common::SharedWorkQueue<QString> wordsQueue(words.toVector());
+        QVector<QFuture<void> > futures;
+
+        for (Hunspell *hunspell: m_HunspellPool) {
+            futures.append(QtConcurrent::run(&m_SpellingThreadPool, this, &SpellCheckWorker::checkWordsFromQueue,
+                                             hunspell, &wordsQueue, results.data()));
         }
 
-        return isOk;
+        checkWordsFromQueue(m_Hunspell, &wordsQueue, results.data());
+
+        for (auto &future: futures) {
+            future.waitForFinished();
+        }
+
+        ensureSpellingCacheFits(size);
+
+        for (int i = 0; i < size; ++i) {
+            m_SpellingCache.insert(words.at(i), results.at(i) != 0);
+        }
     }
 
-    bool SpellCheckWorker::isHunspellSpellingCorrect(const QString &word) const {
+    void SpellCheckWorker::ensureSpellingCacheFits(int wordsCount) {
+        if (m_SpellingCache.size() + wordsCount > MAX_CACHED_SPELLINGS) {
+            LOG_INFO << "Clearing spelling cache of" << m_SpellingCache.size() << "words";
+            m_SpellingCache.clear();
+        }
+    }
+
+    bool SpellCheckWorker::isHunspellSpellingCorrect(Hunspell *hunspell, const QString &word) const {
         bool isOk = false;
 
         try {
             std::string encodedWord = m_Codec->fromUnicode(word).toStdString();
-            isOk = m_Hunspell->spell(encodedWord) != 0;
+            isOk = hunspell->spell(encodedWord) != 0;
         } catch (...) {
             isOk = false;
         }
         return isOk;
     }
 
-    void SpellCheckWorker::findSuggestions(const QString &word) {
-        LOG_INTEGRATION_TESTS << word;
-        bool needsCorrections = false;
+    bool SpellCheckWorker::isWordSpellingCorrect(Hunspell *hunspell, const QString &word) const {
+        bool isOk = isHunspellSpellingCorrect(hunspell, word);
 
-        m_SuggestionsLock.lockForRead();
-        needsCorrections = !m_Suggestions.contains(word);
-        m_SuggestionsLock.unlock();
+        if (!isOk) {
+            QString capitalized = word;
+            capitalized[0] = capitalized[0].toUpper();
 
-        if (needsCorrections) {
-            QStringList suggestions = suggestCorrections(word);
-            m_SuggestionsLock.lockForWrite();
-            m_Suggestions.insert(word, suggestions);
-            m_SuggestionsLock.unlock();
+            if (isHunspellSpellingCorrect(hunspell, capitalized)) {
+                isOk = true;
+            }
         }
+
+        return isOk;
+    }
+
+    void SpellCheckWorker::checkWordsFromQueue(Hunspell *hunspell, Common::SharedWorkQueue<QString> *wordsQueue, char *results) const {
+        int index = 0;
+        QString word;
+
+        while (wordsQueue->tryTakeNext(index, word)) {
+            results[index] = isWordSpellingCorrect(hunspell, word) ? 1 : 0;
+        }
+    }
+
+    bool SpellCheckWorker::initHunspellPool() {
+        if (!m_HunspellPool.isEmpty()) { return true; }
+
+        const int threadsCount = qMin(qMax(QThread::idealThreadCount(), 1), MAX_SPELLCHECK_THREADS);
+        // worker thread itself uses the main instance
+        const int poolSize = threadsCount - 1;
+        if (poolSize <= 0) { return false; }
+
+        LOG_INFO << "Creating" << poolSize << "additional Hunspell instance(s)";
+
+        for (int i = 0; i < poolSize; ++i) {
+            try {
+                m_HunspellPool.append(new Hunspell(m_AffPath.toUtf8().constData(),
+                                                   m_DicPath.toUtf8().constData()));
+            } catch (...) {
+                LOG_WARNING << "Failed to create Hunspell instance";
+                break;
+            }
+        }
+
+        m_SpellingThreadPool.setMaxThreadCount(qMax(m_HunspellPool.size(), 1));
+
+        return !m_HunspellPool.isEmpty();
     }
 
     void SpellCheckWorker::initUserDictionary() {
@@ -325,6 +522,7 @@ namespace SpellCheck {
 
         m_UserDictionary.clear();
         emit userDictCleared();
+        updateSuggestionsUserDict(QStringList(), true);
 
         QFile userDictonaryFile(m_UserDictionaryPath);
         if (userDictonaryFile.open(QIODevice::ReadWrite)) {
@@ -355,6 +553,7 @@ namespace SpellCheck {
         m_UserDictionary.addWords(wordsToAdd);
 
         emit userDictUpdate(wordsToAdd, overwrite);
+        updateSuggestionsUserDict(wordsToAdd, overwrite);
 
         QFile userDictonaryFile(m_UserDictionaryPath);
         auto mode = overwrite? QIODevice::WriteOnly : QIODevice::Append;
@@ -24,17 +24,23 @@
 
 #include <QString>
 #include <QStringList>
-#include <QReadWriteLock>
 #include <QHash>
 #include <QSet>
+#include <QVector>
+#include <QThreadPool>
 #include "../Common/itemprocessingworker.h"
+#include "../Common/sharedworkqueue.h"
 #include "../Models/settingsmodel.h"
 #include "spellcheckitem.h"
 
 class Hunspell;
 class QTextCodec;
+class QThread;
 
 namespace SpellCheck {
+    class SuggestionsCache;
+    class SuggestionsWorker;
+
     class UserDictionary {
     public:
         const QStringList &getWords() const { return m_WordsList; }
@@ -85,15 +91,27 @@ namespace SpellCheck {
     protected:
         virtual bool initWorker() override;
         virtual void processOneItem(std::shared_ptr<ISpellCheckItem> &item) override;
+        virtual size_t getMaxBatchSize() const override;
+
+#ifdef CORE_TESTS
+    public:
+#else
+    protected:
+#endif
+        virtual void processBatch(std::vector<std::shared_ptr<ISpellCheckItem> > &items) override;
 
     private:
         void processSeparatorItem(std::shared_ptr<SpellCheckSeparatorItem> &item);
         void processQueryItem(std::shared_ptr<SpellCheckItem> &item);
+        void processQueryItems(std::vector<std::shared_ptr<SpellCheckItem> > &items);
+        void submitQueryResult(std::shared_ptr<SpellCheckItem> &item);
+        void startSuggestionsWorker();
+        void stopSuggestionsWorker();
         void processChangeUserDict(std::shared_ptr<ModifyUserDictItem> &item);
 
     protected:
         virtual void notifyQueueIsEmpty() override { emit queueIsEmpty(); }
-        virtual void workerStopped() override { emit stopped(); }
+        virtual void workerStopped() override;
 
     public slots:
         void process() { doWork(); }
@@ -108,16 +126,32 @@ namespace SpellCheck {
 
 #ifdef INTEGRATION_TESTS
     public:
-        int getSuggestionsCount() const { return m_Suggestions.count(); }
+        int getSuggestionsCount() const;
+#endif
+
+#ifdef CORE_TESTS
+    public:
+        bool initDictionary(const QString &affPath, const QString &dicPath) { return initHunspell(affPath, dicPath); }
+        void checkWords(const QStringList &words) { checkWordsSpelling(words); }
+        const QHash<QString, bool> &getSpellingCache() const { return m_SpellingCache; }
+        int getHunspellPoolSize() const { return m_HunspellPool.size(); }
+        static int getParallelSpellCheckMinWords();
+        static int getMaxCachedSpellings();
 #endif
 
     private:
         void detectAffEncoding();
-        QStringList suggestCorrections(const QString &word);
+        bool initHunspell(QString affPath, QString dicPath);
         bool checkWordSpelling(const std::shared_ptr<SpellCheckQueryItem> &queryItem);
         bool checkWordSpelling(const QString &word);
-        bool isHunspellSpellingCorrect(const QString &word) const;
-        void findSuggestions(const QString &word);
+        void checkWordsSpelling(const QStringList &words);
+        QString getSuggestionsDictionaryID() const;
+        void updateSuggestionsUserDict(const QStringList &words, bool overwrite);
+        void ensureSpellingCacheFits(int wordsCount);
+        bool isHunspellSpellingCorrect(Hunspell *hunspell, const QString &word) const;
+        bool isWordSpellingCorrect(Hunspell *hunspell, const QString &word) const;
+        void checkWordsFromQueue(Hunspell *hunspell, Common::SharedWorkQueue<QString> *wordsQueue, char *results) const;
+        bool initHunspellPool();
         void initUserDictionary();
         void cleanUserDict();
         void changeUserDict(const QStringList &words, bool overwrite);
@@ -125,12 +159,19 @@ namespace SpellCheck {
 
     private:
         Models::SettingsModel *m_SettingsModel;
-        QHash<QString, QStringList> m_Suggestions;
-        QSet<QString> m_WrongWords;
+        std::shared_ptr<SuggestionsCache> m_SuggestionsCache;
+        SuggestionsWorker *m_SuggestionsWorker;
+        QThread *m_SuggestionsThread;
+        // dictionary answers for correct and wrong words
+        QHash<QString, bool> m_SpellingCache;
         UserDictionary m_UserDictionary;
-        QReadWriteLock m_SuggestionsLock;
         QString m_Encoding;
+        QString m_AffPath;
+        QString m_DicPath;
         Hunspell *m_Hunspell;
+        // additional instances are created for the first big batch only
+        QVector<Hunspell *> m_HunspellPool;
+        QThreadPool m_SpellingThreadPool;
         // Coded does not need destruction
         QTextCodec *m_Codec;
         QString m_UserDictionaryPath;
@@ -0,0 +1,201 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "suggestionscache.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QMutexLocker>
+#include "../Common/defines.h"
+
+#define CACHE_MAGIC 0x58505343
+#define CACHE_VERSION 1
+#define CACHE_STREAM_VERSION QDataStream::Qt_5_2
+
+namespace SpellCheck {
+    SuggestionsCache::SuggestionsCache(int maxSize):
+        m_MaxSize(maxSize),
+        m_UnsavedCount(0)
+    {
+        Q_ASSERT(maxSize > 0);
+    }
+
+    void SuggestionsCache::setStorage(const QString &filepath, const QString &dictionaryID) {
+        QMutexLocker locker(&m_CacheMutex);
+        Q_UNUSED(locker);
+
+        m_Filepath = filepath;
+        m_DictionaryID = dictionaryID;
+    }
+
+    bool SuggestionsCache::tryGet(const QString &word, QStringList &suggestions) {
+        QMutexLocker locker(&m_CacheMutex);
+        Q_UNUSED(locker);
+
+        auto it = m_Cache.find(word);
+        if (it == m_Cache.end()) { return false; }
+
+        CachedSuggestions &cached = it.value();
+        m_UsageOrder.splice(m_UsageOrder.begin(), m_UsageOrder, cached.m_UsageIt);
+        suggestions = cached.m_Suggestions;
+
+        return true;
+    }
+
+    bool SuggestionsCache::contains(const QString &word) {
+        QMutexLocker locker(&m_CacheMutex);
+        Q_UNUSED(locker);
+
+        return m_Cache.contains(word);
+    }
+
+    void SuggestionsCache::insert(const QString &word, const QStringList &suggestions) {
+        QMutexLocker locker(&m_CacheMutex);
+        Q_UNUSED(locker);
+
+        auto it = m_Cache.find(word);
+        if (it != m_Cache.end()) {
+            CachedSuggestions &cached = it.value();
+            cached.m_Suggestions = suggestions;
+            m_UsageOrder.splice(m_UsageOrder.begin(), m_UsageOrder, cached.m_UsageIt);
+        } else {
+            m_UsageOrder.push_front(word);
+            m_Cache.insert(word, CachedSuggestions{suggestions, m_UsageOrder.begin()});
+            evictIfNeeded();
+        }
+
+        m_UnsavedCount++;
+    }
+
+    void SuggestionsCache::reset(const QString &dictionaryID) {
+        QMutexLocker locker(&m_CacheMutex);
+        Q_UNUSED(locker);
+
+        LOG_DEBUG << "Dropping" << m_Cache.size() << "word(s)";
+        m_Cache.clear();
+        m_UsageOrder.clear();
+        m_DictionaryID = dictionaryID;
+        // stale file should be overwritten
+        m_UnsavedCount = 1;
+    }
+
+    int SuggestionsCache::size() {
+        QMutexLocker locker(&m_CacheMutex);
+        Q_UNUSED(locker);
+
+        return m_Cache.size();
+    }
+
+    int SuggestionsCache::getUnsavedCount() {
+        QMutexLocker locker(&m_CacheMutex);
+        Q_UNUSED(locker);
+
+        return m_UnsavedCount;
+    }
+
+    bool SuggestionsCache::load() {
+        QMutexLocker locker(&m_CacheMutex);
+        Q_UNUSED(locker);
+
+        QFile file(m_Filepath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            LOG_INFO << "Suggestions cache not found:" << m_Filepath;
+            return false;
+        }
+
+        QDataStream in(&file);
+        in.setVersion(CACHE_STREAM_VERSION);
+
+        quint32 magic = 0, version = 0;
+        QString dictionaryID;
+        in >> magic >> version >> dictionaryID;
+
+        if ((in.status() != QDataStream::Ok) || (magic != CACHE_MAGIC) || (version != CACHE_VERSION)) {
+            LOG_WARNING << "Unsupported suggestions cache format";
+            return false;
+        }
+
+        if (dictionaryID != m_DictionaryID) {
+            LOG_INFO << "Suggestions cache was built for another dictionary";
+            return false;
+        }
+
+        m_Cache.clear();
+        m_UsageOrder.clear();
+
+        // words are stored from least to most recently used
+        while (!in.atEnd()) {
+            QString word;
+            QStringList suggestions;
+            in >> word >> suggestions;
+
+            if (in.status() != QDataStream::Ok) { break; }
+            if (m_Cache.contains(word)) { continue; }
+
+            m_UsageOrder.push_front(word);
+            m_Cache.insert(word, CachedSuggestions{suggestions, m_UsageOrder.begin()});
+        }
+
+        evictIfNeeded();
+        m_UnsavedCount = 0;
+
+        LOG_INFO << "Read suggestions for" << m_Cache.size() << "word(s)";
+        return true;
+    }
+
+    bool SuggestionsCache::save() {
+        QMutexLocker locker(&m_CacheMutex);
+        Q_UNUSED(locker);
+
+        QSaveFile file(m_Filepath);
+        if (!file.open(QIODevice::WriteOnly)) {
+            LOG_WARNING << "Failed to open" << m_Filepath;
+            return false;
+        }
+
+        {
+            QDataStream out(&file);
+            out.setVersion(CACHE_STREAM_VERSION);
+            out << (quint32)CACHE_MAGIC << (quint32)CACHE_VERSION << m_DictionaryID;
+
+            for (auto it = m_UsageOrder.rbegin(); it != m_UsageOrder.rend(); ++it) {
+                out << *it << m_Cache.value(*it).m_Suggestions;
+            }
+        }
+
+        if (!file.commit()) {
+            LOG_WARNING << "Failed to save" << m_Filepath;
+            return false;
+        }
+
+        m_UnsavedCount = 0;
+        LOG_DEBUG << "Saved suggestions for" << m_Cache.size() << "word(s)";
+        return true;
+    }
+
+    void SuggestionsCache::evictIfNeeded() {
+        // m_CacheMutex should be locked
+        while (m_Cache.size() > m_MaxSize) {
+            m_Cache.remove(m_UsageOrder.back());
+            m_UsageOrder.pop_back();
+        }
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SUGGESTIONSCACHE_H
+#define SUGGESTIONSCACHE_H
+
+#include <list>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QMutex>
+
+namespace SpellCheck {
+    /*
+     * Spelling suggestions of recently misspelled words.
+     * Cache is bounded by number of words with LRU eviction and
+     * is persisted together with the id of dictionary it was built with.
+    */
+    class SuggestionsCache
+    {
+    public:
+        SuggestionsCache(int maxSize);
+
+    public:
+        void setStorage(const QString &filepath, const QString &dictionaryID);
+        bool tryGet(const QString &word, QStringList &suggestions);
+        bool contains(const QString &word);
+        void insert(const QString &word, const QStringList &suggestions);
+        // drops suggestions which were built for another dictionary
+        void reset(const QString &dictionaryID);
+        int size();
+        int getUnsavedCount();
+
+    public:
+        bool load();
+        bool save();
+
+    private:
+        void evictIfNeeded();
+
+    private:
+        struct CachedSuggestions {
+            QStringList m_Suggestions;
+            // position in the usage list
+            std::list<QString>::iterator m_UsageIt;
+        };
+
+    private:
+        QMutex m_CacheMutex;
+        QHash<QString, CachedSuggestions> m_Cache;
+        // most recently used words go first
+        std::list<QString> m_UsageOrder;
+        QString m_Filepath;
+        QString m_DictionaryID;
+        int m_MaxSize;
+        int m_UnsavedCount;
+    };
+}
+
+#endif // SUGGESTIONSCACHE_H
@@ -0,0 +1,185 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "suggestionsworker.h"
+#include <QTextCodec>
+#include <vector>
+#include <string>
+#include "suggestionscache.h"
+#include "../Common/defines.h"
+#include <hunspell/hunspell.hxx>
+
+// avoid rewriting the cache for every word of the user input
+#define SAVE_CACHE_MIN_CHANGES 50
+
+namespace SpellCheck {
+    SuggestionsWorker::SuggestionsWorker(const QString &affPath, const QString &dicPath,
+                                         const QStringList &userDictWords,
+                                         const std::shared_ptr<SuggestionsCache> &suggestionsCache,
+                                         QObject *parent):
+        QObject(parent),
+        m_SuggestionsCache(suggestionsCache),
+        m_AffPath(affPath),
+        m_DicPath(dicPath),
+        m_UserDictWords(userDictWords),
+        m_Hunspell(NULL),
+        m_Codec(NULL)
+    {
+        Q_ASSERT(suggestionsCache);
+    }
+
+    SuggestionsWorker::~SuggestionsWorker() {
+        if (m_Hunspell != NULL) {
+            delete m_Hunspell;
+        }
+    }
+
+    void SuggestionsWorker::submitWords(const QStringList &words, bool isUrgent) {
+        std::vector<std::shared_ptr<SuggestionQueryItem> > items;
+        items.reserve(words.size());
+
+        for (auto &word: words) {
+            if (m_SuggestionsCache->contains(word)) { continue; }
+            items.emplace_back(new SuggestionQueryItem(word));
+        }
+
+        if (items.empty()) { return; }
+
+        if (isUrgent) {
+            submitFirst(items);
+        } else {
+            submitItems(items);
+        }
+    }
+
+    void SuggestionsWorker::updateUserDictionary(const QStringList &words, bool overwrite, const QString &dictionaryID) {
+        LOG_DEBUG << words.size() << "word(s), overwrite:" << overwrite;
+        // should be applied before queued suggestions are searched
+        std::shared_ptr<SuggestionQueryItem> item(new UserDictUpdateItem(words, overwrite, dictionaryID));
+        submitFirst(item);
+    }
+
+    bool SuggestionsWorker::initWorker() {
+        LOG_DEBUG << "#";
+
+        bool initResult = false;
+
+        try {
+            m_Hunspell = new Hunspell(m_AffPath.toUtf8().constData(),
+                                      m_DicPath.toUtf8().constData());
+            m_Codec = QTextCodec::codecForName(m_Hunspell->get_dic_encoding());
+            initResult = true;
+
+            QStringList userDictWords;
+            userDictWords.swap(m_UserDictWords);
+            addUserDictWords(userDictWords);
+        } catch (...) {
+            LOG_WARNING << "Error in Hunspell with AFF" << m_AffPath << "and DIC" << m_DicPath;
+            m_Hunspell = NULL;
+        }
+
+        return initResult;
+    }
+
+    void SuggestionsWorker::processOneItem(std::shared_ptr<SuggestionQueryItem> &item) {
+        auto userDictItem = std::dynamic_pointer_cast<UserDictUpdateItem>(item);
+        if (userDictItem) {
+            processUserDictUpdate(userDictItem);
+            return;
+        }
+
+        const QString &word = item->getWord();
+        // same word could have been queued a few times
+        if (m_SuggestionsCache->contains(word)) { return; }
+
+        QStringList suggestions = suggestCorrections(word);
+        m_SuggestionsCache->insert(word, suggestions);
+    }
+
+    void SuggestionsWorker::notifyQueueIsEmpty() {
+        if (m_SuggestionsCache->getUnsavedCount() >= SAVE_CACHE_MIN_CHANGES) {
+            m_SuggestionsCache->save();
+        }
+    }
+
+    void SuggestionsWorker::workerStopped() {
+        if (m_SuggestionsCache->getUnsavedCount() > 0) {
+            m_SuggestionsCache->save();
+        }
+
+        emit stopped();
+    }
+
+    void SuggestionsWorker::processUserDictUpdate(const std::shared_ptr<UserDictUpdateItem> &item) {
+        if (item->getOverwrite()) {
+            for (auto &word: m_UserDictWords) {
+                try {
+                    m_Hunspell->remove(m_Codec->fromUnicode(word).toStdString());
+                } catch (...) {
+                    LOG_WARNING << "Failed to remove" << word;
+                }
+            }
+
+            m_UserDictWords.clear();
+        }
+
+        addUserDictWords(item->getWords());
+        // cached suggestions do not contain the new words
+        m_SuggestionsCache->reset(item->getDictionaryID());
+    }
+
+    void SuggestionsWorker::addUserDictWords(const QStringList &words) {
+        for (auto &word: words) {
+            try {
+                m_Hunspell->add(m_Codec->fromUnicode(word).toStdString());
+                m_UserDictWords.append(word);
+            } catch (...) {
+                LOG_WARNING << "Failed to add" << word;
+            }
+        }
+
+        LOG_DEBUG << m_UserDictWords.size() << "user dictionary word(s)";
+    }
+
+    QStringList SuggestionsWorker::suggestCorrections(const QString &word) {
+        QStringList suggestions;
+        std::vector<std::string> suggestWordList;
+
+        try {
+            // Encode from Unicode to the encoding used by current dictionary
+            std::string encodedWord = m_Codec->fromUnicode(word).toStdString();
+            suggestWordList = m_Hunspell->suggest(encodedWord);
+            LOG_INTEGRATION_TESTS << "Found" << suggestWordList.size() << "suggestions for" << word;
+            QString lowerWord = word.toLower();
+
+            for (size_t i = 0; i < suggestWordList.size(); ++i) {
+                QString suggestion = m_Codec->toUnicode(QByteArray::fromStdString(suggestWordList[i]));
+
+                if (suggestion.toLower() != lowerWord) {
+                    suggestions << suggestion;
+                }
+            }
+        } catch (...) {
+            LOG_WARNING << "Error for keyword:" << word;
+        }
+        return suggestions;
+    }
+}
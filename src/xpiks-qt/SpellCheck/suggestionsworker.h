@@ -0,0 +1,122 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SUGGESTIONSWORKER_H
+#define SUGGESTIONSWORKER_H
+
+#include <memory>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include "../Common/itemprocessingworker.h"
+
+class Hunspell;
+class QTextCodec;
+
+namespace SpellCheck {
+    class SuggestionsCache;
+
+    class SuggestionQueryItem
+    {
+    public:
+        SuggestionQueryItem(const QString &word):
+            m_Word(word)
+        {}
+
+        virtual ~SuggestionQueryItem() {}
+
+    public:
+        const QString &getWord() const { return m_Word; }
+
+    private:
+        QString m_Word;
+    };
+
+    // words of the user dictionary should be suggested too
+    class UserDictUpdateItem: public SuggestionQueryItem
+    {
+    public:
+        UserDictUpdateItem(const QStringList &words, bool overwrite, const QString &dictionaryID):
+            SuggestionQueryItem(QString()),
+            m_Words(words),
+            m_DictionaryID(dictionaryID),
+            m_Overwrite(overwrite)
+        {}
+
+    public:
+        const QStringList &getWords() const { return m_Words; }
+        const QString &getDictionaryID() const { return m_DictionaryID; }
+        bool getOverwrite() const { return m_Overwrite; }
+
+    private:
+        QStringList m_Words;
+        QString m_DictionaryID;
+        bool m_Overwrite;
+    };
+
+    // Hunspell suggestions are much slower than spelling checks
+    // so they are searched in a separate thread with own instance of Hunspell
+    class SuggestionsWorker : public QObject, public Common::ItemProcessingWorker<SuggestionQueryItem>
+    {
+        Q_OBJECT
+
+    public:
+        SuggestionsWorker(const QString &affPath, const QString &dicPath,
+                          const QStringList &userDictWords,
+                          const std::shared_ptr<SuggestionsCache> &suggestionsCache,
+                          QObject *parent=0);
+        virtual ~SuggestionsWorker();
+
+    public:
+        // words of recent user input go before batch results
+        void submitWords(const QStringList &words, bool isUrgent);
+        void updateUserDictionary(const QStringList &words, bool overwrite, const QString &dictionaryID);
+
+    protected:
+        virtual bool initWorker() override;
+        virtual void processOneItem(std::shared_ptr<SuggestionQueryItem> &item) override;
+        virtual void notifyQueueIsEmpty() override;
+        virtual void workerStopped() override;
+
+    public slots:
+        void process() { doWork(); }
+
+    signals:
+        void stopped();
+
+    private:
+        QStringList suggestCorrections(const QString &word);
+        void processUserDictUpdate(const std::shared_ptr<UserDictUpdateItem> &item);
+        void addUserDictWords(const QStringList &words);
+
+    private:
+        std::shared_ptr<SuggestionsCache> m_SuggestionsCache;
+        QString m_AffPath;
+        QString m_DicPath;
+        // words added to this Hunspell instance
+        QStringList m_UserDictWords;
+        Hunspell *m_Hunspell;
+        // Coded does not need destruction
+        QTextCodec *m_Codec;
+    };
+}
+
+#endif // SUGGESTIONSWORKER_H
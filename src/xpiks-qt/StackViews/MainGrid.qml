@@ -45,6 +45,26 @@ ColumnLayout {
         enabled: (artworkRepository.artworksSourcesCount > 0) && (applicationWindow.openedDialogsCount == 0)
     }
 
+    Action {
+        id: undoAction
+        shortcut: StandardKey.Undo
+        enabled: undoRedoManager.canUndo && (applicationWindow.openedDialogsCount == 0) && !artItemsModel.isScanningDirectories
+        onTriggered: {
+            undoRedoManager.undoLastAction()
+            filteredArtItemsModel.updateFilter()
+        }
+    }
+
+    Action {
+        id: redoAction
+        shortcut: StandardKey.Redo
+        enabled: undoRedoManager.canRedo && (applicationWindow.openedDialogsCount == 0) && !artItemsModel.isScanningDirectories
+        onTriggered: {
+            undoRedoManager.redoLastAction()
+            filteredArtItemsModel.updateFilter()
+        }
+    }
+
     Action {
         id: selectAllAction
         shortcut: StandardKey.SelectAll
@@ -167,6 +187,25 @@ ColumnLayout {
                 }
             }
 
+            StyledText {
+                text: i18.n + qsTr("Scanning folders...")
+                visible: artItemsModel.isScanningDirectories
+                isActive: false
+            }
+
+            StyledText {
+                text: i18.n + qsTr("Cancel")
+                visible: artItemsModel.isScanningDirectories
+                color: cancelScanMA.pressed ? Colors.linkClickedColor : Colors.artworkActiveColor
+
+                MouseArea {
+                    id: cancelScanMA
+                    anchors.fill: parent
+                    cursorShape: Qt.PointingHandCursor
+                    onClicked: artItemsModel.cancelDirectoriesScanning()
+                }
+            }
+
             Item {
                 Layout.fillWidth: true
             }
@@ -208,6 +247,8 @@ ColumnLayout {
             id: workflowHost
             anchors.topMargin: 10
             anchors.fill: parent
+            // artworks are imported when scan is finished
+            enabled: !artItemsModel.isScanningDirectories
             property var autoCompleteBox
 
             function onAutoCompleteClose() {
@@ -322,6 +363,7 @@ ColumnLayout {
 
             Rectangle {
                 id: undoRedoRect
+                property bool isDismissed: false
                 color: Colors.defaultDarkColor
                 width: parent.width
                 height: 4
@@ -332,7 +374,7 @@ ColumnLayout {
                 states: [
                     State {
                         name: "canundo"
-                        when: undoRedoManager.canUndo
+                        when: (undoRedoManager.canUndo || undoRedoManager.canRedo) && !undoRedoRect.isDismissed
                         PropertyChanges {
                             target: undoRedoRect
                             height: 40
@@ -413,7 +455,7 @@ ColumnLayout {
 
                     StyledText {
                         id: undoDescription
-                        text: undoRedoManager.undoDescription
+                        text: undoRedoManager.canUndo ? undoRedoManager.undoDescription : undoRedoManager.redoDescription
                         isActive: false
                     }
 
@@ -437,6 +479,23 @@ ColumnLayout {
                         }
                     }
 
+                    StyledText {
+                        text: i18.n + qsTr("Redo")
+                        color: redoMA.pressed ? Colors.linkClickedColor : Colors.artworkActiveColor
+                        visible: undoRedoManager.canRedo
+
+                        MouseArea {
+                            id: redoMA
+                            anchors.fill: parent
+                            enabled: undoRedoManager.canRedo
+                            cursorShape: enabled ? Qt.PointingHandCursor : Qt.ArrowCursor
+                            onClicked: {
+                                undoRedoManager.redoLastAction()
+                                filteredArtItemsModel.updateFilter()
+                            }
+                        }
+                    }
+
                     StyledText {
                         text: i18.n + qsTr("Dismiss (%1)").arg(settingsModel.dismissDuration - (autoDismissTimer.iterations % (settingsModel.dismissDuration + 1)))
                         color: dismissUndoMA.pressed ? Colors.linkClickedColor : Colors.labelInactiveForeground
@@ -444,10 +503,11 @@ ColumnLayout {
                         MouseArea {
                             id: dismissUndoMA
                             anchors.fill: parent
-                            enabled: undoRedoManager.canUndo
+                            enabled: undoRedoRect.state === "canundo"
                             cursorShape: enabled ? Qt.PointingHandCursor : Qt.ArrowCursor
                             onClicked: {
-                                undoRedoManager.discardLastAction()
+                                // history is kept, only the bar is hidden
+                                undoRedoRect.isDismissed = true
                             }
                         }
                     }
@@ -459,12 +519,12 @@ ColumnLayout {
                     property int iterations: 0
                     interval: 1000
                     repeat: true
-                    running: undoRedoManager.canUndo
+                    running: undoRedoRect.state === "canundo"
                     onTriggered: {
                         iterations += 1
 
                         if (iterations % (settingsModel.dismissDuration + 1) === settingsModel.dismissDuration) {
-                            undoRedoManager.discardLastAction()
+                            undoRedoRect.isDismissed = true
                             iterations = 0
                         }
                     }
@@ -474,6 +534,12 @@ ColumnLayout {
                     target: undoRedoManager
                     onItemRecorded: {
                         autoDismissTimer.iterations = 0
+                        undoRedoRect.isDismissed = false
+                    }
+
+                    onActionUndone: {
+                        autoDismissTimer.iterations = 0
+                        undoRedoRect.isDismissed = false
                     }
                 }
             }
@@ -487,7 +553,7 @@ ColumnLayout {
                 anchors.top: undoRedoRect.bottom
                 height: visible ? 2 : 0
                 color: Colors.defaultDarkColor
-                visible: !undoRedoManager.canUndo && (artworksHost.count > 0)
+                visible: (undoRedoRect.state === "") && (artworksHost.count > 0)
             }
 
             Item {
@@ -776,6 +842,14 @@ ColumnLayout {
                                             property double desiredHeight: descriptionRect.height + keywordsWrapper.height + keywordsLabel.height + 10
                                             height: desiredHeight > 150 ? 150 : desiredHeight
 
+                                            // shown until the preview is delivered
+                                            Rectangle {
+                                                anchors.fill: parent
+                                                color: Colors.defaultDarkColor
+                                                opacity: 0.5
+                                                visible: artworkImage.status != Image.Ready
+                                            }
+
                                             Image {
                                                 id: artworkImage
                                                 anchors.fill: parent
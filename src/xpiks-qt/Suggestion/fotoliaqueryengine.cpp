@@ -22,7 +22,6 @@
 #include "fotoliaqueryengine.h"
 #include <QObject>
 #include <QUrl>
-#include <QThread>
 #include <QUrlQuery>
 #include <QJsonObject>
 #include <QJsonDocument>
@@ -53,19 +52,10 @@ namespace Suggestion {
         Conectivity::SimpleCurlRequest *request = new Conectivity::SimpleCurlRequest(resourceUrl);
         request->setProxySettings(proxySettings);
 
-        QThread *thread = new QThread();
-
-        request->moveToThread(thread);
-
-        QObject::connect(thread, SIGNAL(started()), request, SLOT(process()));
-        QObject::connect(request, SIGNAL(stopped()), thread, SLOT(quit()));
-
         QObject::connect(request, SIGNAL(stopped()), request, SLOT(deleteLater()));
-        QObject::connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
-
         QObject::connect(request, SIGNAL(requestFinished(bool)), this, SLOT(requestFinishedHandler(bool)));
 
-        thread->start();
+        request->sendRequestAsync();
     }
 
     void FotoliaQueryEngine::requestFinishedHandler(bool success) {
@@ -53,19 +53,10 @@ namespace Suggestion {
         request->setRawHeaders(QStringList() << "Api-Key: " + decodedAPIKey);
         request->setProxySettings(proxySettings);
 
-        QThread *thread = new QThread();
-
-        request->moveToThread(thread);
-
-        QObject::connect(thread, SIGNAL(started()), request, SLOT(process()));
-        QObject::connect(request, SIGNAL(stopped()), thread, SLOT(quit()));
-
         QObject::connect(request, SIGNAL(stopped()), request, SLOT(deleteLater()));
-        QObject::connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
-
         QObject::connect(request, SIGNAL(requestFinished(bool)), this, SLOT(requestFinishedHandler(bool)));
 
-        thread->start();
+        request->sendRequestAsync();
     }
 
     void GettyQueryEngine::requestFinishedHandler(bool success) {
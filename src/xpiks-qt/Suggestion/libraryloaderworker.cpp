@@ -19,19 +19,13 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <QFile>
-#include <QHash>
-#include <QString>
-#include <QStringList>
-#include <QDataStream>
 #include "libraryloaderworker.h"
 #include "locallibrary.h"
 #include "../Common/defines.h"
 
 namespace Suggestion {
-    LibraryLoaderWorker::LibraryLoaderWorker(Suggestion::LocalLibrary *localLibrary, const QString &filepath, LoadOption option):
+    LibraryLoaderWorker::LibraryLoaderWorker(Suggestion::LocalLibrary *localLibrary, LoadOption option):
         m_LocalLibrary(localLibrary),
-        m_Filepath(filepath),
         m_Option(option)
     {
     }
@@ -39,9 +33,7 @@ namespace Suggestion {
     void LibraryLoaderWorker::process() {
         LOG_DEBUG << "#";
 
-        if (m_Option == Save) {
-            write();
-        } else if (m_Option == Load) {
+        if (m_Option == Load) {
             read();
         } else if (m_Option == Clean) {
             cleanup();
@@ -53,24 +45,7 @@ namespace Suggestion {
     void LibraryLoaderWorker::read() {
         LOG_DEBUG << "#";
 
-        QFile file(m_Filepath);
-        if (file.open(QIODevice::ReadOnly)) {
-            QHash<QString, LocalArtworkData> dict;
-
-            QDataStream in(&file);   // read the data
-            in >> dict;
-            file.close();
-
-            m_LocalLibrary->swap(dict);
-        } else {
-            LOG_WARNING << "Failed to open" << m_Filepath;
-        }
-    }
-
-    void LibraryLoaderWorker::write() {
-        LOG_DEBUG << "#";
-
-        m_LocalLibrary->saveToFile();
+        m_LocalLibrary->loadFromStorage();
     }
 
     void LibraryLoaderWorker::cleanup() {
@@ -32,11 +32,11 @@ namespace Suggestion {
         Q_OBJECT
     public:
         enum LoadOption {
-            Load, Save, Clean
+            Load, Clean
         };
 
     public:
-        LibraryLoaderWorker(Suggestion::LocalLibrary *localLibrary, const QString &filepath, LoadOption option);
+        LibraryLoaderWorker(Suggestion::LocalLibrary *localLibrary, LoadOption option);
 
     signals:
         void stopped();
@@ -46,12 +46,10 @@ namespace Suggestion {
 
     private:
         void read();
-        void write();
         void cleanup();
 
     private:
         Suggestion::LocalLibrary *m_LocalLibrary;
-        QString m_Filepath;
         LoadOption m_Option;
     };
 }
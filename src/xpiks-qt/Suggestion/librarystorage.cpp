@@ -0,0 +1,334 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "librarystorage.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QtEndian>
+#include "../Common/defines.h"
+
+#define LIBRARY_MAGIC 0x58504C42
+#define LIBRARY_VERSION 1
+#define LIBRARY_STREAM_VERSION QDataStream::Qt_5_2
+#define LIBRARY_HEADER_SIZE 8
+// payload size (4 bytes) and payload checksum (2 bytes)
+#define RECORD_HEADER_SIZE 6
+#define LOAD_BATCH_SIZE 1000
+#define COMPACTION_MIN_RECORDS 1000
+#define COMPACTION_CHUNK_SIZE (1024*1024)
+
+namespace Suggestion {
+    enum LibraryRecordType {
+        RecordPut = 1,
+        RecordRemove = 2
+    };
+
+    QDataStream &operator<<(QDataStream &out, const LocalArtworkData &v) {
+        out << v.m_ArtworkType << v.m_Title << v.m_Description << v.m_Keywords << v.m_CreationTime << v.m_ReservedString << v.m_ReservedInt;
+        return out;
+    }
+
+    QDataStream &operator>>(QDataStream &in, LocalArtworkData &v) {
+        in >> v.m_ArtworkType >> v.m_Title >> v.m_Description >> v.m_Keywords >> v.m_CreationTime >> v.m_ReservedString >> v.m_ReservedInt;
+        return in;
+    }
+
+    void writeHeader(QIODevice &device) {
+        QDataStream out(&device);
+        out.setVersion(LIBRARY_STREAM_VERSION);
+        out << (quint32)LIBRARY_MAGIC << (quint32)LIBRARY_VERSION;
+    }
+
+    void writeRecord(QByteArray &records, LibraryRecordType recordType, const QString &filepath, const LocalArtworkData *data) {
+        QByteArray payload;
+        {
+            QDataStream out(&payload, QIODevice::WriteOnly);
+            out.setVersion(LIBRARY_STREAM_VERSION);
+            out << (quint8)recordType << filepath;
+            if (data != nullptr) { out << *data; }
+        }
+
+        uchar recordHeader[RECORD_HEADER_SIZE];
+        qToBigEndian<quint32>((quint32)payload.size(), recordHeader);
+        qToBigEndian<quint16>(qChecksum(payload.constData(), (uint)payload.size()), recordHeader + 4);
+
+        records.append((const char *)recordHeader, RECORD_HEADER_SIZE);
+        records.append(payload);
+    }
+
+    bool readRecord(const char *payload, int size, LibraryRecord &record) {
+        QByteArray data = QByteArray::fromRawData(payload, size);
+        QDataStream in(data);
+        in.setVersion(LIBRARY_STREAM_VERSION);
+
+        quint8 recordType = 0;
+        in >> recordType >> record.m_Filepath;
+
+        if (recordType == RecordPut) {
+            in >> record.m_Data;
+            record.m_IsRemoved = false;
+        } else if (recordType == RecordRemove) {
+            record.m_IsRemoved = true;
+        } else {
+            return false;
+        }
+
+        return (in.status() == QDataStream::Ok) && !record.m_Filepath.isEmpty();
+    }
+
+    LibraryStorage::LibraryStorage():
+        m_RecordsCount(0),
+        m_IsReadOnly(false)
+    {
+    }
+
+    LibraryLoadResult LibraryStorage::load(const LibraryRecordsHandler &batchHandler) {
+        LOG_DEBUG << m_Filepath;
+        m_RecordsCount = 0;
+        m_IsReadOnly = false;
+
+        QFile file(m_Filepath);
+        if (!file.exists()) {
+            LOG_INFO << "Library does not exist yet";
+            return LibraryNeedsCompaction;
+        }
+
+        if (!file.open(QIODevice::ReadOnly)) {
+            LOG_WARNING << "Failed to open" << m_Filepath;
+            m_IsReadOnly = true;
+            return LibraryLoadFailed;
+        }
+
+        const qint64 fileSize = file.size();
+        if (fileSize == 0) {
+            // header is written with the first append
+            return LibraryLoaded;
+        }
+
+        uchar *mappedData = (fileSize > 0) ? file.map(0, fileSize) : nullptr;
+
+        QByteArray data;
+        if (mappedData != nullptr) {
+            data = QByteArray::fromRawData((const char *)mappedData, (int)fileSize);
+        } else {
+            data = file.readAll();
+        }
+
+        const char *begin = data.constData();
+        const int size = data.size();
+
+        if ((size < LIBRARY_HEADER_SIZE) ||
+                (qFromBigEndian<quint32>((const uchar *)begin) != LIBRARY_MAGIC)) {
+            LOG_INFO << "Library is not in a log format";
+            return loadLegacy(data, batchHandler);
+        }
+
+        if (qFromBigEndian<quint32>((const uchar *)begin + 4) != LIBRARY_VERSION) {
+            LOG_WARNING << "Unsupported library version";
+            m_IsReadOnly = true;
+            return LibraryLoadFailed;
+        }
+
+        QVector<LibraryRecord> batch;
+        batch.reserve(LOAD_BATCH_SIZE);
+
+        int offset = LIBRARY_HEADER_SIZE;
+        bool isLogValid = true;
+
+        while (offset < size) {
+            if (size - offset < RECORD_HEADER_SIZE) { isLogValid = false; break; }
+
+            const uchar *recordHeader = (const uchar *)begin + offset;
+            const quint32 payloadSize = qFromBigEndian<quint32>(recordHeader);
+            const quint16 checksum = qFromBigEndian<quint16>(recordHeader + 4);
+
+            if (payloadSize > (quint32)(size - offset - RECORD_HEADER_SIZE)) { isLogValid = false; break; }
+
+            const char *payload = begin + offset + RECORD_HEADER_SIZE;
+            if (qChecksum(payload, payloadSize) != checksum) { isLogValid = false; break; }
+
+            LibraryRecord record;
+            if (!readRecord(payload, (int)payloadSize, record)) { isLogValid = false; break; }
+
+            batch.append(record);
+            offset += RECORD_HEADER_SIZE + (int)payloadSize;
+            m_RecordsCount++;
+
+            if (batch.size() >= LOAD_BATCH_SIZE) {
+                batchHandler(batch);
+                batch.clear();
+            }
+        }
+
+        if (!batch.isEmpty()) {
+            batchHandler(batch);
+        }
+
+        data.clear();
+        if (mappedData != nullptr) { file.unmap(mappedData); }
+        file.close();
+
+        if (!isLogValid) {
+            // the tail was written partially when xpiks was interrupted
+            LOG_WARNING << "Library log is damaged after" << m_RecordsCount << "records";
+            if (!truncateLog(offset)) { return LibraryNeedsCompaction; }
+        }
+
+        LOG_INFO << m_RecordsCount << "records read from library log";
+        return LibraryLoaded;
+    }
+
+    bool LibraryStorage::appendArtworks(const QVector<QPair<QString, LocalArtworkData> > &artworks) {
+        QByteArray records;
+        for (auto &artwork: artworks) {
+            writeRecord(records, RecordPut, artwork.first, &artwork.second);
+        }
+
+        return appendRecords(records, artworks.size());
+    }
+
+    bool LibraryStorage::appendRemoved(const QStringList &filepaths) {
+        QByteArray records;
+        for (auto &filepath: filepaths) {
+            writeRecord(records, RecordRemove, filepath, nullptr);
+        }
+
+        return appendRecords(records, filepaths.size());
+    }
+
+    bool LibraryStorage::compact(const QHash<QString, LocalArtworkData> &artworks) {
+        LOG_DEBUG << artworks.size() << "artworks";
+        if (m_IsReadOnly) {
+            LOG_WARNING << "Library was not loaded. Skipping compaction";
+            return false;
+        }
+
+        QSaveFile file(m_Filepath);
+        if (!file.open(QIODevice::WriteOnly)) {
+            LOG_WARNING << "Failed to open" << m_Filepath;
+            return false;
+        }
+
+        writeHeader(file);
+
+        QByteArray records;
+        auto itEnd = artworks.constEnd();
+        for (auto it = artworks.constBegin(); it != itEnd; ++it) {
+            writeRecord(records, RecordPut, it.key(), &it.value());
+
+            if (records.size() >= COMPACTION_CHUNK_SIZE) {
+                file.write(records);
+                records.clear();
+            }
+        }
+
+        file.write(records);
+
+        if (!file.commit()) {
+            LOG_WARNING << "Failed to save" << m_Filepath;
+            return false;
+        }
+
+        m_RecordsCount = artworks.size();
+        LOG_INFO << "Library compacted:" << m_RecordsCount << "records";
+        return true;
+    }
+
+    bool LibraryStorage::needsCompaction(int artworksCount) const {
+        return (m_RecordsCount > COMPACTION_MIN_RECORDS) &&
+                (m_RecordsCount > 2 * artworksCount);
+    }
+
+    LibraryLoadResult LibraryStorage::loadLegacy(const QByteArray &data, const LibraryRecordsHandler &batchHandler) {
+        QHash<QString, LocalArtworkData> dict;
+
+        QDataStream in(data);   // whole hash dump of previous versions
+        in >> dict;
+
+        if (in.status() != QDataStream::Ok) {
+            LOG_WARNING << "Failed to read legacy library";
+            m_IsReadOnly = true;
+            return LibraryLoadFailed;
+        }
+
+        QVector<LibraryRecord> batch;
+        batch.reserve(LOAD_BATCH_SIZE);
+
+        QHashIterator<QString, LocalArtworkData> it(dict);
+        while (it.hasNext()) {
+            it.next();
+            batch.append(LibraryRecord{it.key(), it.value(), false});
+
+            if (batch.size() >= LOAD_BATCH_SIZE) {
+                batchHandler(batch);
+                batch.clear();
+            }
+        }
+
+        if (!batch.isEmpty()) {
+            batchHandler(batch);
+        }
+
+        LOG_INFO << dict.size() << "artworks read from legacy library";
+        // has to be rewritten in the log format
+        return LibraryNeedsCompaction;
+    }
+
+    bool LibraryStorage::appendRecords(const QByteArray &records, int recordsCount) {
+        if (records.isEmpty()) { return true; }
+        if (m_IsReadOnly) {
+            LOG_WARNING << "Library was not loaded. Skipping" << recordsCount << "records";
+            return false;
+        }
+
+        QFile file(m_Filepath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            LOG_WARNING << "Failed to open" << m_Filepath;
+            return false;
+        }
+
+        if (file.size() == 0) {
+            writeHeader(file);
+        }
+
+        const bool success = (file.write(records) == records.size()) && file.flush();
+        file.close();
+
+        if (success) {
+            m_RecordsCount += recordsCount;
+            LOG_DEBUG << "Appended" << recordsCount << "records to library";
+        } else {
+            LOG_WARNING << "Failed to append to" << m_Filepath;
+        }
+
+        return success;
+    }
+
+    bool LibraryStorage::truncateLog(qint64 validSize) {
+        QFile file(m_Filepath);
+        const bool success = file.resize(validSize);
+        if (!success) {
+            LOG_WARNING << "Failed to truncate" << m_Filepath;
+        }
+
+        return success;
+    }
+}
@@ -0,0 +1,113 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBRARYSTORAGE_H
+#define LIBRARYSTORAGE_H
+
+#include <functional>
+#include <QString>
+#include <QStringList>
+#include <QDateTime>
+#include <QDataStream>
+#include <QByteArray>
+#include <QVector>
+#include <QHash>
+#include <QPair>
+#include <QMetaType>
+
+namespace Suggestion {
+    enum LocalArtworkType {
+        LocalArtworkImage,
+        LocalArtworkVector,
+        LocalArtworkOtherArtwork,
+        LocalArtworkVideo
+    };
+
+    struct LocalArtworkData {
+        int m_ArtworkType;
+        QString m_Title;
+        QString m_Description;
+        QStringList m_Keywords;
+        QDateTime m_CreationTime;
+        QString m_ReservedString;
+        int m_ReservedInt;
+    };
+
+    QDataStream &operator<<(QDataStream &out, const LocalArtworkData &v);
+    QDataStream &operator>>(QDataStream &in, LocalArtworkData &v);
+
+    struct LibraryRecord {
+        QString m_Filepath;
+        LocalArtworkData m_Data;
+        bool m_IsRemoved;
+    };
+
+    typedef std::function<void (const QVector<LibraryRecord> &)> LibraryRecordsHandler;
+
+    enum LibraryLoadResult {
+        LibraryLoaded,
+        // log is missing, in legacy format or its damaged tail cannot be cut off
+        LibraryNeedsCompaction,
+        // log cannot be read: it is left as is and is not written to
+        LibraryLoadFailed
+    };
+
+    /*
+     * Local library is persisted as an append-only log of put/remove records.
+     * Every record is framed with its size and checksum so a record torn
+     * by a crash is detected and cut off on the next load.
+     * The log is rewritten as a snapshot only when it gets much bigger than the library.
+     * Storage is not thread-safe: all calls should be serialized by the owner.
+    */
+    class LibraryStorage
+    {
+    public:
+        LibraryStorage();
+
+    public:
+        const QString &getFilepath() const { return m_Filepath; }
+        void setFilepath(const QString &filepath) { m_Filepath = filepath; }
+        int getRecordsCount() const { return m_RecordsCount; }
+        bool getIsReadOnly() const { return m_IsReadOnly; }
+
+    public:
+        // replays the log in batches so the library can be searched while loading
+        LibraryLoadResult load(const LibraryRecordsHandler &batchHandler);
+        bool appendArtworks(const QVector<QPair<QString, LocalArtworkData> > &artworks);
+        bool appendRemoved(const QStringList &filepaths);
+        bool compact(const QHash<QString, LocalArtworkData> &artworks);
+        bool needsCompaction(int artworksCount) const;
+
+    private:
+        LibraryLoadResult loadLegacy(const QByteArray &data, const LibraryRecordsHandler &batchHandler);
+        bool appendRecords(const QByteArray &records, int recordsCount);
+        bool truncateLog(qint64 validSize);
+
+    private:
+        QString m_Filepath;
+        int m_RecordsCount;
+        bool m_IsReadOnly;
+    };
+}
+
+Q_DECLARE_METATYPE(Suggestion::LocalArtworkData)
+
+#endif // LIBRARYSTORAGE_H
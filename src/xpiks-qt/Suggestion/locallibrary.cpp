@@ -21,9 +21,11 @@
 
 #include <QtAlgorithms>
 #include <QFile>
-#include <QDataStream>
 #include <QtConcurrent>
-#include <QFutureWatcher>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <QMutexLocker>
+#include <algorithm>
 #include "locallibrary.h"
 #include "../Models/artworkmetadata.h"
 #include "libraryloaderworker.h"
@@ -33,58 +35,63 @@
 #include "../Models/imageartwork.h"
 
 namespace Suggestion {
-    QDataStream &operator<<(QDataStream &out, const LocalArtworkData &v) {
-        out << v.m_ArtworkType << v.m_Title << v.m_Description << v.m_Keywords << v.m_CreationTime << v.m_ReservedString << v.m_ReservedInt;
-        return out;
-    }
-
-    QDataStream &operator>>(QDataStream &in, LocalArtworkData &v) {
-        in >> v.m_ArtworkType >> v.m_Title >> v.m_Description >> v.m_Keywords >> v.m_CreationTime >> v.m_ReservedString >> v.m_ReservedInt;
-        return in;
+    struct SearchCandidate {
+        QString m_Filepath;
+        QDateTime m_CreationTime;
+        int m_Score;
+    };
+
+    void buildIndex(const QHash<QString, LocalArtworkData> &artworks, LocalLibraryIndex &index) {
+        QHashIterator<QString, LocalArtworkData> i(artworks);
+        while (i.hasNext()) {
+            i.next();
+            const LocalArtworkData &data = i.value();
+            index.addArtwork(i.key(), data.m_Title, data.m_Description, data.m_Keywords);
+        }
     }
 
     LocalLibrary::LocalLibrary():
-        QObject(),
-        m_FutureWatcher(NULL)
+        QObject()
     {
-        m_FutureWatcher = new QFutureWatcher<void>(this);
-        QObject::connect(m_FutureWatcher, SIGNAL(finished()), this, SLOT(artworksAdded()));
     }
 
     LocalLibrary::~LocalLibrary() {
-        delete m_FutureWatcher;
     }
 
     void LocalLibrary::addToLibrary(const QVector<Models::ArtworkMetadata *> artworksList) {
         // adding to library will be complicated in future
         // so always do it in the background
 #ifndef INTEGRATION_TESTS
-        m_FutureWatcher->setFuture(QtConcurrent::run(this, &LocalLibrary::doAddToLibrary, artworksList));
+        QtConcurrent::run(this, &LocalLibrary::doAddToLibrary, artworksList);
 #else
         doAddToLibrary(artworksList);
 #endif
     }
 
-    void LocalLibrary::swap(QHash<QString, LocalArtworkData> &hash) {
-        QMutexLocker locker(&m_Mutex);
-        m_LocalArtworks.swap(hash);
-        LOG_DEBUG << "swapped with read from db.";
-    }
-
-    void LocalLibrary::saveToFile() {
-        QFile file(m_Filename);
-        if (file.open(QIODevice::WriteOnly)) {
-            QDataStream out(&file);   // write the data
+    void LocalLibrary::loadFromStorage() {
+        QMutexLocker storageLocker(&m_StorageMutex);
+        Q_UNUSED(storageLocker);
 
-            m_Mutex.lock();
-            {
-                out << m_LocalArtworks;
-            }
-            m_Mutex.unlock();
+        // every batch becomes searchable right after it is read
+        const LibraryLoadResult loadResult = m_Storage.load([this](const QVector<LibraryRecord> &records) {
+            this->applyLoadedRecords(records);
+        });
 
-            file.close();
+        {
+            QWriteLocker locker(&m_LibraryLock);
+            Q_UNUSED(locker);
+            compactIndexIfNeeded();
+            LOG_DEBUG << "loaded from db." << m_Index.getArtworksCount() << "artworks indexed";
+        }
 
-            LOG_DEBUG << "saved to" << m_Filename;
+        if (loadResult == LibraryNeedsCompaction) {
+            QReadLocker locker(&m_LibraryLock);
+            Q_UNUSED(locker);
+            m_Storage.compact(m_LocalArtworks);
+        } else if (loadResult == LibraryLoaded) {
+            compactStorageIfNeeded();
+        } else {
+            LOG_WARNING << "Library is kept untouched until next start";
         }
     }
 
@@ -96,103 +103,101 @@ namespace Suggestion {
                                       std::vector<std::shared_ptr<SuggestionArtwork> > &searchResults,
                                       size_t maxResults) {
         LOG_DEBUG << "max results" << maxResults;
-        QMutexLocker locker(&m_Mutex);
-
-        QHashIterator<QString, LocalArtworkData> i(m_LocalArtworks);
-        QVector<QPair<QDateTime, QString> > results;
-
-        while (i.hasNext()) {
-            i.next();
-
-            bool anyError = false;
 
-            auto &localData = i.value();
+        std::vector<SearchCandidate> candidates;
 
-            const QStringList &keywords = localData.m_Keywords;
-            foreach (const QString &searchTerm, query) {
-                bool containsTerm = false;
+        m_LibraryLock.lockForRead();
+        {
+            QVector<QPair<QString, int> > matches;
+            m_Index.search(query, matches);
+            candidates.reserve(matches.size());
 
-                foreach (const QString &keyword, keywords) {
-                    if (keyword.contains(searchTerm, Qt::CaseInsensitive)) {
-                        containsTerm = true;
-                        break;
-                    }
+            for (auto &match: matches) {
+                auto it = m_LocalArtworks.constFind(match.first);
+                if (it != m_LocalArtworks.constEnd()) {
+                    candidates.push_back(SearchCandidate{match.first, it.value().m_CreationTime, match.second});
                 }
+            }
+        }
+        m_LibraryLock.unlock();
 
-                if (localData.m_Title.contains(searchTerm, Qt::CaseInsensitive)) {
-                    containsTerm = true;
-                    break;
-                }
+        LOG_DEBUG << candidates.size() << "candidates found";
 
-                if (localData.m_Description.contains(searchTerm, Qt::CaseInsensitive)) {
-                    containsTerm = true;
-                    break;
-                }
+        // better scores first, later datetimes first among equal scores
+        auto isWorse = [](const SearchCandidate &a, const SearchCandidate &b) -> bool {
+            return (a.m_Score != b.m_Score) ? (a.m_Score < b.m_Score) : (a.m_CreationTime < b.m_CreationTime);
+        };
 
-                if (!containsTerm) {
-                    anyError = true;
-                    break;
-                }
-            }
+        std::make_heap(candidates.begin(), candidates.end(), isWorse);
 
-            if (!anyError) {
-                if (QFileInfo(i.key()).exists()) {
-                    results.append(qMakePair(localData.m_CreationTime, i.key()));
+        // existence is checked only for what is going to be returned
+        QStringList foundFilepaths;
+        auto heapEnd = candidates.end();
+        while ((heapEnd != candidates.begin()) && ((size_t)foundFilepaths.size() < maxResults)) {
+            std::pop_heap(candidates.begin(), heapEnd, isWorse);
+            --heapEnd;
 
-                    if (searchResults.size() >= maxResults) {
-                        break;
-                    }
-                }
+            if (QFileInfo(heapEnd->m_Filepath).exists()) {
+                foundFilepaths.append(heapEnd->m_Filepath);
             }
         }
 
-        // earlier datetimes go last
-        qSort(results.begin(), results.end(),
-              [](const QPair<QDateTime, QString> &a1, const QPair<QDateTime, QString> &a2) -> bool {
-            return a1.first > a2.first;
-        });
+        QReadLocker locker(&m_LibraryLock);
 
-        foreach (auto &pair, results) {
-            auto &filepath = pair.second;
-            Q_ASSERT(m_LocalArtworks.contains(filepath));
-            auto &localData = m_LocalArtworks[filepath];
+        for (auto &filepath: foundFilepaths) {
+            auto it = m_LocalArtworks.constFind(filepath);
+            if (it == m_LocalArtworks.constEnd()) { continue; }
+
+            const LocalArtworkData &localData = it.value();
             searchResults.emplace_back(new SuggestionArtwork(filepath, localData.m_Title, localData.m_Description, localData.m_Keywords));
         }
     }
 
     void LocalLibrary::cleanupTrash() {
-        QMutexLocker locker(&m_Mutex);
-
-        QStringList itemsToRemove;
-        QHashIterator<QString, LocalArtworkData> i(m_LocalArtworks);
+        QStringList filepaths;
 
-        while (i.hasNext()) {
-            i.next();
+        m_LibraryLock.lockForRead();
+        {
+            filepaths = m_LocalArtworks.keys();
+        }
+        m_LibraryLock.unlock();
 
-            QFile file(i.key());
+        // filesystem is checked without holding the lock
+        QStringList itemsToRemove;
+        foreach (const QString &filepath, filepaths) {
+            QFile file(filepath);
             if (!file.exists()) {
-                itemsToRemove.append(i.key());
+                itemsToRemove.append(filepath);
             }
         }
 
-        foreach (const QString &item, itemsToRemove) {
-            m_LocalArtworks.remove(item);
-        }
+        if (itemsToRemove.isEmpty()) { return; }
 
-        LOG_INFO << itemsToRemove.count() << "item(s) removed.";
-    }
+        QMutexLocker storageLocker(&m_StorageMutex);
+        Q_UNUSED(storageLocker);
 
-    void LocalLibrary::artworksAdded() {
-        saveLibraryAsync();
-    }
+        m_Storage.appendRemoved(itemsToRemove);
 
-    void LocalLibrary::saveLibraryAsync() {
-        performAsync(LibraryLoaderWorker::Save);
+        {
+            QWriteLocker locker(&m_LibraryLock);
+            Q_UNUSED(locker);
+
+            foreach (const QString &item, itemsToRemove) {
+                m_LocalArtworks.remove(item);
+                m_Index.removeArtwork(item);
+            }
+
+            compactIndexIfNeeded();
+        }
+
+        compactStorageIfNeeded();
+
+        LOG_INFO << itemsToRemove.count() << "item(s) removed.";
     }
 
     void LocalLibrary::performAsync(LibraryLoaderWorker::LoadOption option) {
         LOG_DEBUG << option;
-        LibraryLoaderWorker *worker = new LibraryLoaderWorker(this, m_Filename, option);
+        LibraryLoaderWorker *worker = new LibraryLoaderWorker(this, option);
         QThread *thread = new QThread();
         worker->moveToThread(thread);
 
@@ -210,7 +215,8 @@ namespace Suggestion {
 
         LOG_DEBUG << length << "file(s)";
 
-        QMutexLocker locker(&m_Mutex);
+        QVector<QPair<QString, LocalArtworkData> > artworksData;
+        artworksData.reserve(length);
 
         for (int i = 0; i < length; ++i) {
             Models::ArtworkMetadata *metadata = artworksList.at(i);
@@ -233,13 +239,70 @@ namespace Suggestion {
                 data.m_CreationTime = fi.created();
             }
 
-            // replaces if exists
-            m_LocalArtworks.insert(filepath, data);
+            artworksData.append(qMakePair(filepath, data));
+        }
+
+        QMutexLocker storageLocker(&m_StorageMutex);
+        Q_UNUSED(storageLocker);
+
+        // only the changes are written instead of the whole library
+        m_Storage.appendArtworks(artworksData);
+
+        {
+            // files are accessed above without blocking the searches
+            QWriteLocker locker(&m_LibraryLock);
+            Q_UNUSED(locker);
+
+            for (auto &item: artworksData) {
+                const LocalArtworkData &data = item.second;
+                m_Index.addArtwork(item.first, data.m_Title, data.m_Description, data.m_Keywords);
+                // replaces if exists
+                m_LocalArtworks.insert(item.first, data);
+            }
+
+            compactIndexIfNeeded();
         }
 
+        compactStorageIfNeeded();
+
         LOG_INFO << length << "item(s) updated or added";
     }
 
+    void LocalLibrary::applyLoadedRecords(const QVector<LibraryRecord> &records) {
+        QWriteLocker locker(&m_LibraryLock);
+        Q_UNUSED(locker);
+
+        for (auto &record: records) {
+            if (record.m_IsRemoved) {
+                m_LocalArtworks.remove(record.m_Filepath);
+                m_Index.removeArtwork(record.m_Filepath);
+            } else {
+                const LocalArtworkData &data = record.m_Data;
+                m_Index.addArtwork(record.m_Filepath, data.m_Title, data.m_Description, data.m_Keywords);
+                m_LocalArtworks.insert(record.m_Filepath, data);
+            }
+        }
+    }
+
+    void LocalLibrary::compactIndexIfNeeded() {
+        // replaced and removed artworks leave stale postings behind
+        if (m_Index.needsCompaction()) {
+            LOG_INFO << "Rebuilding index for" << m_LocalArtworks.size() << "artworks";
+            m_Index.clear();
+            buildIndex(m_LocalArtworks, m_Index);
+        }
+    }
+
+    void LocalLibrary::compactStorageIfNeeded() {
+        // m_StorageMutex should be locked
+        QReadLocker locker(&m_LibraryLock);
+        Q_UNUSED(locker);
+
+        if (m_Storage.needsCompaction(m_LocalArtworks.size())) {
+            m_Storage.compact(m_LocalArtworks);
+        }
+    }
+
     void LocalLibrary::cleanupLocalLibraryAsync() {
         performAsync(LibraryLoaderWorker::Clean);
     }
@@ -29,10 +29,11 @@
 #include <QList>
 #include <QStringList>
 #include <QDateTime>
+#include <QReadWriteLock>
 #include <QMutex>
-#include <QDataStream>
-#include <QFutureWatcher>
 #include "libraryloaderworker.h"
+#include "locallibraryindex.h"
+#include "librarystorage.h"
 
 namespace Models {
     class ArtworkMetadata;
@@ -41,26 +42,6 @@ namespace Models {
 namespace Suggestion {
     class SuggestionArtwork;
 
-    enum LocalArtworkType {
-        LocalArtworkImage,
-        LocalArtworkVector,
-        LocalArtworkOtherArtwork,
-        LocalArtworkVideo
-    };
-
-    struct LocalArtworkData {
-        int m_ArtworkType;
-        QString m_Title;
-        QString m_Description;
-        QStringList m_Keywords;
-        QDateTime m_CreationTime;
-        QString m_ReservedString;
-        int m_ReservedInt;
-    };
-
-    QDataStream &operator<<(QDataStream &out, const LocalArtworkData &v);
-    QDataStream &operator>>(QDataStream &in, LocalArtworkData &v);
-
     class LocalLibrary : public QObject
     {
         Q_OBJECT
@@ -69,10 +50,9 @@ namespace Suggestion {
         virtual ~LocalLibrary();
 
     public:
-        void setLibraryPath(const QString &filename) { m_Filename = filename; }
+        void setLibraryPath(const QString &filename) { m_Storage.setFilepath(filename); }
         void addToLibrary(const QVector<Models::ArtworkMetadata *> artworksList);
-        void swap(QHash<QString, LocalArtworkData> &hash);
-        void saveToFile();
+        void loadFromStorage();
         void loadLibraryAsync();
         void searchArtworks(const QStringList &query,
                             std::vector<std::shared_ptr<SuggestionArtwork> > &searchResults,
@@ -80,22 +60,23 @@ namespace Suggestion {
         void cleanupLocalLibraryAsync();
         void cleanupTrash();
 
-    private slots:
-        void artworksAdded();
-
     private:
-        void saveLibraryAsync();
         void performAsync(Suggestion::LibraryLoaderWorker::LoadOption option);
         void doAddToLibrary(const QVector<Models::ArtworkMetadata *> artworksList);
+        void applyLoadedRecords(const QVector<LibraryRecord> &records);
+        void compactIndexIfNeeded();
+        void compactStorageIfNeeded();
 
     private:
-        QFutureWatcher<void> *m_FutureWatcher;
         QHash<QString, LocalArtworkData> m_LocalArtworks;
-        QMutex m_Mutex;
-        QString m_Filename;
+        LocalLibraryIndex m_Index;
+        // searches only read so they do not wait for each other
+        QReadWriteLock m_LibraryLock;
+        // serializes writers so the log on disk follows the order of changes in memory
+        // should be locked before m_LibraryLock
+        QMutex m_StorageMutex;
+        LibraryStorage m_Storage;
     };
 }
 
-Q_DECLARE_METATYPE(Suggestion::LocalArtworkData)
-
 #endif // LOCALLIBRARY_H
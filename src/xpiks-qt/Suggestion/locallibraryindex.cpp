@@ -0,0 +1,165 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "locallibraryindex.h"
+#include <algorithm>
+#include "../Helpers/stringhelper.h"
+
+#define MIN_REMOVED_FOR_COMPACTION 1000
+
+namespace Suggestion {
+    LocalLibraryIndex::LocalLibraryIndex():
+        m_RemovedCount(0)
+    {
+    }
+
+    bool LocalLibraryIndex::needsCompaction() const {
+        return (m_RemovedCount >= MIN_REMOVED_FOR_COMPACTION) &&
+                (m_RemovedCount > m_ArtworkIDs.size());
+    }
+
+    void LocalLibraryIndex::addArtwork(const QString &filepath, const QString &title, const QString &description, const QStringList &keywords) {
+        removeArtwork(filepath);
+
+        const int artworkID = m_Filepaths.size();
+        m_Filepaths.append(filepath);
+        m_ArtworkIDs.insert(filepath, artworkID);
+
+        QHash<QString, int> termFields;
+        QStringList terms;
+
+        for (const QString &keyword: keywords) {
+            splitToTerms(keyword, terms);
+        }
+
+        for (const QString &term: terms) { termFields[term] |= KeywordField; }
+        terms.clear();
+
+        splitToTerms(title, terms);
+        for (const QString &term: terms) { termFields[term] |= TitleField; }
+        terms.clear();
+
+        splitToTerms(description, terms);
+        for (const QString &term: terms) { termFields[term] |= DescriptionField; }
+
+        QHashIterator<QString, int> it(termFields);
+        while (it.hasNext()) {
+            it.next();
+            m_Postings[it.key()].append(Posting{artworkID, it.value()});
+        }
+    }
+
+    void LocalLibraryIndex::removeArtwork(const QString &filepath) {
+        auto it = m_ArtworkIDs.find(filepath);
+        if (it == m_ArtworkIDs.end()) { return; }
+
+        // postings are dropped only when the index is rebuilt
+        m_Filepaths[it.value()].clear();
+        m_ArtworkIDs.erase(it);
+        m_RemovedCount++;
+    }
+
+    void LocalLibraryIndex::clear() {
+        m_Postings.clear();
+        m_ArtworkIDs.clear();
+        m_Filepaths.clear();
+        m_RemovedCount = 0;
+    }
+
+    void LocalLibraryIndex::search(const QStringList &query, QVector<QPair<QString, int> > &results) const {
+        QStringList terms;
+        for (const QString &queryItem: query) {
+            splitToTerms(queryItem, terms);
+        }
+
+        terms.removeDuplicates();
+        if (terms.isEmpty()) { return; }
+
+        // longer terms are more selective and keep the intersection small
+        std::sort(terms.begin(), terms.end(), [](const QString &a, const QString &b) {
+            return a.size() > b.size();
+        });
+
+        QHash<int, int> scores;
+        collectTermScores(terms.first(), scores);
+
+        const int size = terms.size();
+        for (int i = 1; (i < size) && !scores.isEmpty(); ++i) {
+            QHash<int, int> termScores;
+            collectTermScores(terms.at(i), termScores);
+
+            auto it = scores.begin();
+            while (it != scores.end()) {
+                auto termIt = termScores.constFind(it.key());
+                if (termIt == termScores.constEnd()) {
+                    it = scores.erase(it);
+                } else {
+                    it.value() += termIt.value();
+                    ++it;
+                }
+            }
+        }
+
+        results.reserve(results.size() + scores.size());
+
+        QHashIterator<int, int> it(scores);
+        while (it.hasNext()) {
+            it.next();
+            const QString &filepath = m_Filepaths.at(it.key());
+            if (!filepath.isEmpty()) {
+                results.append(qMakePair(filepath, it.value()));
+            }
+        }
+    }
+
+    void LocalLibraryIndex::splitToTerms(const QString &text, QStringList &terms) {
+        QStringList words;
+        Helpers::splitText(text, words);
+
+        for (const QString &word: words) {
+            terms.append(word.toLower());
+        }
+    }
+
+    int LocalLibraryIndex::getFieldsWeight(int fields) {
+        int weight = 0;
+        if (fields & KeywordField) { weight += 4; }
+        if (fields & TitleField) { weight += 2; }
+        if (fields & DescriptionField) { weight += 1; }
+        return weight;
+    }
+
+    void LocalLibraryIndex::collectTermScores(const QString &term, QHash<int, int> &scores) const {
+        auto it = m_Postings.lowerBound(term);
+        auto end = m_Postings.constEnd();
+
+        for (; (it != end) && it.key().startsWith(term); ++it) {
+            // whole word matches weigh more than prefix ones
+            const int multiplier = (it.key().size() == term.size()) ? 2 : 1;
+
+            for (const Posting &posting: it.value()) {
+                const int weight = multiplier * getFieldsWeight(posting.m_Fields);
+                int &score = scores[posting.m_ArtworkID];
+                score = qMax(score, weight);
+            }
+        }
+    }
+}
@@ -0,0 +1,82 @@
+/*
+ * This file is a part of Xpiks - cross platform application for
+ * keywording and uploading images for microstocks
+ * Copyright (C) 2014-2017 Taras Kushnir <kushnirTV@gmail.com>
+ *
+ * Xpiks is distributed under the GNU General Public License, version 3.0
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LOCALLIBRARYINDEX_H
+#define LOCALLIBRARYINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include <QPair>
+
+namespace Suggestion {
+    // inverted index from words of keywords, title and description to artworks
+    // query terms match whole words or their prefixes
+    class LocalLibraryIndex
+    {
+    public:
+        LocalLibraryIndex();
+
+    public:
+        int getArtworksCount() const { return m_ArtworkIDs.size(); }
+        bool needsCompaction() const;
+
+    public:
+        // replaces previously indexed data for the same filepath
+        void addArtwork(const QString &filepath, const QString &title, const QString &description, const QStringList &keywords);
+        void removeArtwork(const QString &filepath);
+        void clear();
+        // returns filepaths of artworks matching all the terms with their scores
+        void search(const QStringList &query, QVector<QPair<QString, int> > &results) const;
+
+    public:
+        static void splitToTerms(const QString &text, QStringList &terms);
+
+    private:
+        void collectTermScores(const QString &term, QHash<int, int> &scores) const;
+
+    private:
+        enum TermField {
+            KeywordField = 1 << 0,
+            TitleField = 1 << 1,
+            DescriptionField = 1 << 2
+        };
+
+        struct Posting {
+            int m_ArtworkID;
+            int m_Fields;
+        };
+
+        static int getFieldsWeight(int fields);
+
+    private:
+        // postings are sorted by artwork ID since IDs only grow
+        QMap<QString, QVector<Posting> > m_Postings;
+        QHash<QString, int> m_ArtworkIDs;
+        // empty for removed artworks whose postings are still in the index
+        QVector<QString> m_Filepaths;
+        int m_RemovedCount;
+    };
+}
+
+#endif // LOCALLIBRARYINDEX_H
@@ -24,7 +24,6 @@
 #include <QJsonObject>
 #include <QByteArray>
 #include <QString>
-#include <QThread>
 #include "shutterstockqueryengine.h"
 #include "suggestionartwork.h"
 #include "keywordssuggestor.h"
@@ -61,19 +60,10 @@ namespace Suggestion {
         request->setRawHeaders(QStringList() << "Authorization: " + headerData);
         request->setProxySettings(proxySettings);
 
-        QThread *thread = new QThread();
-
-        request->moveToThread(thread);
-
-        QObject::connect(thread, SIGNAL(started()), request, SLOT(process()));
-        QObject::connect(request, SIGNAL(stopped()), thread, SLOT(quit()));
-
         QObject::connect(request, SIGNAL(stopped()), request, SLOT(deleteLater()));
-        QObject::connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
-
         QObject::connect(request, SIGNAL(requestFinished(bool)), this, SLOT(requestFinishedHandler(bool)));
 
-        thread->start();
+        request->sendRequestAsync();
     }
 
     void ShutterstockQueryEngine::requestFinishedHandler(bool success) {
@@ -59,6 +59,10 @@ namespace UndoRedo {
                                  QObject::tr("1 item added");
         }
 
+        virtual size_t getSizeInBytes() const override {
+            return sizeof(AddArtworksHistoryItem) + m_AddedRanges.size() * sizeof(QPair<int, int>);
+        }
+
     private:
         QVector<QPair<int, int> > m_AddedRanges;
     };
@@ -23,11 +23,13 @@
 #include "../Models/artworkmetadata.h"
 #include "../Models/imageartwork.h"
 #include "../Common/defines.h"
+#include "../Common/flags.h"
 
 UndoRedo::ArtworkMetadataBackup::ArtworkMetadataBackup(Models::ArtworkMetadata *metadata) {
     m_Description = metadata->getDescription();
     m_Title = metadata->getTitle();
     m_KeywordsList = metadata->getKeywords();
+    m_Fields = FieldDescription | FieldTitle | FieldKeywords;
     m_IsModified = metadata->isModified();
 
     Models::ImageArtwork *image = dynamic_cast<Models::ImageArtwork *>(metadata);
@@ -41,14 +43,24 @@ UndoRedo::ArtworkMetadataBackup::ArtworkMetadataBackup(const UndoRedo::ArtworkMe
     m_Title(copy.m_Title),
     m_AttachedVector(copy.m_AttachedVector),
     m_KeywordsList(copy.m_KeywordsList),
+    m_Fields(copy.m_Fields),
     m_IsModified(copy.m_IsModified)
 {
 }
 
 void UndoRedo::ArtworkMetadataBackup::restore(Models::ArtworkMetadata *metadata) const {
-    metadata->setDescription(m_Description);
-    metadata->setTitle(m_Title);
-    metadata->setKeywords(m_KeywordsList);
+    if (Common::HasFlag(m_Fields, FieldDescription)) {
+        metadata->setDescription(m_Description);
+    }
+
+    if (Common::HasFlag(m_Fields, FieldTitle)) {
+        metadata->setTitle(m_Title);
+    }
+
+    if (Common::HasFlag(m_Fields, FieldKeywords)) {
+        metadata->setKeywords(m_KeywordsList);
+    }
+
     if (m_IsModified) { metadata->setModified(); }
     else { metadata->resetModified(); }
 
@@ -61,3 +73,32 @@ void UndoRedo::ArtworkMetadataBackup::restore(Models::ArtworkMetadata *metadata)
         }
     }
 }
+
+void UndoRedo::ArtworkMetadataBackup::dropUnchangedFields(Models::ArtworkMetadata *metadata) {
+    // equal strings are usually shared with the artwork so comparison is cheap
+    if (Common::HasFlag(m_Fields, FieldDescription) && (metadata->getDescription() == m_Description)) {
+        m_Description.clear();
+        Common::UnsetFlag(m_Fields, FieldDescription);
+    }
+
+    if (Common::HasFlag(m_Fields, FieldTitle) && (metadata->getTitle() == m_Title)) {
+        m_Title.clear();
+        Common::UnsetFlag(m_Fields, FieldTitle);
+    }
+
+    if (Common::HasFlag(m_Fields, FieldKeywords) && (metadata->getKeywords() == m_KeywordsList)) {
+        m_KeywordsList.clear();
+        Common::UnsetFlag(m_Fields, FieldKeywords);
+    }
+}
+
+size_t UndoRedo::ArtworkMetadataBackup::getSizeInBytes() const {
+    size_t size = sizeof(ArtworkMetadataBackup);
+    size += (m_Description.size() + m_Title.size() + m_AttachedVector.size()) * sizeof(QChar);
+
+    for (const QString &keyword: m_KeywordsList) {
+        size += sizeof(QString) + keyword.size() * sizeof(QChar);
+    }
+
+    return size;
+}
@@ -37,12 +37,23 @@ namespace UndoRedo {
 
     public:
         void restore(Models::ArtworkMetadata *metadata) const;
+        // keeps only the fields which differ from the current ones
+        void dropUnchangedFields(Models::ArtworkMetadata *metadata);
+        size_t getSizeInBytes() const;
+
+    private:
+        enum BackupFields {
+            FieldDescription = 1 << 0,
+            FieldTitle = 1 << 1,
+            FieldKeywords = 1 << 2
+        };
 
     private:
         QString m_Description;
         QString m_Title;
         QString m_AttachedVector;
         QStringList m_KeywordsList;
+        int m_Fields;
         bool m_IsModified;
     };
 }
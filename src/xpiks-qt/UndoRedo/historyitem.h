@@ -50,6 +50,7 @@ namespace UndoRedo {
     public:
         virtual int getActionType() const override { return (int)m_ActionType; }
         virtual int getCommandID() const override { return m_CommandID; }
+        virtual void compact(const Commands::ICommandManager *) override { }
 
     private:
         HistoryActionType m_ActionType;
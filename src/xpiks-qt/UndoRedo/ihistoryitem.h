@@ -23,6 +23,7 @@
 #define IHISTORYITEM_H
 
 #include <QString>
+#include <cstddef>
 
 namespace Commands {
     class ICommandManager;
@@ -38,6 +39,9 @@ namespace UndoRedo {
         virtual QString getDescription() const = 0;
         virtual int getActionType() const = 0;
         virtual int getCommandID() const = 0;
+        // called once the change is applied to drop what undo does not need
+        virtual void compact(const Commands::ICommandManager *commandManager) = 0;
+        virtual size_t getSizeInBytes() const = 0;
     };
 }
 
@@ -37,22 +37,61 @@ void UndoRedo::ModifyArtworksHistoryItem::undo(const Commands::ICommandManager *
     QVector<Models::ArtworkMetadata*> itemsToSave;
     itemsToSave.reserve(count);
 
+    std::vector<ArtworkMetadataBackup> redoBackups;
+    redoBackups.reserve(count);
+    QVector<int> redoIndices;
+    redoIndices.reserve(count);
+
     for (int i = 0; i < count; ++i) {
         int index = m_Indices[i];
         Models::ArtworkMetadata *metadata = artItemsModel->getArtwork(index);
         if (metadata != NULL) {
+            // current state is what redo has to bring back
+            redoBackups.emplace_back(metadata);
+
             const ArtworkMetadataBackup &backup = m_ArtworksBackups.at(i);
             backup.restore(metadata);
             itemsToSave.append(metadata);
+
+            redoBackups.back().dropUnchangedFields(metadata);
+            redoIndices.append(index);
         }
     }
 
+    if (!redoBackups.empty()) {
+        std::unique_ptr<IHistoryItem> redoItem(new ModifyArtworksHistoryItem(getCommandID(), redoBackups, redoIndices, m_ModificationType));
+        commandManager->recordHistoryItem(redoItem);
+    }
+
     commandManager->submitForSpellCheck(itemsToSave);
     commandManager->saveArtworksBackups(itemsToSave);
     artItemsModel->updateItemsAtIndices(m_Indices);
     artItemsModel->updateModifiedCount();
 }
 
+void UndoRedo::ModifyArtworksHistoryItem::compact(const Commands::ICommandManager *commandManagerInterface) {
+    Commands::CommandManager *commandManager = (Commands::CommandManager*)commandManagerInterface;
+    Models::ArtItemsModel *artItemsModel = commandManager->getArtItemsModel();
+
+    int count = m_Indices.count();
+    for (int i = 0; i < count; ++i) {
+        Models::ArtworkMetadata *metadata = artItemsModel->getArtwork(m_Indices[i]);
+        if (metadata != NULL) {
+            m_ArtworksBackups[i].dropUnchangedFields(metadata);
+        }
+    }
+}
+
+size_t UndoRedo::ModifyArtworksHistoryItem::getSizeInBytes() const {
+    size_t size = sizeof(ModifyArtworksHistoryItem) + m_Indices.size() * sizeof(int);
+
+    for (const ArtworkMetadataBackup &backup: m_ArtworksBackups) {
+        size += backup.getSizeInBytes();
+    }
+
+    return size;
+}
+
 QString UndoRedo::getModificationTypeDescription(UndoRedo::ModificationType type) {
     switch (type) {
     case PasteModificationType:
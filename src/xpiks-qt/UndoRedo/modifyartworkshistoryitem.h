@@ -56,6 +56,8 @@ namespace UndoRedo {
 
     public:
          virtual void undo(const Commands::ICommandManager *commandManagerInterface) const override;
+         virtual void compact(const Commands::ICommandManager *commandManagerInterface) override;
+         virtual size_t getSizeInBytes() const override;
 
     public:
          virtual QString getDescription() const override {
@@ -111,3 +111,18 @@ void UndoRedo::RemoveArtworksHistoryItem::undo(const Commands::ICommandManager *
     commandManager->readMetadata(artworksToImport, ranges);
     artItemsModel->raiseArtworksAdded(usedCount, attachedVectors);
 }
+
+size_t UndoRedo::RemoveArtworksHistoryItem::getSizeInBytes() const {
+    size_t size = sizeof(RemoveArtworksHistoryItem);
+    size += m_RemovedArtworksIndices.size() * sizeof(int);
+
+    for (const QString &path: m_RemovedArtworksPathes) {
+        size += sizeof(QString) + path.size() * sizeof(QChar);
+    }
+
+    for (const QString &path: m_RemovedAttachedVectors) {
+        size += sizeof(QString) + path.size() * sizeof(QChar);
+    }
+
+    return size;
+}
@@ -54,6 +54,8 @@ namespace UndoRedo {
                                QObject::tr("1 item removed");
         }
 
+        virtual size_t getSizeInBytes() const override;
+
 
     private:
         QVector<int> m_RemovedArtworksIndices;
@@ -22,22 +22,45 @@
 #include "undoredomanager.h"
 #include "../Common/defines.h"
 
+#define MAX_UNDO_HISTORY_ITEMS 20
+#define MAX_UNDO_HISTORY_BYTES (50*1024*1024)
+
 UndoRedo::UndoRedoManager::~UndoRedoManager() { }
 
 void UndoRedo::UndoRedoManager::recordHistoryItem(std::unique_ptr<IHistoryItem> &historyItem) {
     LOG_INFO << "History item about to be recorded:" << historyItem->getActionType();
 
-    QMutexLocker locker(&m_Mutex);
+    if (m_CommandManager != NULL) {
+        // keep only fields that actually differ from the current state
+        historyItem->compact(m_CommandManager);
+    }
+
+    bool isUndoItem = true;
+
+    {
+        QMutexLocker locker(&m_Mutex);
+
+        if (m_IsUndoing) {
+            isUndoItem = false;
+            pushItem(m_RedoStack, m_RedoBytes, historyItem);
+        } else {
+            if (!m_IsRedoing) {
+                // new action invalidates everything that could be redone
+                clearStack(m_RedoStack, m_RedoBytes);
+            }
+
+            pushItem(m_UndoStack, m_UndoBytes, historyItem);
+        }
 
-    if (!m_HistoryStack.empty()) {
-        m_HistoryStack.pop();
-        Q_ASSERT(m_HistoryStack.empty());
+        LOG_DEBUG << "Undo stack:" << m_UndoStack.size() << "item(s)," << m_UndoBytes << "bytes."
+                  << "Redo stack:" << m_RedoStack.size() << "item(s)," << m_RedoBytes << "bytes";
     }
 
-    m_HistoryStack.push(std::move(historyItem));
-    emit canUndoChanged();
-    emit itemRecorded();
-    emit undoDescriptionChanged();
+    emitStacksChanged();
+
+    if (isUndoItem) {
+        emit itemRecorded();
+    }
 }
 
 bool UndoRedo::UndoRedoManager::undoLastAction() {
@@ -45,17 +68,21 @@ bool UndoRedo::UndoRedoManager::undoLastAction() {
     m_Mutex.lock();
 
     bool anyItem = false;
-    anyItem = !m_HistoryStack.empty();
+    anyItem = !m_UndoStack.empty();
 
     if (anyItem) {
-        std::unique_ptr<UndoRedo::IHistoryItem> historyItem(std::move(m_HistoryStack.top()));
-        m_HistoryStack.pop();
+        std::unique_ptr<UndoRedo::IHistoryItem> historyItem(popItem(m_UndoStack, m_UndoBytes));
+        m_IsUndoing = true;
         m_Mutex.unlock();
 
-        emit canUndoChanged();
-        emit undoDescriptionChanged();
+        emitStacksChanged();
         int commandID = historyItem->getCommandID();
         historyItem->undo(m_CommandManager);
+
+        m_Mutex.lock();
+        m_IsUndoing = false;
+        m_Mutex.unlock();
+
         emit actionUndone(commandID);
     } else {
         m_Mutex.unlock();
@@ -65,22 +92,47 @@ bool UndoRedo::UndoRedoManager::undoLastAction() {
     return anyItem;
 }
 
+bool UndoRedo::UndoRedoManager::redoLastAction() {
+    LOG_DEBUG << "#";
+    m_Mutex.lock();
+
+    bool anyItem = false;
+    anyItem = !m_RedoStack.empty();
+
+    if (anyItem) {
+        std::unique_ptr<UndoRedo::IHistoryItem> historyItem(popItem(m_RedoStack, m_RedoBytes));
+        m_IsRedoing = true;
+        m_Mutex.unlock();
+
+        emitStacksChanged();
+        // undoing an inverse item records the original action again
+        historyItem->undo(m_CommandManager);
+
+        m_Mutex.lock();
+        m_IsRedoing = false;
+        m_Mutex.unlock();
+    } else {
+        m_Mutex.unlock();
+        LOG_WARNING << "No item for redo";
+    }
+
+    return anyItem;
+}
+
 void UndoRedo::UndoRedoManager::discardLastAction() {
     LOG_DEBUG << "#";
     m_Mutex.lock();
 
     bool anyItem = false;
-    anyItem = !m_HistoryStack.empty();
+    anyItem = !m_UndoStack.empty();
 
     if (anyItem) {
-        std::unique_ptr<UndoRedo::IHistoryItem> historyItem(std::move(m_HistoryStack.top()));
-        m_HistoryStack.pop();
-        bool isNowEmpty = m_HistoryStack.empty();
+        std::unique_ptr<UndoRedo::IHistoryItem> historyItem(popItem(m_UndoStack, m_UndoBytes));
+        bool isNowEmpty = m_UndoStack.empty() && m_RedoStack.empty();
 
         m_Mutex.unlock();
 
-        emit canUndoChanged();
-        emit undoDescriptionChanged();
+        emitStacksChanged();
 
         if (isNowEmpty) {
             emit undoStackEmpty();
@@ -89,3 +141,53 @@ void UndoRedo::UndoRedoManager::discardLastAction() {
         m_Mutex.unlock();
     }
 }
+
+void UndoRedo::UndoRedoManager::clearHistory() {
+    LOG_DEBUG << "#";
+
+    {
+        QMutexLocker locker(&m_Mutex);
+        clearStack(m_UndoStack, m_UndoBytes);
+        clearStack(m_RedoStack, m_RedoBytes);
+    }
+
+    emitStacksChanged();
+    emit undoStackEmpty();
+}
+
+void UndoRedo::UndoRedoManager::pushItem(std::deque<std::unique_ptr<IHistoryItem> > &stack, size_t &bytes,
+                                         std::unique_ptr<IHistoryItem> &historyItem) {
+    bytes += historyItem->getSizeInBytes();
+    stack.push_back(std::move(historyItem));
+
+    // evict oldest items but always keep the most recent one
+    while ((stack.size() > 1) &&
+           ((stack.size() > MAX_UNDO_HISTORY_ITEMS) || (bytes > MAX_UNDO_HISTORY_BYTES))) {
+        LOG_INFO << "Evicting oldest history item:" << stack.front()->getActionType();
+        bytes -= stack.front()->getSizeInBytes();
+        stack.pop_front();
+    }
+}
+
+std::unique_ptr<UndoRedo::IHistoryItem> UndoRedo::UndoRedoManager::popItem(std::deque<std::unique_ptr<IHistoryItem> > &stack, size_t &bytes) {
+    Q_ASSERT(!stack.empty());
+    std::unique_ptr<IHistoryItem> historyItem(std::move(stack.back()));
+    stack.pop_back();
+
+    size_t itemBytes = historyItem->getSizeInBytes();
+    bytes = (bytes > itemBytes) ? (bytes - itemBytes) : 0;
+
+    return historyItem;
+}
+
+void UndoRedo::UndoRedoManager::clearStack(std::deque<std::unique_ptr<IHistoryItem> > &stack, size_t &bytes) {
+    stack.clear();
+    bytes = 0;
+}
+
+void UndoRedo::UndoRedoManager::emitStacksChanged() {
+    emit canUndoChanged();
+    emit undoDescriptionChanged();
+    emit canRedoChanged();
+    emit redoDescriptionChanged();
+}
@@ -23,7 +23,7 @@
 #define UNDOREDOMANAGER_H
 
 #include <QObject>
-#include <stack>
+#include <deque>
 #include <memory>
 #include <QMutex>
 #include "../Commands/commandmanager.h"
@@ -41,36 +41,66 @@ namespace UndoRedo {
         Q_OBJECT
         Q_PROPERTY(bool canUndo READ getCanUndo NOTIFY canUndoChanged)
         Q_PROPERTY(QString undoDescription READ getUndoDescription NOTIFY undoDescriptionChanged)
+        Q_PROPERTY(bool canRedo READ getCanRedo NOTIFY canRedoChanged)
+        Q_PROPERTY(QString redoDescription READ getRedoDescription NOTIFY redoDescriptionChanged)
     public:
         UndoRedoManager(QObject *parent=0):
             QObject(parent),
-            Common::BaseEntity()
+            Common::BaseEntity(),
+            m_UndoBytes(0),
+            m_RedoBytes(0),
+            m_IsUndoing(false),
+            m_IsRedoing(false)
         {}
 
         virtual ~UndoRedoManager();
 
     public:
-        bool getCanUndo() const { return !m_HistoryStack.empty(); }
+        bool getCanUndo() const { return !m_UndoStack.empty(); }
+        bool getCanRedo() const { return !m_RedoStack.empty(); }
+#ifdef CORE_TESTS
+        size_t getUndoStackSize() const { return m_UndoStack.size(); }
+        size_t getRedoStackSize() const { return m_RedoStack.size(); }
+        size_t getUndoBytes() const { return m_UndoBytes; }
+#endif
 
     signals:
         void canUndoChanged();
         void undoDescriptionChanged();
+        void canRedoChanged();
+        void redoDescriptionChanged();
         void itemRecorded();
         void undoStackEmpty();
         void actionUndone(int commandID);
 
     private:
-        QString getUndoDescription() const { return m_HistoryStack.empty() ? "" : m_HistoryStack.top()->getDescription(); }
+        QString getUndoDescription() const { return m_UndoStack.empty() ? "" : m_UndoStack.back()->getDescription(); }
+        QString getRedoDescription() const { return m_RedoStack.empty() ? "" : m_RedoStack.back()->getDescription(); }
 
     public:
         virtual void recordHistoryItem(std::unique_ptr<UndoRedo::IHistoryItem> &historyItem) override;
         Q_INVOKABLE bool undoLastAction();
+        Q_INVOKABLE bool redoLastAction();
         Q_INVOKABLE void discardLastAction();
+        void clearHistory();
 
     private:
-        // stack for future todos
-        std::stack<std::unique_ptr<IHistoryItem> > m_HistoryStack;
+        void pushItem(std::deque<std::unique_ptr<IHistoryItem> > &stack, size_t &bytes,
+                      std::unique_ptr<IHistoryItem> &historyItem);
+        std::unique_ptr<IHistoryItem> popItem(std::deque<std::unique_ptr<IHistoryItem> > &stack, size_t &bytes);
+        void clearStack(std::deque<std::unique_ptr<IHistoryItem> > &stack, size_t &bytes);
+        void emitStacksChanged();
+
+    private:
+        // back() is the most recent item
+        std::deque<std::unique_ptr<IHistoryItem> > m_UndoStack;
+        std::deque<std::unique_ptr<IHistoryItem> > m_RedoStack;
         QMutex m_Mutex;
+        size_t m_UndoBytes;
+        size_t m_RedoBytes;
+        // items recorded while undoing go to the redo stack
+        bool m_IsUndoing;
+        bool m_IsRedoing;
     };
 }
 
@@ -29,6 +29,8 @@
 #include "../Models/imageartwork.h"
 #include "warningssettingsmodel.h"
 
+#define WARNINGS_QUEUE_CAPACITY 4096
+
 namespace Warnings {
     QSet<QString> toLowerSet(const QStringList &from) {
         QSet<QString> result;
@@ -42,6 +44,7 @@ namespace Warnings {
     WarningsCheckingWorker::WarningsCheckingWorker(WarningsSettingsModel *warningsSettingsModel,
                                                    QObject *parent):
         QObject(parent),
+        Common::ItemProcessingWorker<WarningsItem>(1, WARNINGS_QUEUE_CAPACITY),
         m_WarningsSettingsModel(warningsSettingsModel)
     {
         Q_ASSERT(warningsSettingsModel != nullptr);
@@ -85,6 +88,12 @@ namespace Warnings {
         item->submitWarnings(warningsFlags);
     }
 
+    bool WarningsCheckingWorker::getCoalescingKey(const std::shared_ptr<WarningsItem> &item, Common::CoalescingKey &key) const {
+        // checks of different groups update different flags so only same checks supersede each other
+        key = qMakePair((quintptr)item->getCheckableItem(), (int)item->getCheckingFlags());
+        return true;
+    }
+
     Common::WarningFlags WarningsCheckingWorker::checkDimensions(std::shared_ptr<WarningsItem> &wi) const {
         LOG_INTEGRATION_TESTS << "#";
         const QString &allowedFilenameCharacters = m_WarningsSettingsModel->getAllowedFilenameCharacters();
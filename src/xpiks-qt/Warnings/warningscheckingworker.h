@@ -40,6 +40,7 @@ namespace Warnings {
     protected:
         virtual bool initWorker() override;
         virtual void processOneItem(std::shared_ptr<WarningsItem> &item) override;
+        virtual bool getCoalescingKey(const std::shared_ptr<WarningsItem> &item, Common::CoalescingKey &key) const override;
 
     private:
         void initValuesFromSettings();
@@ -41,6 +41,8 @@
 #include "SpellCheck/spellchecksuggestionmodel.h"
 #include "SpellCheck/userdicteditmodel.h"
 #include "QMLExtensions/cachingimageprovider.h"
+#include "QMLExtensions/asynccachingimageprovider.h"
+#include "QMLExtensions/decodedimagecache.h"
 #include "Models/filteredartitemsproxymodel.h"
 #include "QMLExtensions/imagecachingservice.h"
 #include "MetadataIO/metadataiocoordinator.h"
@@ -144,6 +146,9 @@ void myMessageHandler(QtMsgType type, const QMessageLogContext &context, const Q
 #define STRINGIZE_(x) #x
 #define STRINGIZE(x) STRINGIZE_(x)
 
+// about 700 decoded previews of the default size
+#define DECODED_IMAGES_CACHE_BYTES (64*1024*1024)
+
 void initQSettings() {
     QCoreApplication::setOrganizationName(Constants::ORGANIZATION_NAME);
     QCoreApplication::setOrganizationDomain(Constants::ORGANIZATION_DOMAIN);
@@ -334,6 +339,8 @@ int main(int argc, char *argv[]) {
     AutoComplete::AutoCompleteModel autoCompleteModel;
     AutoComplete::AutoCompleteService autoCompleteService(&autoCompleteModel);
     QMLExtensions::ImageCachingService imageCachingService;
+    QMLExtensions::DecodedImageCache decodedImageCache(DECODED_IMAGES_CACHE_BYTES);
+    imageCachingService.setDecodedImageCache(&decodedImageCache);
     Models::FindAndReplaceModel replaceModel(&colorsModel);
     Models::DeleteKeywordsViewModel deleteKeywordsModel;
     Models::ArtworkProxyModel artworkProxyModel;
@@ -427,8 +434,13 @@ int main(int argc, char *argv[]) {
 
     QQmlApplicationEngine engine;
     Helpers::GlobalImageProvider *globalProvider = new Helpers::GlobalImageProvider(QQmlImageProviderBase::Image);
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 6, 0))
+    QMLExtensions::AsyncCachingImageProvider *cachingProvider = new QMLExtensions::AsyncCachingImageProvider();
+#else
     QMLExtensions::CachingImageProvider *cachingProvider = new QMLExtensions::CachingImageProvider(QQmlImageProviderBase::Image);
+#endif
     cachingProvider->setImageCachingService(&imageCachingService);
+    globalProvider->setDecodedImageCache(&decodedImageCache);
 
     QQmlContext *rootContext = engine.rootContext();
     rootContext->setContextProperty("artItemsModel", &artItemsModel);
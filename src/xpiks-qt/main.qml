@@ -255,7 +255,7 @@ ApplicationWindow {
     Action {
         id: editAction
         shortcut: "Ctrl+E"
-        enabled: (artworkRepository.artworksSourcesCount > 0) && (applicationWindow.openedDialogsCount == 0)
+        enabled: (artworkRepository.artworksSourcesCount > 0) && (applicationWindow.openedDialogsCount == 0) && !artItemsModel.isScanningDirectories
         onTriggered: {
             if (filteredArtItemsModel.selectedArtworksCount === 0) {
                 mustSelectDialog.open()
@@ -289,7 +289,7 @@ ApplicationWindow {
     Action {
         id: saveAction
         shortcut: StandardKey.Save
-        enabled: (artworkRepository.artworksSourcesCount > 0) && (applicationWindow.openedDialogsCount == 0)
+        enabled: (artworkRepository.artworksSourcesCount > 0) && (applicationWindow.openedDialogsCount == 0) && !artItemsModel.isScanningDirectories
         onTriggered: {
             if (filteredArtItemsModel.selectedArtworksCount == 0) {
                 mustSelectDialog.open()
@@ -312,13 +312,13 @@ ApplicationWindow {
         id: searchAndReplaceAction
         shortcut: "Shift+Ctrl+F"
         onTriggered: openFindAndReplaceDialog()
-        enabled: (artworkRepository.artworksSourcesCount > 0) && (applicationWindow.openedDialogsCount == 0)
+        enabled: (artworkRepository.artworksSourcesCount > 0) && (applicationWindow.openedDialogsCount == 0) && !artItemsModel.isScanningDirectories
     }
 
     Action {
         id: removeAction
         shortcut: "Ctrl+Del"
-        enabled: (artworkRepository.artworksSourcesCount > 0) && (applicationWindow.openedDialogsCount == 0)
+        enabled: (artworkRepository.artworksSourcesCount > 0) && (applicationWindow.openedDialogsCount == 0) && !artItemsModel.isScanningDirectories
         onTriggered: {
             if (filteredArtItemsModel.selectedArtworksCount === 0) {
                 mustSelectDialog.open()
@@ -356,7 +356,7 @@ ApplicationWindow {
         id: addFilesAction
         shortcut: StandardKey.Open
         onTriggered: chooseArtworksDialog.open()
-        enabled: (applicationWindow.openedDialogsCount == 0)
+        enabled: (applicationWindow.openedDialogsCount == 0) && !artItemsModel.isScanningDirectories
     }
 
     menuBar: MenuBar {
@@ -376,10 +376,8 @@ ApplicationWindow {
                     delegate: MenuItem {
                         text: display
                         onTriggered: {
-                            var filesAdded = artItemsModel.addRecentDirectory(display)
-                            if (filesAdded === 0) {
-                                noNewFilesDialog.open()
-                            }
+                            // files are reported in onDirectoriesAdded
+                            artItemsModel.addRecentDirectory(display)
                         }
                     }
                 }
@@ -388,7 +386,7 @@ ApplicationWindow {
             Menu {
                 id: recentFilesMenu
                 title: i18.n + qsTr("&Recent files")
-                enabled: applicationWindow.openedDialogsCount == 0
+                enabled: (applicationWindow.openedDialogsCount == 0) && !artItemsModel.isScanningDirectories
 
                 Instantiator {
                     model: recentFiles
@@ -428,7 +426,7 @@ ApplicationWindow {
 
         Menu {
             title: i18.n + qsTr("&Edit")
-            enabled: applicationWindow.openedDialogsCount == 0
+            enabled: (applicationWindow.openedDialogsCount == 0) && !artItemsModel.isScanningDirectories
 
             MenuItem {
                 text: i18.n + qsTr("&Presets")
@@ -874,14 +872,8 @@ ApplicationWindow {
 
         onAccepted: {
             console.debug("You chose: " + chooseDirectoryDialog.fileUrls)
-            var filesAdded = artItemsModel.addLocalDirectories(chooseDirectoryDialog.fileUrls)
-            if (filesAdded > 0) {
-                settingsModel.saveRecentDirectories()
-                settingsModel.saveRecentFiles()
-                console.debug("" + filesAdded + ' files via Open Directory')
-            } else {
-                noNewFilesDialog.open()
-            }
+            // files are reported in onDirectoriesAdded
+            artItemsModel.addLocalDirectories(chooseDirectoryDialog.fileUrls)
         }
 
         onRejected: {
@@ -961,6 +953,14 @@ ApplicationWindow {
             unavailableVectorsDialog.open()
         }
 
+        onDirectoriesAdded: {
+            if (filesCount > 0) {
+                settingsModel.saveRecentDirectories()
+                settingsModel.saveRecentFiles()
+                console.debug("" + filesCount + ' files via directories scan')
+            }
+        }
+
         onArtworksAdded: {
             if ((imagesCount === 0) && (vectorsCount === 0)) {
                 noNewFilesDialog.open();
@@ -1023,7 +1023,7 @@ ApplicationWindow {
         anchors.fill: parent
 
         DropArea {
-            enabled: applicationWindow.openedDialogsCount == 0
+            enabled: (applicationWindow.openedDialogsCount == 0) && !artItemsModel.isScanningDirectories
             anchors.fill: parent
             onDropped: {
                 if (drop.hasUrls) {
@@ -13,6 +13,8 @@ QMAKE_TARGET_COPYRIGHT = "Copyright (C) 2014-2017 Taras Kushnir"
 
 SOURCES += main.cpp \
     Models/artitemsmodel.cpp \
+    Models/directoryscanner.cpp \
+    Models/fileschangemonitor.cpp \
     Models/artworkmetadata.cpp \
     Helpers/globalimageprovider.cpp \
     Models/artworksrepository.cpp \
@@ -44,16 +46,21 @@ SOURCES += main.cpp \
     Helpers/logger.cpp \
     Models/logsmodel.cpp \
     Models/filteredartitemsproxymodel.cpp \
+    Models/artworkssearchindex.cpp \
     Helpers/filenameshelpers.cpp \
     Helpers/helpersqmlwrapper.cpp \
     Models/recentdirectoriesmodel.cpp \
     Suggestion/locallibrary.cpp \
+    Suggestion/locallibraryindex.cpp \
+    Suggestion/librarystorage.cpp \
     Suggestion/libraryqueryworker.cpp \
     Suggestion/libraryloaderworker.cpp \
     Conectivity/updateservice.cpp \
     SpellCheck/spellcheckerservice.cpp \
     SpellCheck/spellcheckitem.cpp \
     SpellCheck/spellcheckworker.cpp \
+    SpellCheck/suggestionscache.cpp \
+    SpellCheck/suggestionsworker.cpp \
     SpellCheck/spellchecksuggestionmodel.cpp \
     Common/basickeywordsmodel.cpp \
     SpellCheck/spellcheckerrorshighlighter.cpp \
@@ -68,6 +75,9 @@ SOURCES += main.cpp \
     MetadataIO/metadataiocoordinator.cpp \
     MetadataIO/saverworkerjobitem.cpp \
     MetadataIO/metadatawritingworker.cpp \
+    MetadataIO/exiftoolprocess.cpp \
+    MetadataIO/exiftoolworker.cpp \
+    MetadataIO/exiftoolservice.cpp \
     Conectivity/curlftpuploader.cpp \
     Conectivity/ftpuploaderworker.cpp \
     Conectivity/ftpcoordinator.cpp \
@@ -82,6 +92,7 @@ SOURCES += main.cpp \
     Warnings/warningsmodel.cpp \
     Models/languagesmodel.cpp \
     Conectivity/conectivityhelpers.cpp \
+    Conectivity/archivespipeline.cpp \
     Helpers/filterhelpers.cpp \
     QMLExtensions/triangleelement.cpp \
     Suggestion/shutterstockqueryengine.cpp \
@@ -101,13 +112,17 @@ SOURCES += main.cpp \
     Models/imageartwork.cpp \
     MetadataIO/exiv2readingworker.cpp \
     MetadataIO/readingorchestrator.cpp \
+    MetadataIO/backupslookup.cpp \
     MetadataIO/exiv2writingworker.cpp \
     MetadataIO/writingorchestrator.cpp \
     Common/flags.cpp \
     Models/proxysettings.cpp \
     QMLExtensions/imagecachingworker.cpp \
     QMLExtensions/imagecachingservice.cpp \
+    QMLExtensions/imagecacheindex.cpp \
     QMLExtensions/cachingimageprovider.cpp \
+    QMLExtensions/asynccachingimageprovider.cpp \
+    QMLExtensions/decodedimagecache.cpp \
     Helpers/deletelogshelper.cpp \
     Commands/findandreplacecommand.cpp \
     Helpers/metadatahighlighter.cpp \
@@ -120,6 +135,7 @@ SOURCES += main.cpp \
     Conectivity/telemetryworker.cpp \
     Warnings/warningssettingsmodel.cpp \
     Conectivity/simplecurlrequest.cpp \
+    Conectivity/curlrequestsengine.cpp \
     Conectivity/curlinithelper.cpp \
     MetadataIO/exiv2inithelper.cpp \
     Conectivity/simplecurldownloader.cpp \
@@ -165,6 +181,8 @@ include(deployment.pri)
 
 HEADERS += \
     Models/artitemsmodel.h \
+    Models/directoryscanner.h \
+    Models/fileschangemonitor.h \
     Models/artworkmetadata.h \
     Helpers/globalimageprovider.h \
     Models/artworksrepository.h \
@@ -207,23 +225,30 @@ HEADERS += \
     Helpers/loggingworker.h \
     Common/defines.h \
     Models/filteredartitemsproxymodel.h \
+    Models/artworkssearchindex.h \
     Helpers/filenameshelpers.h \
     Common/flags.h \
     Helpers/helpersqmlwrapper.h \
     Models/recentdirectoriesmodel.h \
     Common/version.h \
     Suggestion/locallibrary.h \
+    Suggestion/locallibraryindex.h \
+    Suggestion/librarystorage.h \
     Suggestion/libraryqueryworker.h \
     Suggestion/libraryloaderworker.h \
     Conectivity/updateservice.h \
     SpellCheck/spellcheckerservice.h \
     SpellCheck/spellcheckitem.h \
     SpellCheck/spellcheckworker.h \
+    SpellCheck/suggestionscache.h \
+    SpellCheck/suggestionsworker.h \
     SpellCheck/spellchecksuggestionmodel.h \
     SpellCheck/spellcheckerrorshighlighter.h \
     SpellCheck/spellcheckiteminfo.h \
     MetadataIO/backupsaverworker.h \
     Common/itemprocessingworker.h \
+    Common/sharedworkqueue.h \
+    Common/boundedmpmcqueue.h \
     MetadataIO/backupsaverservice.h \
     SpellCheck/spellsuggestionsitem.h \
     Conectivity/analyticsuserevent.h \
@@ -235,6 +260,10 @@ HEADERS += \
     MetadataIO/metadatareadingworker.h \
     MetadataIO/metadataiocoordinator.h \
     MetadataIO/metadatawritingworker.h \
+    MetadataIO/exiftoolprocess.h \
+    MetadataIO/exiftoolworker.h \
+    MetadataIO/exiftoolservice.h \
+    MetadataIO/exiftooljob.h \
     Conectivity/curlftpuploader.h \
     Conectivity/ftpuploaderworker.h \
     Conectivity/ftpcoordinator.h \
@@ -263,6 +292,7 @@ HEADERS += \
     Conectivity/uploadbatch.h \
     Helpers/filterhelpers.h \
     Conectivity/iftpcoordinator.h \
+    Conectivity/archivespipeline.h \
     QMLExtensions/triangleelement.h \
     Suggestion/shutterstockqueryengine.h \
     Suggestion/locallibraryqueryengine.h \
@@ -287,6 +317,7 @@ HEADERS += \
     MetadataIO/exiv2readingworker.h \
     MetadataIO/importdataresult.h \
     MetadataIO/readingorchestrator.h \
+    MetadataIO/backupslookup.h \
     MetadataIO/imetadatareader.h \
     MetadataIO/exiv2writingworker.h \
     MetadataIO/writingorchestrator.h \
@@ -296,7 +327,10 @@ HEADERS += \
     QMLExtensions/imagecachingworker.h \
     QMLExtensions/imagecacherequest.h \
     QMLExtensions/imagecachingservice.h \
+    QMLExtensions/imagecacheindex.h \
     QMLExtensions/cachingimageprovider.h \
+    QMLExtensions/asynccachingimageprovider.h \
+    QMLExtensions/decodedimagecache.h \
     Helpers/deletelogshelper.h \
     Commands/findandreplacecommand.h \
     Models/metadataelement.h \
@@ -312,6 +346,7 @@ HEADERS += \
     Conectivity/telemetryworker.h \
     Warnings/warningssettingsmodel.h \
     Conectivity/simplecurlrequest.h \
+    Conectivity/curlrequestsengine.h \
     Conectivity/curlinithelper.h \
     MetadataIO/exiv2inithelper.h \
     Conectivity/simplecurldownloader.h \
@@ -454,6 +489,7 @@ CONFIG(debug, debug|release)  {
     #QMAKE_CXXFLAGS += -fsanitize=thread
 } else {
     DEFINES += WITH_LOGS
+    #DEFINES += XPIKS_LOG_LEVEL=1
     message("Building release")
 }
 
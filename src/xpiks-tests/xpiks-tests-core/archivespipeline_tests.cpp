@@ -0,0 +1,199 @@
+#include "archivespipeline_tests.h"
+#include <QtConcurrent>
+#include <QTemporaryDir>
+#include <QFile>
+#include "../../xpiks-qt/Conectivity/archivespipeline.h"
+
+static void pushArchive(Conectivity::ArchivesPipeline &pipeline, const QString &archivePath) {
+    QVERIFY(pipeline.reserveSlot());
+    pipeline.pushArchive(archivePath);
+}
+
+static QString createFile(const QString &directory, const QString &name) {
+    QString filepath = directory + "/" + name;
+    QFile file(filepath);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write("zip");
+        file.close();
+    }
+
+    return filepath;
+}
+
+void ArchivesPipelineTests::archivesAreTakenInOrderTest() {
+    Conectivity::ArchivesPipeline pipeline(4, 1, 3);
+    pipeline.setRemoveUploaded(false);
+
+    pushArchive(pipeline, "a.zip");
+    pushArchive(pipeline, "b.zip");
+    pushArchive(pipeline, "c.zip");
+
+    QString archivePath;
+    QVERIFY(pipeline.tryTakeNext(0, archivePath));
+    QCOMPARE(archivePath, QString("a.zip"));
+    QVERIFY(pipeline.tryTakeNext(0, archivePath));
+    QCOMPARE(archivePath, QString("b.zip"));
+    QVERIFY(pipeline.tryTakeNext(0, archivePath));
+    QCOMPARE(archivePath, QString("c.zip"));
+    QVERIFY(!pipeline.tryTakeNext(0, archivePath));
+}
+
+void ArchivesPipelineTests::everyConsumerGetsAllArchivesTest() {
+    Conectivity::ArchivesPipeline pipeline(4, 2, 2);
+    pipeline.setRemoveUploaded(false);
+
+    pushArchive(pipeline, "a.zip");
+    pushArchive(pipeline, "b.zip");
+
+    QString archivePath;
+    for (int consumer = 0; consumer < 2; ++consumer) {
+        QVERIFY(pipeline.tryTakeNext(consumer, archivePath));
+        QCOMPARE(archivePath, QString("a.zip"));
+        QVERIFY(pipeline.tryTakeNext(consumer, archivePath));
+        QCOMPARE(archivePath, QString("b.zip"));
+    }
+
+    pipeline.releaseArchive("a.zip", true);
+    pipeline.releaseArchive("b.zip", true);
+    // still pending for the second consumer
+    QCOMPARE(pipeline.getInFlightCount(), 2);
+
+    pipeline.releaseArchive("a.zip", true);
+    pipeline.releaseArchive("b.zip", true);
+    QCOMPARE(pipeline.getInFlightCount(), 0);
+}
+
+void ArchivesPipelineTests::drainedOnlyAfterProducingFinishedTest() {
+    Conectivity::ArchivesPipeline pipeline(4, 1, 1);
+    pipeline.setRemoveUploaded(false);
+
+    QVERIFY(!pipeline.isDrained(0));
+    pushArchive(pipeline, "a.zip");
+    pipeline.finishProducing();
+    QVERIFY(!pipeline.isDrained(0));
+
+    QString archivePath;
+    QVERIFY(pipeline.tryTakeNext(0, archivePath));
+    QVERIFY(pipeline.isDrained(0));
+}
+
+void ArchivesPipelineTests::producerWaitsForFreeSlotTest() {
+    Conectivity::ArchivesPipeline pipeline(2, 1, 3);
+    pipeline.setRemoveUploaded(false);
+
+    pushArchive(pipeline, "a.zip");
+    pushArchive(pipeline, "b.zip");
+
+    QFuture<bool> reservation = QtConcurrent::run(&pipeline, &Conectivity::ArchivesPipeline::reserveSlot);
+    QTest::qWait(200);
+    QVERIFY(!reservation.isFinished());
+
+    QString archivePath;
+    QVERIFY(pipeline.tryTakeNext(0, archivePath));
+    pipeline.releaseArchive(archivePath, true);
+
+    reservation.waitForFinished();
+    QVERIFY(reservation.result());
+    QCOMPARE(pipeline.getInFlightCount(), 2);
+}
+
+void ArchivesPipelineTests::uploadedArchiveIsRemovedTest() {
+    Conectivity::ArchivesPipeline pipeline(2, 2, 1);
+    QString filepath = createFile(pipeline.getArchivesDirectory(), "uploaded.zip");
+    QVERIFY(QFile::exists(filepath));
+
+    pushArchive(pipeline, filepath);
+
+    QString archivePath;
+    QVERIFY(pipeline.tryTakeNext(0, archivePath));
+    pipeline.releaseArchive(archivePath, true);
+    QVERIFY(QFile::exists(filepath));
+
+    QVERIFY(pipeline.tryTakeNext(1, archivePath));
+    pipeline.releaseArchive(archivePath, true);
+    QVERIFY(!QFile::exists(filepath));
+}
+
+void ArchivesPipelineTests::failedArchiveIsKeptTest() {
+    Conectivity::ArchivesPipeline pipeline(2, 2, 1);
+    QString filepath = createFile(pipeline.getArchivesDirectory(), "failed.zip");
+    QVERIFY(QFile::exists(filepath));
+
+    pushArchive(pipeline, filepath);
+
+    QString archivePath;
+    QVERIFY(pipeline.tryTakeNext(0, archivePath));
+    pipeline.releaseArchive(archivePath, false);
+    QVERIFY(pipeline.tryTakeNext(1, archivePath));
+    pipeline.releaseArchive(archivePath, true);
+
+    QVERIFY(QFile::exists(filepath));
+    QCOMPARE(pipeline.getInFlightCount(), 0);
+}
+
+void ArchivesPipelineTests::archiveOfUserIsKeptTest() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString filepath = createFile(dir.path(), "existing.zip");
+
+    Conectivity::ArchivesPipeline pipeline(2, 1, 1);
+    pushArchive(pipeline, filepath);
+
+    QString archivePath;
+    QVERIFY(pipeline.tryTakeNext(0, archivePath));
+    pipeline.releaseArchive(archivePath, true);
+
+    QVERIFY(QFile::exists(filepath));
+    QCOMPARE(pipeline.getInFlightCount(), 0);
+}
+
+void ArchivesPipelineTests::detachedConsumerReleasesArchivesTest() {
+    Conectivity::ArchivesPipeline pipeline(2, 2, 3);
+    pipeline.setRemoveUploaded(false);
+
+    pushArchive(pipeline, "a.zip");
+    pushArchive(pipeline, "b.zip");
+    pipeline.detachConsumer(1);
+
+    QString archivePath;
+    QVERIFY(pipeline.tryTakeNext(0, archivePath));
+    pipeline.releaseArchive(archivePath, true);
+    QVERIFY(pipeline.tryTakeNext(0, archivePath));
+    pipeline.releaseArchive(archivePath, true);
+    QCOMPARE(pipeline.getInFlightCount(), 0);
+
+    // later archives wait only for the remaining consumer
+    pushArchive(pipeline, "c.zip");
+    QVERIFY(!pipeline.tryTakeNext(1, archivePath));
+    QVERIFY(pipeline.isDrained(1));
+    QVERIFY(pipeline.tryTakeNext(0, archivePath));
+    pipeline.releaseArchive(archivePath, true);
+    QCOMPARE(pipeline.getInFlightCount(), 0);
+}
+
+void ArchivesPipelineTests::cancelWakesProducerTest() {
+    Conectivity::ArchivesPipeline pipeline(1, 1, 2);
+    pipeline.setRemoveUploaded(false);
+
+    pushArchive(pipeline, "a.zip");
+
+    QFuture<bool> reservation = QtConcurrent::run(&pipeline, &Conectivity::ArchivesPipeline::reserveSlot);
+    QTest::qWait(200);
+    QVERIFY(!reservation.isFinished());
+
+    pipeline.cancel();
+    reservation.waitForFinished();
+    QVERIFY(!reservation.result());
+    QVERIFY(pipeline.isDrained(0));
+}
+
+void ArchivesPipelineTests::failedCreationIsNotExpectedTest() {
+    Conectivity::ArchivesPipeline pipeline(2, 1, 2);
+
+    QVERIFY(pipeline.reserveSlot());
+    pipeline.cancelReservation();
+
+    QCOMPARE(pipeline.getExpectedCount(), 1);
+    QCOMPARE(pipeline.getFailedCount(), 1);
+    QCOMPARE(pipeline.getInFlightCount(), 0);
+}
@@ -0,0 +1,23 @@
+#ifndef ARCHIVESPIPELINETESTS_H
+#define ARCHIVESPIPELINETESTS_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+class ArchivesPipelineTests: public QObject
+{
+    Q_OBJECT
+private slots:
+    void archivesAreTakenInOrderTest();
+    void everyConsumerGetsAllArchivesTest();
+    void drainedOnlyAfterProducingFinishedTest();
+    void producerWaitsForFreeSlotTest();
+    void uploadedArchiveIsRemovedTest();
+    void failedArchiveIsKeptTest();
+    void archiveOfUserIsKeptTest();
+    void detachedConsumerReleasesArchivesTest();
+    void cancelWakesProducerTest();
+    void failedCreationIsNotExpectedTest();
+};
+
+#endif // ARCHIVESPIPELINETESTS_H
@@ -350,3 +350,161 @@ void ArtworkRepositoryTests::selectFolderTest() {
     dirIDs.push_back(dirID);
     QCOMPARE(repository.isDirectoryIncluded(dirIDs[3]), true);
 }
+
+void ArtworkRepositoryTests::prepareFilesDedupTest() {
+    Mocks::CommandManagerMock commandManagerMock;
+    Models::ArtworksRepository repository;
+    commandManagerMock.InjectDependency(&repository);
+
+#ifdef Q_OS_WIN
+    QString filename1 = "C:/path/to/some/file1";
+    QString filename2 = "C:/path/to/some/file2";
+    QString filename3 = "C:/path/to/other/file3";
+#else
+    QString filename1 = "/path/to/some/file1";
+    QString filename2 = "/path/to/some/file2";
+    QString filename3 = "/path/to/other/file3";
+#endif
+
+    qint64 dirID = 0;
+    repository.accountFile(filename1, dirID);
+
+    QStringList files;
+    files << filename1 << filename2 << filename3 << filename2;
+
+    Models::ArtworksRepository::PreparedFiles preparedFiles;
+    repository.prepareFiles(files, preparedFiles);
+
+    QCOMPARE(preparedFiles.m_Filepaths, QStringList() << filename2 << filename3);
+    QCOMPARE(preparedFiles.m_Directories.length(), 2);
+    QCOMPARE(preparedFiles.m_NewDirectoriesCount, 1);
+}
+
+void ArtworkRepositoryTests::prepareScannedFilesTest() {
+    Mocks::CommandManagerMock commandManagerMock;
+    Models::ArtworksRepository repository;
+    commandManagerMock.InjectDependency(&repository);
+
+#ifdef Q_OS_WIN
+    QString dir1 = "C:/path/to/some";
+    QString dir2 = "C:/path/to/other";
+#else
+    QString dir1 = "/path/to/some";
+    QString dir2 = "/path/to/other";
+#endif
+
+    QString filename1 = dir1 + "/file1";
+    QString filename2 = dir1 + "/file2";
+    QString filename3 = dir2 + "/file3";
+
+    qint64 dirID = 0;
+    repository.accountFile(filename1, dirID);
+
+    QStringList files, directories;
+    files << filename1 << filename2 << filename3 << filename2;
+    directories << dir1 << dir1 << dir2 << dir1;
+
+    Models::ArtworksRepository::PreparedFiles preparedFiles;
+    repository.prepareScannedFiles(files, directories, preparedFiles);
+
+    QCOMPARE(preparedFiles.m_Filepaths, QStringList() << filename2 << filename3);
+    QCOMPARE(preparedFiles.m_Directories, QStringList() << dir1 << dir2);
+    QCOMPARE(preparedFiles.m_NewDirectoriesCount, 1);
+}
+
+void ArtworkRepositoryTests::prepareBigBatchTest() {
+    Mocks::CommandManagerMock commandManagerMock;
+    Models::ArtworksRepository repository;
+    commandManagerMock.InjectDependency(&repository);
+
+#ifdef Q_OS_WIN
+    QString pathTemplate = "C:/path/to/dir%1/file%2";
+#else
+    QString pathTemplate = "/path/to/dir%1/file%2";
+#endif
+
+    const int dirsCount = 50, filesPerDir = 20;
+    QStringList files;
+    for (int i = 0; i < dirsCount; ++i) {
+        for (int j = 0; j < filesPerDir; ++j) {
+            files << pathTemplate.arg(i).arg(j);
+        }
+    }
+
+    Models::ArtworksRepository::PreparedFiles preparedFiles;
+    repository.prepareFiles(files, preparedFiles);
+
+    QCOMPARE(preparedFiles.m_Filepaths, files);
+    QCOMPARE(preparedFiles.m_NewDirectoriesCount, dirsCount);
+    QCOMPARE(repository.getNewDirectoriesCount(files), dirsCount);
+}
+
+void ArtworkRepositoryTests::accountPreparedFilesTest() {
+    Mocks::CommandManagerMock commandManagerMock;
+    Models::ArtworksRepository repository;
+    commandManagerMock.InjectDependency(&repository);
+
+#ifdef Q_OS_WIN
+    QString filename1 = "C:/path/to/some/file1";
+    QString filename2 = "C:/path/to/some/file2";
+    QString filename3 = "C:/path/to/other/file3";
+    QString directory = "C:/path/to/some";
+#else
+    QString filename1 = "/path/to/some/file1";
+    QString filename2 = "/path/to/some/file2";
+    QString filename3 = "/path/to/other/file3";
+    QString directory = "/path/to/some";
+#endif
+
+    QStringList files;
+    files << filename1 << filename2 << filename3;
+
+    QSignalSpy sourcesSpy(&repository, SIGNAL(artworksSourcesCountChanged()));
+
+    Models::ArtworksRepository::PreparedFiles preparedFiles;
+    repository.prepareFiles(files, preparedFiles);
+    bool filesWereAccounted = repository.beginAccountingDirectories(preparedFiles.m_NewDirectoriesCount);
+    QVERIFY(filesWereAccounted);
+
+    for (int i = 0; i < preparedFiles.m_Filepaths.length(); ++i) {
+        qint64 dirID = 0;
+        QVERIFY(repository.accountPreparedFile(preparedFiles.m_Filepaths[i], preparedFiles.m_Directories[i], dirID));
+    }
+
+    repository.endAccountingFiles(filesWereAccounted);
+
+    QCOMPARE(sourcesSpy.count(), 1);
+    QCOMPARE(repository.getArtworksSourcesCount(), 2);
+    QCOMPARE(repository.getFilesCountForDirectory(directory), 2);
+    QCOMPARE(repository.getNewFilesCount(files), 0);
+}
+
+void ArtworkRepositoryTests::findDirectoryAfterRemoveTest() {
+    Mocks::CommandManagerMock commandManagerMock;
+    Models::ArtworksRepository repository;
+    commandManagerMock.InjectDependency(&repository);
+
+#ifdef Q_OS_WIN
+    QString filename1 = "C:/path1/to/some/file";
+    QString filename2 = "C:/path2/to/some/file";
+    QString filename3 = "C:/path2/to/some/other";
+    QString directory2 = "C:/path2/to/some";
+#else
+    QString filename1 = "/path1/to/some/file";
+    QString filename2 = "/path2/to/some/file";
+    QString filename3 = "/path2/to/some/other";
+    QString directory2 = "/path2/to/some";
+#endif
+
+    qint64 dirID1 = 0, dirID2 = 0, dirID3 = 0;
+    repository.accountFile(filename1, dirID1);
+    repository.accountFile(filename2, dirID2);
+
+    repository.removeItem(0);
+    QCOMPARE(repository.getArtworksSourcesCount(), 1);
+
+    QVERIFY(repository.accountFile(filename3, dirID3));
+    QCOMPARE(dirID3, dirID2);
+    QCOMPARE(repository.getArtworksSourcesCount(), 1);
+    QCOMPARE(repository.getFilesCountForDirectory(directory2), 2);
+}
@@ -20,6 +20,11 @@ private slots:
     void endAccountingWithNoNewFilesTest();
     void startAccountingNewFilesEmitsTest();
     void selectFolderTest();
+    void prepareFilesDedupTest();
+    void prepareScannedFilesTest();
+    void prepareBigBatchTest();
+    void accountPreparedFilesTest();
+    void findDirectoryAfterRemoveTest();
 };
 
 #endif // ARTWORKREPOSITORYTESTS_H
@@ -0,0 +1,193 @@
+#include "artworkssearchindex_tests.h"
+#include "Mocks/artworkmetadatamock.h"
+#include "../../xpiks-qt/Models/artworkssearchindex.h"
+#include "../../xpiks-qt/Helpers/filterhelpers.h"
+
+void ArtworksSearchIndexTests::substringMatchTest() {
+    Mocks::ArtworkMetadataMock first("/path/to/first.jpg");
+    first.initialize("", "sunset over the ocean", QStringList() << "sky");
+    Mocks::ArtworkMetadataMock second("/path/to/second.jpg");
+    second.initialize("", "", QStringList() << "beach" << "sand");
+
+    Models::ArtworksSearchIndex index;
+    index.setQuery("cea", flagsAnyTerms());
+    QVERIFY(index.hasMatch(&first));
+    QVERIFY(!index.hasMatch(&second));
+
+    index.setQuery("each", flagsAnyTerms());
+    QVERIFY(!index.hasMatch(&first));
+    QVERIFY(index.hasMatch(&second));
+
+    index.setQuery("set over", flagsAnyTerms());
+    QVERIFY(index.hasMatch(&first));
+    QVERIFY(!index.hasMatch(&second));
+
+    index.setQuery("second.j", flagsAnyTerms());
+    QVERIFY(!index.hasMatch(&first));
+    QVERIFY(index.hasMatch(&second));
+}
+
+void ArtworksSearchIndexTests::caseInsensitiveMatchTest() {
+    Mocks::ArtworkMetadataMock first("/path/to/first.jpg");
+    first.initialize("Mountain Lake", "", QStringList() << "Alps");
+
+    Models::ArtworksSearchIndex index;
+    index.setQuery("LAKE", flagsAnyTerms());
+    QVERIFY(index.hasMatch(&first));
+
+    index.setQuery("alps", flagsAnyTerms());
+    QVERIFY(index.hasMatch(&first));
+}
+
+void ArtworksSearchIndexTests::anyAndAllTermsTest() {
+    Mocks::ArtworkMetadataMock first("/path/to/first.jpg");
+    first.initialize("red car", "", QStringList() << "vehicle");
+    Mocks::ArtworkMetadataMock second("/path/to/second.jpg");
+    second.initialize("blue car", "", QStringList() << "vehicle");
+
+    Models::ArtworksSearchIndex index;
+    index.setQuery("red blue", flagsAnyTerms());
+    QVERIFY(index.hasMatch(&first));
+    QVERIFY(index.hasMatch(&second));
+
+    index.setQuery("red car", flagsAllTerms());
+    QVERIFY(index.hasMatch(&first));
+    QVERIFY(!index.hasMatch(&second));
+
+    index.setQuery("red blue", flagsAllTerms());
+    QVERIFY(!index.hasMatch(&first));
+    QVERIFY(!index.hasMatch(&second));
+}
+
+void ArtworksSearchIndexTests::wholeKeywordTest() {
+    Mocks::ArtworkMetadataMock first("/path/to/first.jpg");
+    first.initialize("", "", QStringList() << "beach" << "sand");
+
+    Models::ArtworksSearchIndex index;
+    index.setQuery("!beach", flagsAnyTerms());
+    QVERIFY(index.hasMatch(&first));
+
+    index.setQuery("!bea", flagsAnyTerms());
+    QVERIFY(!index.hasMatch(&first));
+
+    index.setQuery("bea", flagsAnyTerms());
+    QVERIFY(index.hasMatch(&first));
+}
+
+void ArtworksSearchIndexTests::reindexAfterEditTest() {
+    Mocks::ArtworkMetadataMock first("/path/to/first.jpg");
+    first.initialize("", "forest", QStringList() << "tree");
+    Mocks::ArtworkMetadataMock second("/path/to/second.jpg");
+    second.initialize("", "desert", QStringList() << "sand");
+
+    Models::ArtworksSearchIndex index;
+    index.setQuery("mountain", flagsAnyTerms());
+    QVERIFY(!index.hasMatch(&first));
+    QVERIFY(!index.hasMatch(&second));
+
+    second.setDescription("mountain view");
+    QVERIFY(!index.hasMatch(&first));
+    QVERIFY(index.hasMatch(&second));
+
+    second.clearKeywords();
+    second.setDescription("desert");
+    QVERIFY(!index.hasMatch(&second));
+
+    first.appendKeyword("mountains");
+    QVERIFY(index.hasMatch(&first));
+}
+
+void ArtworksSearchIndexTests::refinedQueryTest() {
+    Mocks::ArtworkMetadataMock first("/path/to/first.jpg");
+    first.initialize("", "sunset", QStringList());
+    Mocks::ArtworkMetadataMock second("/path/to/second.jpg");
+    second.initialize("", "sunny day", QStringList());
+    Mocks::ArtworkMetadataMock third("/path/to/third.jpg");
+    third.initialize("", "night", QStringList());
+
+    Models::ArtworksSearchIndex index;
+    index.setQuery("sun", flagsAnyTerms());
+    QVERIFY(index.hasMatch(&first));
+    QVERIFY(index.hasMatch(&second));
+    QVERIFY(!index.hasMatch(&third));
+
+    index.setQuery("suns", flagsAnyTerms());
+    QVERIFY(index.hasMatch(&first));
+    QVERIFY(!index.hasMatch(&second));
+    QVERIFY(!index.hasMatch(&third));
+
+    index.setQuery("su", flagsAnyTerms());
+    QVERIFY(index.hasMatch(&first));
+    QVERIFY(index.hasMatch(&second));
+    QVERIFY(!index.hasMatch(&third));
+}
+
+void ArtworksSearchIndexTests::refinedQueryAfterEditTest() {
+    Mocks::ArtworkMetadataMock first("/path/to/first.jpg");
+    first.initialize("", "sunset", QStringList());
+    Mocks::ArtworkMetadataMock second("/path/to/second.jpg");
+    second.initialize("", "night", QStringList());
+
+    Models::ArtworksSearchIndex index;
+    index.setQuery("sun", flagsAnyTerms());
+    QVERIFY(index.hasMatch(&first));
+    QVERIFY(!index.hasMatch(&second));
+
+    // not a match for the previous query but a match for the refined one
+    second.setDescription("sunset at night");
+
+    index.setQuery("sunset", flagsAnyTerms());
+    QVERIFY(index.hasMatch(&first));
+    QVERIFY(index.hasMatch(&second));
+}
+
+void ArtworksSearchIndexTests::removeArtworkTest() {
+    Mocks::ArtworkMetadataMock first("/path/to/first.jpg");
+    first.initialize("", "river", QStringList());
+    Mocks::ArtworkMetadataMock second("/path/to/second.jpg");
+    second.initialize("", "river bank", QStringList());
+
+    Models::ArtworksSearchIndex index;
+    index.setQuery("river", flagsAnyTerms());
+    QVERIFY(index.hasMatch(&first));
+    QVERIFY(index.hasMatch(&second));
+    QCOMPARE(index.getIndexedCount(), 2);
+
+    index.removeArtwork(&first);
+    QCOMPARE(index.getIndexedCount(), 1);
+    QVERIFY(index.hasMatch(&second));
+
+    index.clear();
+    QCOMPARE(index.getIndexedCount(), 0);
+}
+
+void ArtworksSearchIndexTests::sameAsFilterHelpersTest() {
+    Mocks::ArtworkMetadataMock first("/path/to/first_photo.jpg");
+    first.initialize("Old Town", "narrow street, old houses", QStringList() << "town" << "street" << "europe");
+    Mocks::ArtworkMetadataMock second("/path/to/vector-art.jpg");
+    second.initialize("Abstract", "colorful shapes", QStringList() << "abstract" << "shape");
+    Mocks::ArtworkMetadataMock third("/path/to/empty.jpg");
+
+    QVector<Models::ArtworkMetadata *> artworks;
+    artworks << &first << &second << &third;
+
+    QStringList queries;
+    queries << "old" << "street," << "!town" << "!tow" << "t, o" << "ape tow" << "photo" << "-art"
+            << "x:empty" << "x:image old" << "abstract shape" << "EUROPE" << "nothing";
+
+    QVector<Common::SearchFlags> allFlags;
+    allFlags << flagsAnyTerms() << flagsAllTerms() << Common::SearchFlags::Metadata
+             << Common::SearchFlags::ExactKeywords << Common::SearchFlags::MetadataCaseSensitive;
+
+    Models::ArtworksSearchIndex index;
+
+    for (Common::SearchFlags flags: allFlags) {
+        for (const QString &query: queries) {
+            index.setQuery(query, flags);
+
+            for (Models::ArtworkMetadata *artwork: artworks) {
+                QCOMPARE(index.hasMatch(artwork), Helpers::hasSearchMatch(query, artwork, flags));
+            }
+        }
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef ARTWORKSSEARCHINDEXTESTS_H
+#define ARTWORKSSEARCHINDEXTESTS_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "../../xpiks-qt/Common/flags.h"
+
+class ArtworksSearchIndexTests: public QObject
+{
+    Q_OBJECT
+private:
+    Common::SearchFlags flagsAnyTerms() { return Common::SearchFlags::AnyTermsEverything; }
+    Common::SearchFlags flagsAllTerms() { return Common::SearchFlags::AllTermsEverything; }
+
+private slots:
+    void substringMatchTest();
+    void caseInsensitiveMatchTest();
+    void anyAndAllTermsTest();
+    void wholeKeywordTest();
+    void reindexAfterEditTest();
+    void refinedQueryTest();
+    void refinedQueryAfterEditTest();
+    void removeArtworkTest();
+    void sameAsFilterHelpersTest();
+};
+
+#endif // ARTWORKSSEARCHINDEXTESTS_H
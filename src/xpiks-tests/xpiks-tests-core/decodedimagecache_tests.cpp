@@ -0,0 +1,97 @@
+#include "decodedimagecache_tests.h"
+#include <QImage>
+#include "../../xpiks-qt/QMLExtensions/decodedimagecache.h"
+
+// 100x100 ARGB image takes 40000 bytes
+#define IMAGE_BYTES (100*100*4)
+
+static QImage createImage(QRgb color, int side=100) {
+    QImage image(side, side, QImage::Format_ARGB32);
+    image.fill(color);
+    return image;
+}
+
+void DecodedImageCacheTests::getMissingImageTest() {
+    QMLExtensions::DecodedImageCache cache(10*IMAGE_BYTES);
+    QImage image;
+    QVERIFY(!cache.tryGet("/path/to/image.jpg", image));
+    QVERIFY(image.isNull());
+}
+
+void DecodedImageCacheTests::insertAndGetTest() {
+    QMLExtensions::DecodedImageCache cache(10*IMAGE_BYTES);
+    QImage original = createImage(qRgb(255, 0, 0));
+    cache.insert("a", original);
+
+    QImage image;
+    QVERIFY(cache.tryGet("a", image));
+    QCOMPARE(image, original);
+    QCOMPARE(cache.size(), 1);
+    QCOMPARE(cache.getUsedBytes(), (qint64)IMAGE_BYTES);
+}
+
+void DecodedImageCacheTests::keyIncludesRequestedSizeTest() {
+    const QString filepath = "/path/to/image.jpg";
+    QString smallKey = QMLExtensions::DecodedImageCache::makeKey(filepath, QSize(150, 150));
+    QString bigKey = QMLExtensions::DecodedImageCache::makeKey(filepath, QSize(300, 300));
+
+    QVERIFY(smallKey != bigKey);
+    QCOMPARE(smallKey, QMLExtensions::DecodedImageCache::makeKey(filepath, QSize(150, 150)));
+}
+
+void DecodedImageCacheTests::leastRecentlyUsedIsEvictedByBytesTest() {
+    QMLExtensions::DecodedImageCache cache(5*IMAGE_BYTES);
+    cache.insert("a", createImage(qRgb(1, 0, 0)));
+    cache.insert("b", createImage(qRgb(2, 0, 0)));
+    cache.insert("c", createImage(qRgb(3, 0, 0)));
+    cache.insert("d", createImage(qRgb(4, 0, 0)));
+    cache.insert("e", createImage(qRgb(5, 0, 0)));
+
+    QImage image;
+    QVERIFY(cache.tryGet("a", image));
+
+    cache.insert("f", createImage(qRgb(6, 0, 0)));
+
+    QCOMPARE(cache.size(), 5);
+    QVERIFY(cache.getUsedBytes() <= cache.getMaxBytes());
+    QVERIFY(cache.tryGet("a", image));
+    QVERIFY(!cache.tryGet("b", image));
+    QVERIFY(cache.tryGet("f", image));
+}
+
+void DecodedImageCacheTests::replacingImageUpdatesUsedBytesTest() {
+    QMLExtensions::DecodedImageCache cache(10*IMAGE_BYTES);
+    cache.insert("a", createImage(qRgb(1, 0, 0)));
+    cache.insert("a", createImage(qRgb(2, 0, 0), 50));
+
+    QCOMPARE(cache.size(), 1);
+    QCOMPARE(cache.getUsedBytes(), (qint64)(50*50*4));
+
+    cache.remove("a");
+    QCOMPARE(cache.size(), 0);
+    QCOMPARE(cache.getUsedBytes(), (qint64)0);
+}
+
+void DecodedImageCacheTests::tooBigImageIsNotCachedTest() {
+    QMLExtensions::DecodedImageCache cache(2*IMAGE_BYTES);
+    cache.insert("a", createImage(qRgb(1, 0, 0)));
+
+    QImage image;
+    QVERIFY(!cache.tryGet("a", image));
+    QCOMPARE(cache.size(), 0);
+}
+
+void DecodedImageCacheTests::hitRatioIsCountedTest() {
+    QMLExtensions::DecodedImageCache cache(10*IMAGE_BYTES);
+    cache.insert("a", createImage(qRgb(1, 0, 0)));
+
+    QImage image;
+    QVERIFY(cache.tryGet("a", image));
+    QVERIFY(cache.tryGet("a", image));
+    QVERIFY(cache.tryGet("a", image));
+    QVERIFY(!cache.tryGet("b", image));
+
+    QCOMPARE(cache.getHitsCount(), 3);
+    QCOMPARE(cache.getMissesCount(), 1);
+    QCOMPARE(cache.getHitRatio(), 0.75);
+}
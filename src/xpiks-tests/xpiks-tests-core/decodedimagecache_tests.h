@@ -0,0 +1,20 @@
+#ifndef DECODEDIMAGECACHETESTS_H
+#define DECODEDIMAGECACHETESTS_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+class DecodedImageCacheTests: public QObject
+{
+    Q_OBJECT
+private slots:
+    void getMissingImageTest();
+    void insertAndGetTest();
+    void keyIncludesRequestedSizeTest();
+    void leastRecentlyUsedIsEvictedByBytesTest();
+    void replacingImageUpdatesUsedBytesTest();
+    void tooBigImageIsNotCachedTest();
+    void hitRatioIsCountedTest();
+};
+
+#endif // DECODEDIMAGECACHETESTS_H
@@ -0,0 +1,94 @@
+#include "directoryscanner_tests.h"
+#include <QTemporaryDir>
+#include <QSignalSpy>
+#include <QFile>
+#include <QDir>
+#include "../../xpiks-qt/Models/directoryscanner.h"
+#include "filehelpersfortests.h"
+
+void DirectoryScannerTests::scanMatchesVectorsTest() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    createEmptyFiles(tempDir.path(), QStringList() << "a.jpg" << "a.eps" << "b.JPEG" << "b.ai"
+                << "c.tif" << "c.ai" << "c.eps" << "d.png" << "e.txt" << "f.eps");
+
+    Models::ScannedDirectory scanned = Models::scanDirectory(tempDir.path());
+    QDir dir(tempDir.path());
+
+    QCOMPARE(scanned.m_Images, QStringList() << dir.absoluteFilePath("a.jpg")
+             << dir.absoluteFilePath("b.JPEG") << dir.absoluteFilePath("c.tif"));
+    QCOMPARE(scanned.m_Vectors, QStringList() << dir.absoluteFilePath("a.eps")
+             << dir.absoluteFilePath("b.ai") << dir.absoluteFilePath("c.eps"));
+    QCOMPARE(scanned.m_Directories, QStringList() << dir.absolutePath() << dir.absolutePath() << dir.absolutePath());
+}
+
+void DirectoryScannerTests::scanEmptyDirectoryTest() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    Models::DirectoryScanner scanner;
+    QSignalSpy filesSpy(&scanner, SIGNAL(filesFound(QStringList,QStringList,QStringList)));
+    QSignalSpy finishedSpy(&scanner, SIGNAL(scanningFinished()));
+
+    scanner.scanDirectories(QStringList() << tempDir.path());
+    QVERIFY(scanner.getInProgress());
+    QVERIFY(finishedSpy.wait(5000));
+
+    QCOMPARE(filesSpy.count(), 0);
+    QVERIFY(!scanner.getInProgress());
+}
+
+void DirectoryScannerTests::scanInBatchesTest() {
+    QTemporaryDir tempDir1, tempDir2;
+    QVERIFY(tempDir1.isValid() && tempDir2.isValid());
+
+    const int filesPerDirectory = 600;
+    QStringList names;
+    for (int i = 0; i < filesPerDirectory; ++i) {
+        names << QString("image%1.jpg").arg(i);
+    }
+
+    createEmptyFiles(tempDir1.path(), names);
+    createEmptyFiles(tempDir2.path(), names);
+
+    Models::DirectoryScanner scanner;
+    QSignalSpy filesSpy(&scanner, SIGNAL(filesFound(QStringList,QStringList,QStringList)));
+    QSignalSpy finishedSpy(&scanner, SIGNAL(scanningFinished()));
+
+    scanner.scanDirectories(QStringList() << tempDir1.path() << tempDir2.path());
+    QVERIFY(finishedSpy.wait(10000));
+
+    QVERIFY(filesSpy.count() > 2);
+
+    QSet<QString> allImages;
+    for (auto &arguments: filesSpy) {
+        QStringList images = arguments.at(0).toStringList();
+        QStringList vectors = arguments.at(1).toStringList();
+        QStringList directories = arguments.at(2).toStringList();
+        QCOMPARE(images.length(), vectors.length());
+        QCOMPARE(images.length(), directories.length());
+        allImages.unite(QSet<QString>::fromList(images));
+    }
+
+    QCOMPARE(allImages.size(), 2*filesPerDirectory);
+}
+
+void DirectoryScannerTests::cancelScanningTest() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    createEmptyFiles(tempDir.path(), QStringList() << "a.jpg" << "b.jpg");
+
+    Models::DirectoryScanner scanner;
+    QSignalSpy filesSpy(&scanner, SIGNAL(filesFound(QStringList,QStringList,QStringList)));
+    QSignalSpy finishedSpy(&scanner, SIGNAL(scanningFinished()));
+
+    scanner.scanDirectories(QStringList() << tempDir.path());
+    scanner.cancelScanning();
+
+    QCOMPARE(finishedSpy.count(), 1);
+    QVERIFY(!scanner.getInProgress());
+
+    QTest::qWait(200);
+    QCOMPARE(filesSpy.count(), 0);
+    QCOMPARE(finishedSpy.count(), 1);
+}
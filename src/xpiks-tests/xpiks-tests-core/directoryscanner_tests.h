@@ -0,0 +1,17 @@
+#ifndef DIRECTORYSCANNERTESTS_H
+#define DIRECTORYSCANNERTESTS_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+class DirectoryScannerTests : public QObject
+{
+    Q_OBJECT
+private slots:
+    void scanMatchesVectorsTest();
+    void scanEmptyDirectoryTest();
+    void scanInBatchesTest();
+    void cancelScanningTest();
+};
+
+#endif // DIRECTORYSCANNERTESTS_H
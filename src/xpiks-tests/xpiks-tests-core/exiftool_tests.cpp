@@ -0,0 +1,318 @@
+#include "exiftool_tests.h"
+#include <QThread>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+#include <memory>
+#include <vector>
+#include "../../xpiks-qt/MetadataIO/exiftoolprocess.h"
+#include "../../xpiks-qt/MetadataIO/exiftoolworker.h"
+#include "../../xpiks-qt/MetadataIO/exiftooljob.h"
+
+// answers like exiftool -stay_open but without starting anything
+class FakeExiftoolProcess: public MetadataIO::ExiftoolProcess
+{
+public:
+    FakeExiftoolProcess(bool canStart=true):
+        m_CanStart(canStart),
+        m_IsRunning(false),
+        m_ChunkSize(0),
+        m_HangOnCommand(-1),
+        m_CrashOnCommand(-1),
+        m_StartsCount(0),
+        m_KillsCount(0),
+        m_CommandsCount(0)
+    { }
+
+public:
+    // output is split into chunks read one at a time
+    void setChunkSize(int chunkSize) { m_ChunkSize = chunkSize; }
+    // commands are counted from 1 over the lifetime of the fake
+    void setHangOnCommand(int command) { m_HangOnCommand = command; }
+    void setCrashOnCommand(int command) { m_CrashOnCommand = command; }
+
+    int getStartsCount() const { return m_StartsCount; }
+    int getKillsCount() const { return m_KillsCount; }
+    int getCommandsCount() const { return m_CommandsCount; }
+    bool getIsRunning() const { return m_IsRunning; }
+
+public:
+    virtual bool ensureStarted(const QString &exiftoolPath) override {
+        Q_UNUSED(exiftoolPath);
+        if (m_IsRunning) { return true; }
+        if (!m_CanStart) { return false; }
+
+        m_IsRunning = true;
+        m_StartsCount++;
+        return true;
+    }
+
+    virtual void stop() override { m_IsRunning = false; }
+
+protected:
+    virtual bool isRunning() const override { return m_IsRunning; }
+
+    virtual void writeCommand(const QByteArray &command) override {
+        QList<QByteArray> lines = command.split('\n');
+        lines.removeLast();
+        // -executeNUM
+        const QByteArray executeID = lines.takeLast().mid(8);
+        m_CommandsCount++;
+
+        if (m_CommandsCount == m_CrashOnCommand) {
+            m_IsRunning = false;
+            return;
+        }
+
+        if (m_CommandsCount == m_HangOnCommand) { return; }
+
+        const QByteArray response = "processed " + lines.last() + "\n{ready" + executeID + "}\n";
+        const int chunkSize = (m_ChunkSize > 0) ? m_ChunkSize : response.size();
+        for (int i = 0; i < response.size(); i += chunkSize) {
+            m_Chunks.append(response.mid(i, chunkSize));
+        }
+    }
+
+    virtual QByteArray readOutput(int timeoutMsecs) override {
+        if (m_Chunks.isEmpty()) {
+            QThread::msleep(qMin(timeoutMsecs, 5));
+            return QByteArray();
+        }
+
+        return m_Chunks.takeFirst();
+    }
+
+    virtual void logErrors() override { }
+
+    virtual void kill() override {
+        m_IsRunning = false;
+        m_Chunks.clear();
+        m_KillsCount++;
+    }
+
+private:
+    QList<QByteArray> m_Chunks;
+    bool m_CanStart;
+    bool m_IsRunning;
+    int m_ChunkSize;
+    int m_HangOnCommand;
+    int m_CrashOnCommand;
+    int m_StartsCount;
+    int m_KillsCount;
+    int m_CommandsCount;
+};
+
+class TestExiftoolJob: public MetadataIO::ExiftoolJob
+{
+public:
+    TestExiftoolJob(int itemsCount):
+        MetadataIO::ExiftoolJob("exiftool", itemsCount),
+        m_Results(itemsCount, 0),
+        m_DuplicatesCount(0)
+    { }
+
+public:
+    int getProcessedCount() { QMutexLocker locker(&m_Mutex); return m_Results.size() - m_Results.count(0); }
+    int getSucceededCount() { QMutexLocker locker(&m_Mutex); return m_Results.count(1); }
+    int getDuplicatesCount() { QMutexLocker locker(&m_Mutex); return m_DuplicatesCount; }
+
+public:
+    virtual QStringList getArguments(int index) const override {
+        return QStringList() << "-m" << QString("/path/to/file%1.jpg").arg(index);
+    }
+
+    virtual bool processOutput(int index, bool success, const QByteArray &output) override {
+        QMutexLocker locker(&m_Mutex);
+        if (m_Results[index] != 0) { m_DuplicatesCount++; }
+
+        const QByteArray expected = "processed " + getArguments(index).last().toUtf8() + "\n";
+        m_Results[index] = (success && (output == expected)) ? 1 : -1;
+        return false;
+    }
+
+private:
+    QMutex m_Mutex;
+    // 0 - not processed, 1 - succeeded, -1 - failed
+    QVector<int> m_Results;
+    int m_DuplicatesCount;
+};
+
+class ExiftoolWorkerThread: public QThread
+{
+public:
+    ExiftoolWorkerThread(MetadataIO::ExiftoolWorker *worker): m_Worker(worker) { }
+
+protected:
+    virtual void run() override { m_Worker->doWork(); }
+
+private:
+    MetadataIO::ExiftoolWorker *m_Worker;
+};
+
+typedef std::vector<std::unique_ptr<MetadataIO::ExiftoolWorker> > WorkersList;
+
+static void createWorkers(const std::vector<FakeExiftoolProcess *> &processes, WorkersList &workers) {
+    for (size_t i = 0; i < processes.size(); ++i) {
+        workers.emplace_back(new MetadataIO::ExiftoolWorker((int)i, processes[i]));
+    }
+}
+
+// returns how many times the job was reported as finished
+static int runJob(WorkersList &workers, const std::shared_ptr<TestExiftoolJob> &job) {
+    std::vector<std::unique_ptr<QSignalSpy> > spies;
+    std::vector<std::unique_ptr<ExiftoolWorkerThread> > threads;
+
+    job->setWorkersCount((int)workers.size());
+
+    for (auto &worker: workers) {
+        spies.emplace_back(new QSignalSpy(worker.get(), SIGNAL(jobFinished(int,bool))));
+        worker->submitItem(job);
+        threads.emplace_back(new ExiftoolWorkerThread(worker.get()));
+        threads.back()->start();
+    }
+
+    // queued job is still processed after graceful stop
+    for (auto &worker: workers) {
+        worker->stopWorking(false);
+    }
+
+    int finishedCount = 0;
+    for (size_t i = 0; i < threads.size(); ++i) {
+        if (!threads[i]->wait(10000)) { return -1; }
+        finishedCount += spies[i]->count();
+    }
+
+    return finishedCount;
+}
+
+void ExiftoolTests::readyMarkerSplitBetweenReadsTest() {
+    FakeExiftoolProcess exiftool;
+    exiftool.setChunkSize(3);
+    QVERIFY(exiftool.ensureStarted("exiftool"));
+
+    QByteArray output;
+    QVERIFY(exiftool.execute(QStringList() << "-m" << "/file.jpg", 1000, output));
+    QCOMPARE(output, QByteArray("processed /file.jpg\n"));
+    QCOMPARE(exiftool.getKillsCount(), 0);
+}
+
+void ExiftoolTests::outputOfEveryCommandIsFramedTest() {
+    FakeExiftoolProcess exiftool;
+    QVERIFY(exiftool.ensureStarted("exiftool"));
+
+    QByteArray output;
+    QVERIFY(exiftool.execute(QStringList() << "/first.jpg", 1000, output));
+    QCOMPARE(output, QByteArray("processed /first.jpg\n"));
+
+    QVERIFY(exiftool.execute(QStringList() << "/second.jpg", 1000, output));
+    QCOMPARE(output, QByteArray("processed /second.jpg\n"));
+
+    QCOMPARE(exiftool.getCommandsCount(), 2);
+    QCOMPARE(exiftool.getStartsCount(), 1);
+}
+
+void ExiftoolTests::timeoutKillsProcessTest() {
+    FakeExiftoolProcess exiftool;
+    exiftool.setHangOnCommand(1);
+    QVERIFY(exiftool.ensureStarted("exiftool"));
+
+    QByteArray output;
+    QVERIFY(!exiftool.execute(QStringList() << "/file.jpg", 50, output));
+    QCOMPARE(exiftool.getKillsCount(), 1);
+    QVERIFY(!exiftool.getIsRunning());
+
+    QVERIFY(exiftool.ensureStarted("exiftool"));
+    QCOMPARE(exiftool.getStartsCount(), 2);
+
+    QVERIFY(exiftool.execute(QStringList() << "/file.jpg", 1000, output));
+    QCOMPARE(output, QByteArray("processed /file.jpg\n"));
+}
+
+void ExiftoolTests::lineBreakInArgumentIsRejectedTest() {
+    FakeExiftoolProcess exiftool;
+    QVERIFY(exiftool.ensureStarted("exiftool"));
+
+    QByteArray output;
+    QVERIFY(!exiftool.execute(QStringList() << "-XMP:Title=a\n-b" << "/file.jpg", 1000, output));
+    QCOMPARE(exiftool.getCommandsCount(), 0);
+    QCOMPARE(exiftool.getKillsCount(), 0);
+    QVERIFY(exiftool.getIsRunning());
+}
+
+void ExiftoolTests::itemsAreShardedBetweenWorkersTest() {
+    std::vector<FakeExiftoolProcess *> processes;
+    processes.push_back(new FakeExiftoolProcess());
+    processes.push_back(new FakeExiftoolProcess());
+    processes.push_back(new FakeExiftoolProcess());
+
+    WorkersList workers;
+    createWorkers(processes, workers);
+
+    std::shared_ptr<TestExiftoolJob> job(new TestExiftoolJob(60));
+    QCOMPARE(runJob(workers, job), 1);
+
+    QCOMPARE(job->getSucceededCount(), 60);
+    QCOMPARE(job->getDuplicatesCount(), 0);
+    QVERIFY(job->isSuccessful());
+
+    int commandsCount = 0;
+    for (auto *process: processes) {
+        commandsCount += process->getCommandsCount();
+    }
+
+    QCOMPARE(commandsCount, 60);
+}
+
+void ExiftoolTests::workerIsRestartedAfterCrashTest() {
+    FakeExiftoolProcess *exiftool = new FakeExiftoolProcess();
+    exiftool->setCrashOnCommand(3);
+
+    WorkersList workers;
+    createWorkers(std::vector<FakeExiftoolProcess *>(1, exiftool), workers);
+
+    std::shared_ptr<TestExiftoolJob> job(new TestExiftoolJob(10));
+    QCOMPARE(runJob(workers, job), 1);
+
+    QCOMPARE(job->getProcessedCount(), 10);
+    QCOMPARE(job->getSucceededCount(), 9);
+    QVERIFY(!job->isSuccessful());
+    QCOMPARE(exiftool->getKillsCount(), 1);
+    QCOMPARE(exiftool->getStartsCount(), 2);
+}
+
+void ExiftoolTests::brokenWorkerTakesNoItemsTest() {
+    FakeExiftoolProcess *broken = new FakeExiftoolProcess(false);
+    FakeExiftoolProcess *healthy = new FakeExiftoolProcess();
+
+    std::vector<FakeExiftoolProcess *> processes;
+    processes.push_back(broken);
+    processes.push_back(healthy);
+
+    WorkersList workers;
+    createWorkers(processes, workers);
+
+    std::shared_ptr<TestExiftoolJob> job(new TestExiftoolJob(40));
+    QCOMPARE(runJob(workers, job), 1);
+
+    QCOMPARE(job->getSucceededCount(), 40);
+    QVERIFY(job->isSuccessful());
+    QCOMPARE(broken->getCommandsCount(), 0);
+    QCOMPARE(healthy->getCommandsCount(), 40);
+}
+
+void ExiftoolTests::itemsFailWhenNoWorkerIsRunningTest() {
+    std::vector<FakeExiftoolProcess *> processes;
+    processes.push_back(new FakeExiftoolProcess(false));
+    processes.push_back(new FakeExiftoolProcess(false));
+
+    WorkersList workers;
+    createWorkers(processes, workers);
+
+    std::shared_ptr<TestExiftoolJob> job(new TestExiftoolJob(20));
+    QCOMPARE(runJob(workers, job), 1);
+
+    QCOMPARE(job->getProcessedCount(), 20);
+    QCOMPARE(job->getSucceededCount(), 0);
+    QCOMPARE(job->getDuplicatesCount(), 0);
+    QVERIFY(!job->isSuccessful());
+}
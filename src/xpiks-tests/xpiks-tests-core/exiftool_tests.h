@@ -0,0 +1,21 @@
+#ifndef EXIFTOOLTESTS_H
+#define EXIFTOOLTESTS_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+class ExiftoolTests : public QObject
+{
+    Q_OBJECT
+private slots:
+    void readyMarkerSplitBetweenReadsTest();
+    void outputOfEveryCommandIsFramedTest();
+    void timeoutKillsProcessTest();
+    void lineBreakInArgumentIsRejectedTest();
+    void itemsAreShardedBetweenWorkersTest();
+    void workerIsRestartedAfterCrashTest();
+    void brokenWorkerTakesNoItemsTest();
+    void itemsFailWhenNoWorkerIsRunningTest();
+};
+
+#endif // EXIFTOOLTESTS_H
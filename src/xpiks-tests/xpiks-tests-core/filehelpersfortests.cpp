@@ -0,0 +1,18 @@
+#include "filehelpersfortests.h"
+#include <QFile>
+#include <QDir>
+
+QStringList createEmptyFiles(const QString &directory, const QStringList &names) {
+    QDir dir(directory);
+    QStringList filepaths;
+
+    foreach (const QString &name, names) {
+        QString filepath = dir.filePath(name);
+        QFile file(filepath);
+        file.open(QIODevice::WriteOnly);
+        file.close();
+        filepaths.append(filepath);
+    }
+
+    return filepaths;
+}
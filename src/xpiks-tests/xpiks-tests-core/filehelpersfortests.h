@@ -0,0 +1,10 @@
+#ifndef FILEHELPERSFORTESTS_H
+#define FILEHELPERSFORTESTS_H
+
+#include <QString>
+#include <QStringList>
+
+// creates empty files and returns their pathes
+QStringList createEmptyFiles(const QString &directory, const QStringList &names);
+
+#endif // FILEHELPERSFORTESTS_H
@@ -0,0 +1,101 @@
+#include "fileschangemonitor_tests.h"
+#include <QTemporaryDir>
+#include <QSignalSpy>
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include "../../xpiks-qt/Models/fileschangemonitor.h"
+#include "filehelpersfortests.h"
+
+void FilesChangeMonitorTests::watchOneDirectoryForManyFilesTest() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QStringList files = createEmptyFiles(tempDir.path(), QStringList() << "a.jpg" << "b.jpg" << "c.eps");
+
+    Models::FilesChangeMonitor monitor;
+    monitor.watchFiles(files);
+    monitor.watchFile(files.first());
+
+    QCOMPARE(monitor.getWatchedFilesCount(), files.length());
+    QCOMPARE(monitor.getWatchedDirectoriesCount(), 1);
+}
+
+void FilesChangeMonitorTests::unwatchLastFileRemovesDirectoryTest() {
+    QTemporaryDir tempDir1, tempDir2;
+    QVERIFY(tempDir1.isValid() && tempDir2.isValid());
+    QStringList files1 = createEmptyFiles(tempDir1.path(), QStringList() << "a.jpg" << "b.jpg");
+    QStringList files2 = createEmptyFiles(tempDir2.path(), QStringList() << "c.jpg");
+
+    Models::FilesChangeMonitor monitor;
+    monitor.watchFiles(files1 + files2);
+    QCOMPARE(monitor.getWatchedDirectoriesCount(), 2);
+
+    monitor.unwatchFile(files1.first());
+    QCOMPARE(monitor.getWatchedDirectoriesCount(), 2);
+
+    monitor.unwatchFiles(files2);
+    QCOMPARE(monitor.getWatchedDirectoriesCount(), 1);
+    QCOMPARE(monitor.getWatchedFilesCount(), 1);
+}
+
+void FilesChangeMonitorTests::removedFilesAreReportedTest() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QStringList files = createEmptyFiles(tempDir.path(), QStringList() << "a.jpg" << "b.jpg" << "c.jpg");
+
+    Models::FilesChangeMonitor monitor;
+    monitor.watchFiles(files);
+
+    QSignalSpy unavailableSpy(&monitor, SIGNAL(filesUnavailable(QStringList)));
+
+    QVERIFY(QFile::remove(files[0]));
+    QVERIFY(QFile::remove(files[2]));
+
+    QVERIFY(unavailableSpy.wait(5000));
+    // let late notifications to be coalesced as well
+    QTest::qWait(1000);
+
+    QStringList reported;
+    for (auto &arguments: unavailableSpy) {
+        reported += arguments.at(0).toStringList();
+    }
+
+    reported.sort();
+    QCOMPARE(reported, QStringList() << files[0] << files[2]);
+    QCOMPARE(monitor.getWatchedFilesCount(), 1);
+}
+
+void FilesChangeMonitorTests::clearStopsWatchingTest() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QStringList files = createEmptyFiles(tempDir.path(), QStringList() << "a.jpg");
+
+    Models::FilesChangeMonitor monitor;
+    monitor.watchFiles(files);
+    monitor.clear();
+
+    QCOMPARE(monitor.getWatchedFilesCount(), 0);
+    QCOMPARE(monitor.getWatchedDirectoriesCount(), 0);
+
+    QSignalSpy unavailableSpy(&monitor, SIGNAL(filesUnavailable(QStringList)));
+    QVERIFY(QFile::remove(files[0]));
+    QTest::qWait(1000);
+    QCOMPARE(unavailableSpy.count(), 0);
+}
+
+void FilesChangeMonitorTests::changedDirectoryIsReportedTest() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QStringList files = createEmptyFiles(tempDir.path(), QStringList() << "a.jpg");
+
+    Models::FilesChangeMonitor monitor;
+    monitor.watchFiles(files);
+
+    QSignalSpy changedSpy(&monitor, SIGNAL(directoriesChanged(QStringList)));
+
+    createEmptyFiles(tempDir.path(), QStringList() << "b.jpg");
+
+    QVERIFY(changedSpy.wait(5000));
+    QCOMPARE(changedSpy.at(0).at(0).toStringList(), QStringList() << QFileInfo(files[0]).absolutePath());
+    QCOMPARE(monitor.getWatchedFilesCount(), 1);
+}
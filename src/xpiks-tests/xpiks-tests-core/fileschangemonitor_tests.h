@@ -0,0 +1,18 @@
+#ifndef FILESCHANGEMONITORTESTS_H
+#define FILESCHANGEMONITORTESTS_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+class FilesChangeMonitorTests : public QObject
+{
+    Q_OBJECT
+private slots:
+    void watchOneDirectoryForManyFilesTest();
+    void unwatchLastFileRemovesDirectoryTest();
+    void removedFilesAreReportedTest();
+    void clearStopsWatchingTest();
+    void changedDirectoryIsReportedTest();
+};
+
+#endif // FILESCHANGEMONITORTESTS_H
@@ -0,0 +1,272 @@
+#include "imagecacheindex_tests.h"
+#include <QTemporaryDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include "../../xpiks-qt/QMLExtensions/imagecacheindex.h"
+
+#define THUMB_SIZE QSize(150, 150)
+#define CACHED_FILE_SIZE 100
+
+// puts entry for /sources/<name> with fake cached file of CACHED_FILE_SIZE bytes
+static void putImage(QMLExtensions::ImageCacheIndex &index, const QString &name) {
+    QMLExtensions::CachedImage cachedImage;
+    cachedImage.m_Filename = name + ".jpg";
+    cachedImage.m_LastModified = QDateTime::fromMSecsSinceEpoch(1000);
+    cachedImage.m_Size = THUMB_SIZE;
+    cachedImage.m_FileSize = CACHED_FILE_SIZE;
+
+    QFile file(QDir(index.getImagesCacheDir()).filePath(cachedImage.m_Filename));
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QByteArray(CACHED_FILE_SIZE, 'x'));
+        file.close();
+    }
+
+    index.updateCachedImage("/sources/" + name, cachedImage);
+}
+
+static bool hitImage(QMLExtensions::ImageCacheIndex &index, const QString &name) {
+    QString cachedPath;
+    bool needsUpdate = false, needsVerification = false;
+    return index.tryGetCachedImage("/sources/" + name, THUMB_SIZE, cachedPath, needsUpdate, needsVerification);
+}
+
+// unlike hit does not change usage order
+static bool containsImage(QMLExtensions::ImageCacheIndex &index, const QString &name) {
+    return index.getIsCached("/sources/" + name);
+}
+
+void ImageCacheIndexTests::hitDoesNotCheckSourceFileTest() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    QMLExtensions::ImageCacheIndex index;
+    index.initialize(tempDir.path());
+    putImage(index, "a");
+
+    // source does not exist but the hit is served from index only
+    QString cachedPath;
+    bool needsUpdate = true, needsVerification = true;
+    QVERIFY(index.tryGetCachedImage("/sources/a", THUMB_SIZE, cachedPath, needsUpdate, needsVerification));
+    QVERIFY(!needsUpdate);
+    QVERIFY(!needsVerification);
+    QCOMPARE(cachedPath, QDir::cleanPath(index.getImagesCacheDir() + "/a.jpg"));
+
+    QVERIFY(index.tryGetCachedImage("/sources/a", QSize(300, 300), cachedPath, needsUpdate, needsVerification));
+    QVERIFY(needsUpdate);
+}
+
+void ImageCacheIndexTests::indexIsReplayedFromLogTest() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    {
+        QMLExtensions::ImageCacheIndex index;
+        index.initialize(tempDir.path());
+        putImage(index, "a");
+        putImage(index, "b");
+        putImage(index, "c");
+        // replaced entry is accounted only once
+        putImage(index, "b");
+        index.sync();
+    }
+
+    QMLExtensions::ImageCacheIndex index;
+    index.initialize(tempDir.path());
+
+    QCOMPARE(index.getCachedImagesCount(), 3);
+    QCOMPARE(index.getTotalCacheSize(), (qint64)3*CACHED_FILE_SIZE);
+
+    QVERIFY(containsImage(index, "a"));
+    QVERIFY(containsImage(index, "b"));
+    QVERIFY(containsImage(index, "c"));
+
+    // replayed entries still need verification of files on disk
+    QString cachedPath;
+    bool needsUpdate = false, needsVerification = false;
+    QVERIFY(index.tryGetCachedImage("/sources/a", THUMB_SIZE, cachedPath, needsUpdate, needsVerification));
+    QVERIFY(needsVerification);
+}
+
+void ImageCacheIndexTests::touchRecordsRestoreUsageOrderTest() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    {
+        QMLExtensions::ImageCacheIndex index;
+        index.initialize(tempDir.path());
+        putImage(index, "a");
+        putImage(index, "b");
+        putImage(index, "c");
+        QVERIFY(hitImage(index, "a"));
+        index.sync();
+    }
+
+    QMLExtensions::ImageCacheIndex index;
+    // least recently used "b" does not fit after restart
+    index.setMaxCacheSize(2*CACHED_FILE_SIZE + CACHED_FILE_SIZE/2);
+    index.initialize(tempDir.path());
+
+    QCOMPARE(index.getCachedImagesCount(), 2);
+    QVERIFY(!containsImage(index, "b"));
+    QVERIFY(containsImage(index, "a"));
+    QVERIFY(containsImage(index, "c"));
+    QVERIFY(!QFileInfo(QDir(index.getImagesCacheDir()).filePath("b.jpg")).exists());
+}
+
+void ImageCacheIndexTests::tornTailIsTruncatedTest() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    QString indexFilepath;
+    qint64 validSize = 0;
+
+    {
+        QMLExtensions::ImageCacheIndex index;
+        index.initialize(tempDir.path());
+        putImage(index, "a");
+        putImage(index, "b");
+        index.sync();
+
+        indexFilepath = index.getIndexFilepath();
+        validSize = QFileInfo(indexFilepath).size();
+        QVERIFY(validSize > 0);
+
+        putImage(index, "c");
+        index.sync();
+    }
+
+    // simulate crash in the middle of the last record
+    {
+        QFile file(indexFilepath);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        const qint64 lastRecordSize = file.size() - validSize;
+        QVERIFY(lastRecordSize > 2);
+        QVERIFY(file.resize(validSize + lastRecordSize/2));
+    }
+
+    {
+        QMLExtensions::ImageCacheIndex index;
+        index.initialize(tempDir.path());
+
+        QCOMPARE(index.getCachedImagesCount(), 2);
+        QVERIFY(containsImage(index, "a"));
+        QVERIFY(containsImage(index, "b"));
+        QVERIFY(!containsImage(index, "c"));
+
+        // records appended after the torn tail should be readable
+        putImage(index, "d");
+        index.sync();
+    }
+
+    QMLExtensions::ImageCacheIndex index;
+    index.initialize(tempDir.path());
+
+    QCOMPARE(index.getCachedImagesCount(), 3);
+    QVERIFY(containsImage(index, "d"));
+}
+
+void ImageCacheIndexTests::leastRecentlyUsedIsEvictedByBytesTest() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    QMLExtensions::ImageCacheIndex index;
+    index.setMaxCacheSize(5*CACHED_FILE_SIZE);
+    index.initialize(tempDir.path());
+
+    for (int i = 0; i < 5; ++i) {
+        putImage(index, QString::number(i));
+    }
+
+    QCOMPARE(index.getTotalCacheSize(), (qint64)5*CACHED_FILE_SIZE);
+
+    QVERIFY(hitImage(index, "0"));
+    QVERIFY(hitImage(index, "1"));
+
+    // budget is exceeded so cache is shrinked below 90% of it
+    putImage(index, "5");
+
+    QVERIFY(index.getTotalCacheSize() <= (qint64)(5*CACHED_FILE_SIZE*0.9));
+    QCOMPARE(index.getCachedImagesCount(), 4);
+
+    QVERIFY(!containsImage(index, "2"));
+    QVERIFY(!containsImage(index, "3"));
+    QVERIFY(containsImage(index, "0"));
+    QVERIFY(containsImage(index, "1"));
+    QVERIFY(containsImage(index, "4"));
+    QVERIFY(containsImage(index, "5"));
+
+    QDir cacheDir(index.getImagesCacheDir());
+    QVERIFY(!cacheDir.exists("2.jpg"));
+    QVERIFY(!cacheDir.exists("3.jpg"));
+    QVERIFY(cacheDir.exists("0.jpg"));
+
+    // decreased budget is applied immediately
+    index.setMaxCacheSize(2*CACHED_FILE_SIZE);
+    QVERIFY(index.getTotalCacheSize() <= (qint64)(2*CACHED_FILE_SIZE*0.9));
+    QCOMPARE(index.getCachedImagesCount(), 1);
+    QVERIFY(containsImage(index, "5"));
+}
+
+void ImageCacheIndexTests::logIsCompactedTest() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    QString indexFilepath;
+    qint64 logSize = 0;
+
+    {
+        QMLExtensions::ImageCacheIndex index;
+        index.initialize(tempDir.path());
+        indexFilepath = index.getIndexFilepath();
+
+        // every put goes to the log so it grows much bigger than the index
+        for (int i = 0; i < 1200; ++i) {
+            putImage(index, QString::number(i % 10));
+        }
+
+        QVERIFY(hitImage(index, "3"));
+
+        logSize = QFileInfo(indexFilepath).size();
+        index.sync();
+
+        QVERIFY(QFileInfo(indexFilepath).size() < logSize / 10);
+    }
+
+    QMLExtensions::ImageCacheIndex index;
+    index.setMaxCacheSize(9*CACHED_FILE_SIZE);
+    index.initialize(tempDir.path());
+
+    // usage order is preserved by compaction: "9" was put last but "3" was hit later
+    QCOMPARE(index.getCachedImagesCount(), 8);
+    QVERIFY(containsImage(index, "3"));
+    QVERIFY(containsImage(index, "9"));
+    QVERIFY(!containsImage(index, "0"));
+    QVERIFY(!containsImage(index, "1"));
+}
+
+void ImageCacheIndexTests::invalidatedDirectoryNeedsVerificationTest() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    QMLExtensions::ImageCacheIndex index;
+    index.initialize(tempDir.path());
+    putImage(index, "a");
+
+    QMLExtensions::CachedImage otherImage;
+    otherImage.m_Filename = "other.jpg";
+    otherImage.m_Size = THUMB_SIZE;
+    index.updateCachedImage("/other/a", otherImage);
+
+    index.invalidateDirectories(QStringList() << "/sources");
+
+    QString cachedPath;
+    bool needsUpdate = false, needsVerification = false;
+    QVERIFY(index.tryGetCachedImage("/sources/a", THUMB_SIZE, cachedPath, needsUpdate, needsVerification));
+    QVERIFY(needsVerification);
+    QVERIFY(!needsUpdate);
+
+    QVERIFY(index.tryGetCachedImage("/other/a", THUMB_SIZE, cachedPath, needsUpdate, needsVerification));
+    QVERIFY(!needsVerification);
+}
@@ -0,0 +1,20 @@
+#ifndef IMAGECACHEINDEXTESTS_H
+#define IMAGECACHEINDEXTESTS_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+class ImageCacheIndexTests: public QObject
+{
+    Q_OBJECT
+private slots:
+    void hitDoesNotCheckSourceFileTest();
+    void indexIsReplayedFromLogTest();
+    void touchRecordsRestoreUsageOrderTest();
+    void tornTailIsTruncatedTest();
+    void leastRecentlyUsedIsEvictedByBytesTest();
+    void logIsCompactedTest();
+    void invalidatedDirectoryNeedsVerificationTest();
+};
+
+#endif // IMAGECACHEINDEXTESTS_H
@@ -305,3 +305,23 @@ void IndicesToRangesTests::allSameNumbersTest() {
     Pairs expectedPairs = MAKE_PAIRS(1, 0, 0);
     COMPARE_PAIRS(actualPairs, expectedPairs);
 }
+
+void IndicesToRangesTests::rangesToIndicesTest() {
+    Pairs pairs = MAKE_PAIRS(3, 0, 2, 5, 5, 7, 8);
+    Indices actualIndices;
+    Helpers::rangesToIndices(pairs, actualIndices);
+
+    Indices expectedIndices = Indices() << 0 << 1 << 2 << 5 << 7 << 8;
+    QCOMPARE(actualIndices, expectedIndices);
+}
+
+void IndicesToRangesTests::rangesToIndicesRoundtripTest() {
+    Indices indices = Indices() << 1 << 2 << 3 << 10 << 12 << 13;
+    Pairs pairs;
+    Helpers::indicesToRanges(indices, pairs);
+
+    Indices actualIndices;
+    Helpers::rangesToIndices(pairs, actualIndices);
+    QCOMPARE(actualIndices, indices);
+    QCOMPARE(Helpers::getRangesLength(pairs), indices.size());
+}
@@ -31,6 +31,8 @@ private slots:
     void splitIntoMoreThanAHalfTest();
     void sameNumbersTest();
     void allSameNumbersTest();
+    void rangesToIndicesTest();
+    void rangesToIndicesRoundtripTest();
 };
 
 #endif // INDICESTORANGES_TESTS_H
@@ -0,0 +1,325 @@
+#include "itemprocessingworker_tests.h"
+#include <QThread>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QAtomicInt>
+#include <QVector>
+#include "../../xpiks-qt/Common/boundedmpmcqueue.h"
+#include "../../xpiks-qt/Common/itemprocessingworker.h"
+
+class TestWorker: public Common::ItemProcessingWorker<int>
+{
+public:
+    TestWorker(int consumersCount, quint32 ringCapacity, size_t batchSize=1, int coalesceBy=0):
+        Common::ItemProcessingWorker<int>(consumersCount, ringCapacity),
+        m_BatchSize(batchSize),
+        m_CoalesceBy(coalesceBy)
+    { }
+
+public:
+    QVector<int> getProcessed() { QMutexLocker locker(&m_Mutex); return m_Processed; }
+    int getProcessedCount() { QMutexLocker locker(&m_Mutex); return m_Processed.size(); }
+    int getBatchesCount() const { return m_BatchesCount.load(); }
+    int getEmptyNotificationsCount() const { return m_EmptyNotifications.load(); }
+    int getMergesCount() const { return m_MergesCount.load(); }
+
+protected:
+    virtual bool initWorker() override { return true; }
+    virtual void processOneItem(std::shared_ptr<int> &item) override {
+        QMutexLocker locker(&m_Mutex);
+        m_Processed.append(*item);
+    }
+    virtual void notifyQueueIsEmpty() override { m_EmptyNotifications.ref(); }
+    virtual void workerStopped() override { }
+
+    virtual size_t getMaxBatchSize() const override { return m_BatchSize; }
+    virtual void processBatch(std::vector<std::shared_ptr<int> > &items) override {
+        m_BatchesCount.ref();
+        Common::ItemProcessingWorker<int>::processBatch(items);
+    }
+
+    // items with the same quotient are coalesced
+    virtual bool getCoalescingKey(const std::shared_ptr<int> &item, Common::CoalescingKey &key) const override {
+        if (m_CoalesceBy == 0) { return false; }
+        key = qMakePair((quintptr)(*item / m_CoalesceBy), 0);
+        return true;
+    }
+
+    virtual void mergeItems(const std::shared_ptr<int> &pending, std::shared_ptr<int> &incoming) override {
+        Q_UNUSED(pending); Q_UNUSED(incoming);
+        m_MergesCount.ref();
+    }
+
+private:
+    QMutex m_Mutex;
+    QVector<int> m_Processed;
+    QAtomicInt m_BatchesCount;
+    QAtomicInt m_EmptyNotifications;
+    QAtomicInt m_MergesCount;
+    size_t m_BatchSize;
+    int m_CoalesceBy;
+};
+
+class WorkerThread: public QThread
+{
+public:
+    WorkerThread(TestWorker *worker): m_Worker(worker) { }
+
+protected:
+    virtual void run() override { m_Worker->doWork(); }
+
+private:
+    TestWorker *m_Worker;
+};
+
+static void submitRange(TestWorker &worker, int from, int to) {
+    std::vector<std::shared_ptr<int> > items;
+    for (int i = from; i < to; ++i) {
+        items.emplace_back(new int(i));
+    }
+
+    worker.submitItems(items);
+}
+
+static void stopAndWait(TestWorker &worker, WorkerThread &thread) {
+    worker.stopWorking();
+    QVERIFY(thread.wait(5000));
+}
+
+void ItemProcessingWorkerTests::boundedQueueRoundsCapacityTest() {
+    Common::BoundedMPMCQueue<int> queue(5);
+    QCOMPARE(queue.capacity(), (quint32)8);
+
+    for (int i = 0; i < 8; ++i) {
+        QVERIFY(queue.tryPush(i));
+    }
+
+    QVERIFY(!queue.tryPush(8));
+}
+
+void ItemProcessingWorkerTests::boundedQueueIsFifoTest() {
+    Common::BoundedMPMCQueue<int> queue(4);
+    int value = -1;
+
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 4; ++i) {
+            QVERIFY(queue.tryPush(round * 10 + i));
+        }
+
+        for (int i = 0; i < 4; ++i) {
+            QVERIFY(queue.tryPop(value));
+            QCOMPARE(value, round * 10 + i);
+        }
+    }
+
+    QVERIFY(!queue.tryPop(value));
+}
+
+void ItemProcessingWorkerTests::ringOverflowKeepsOrderTest() {
+    TestWorker worker(1, 4);
+    submitRange(worker, 0, 50);
+    QVERIFY(worker.hasPendingJobs());
+
+    WorkerThread thread(&worker);
+    thread.start();
+    QTRY_COMPARE(worker.getProcessedCount(), 50);
+    stopAndWait(worker, thread);
+
+    QVector<int> processed = worker.getProcessed();
+    for (int i = 0; i < processed.size(); ++i) {
+        QCOMPARE(processed[i], i);
+    }
+
+    QVERIFY(!worker.hasPendingJobs());
+}
+
+void ItemProcessingWorkerTests::submitFirstGoesBeforeRingTest() {
+    TestWorker worker(1, 16);
+    submitRange(worker, 1, 5);
+    worker.submitFirst(std::shared_ptr<int>(new int(0)));
+
+    WorkerThread thread(&worker);
+    thread.start();
+    QTRY_COMPARE(worker.getProcessedCount(), 5);
+    stopAndWait(worker, thread);
+
+    QCOMPARE(worker.getProcessed(), QVector<int>() << 0 << 1 << 2 << 3 << 4);
+}
+
+void ItemProcessingWorkerTests::manyConsumersProcessAllItemsTest() {
+    const int itemsCount = 2000;
+    TestWorker worker(4, 64);
+
+    WorkerThread thread(&worker);
+    thread.start();
+
+    for (int i = 0; i < itemsCount; i += 100) {
+        submitRange(worker, i, i + 100);
+    }
+
+    QTRY_COMPARE(worker.getProcessedCount(), itemsCount);
+    stopAndWait(worker, thread);
+
+    QVector<int> processed = worker.getProcessed();
+    std::sort(processed.begin(), processed.end());
+    for (int i = 0; i < itemsCount; ++i) {
+        QCOMPARE(processed[i], i);
+    }
+
+    QVERIFY(worker.getEmptyNotificationsCount() >= 1);
+}
+
+void ItemProcessingWorkerTests::queueIsEmptyNotifiedOnceTest() {
+    TestWorker worker(4, 32);
+    submitRange(worker, 0, 500);
+
+    WorkerThread thread(&worker);
+    thread.start();
+    QTRY_COMPARE(worker.getProcessedCount(), 500);
+    QTRY_COMPARE(worker.getEmptyNotificationsCount(), 1);
+    // nothing else should come after the queue was drained
+    QTest::qWait(200);
+    stopAndWait(worker, thread);
+
+    QCOMPARE(worker.getEmptyNotificationsCount(), 1);
+}
+
+void ItemProcessingWorkerTests::cancelCurrentBatchClearsAllQueuesTest() {
+    TestWorker worker(1, 4);
+    submitRange(worker, 0, 20);
+    worker.submitFirst(std::shared_ptr<int>(new int(100)));
+    QVERIFY(worker.hasPendingJobs());
+
+    worker.cancelCurrentBatch();
+    QVERIFY(!worker.hasPendingJobs());
+    QCOMPARE(worker.getEmptyNotificationsCount(), 1);
+
+    WorkerThread thread(&worker);
+    thread.start();
+    submitRange(worker, 0, 3);
+    QTRY_COMPARE(worker.getProcessedCount(), 3);
+    stopAndWait(worker, thread);
+
+    QCOMPARE(worker.getProcessed(), QVector<int>() << 0 << 1 << 2);
+}
+
+void ItemProcessingWorkerTests::batchesAreTakenFromRingTest() {
+    TestWorker worker(1, 8, 10);
+    submitRange(worker, 0, 95);
+
+    WorkerThread thread(&worker);
+    thread.start();
+    QTRY_COMPARE(worker.getProcessedCount(), 95);
+    stopAndWait(worker, thread);
+
+    // 9 full batches and the last one of 5 items
+    QCOMPARE(worker.getBatchesCount(), 10);
+}
+
+void ItemProcessingWorkerTests::sameKeyItemsAreCoalescedTest() {
+    TestWorker worker(1, 16, 1, 100);
+    for (int i = 0; i < 50; ++i) {
+        worker.submitItem(std::shared_ptr<int>(new int(i)));
+    }
+
+    QCOMPARE(worker.getMergesCount(), 49);
+
+    WorkerThread thread(&worker);
+    thread.start();
+    QTRY_COMPARE(worker.getEmptyNotificationsCount(), 1);
+    stopAndWait(worker, thread);
+
+    // the latest submitted item supersedes the pending ones
+    QCOMPARE(worker.getProcessed(), QVector<int>() << 49);
+}
+
+void ItemProcessingWorkerTests::supersedingItemIsQueuedLastTest() {
+    TestWorker worker(1, 4, 1, 10);
+    submitRange(worker, 0, 30);
+    worker.submitItem(std::shared_ptr<int>(new int(5)));
+    worker.submitItem(std::shared_ptr<int>(new int(25)));
+
+    WorkerThread thread(&worker);
+    thread.start();
+    QTRY_COMPARE(worker.getEmptyNotificationsCount(), 1);
+    stopAndWait(worker, thread);
+
+    QCOMPARE(worker.getProcessed(), QVector<int>() << 19 << 5 << 25);
+}
+
+void ItemProcessingWorkerTests::coalescedSubmitFirstKeepsPriorityTest() {
+    TestWorker worker(1, 16, 1, 10);
+    submitRange(worker, 10, 15);
+    submitRange(worker, 20, 22);
+    worker.submitFirst(std::shared_ptr<int>(new int(15)));
+
+    WorkerThread thread(&worker);
+    thread.start();
+    QTRY_COMPARE(worker.getEmptyNotificationsCount(), 1);
+    stopAndWait(worker, thread);
+
+    // superseded items queued before are not processed after the latest one
+    QCOMPARE(worker.getProcessed(), QVector<int>() << 15 << 21);
+    QVERIFY(!worker.hasPendingJobs());
+}
+
+void ItemProcessingWorkerTests::processedKeyCanBeSubmittedAgainTest() {
+    TestWorker worker(1, 16, 1, 100);
+
+    WorkerThread thread(&worker);
+    thread.start();
+
+    worker.submitItem(std::shared_ptr<int>(new int(1)));
+    QTRY_COMPARE(worker.getProcessedCount(), 1);
+
+    worker.submitItem(std::shared_ptr<int>(new int(2)));
+    QTRY_COMPARE(worker.getProcessedCount(), 2);
+    stopAndWait(worker, thread);
+
+    QCOMPARE(worker.getProcessed(), QVector<int>() << 1 << 2);
+    QCOMPARE(worker.getMergesCount(), 0);
+}
+
+void ItemProcessingWorkerTests::cancelCurrentBatchDropsCoalescedItemsTest() {
+    TestWorker worker(1, 16, 1, 100);
+    submitRange(worker, 0, 10);
+    worker.cancelCurrentBatch();
+
+    WorkerThread thread(&worker);
+    thread.start();
+    worker.submitItem(std::shared_ptr<int>(new int(42)));
+    QTRY_COMPARE(worker.getProcessedCount(), 1);
+    stopAndWait(worker, thread);
+
+    QCOMPARE(worker.getProcessed(), QVector<int>() << 42);
+    QCOMPARE(worker.getMergesCount(), 9);
+}
+
+void ItemProcessingWorkerTests::gracefulStopProcessesQueuedItemsTest() {
+    TestWorker worker(2, 8);
+    submitRange(worker, 0, 30);
+    worker.stopWorking(false);
+
+    // nothing is accepted after stop
+    submitRange(worker, 30, 40);
+
+    WorkerThread thread(&worker);
+    thread.start();
+    QVERIFY(thread.wait(5000));
+
+    QCOMPARE(worker.getProcessedCount(), 30);
+    QVERIFY(!worker.hasPendingJobs());
+}
+
+void ItemProcessingWorkerTests::immediateStopDropsQueuedItemsTest() {
+    TestWorker worker(2, 8);
+    submitRange(worker, 0, 30);
+    worker.stopWorking(true);
+
+    WorkerThread thread(&worker);
+    thread.start();
+    QVERIFY(thread.wait(5000));
+
+    QCOMPARE(worker.getProcessedCount(), 0);
+    QVERIFY(!worker.hasPendingJobs());
+}
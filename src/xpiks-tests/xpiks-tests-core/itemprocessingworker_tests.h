@@ -0,0 +1,28 @@
+#ifndef ITEMPROCESSINGWORKERTESTS_H
+#define ITEMPROCESSINGWORKERTESTS_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+class ItemProcessingWorkerTests : public QObject
+{
+    Q_OBJECT
+private slots:
+    void boundedQueueRoundsCapacityTest();
+    void boundedQueueIsFifoTest();
+    void ringOverflowKeepsOrderTest();
+    void submitFirstGoesBeforeRingTest();
+    void manyConsumersProcessAllItemsTest();
+    void queueIsEmptyNotifiedOnceTest();
+    void cancelCurrentBatchClearsAllQueuesTest();
+    void batchesAreTakenFromRingTest();
+    void sameKeyItemsAreCoalescedTest();
+    void supersedingItemIsQueuedLastTest();
+    void coalescedSubmitFirstKeepsPriorityTest();
+    void processedKeyCanBeSubmittedAgainTest();
+    void cancelCurrentBatchDropsCoalescedItemsTest();
+    void gracefulStopProcessesQueuedItemsTest();
+    void immediateStopDropsQueuedItemsTest();
+};
+
+#endif // ITEMPROCESSINGWORKERTESTS_H
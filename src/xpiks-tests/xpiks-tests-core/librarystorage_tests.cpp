@@ -0,0 +1,222 @@
+#include "librarystorage_tests.h"
+#include <QFile>
+#include <QDataStream>
+#include "../../xpiks-qt/Suggestion/librarystorage.h"
+
+typedef QHash<QString, Suggestion::LocalArtworkData> LibraryHash;
+
+Suggestion::LocalArtworkData createArtworkData(const QString &title) {
+    Suggestion::LocalArtworkData data;
+    data.m_ArtworkType = Suggestion::LocalArtworkImage;
+    data.m_Title = title;
+    data.m_Description = title + " description";
+    data.m_Keywords << "keyword" << title;
+    data.m_CreationTime = QDateTime::fromMSecsSinceEpoch(1000000);
+    data.m_ReservedInt = 0;
+    return data;
+}
+
+Suggestion::LibraryLoadResult loadToHash(Suggestion::LibraryStorage &storage, LibraryHash &hash) {
+    return storage.load([&hash](const QVector<Suggestion::LibraryRecord> &records) {
+        for (auto &record: records) {
+            if (record.m_IsRemoved) {
+                hash.remove(record.m_Filepath);
+            } else {
+                hash.insert(record.m_Filepath, record.m_Data);
+            }
+        }
+    });
+}
+
+void LibraryStorageTests::init() {
+    m_TempDir = new QTemporaryDir();
+    QVERIFY(m_TempDir->isValid());
+}
+
+void LibraryStorageTests::cleanup() {
+    delete m_TempDir;
+    m_TempDir = nullptr;
+}
+
+QString LibraryStorageTests::getLibraryPath() const {
+    return QDir(m_TempDir->path()).filePath("test.library");
+}
+
+void LibraryStorageTests::loadMissingFileTest() {
+    Suggestion::LibraryStorage storage;
+    storage.setFilepath(getLibraryPath());
+
+    LibraryHash hash;
+    QCOMPARE(loadToHash(storage, hash), Suggestion::LibraryNeedsCompaction);
+    QVERIFY(hash.isEmpty());
+    QVERIFY(!storage.getIsReadOnly());
+}
+
+void LibraryStorageTests::appendAndLoadTest() {
+    Suggestion::LibraryStorage storage;
+    storage.setFilepath(getLibraryPath());
+
+    QVector<QPair<QString, Suggestion::LocalArtworkData> > artworks;
+    artworks << qMakePair(QString("/a.jpg"), createArtworkData("a"))
+             << qMakePair(QString("/b.jpg"), createArtworkData("b"));
+    QVERIFY(storage.appendArtworks(artworks));
+
+    artworks.clear();
+    artworks << qMakePair(QString("/a.jpg"), createArtworkData("c"));
+    QVERIFY(storage.appendArtworks(artworks));
+    QCOMPARE(storage.getRecordsCount(), 3);
+
+    Suggestion::LibraryStorage otherStorage;
+    otherStorage.setFilepath(getLibraryPath());
+    LibraryHash hash;
+    QCOMPARE(loadToHash(otherStorage, hash), Suggestion::LibraryLoaded);
+
+    QCOMPARE(otherStorage.getRecordsCount(), 3);
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash.value("/a.jpg").m_Title, QString("c"));
+    QCOMPARE(hash.value("/b.jpg").m_Keywords, QStringList() << "keyword" << "b");
+    QCOMPARE(hash.value("/b.jpg").m_CreationTime, QDateTime::fromMSecsSinceEpoch(1000000));
+}
+
+void LibraryStorageTests::removedRecordsAreReplayedTest() {
+    Suggestion::LibraryStorage storage;
+    storage.setFilepath(getLibraryPath());
+
+    QVector<QPair<QString, Suggestion::LocalArtworkData> > artworks;
+    artworks << qMakePair(QString("/a.jpg"), createArtworkData("a"))
+             << qMakePair(QString("/b.jpg"), createArtworkData("b"));
+    QVERIFY(storage.appendArtworks(artworks));
+    QVERIFY(storage.appendRemoved(QStringList() << "/a.jpg"));
+
+    LibraryHash hash;
+    QCOMPARE(loadToHash(storage, hash), Suggestion::LibraryLoaded);
+    QCOMPARE(hash.keys(), QStringList() << "/b.jpg");
+}
+
+void LibraryStorageTests::damagedTailIsCutOffTest() {
+    Suggestion::LibraryStorage storage;
+    storage.setFilepath(getLibraryPath());
+
+    QVector<QPair<QString, Suggestion::LocalArtworkData> > artworks;
+    artworks << qMakePair(QString("/a.jpg"), createArtworkData("a"));
+    QVERIFY(storage.appendArtworks(artworks));
+
+    QFile file(getLibraryPath());
+    const qint64 validSize = file.size();
+
+    artworks.clear();
+    artworks << qMakePair(QString("/b.jpg"), createArtworkData("b"));
+    QVERIFY(storage.appendArtworks(artworks));
+
+    // simulate the crash in the middle of the last record
+    QVERIFY(file.resize(file.size() - 5));
+
+    LibraryHash hash;
+    QCOMPARE(loadToHash(storage, hash), Suggestion::LibraryLoaded);
+    QCOMPARE(hash.keys(), QStringList() << "/a.jpg");
+    QCOMPARE(storage.getRecordsCount(), 1);
+    QCOMPARE(QFile(getLibraryPath()).size(), validSize);
+}
+
+void LibraryStorageTests::appendAfterDamagedTailTest() {
+    Suggestion::LibraryStorage storage;
+    storage.setFilepath(getLibraryPath());
+
+    QVector<QPair<QString, Suggestion::LocalArtworkData> > artworks;
+    artworks << qMakePair(QString("/a.jpg"), createArtworkData("a"));
+    QVERIFY(storage.appendArtworks(artworks));
+
+    QFile file(getLibraryPath());
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Append));
+    file.write("garbage");
+    file.close();
+
+    LibraryHash hash;
+    QCOMPARE(loadToHash(storage, hash), Suggestion::LibraryLoaded);
+
+    artworks.clear();
+    artworks << qMakePair(QString("/b.jpg"), createArtworkData("b"));
+    QVERIFY(storage.appendArtworks(artworks));
+
+    hash.clear();
+    QCOMPARE(loadToHash(storage, hash), Suggestion::LibraryLoaded);
+    QCOMPARE(hash.size(), 2);
+    QVERIFY(hash.contains("/b.jpg"));
+}
+
+void LibraryStorageTests::compactTest() {
+    Suggestion::LibraryStorage storage;
+    storage.setFilepath(getLibraryPath());
+
+    QVector<QPair<QString, Suggestion::LocalArtworkData> > artworks;
+    for (int i = 0; i < 2000; ++i) {
+        artworks << qMakePair(QString("/a.jpg"), createArtworkData(QString::number(i)));
+    }
+
+    QVERIFY(storage.appendArtworks(artworks));
+    QVERIFY(storage.needsCompaction(1));
+
+    LibraryHash hash;
+    hash.insert("/a.jpg", createArtworkData("last"));
+    QVERIFY(storage.compact(hash));
+    QCOMPARE(storage.getRecordsCount(), 1);
+    QVERIFY(!storage.needsCompaction(1));
+
+    LibraryHash loaded;
+    QCOMPARE(loadToHash(storage, loaded), Suggestion::LibraryLoaded);
+    QCOMPARE(loaded.size(), 1);
+    QCOMPARE(loaded.value("/a.jpg").m_Title, QString("last"));
+}
+
+void LibraryStorageTests::legacyLibraryIsReadTest() {
+    LibraryHash legacy;
+    legacy.insert("/a.jpg", createArtworkData("a"));
+    legacy.insert("/b.jpg", createArtworkData("b"));
+
+    QFile file(getLibraryPath());
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QDataStream out(&file);
+    out << legacy;
+    file.close();
+
+    Suggestion::LibraryStorage storage;
+    storage.setFilepath(getLibraryPath());
+
+    LibraryHash hash;
+    // legacy library has to be compacted to the new format
+    QCOMPARE(loadToHash(storage, hash), Suggestion::LibraryNeedsCompaction);
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash.value("/b.jpg").m_Title, QString("b"));
+}
+
+void LibraryStorageTests::unsupportedVersionIsKeptTest() {
+    Suggestion::LibraryStorage storage;
+    storage.setFilepath(getLibraryPath());
+
+    QVector<QPair<QString, Suggestion::LocalArtworkData> > artworks;
+    artworks << qMakePair(QString("/a.jpg"), createArtworkData("a"));
+    QVERIFY(storage.appendArtworks(artworks));
+
+    QFile file(getLibraryPath());
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    // version follows the magic number
+    QVERIFY(file.seek(4));
+    file.write(QByteArray("\x00\x00\x00\x7F", 4));
+    file.close();
+
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray contents = file.readAll();
+    file.close();
+
+    LibraryHash hash;
+    QCOMPARE(loadToHash(storage, hash), Suggestion::LibraryLoadFailed);
+    QVERIFY(hash.isEmpty());
+    QVERIFY(storage.getIsReadOnly());
+
+    QVERIFY(!storage.appendArtworks(artworks));
+    QVERIFY(!storage.compact(hash));
+
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), contents);
+    file.close();
+}
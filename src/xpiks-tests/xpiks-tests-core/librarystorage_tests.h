@@ -0,0 +1,30 @@
+#ifndef LIBRARYSTORAGETESTS_H
+#define LIBRARYSTORAGETESTS_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+
+class LibraryStorageTests: public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+    void loadMissingFileTest();
+    void appendAndLoadTest();
+    void removedRecordsAreReplayedTest();
+    void damagedTailIsCutOffTest();
+    void appendAfterDamagedTailTest();
+    void compactTest();
+    void legacyLibraryIsReadTest();
+    void unsupportedVersionIsKeptTest();
+
+private:
+    QString getLibraryPath() const;
+
+private:
+    QTemporaryDir *m_TempDir;
+};
+
+#endif // LIBRARYSTORAGETESTS_H
@@ -0,0 +1,123 @@
+#include "locallibraryindex_tests.h"
+#include "../../xpiks-qt/Suggestion/locallibraryindex.h"
+
+typedef QVector<QPair<QString, int> > SearchResults;
+
+QStringList getFilepaths(const SearchResults &results) {
+    QStringList filepaths;
+    foreach (auto &result, results) {
+        filepaths.append(result.first);
+    }
+
+    filepaths.sort();
+    return filepaths;
+}
+
+int getScore(const SearchResults &results, const QString &filepath) {
+    foreach (auto &result, results) {
+        if (result.first == filepath) { return result.second; }
+    }
+
+    return -1;
+}
+
+void LocalLibraryIndexTests::searchEmptyIndexTest() {
+    Suggestion::LocalLibraryIndex index;
+    SearchResults results;
+    index.search(QStringList() << "test", results);
+    QVERIFY(results.isEmpty());
+}
+
+void LocalLibraryIndexTests::searchWholeWordTest() {
+    Suggestion::LocalLibraryIndex index;
+    index.addArtwork("/a.jpg", "Sunny beach", "", QStringList() << "sea" << "sand");
+    index.addArtwork("/b.jpg", "Mountains", "", QStringList() << "rock" << "snow");
+
+    SearchResults results;
+    index.search(QStringList() << "sand", results);
+    QCOMPARE(getFilepaths(results), QStringList() << "/a.jpg");
+}
+
+void LocalLibraryIndexTests::searchPrefixTest() {
+    Suggestion::LocalLibraryIndex index;
+    index.addArtwork("/a.jpg", "", "", QStringList() << "mountain");
+    index.addArtwork("/b.jpg", "", "", QStringList() << "mount everest");
+    index.addArtwork("/c.jpg", "", "", QStringList() << "sea");
+
+    SearchResults results;
+    index.search(QStringList() << "mou", results);
+    QCOMPARE(getFilepaths(results), QStringList() << "/a.jpg" << "/b.jpg");
+}
+
+void LocalLibraryIndexTests::searchIsCaseInsensitiveTest() {
+    Suggestion::LocalLibraryIndex index;
+    index.addArtwork("/a.jpg", "Golden Gate", "", QStringList());
+
+    SearchResults results;
+    index.search(QStringList() << "GOLDEN", results);
+    QCOMPARE(getFilepaths(results), QStringList() << "/a.jpg");
+}
+
+void LocalLibraryIndexTests::searchRequiresAllTermsTest() {
+    Suggestion::LocalLibraryIndex index;
+    index.addArtwork("/a.jpg", "", "red car on the road", QStringList());
+    index.addArtwork("/b.jpg", "", "red apple", QStringList());
+
+    SearchResults results;
+    index.search(QStringList() << "red" << "car", results);
+    QCOMPARE(getFilepaths(results), QStringList() << "/a.jpg");
+
+    results.clear();
+    index.search(QStringList() << "red car", results);
+    QCOMPARE(getFilepaths(results), QStringList() << "/a.jpg");
+}
+
+void LocalLibraryIndexTests::keywordsRankHigherThanDescriptionTest() {
+    Suggestion::LocalLibraryIndex index;
+    index.addArtwork("/a.jpg", "", "a cat on the sofa", QStringList());
+    index.addArtwork("/b.jpg", "", "", QStringList() << "cat");
+
+    SearchResults results;
+    index.search(QStringList() << "cat", results);
+    QCOMPARE(results.size(), 2);
+    QVERIFY(getScore(results, "/b.jpg") > getScore(results, "/a.jpg"));
+}
+
+void LocalLibraryIndexTests::wholeWordRanksHigherThanPrefixTest() {
+    Suggestion::LocalLibraryIndex index;
+    index.addArtwork("/a.jpg", "", "", QStringList() << "category");
+    index.addArtwork("/b.jpg", "", "", QStringList() << "cat");
+
+    SearchResults results;
+    index.search(QStringList() << "cat", results);
+    QCOMPARE(results.size(), 2);
+    QVERIFY(getScore(results, "/b.jpg") > getScore(results, "/a.jpg"));
+}
+
+void LocalLibraryIndexTests::removeArtworkTest() {
+    Suggestion::LocalLibraryIndex index;
+    index.addArtwork("/a.jpg", "", "", QStringList() << "tree");
+    index.addArtwork("/b.jpg", "", "", QStringList() << "tree");
+    index.removeArtwork("/a.jpg");
+
+    QCOMPARE(index.getArtworksCount(), 1);
+
+    SearchResults results;
+    index.search(QStringList() << "tree", results);
+    QCOMPARE(getFilepaths(results), QStringList() << "/b.jpg");
+}
+
+void LocalLibraryIndexTests::replaceArtworkTest() {
+    Suggestion::LocalLibraryIndex index;
+    index.addArtwork("/a.jpg", "", "", QStringList() << "tree");
+    index.addArtwork("/a.jpg", "", "", QStringList() << "flower");
+
+    QCOMPARE(index.getArtworksCount(), 1);
+
+    SearchResults results;
+    index.search(QStringList() << "tree", results);
+    QVERIFY(results.isEmpty());
+
+    index.search(QStringList() << "flower", results);
+    QCOMPARE(getFilepaths(results), QStringList() << "/a.jpg");
+}
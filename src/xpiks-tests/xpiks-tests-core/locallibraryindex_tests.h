@@ -0,0 +1,22 @@
+#ifndef LOCALLIBRARYINDEXTESTS_H
+#define LOCALLIBRARYINDEXTESTS_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+class LocalLibraryIndexTests: public QObject
+{
+    Q_OBJECT
+private slots:
+    void searchEmptyIndexTest();
+    void searchWholeWordTest();
+    void searchPrefixTest();
+    void searchIsCaseInsensitiveTest();
+    void searchRequiresAllTermsTest();
+    void keywordsRankHigherThanDescriptionTest();
+    void wholeWordRanksHigherThanPrefixTest();
+    void removeArtworkTest();
+    void replaceArtworkTest();
+};
+
+#endif // LOCALLIBRARYINDEXTESTS_H
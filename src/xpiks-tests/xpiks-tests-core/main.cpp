@@ -27,6 +27,18 @@
 #include "deletekeywords_tests.h"
 #include "preset_tests.h"
 #include "quickbuffer_tests.h"
+#include "locallibraryindex_tests.h"
+#include "directoryscanner_tests.h"
+#include "fileschangemonitor_tests.h"
+#include "itemprocessingworker_tests.h"
+#include "decodedimagecache_tests.h"
+#include "archivespipeline_tests.h"
+#include "librarystorage_tests.h"
+#include "suggestionscache_tests.h"
+#include "artworkssearchindex_tests.h"
+#include "exiftool_tests.h"
+#include "imagecacheindex_tests.h"
+#include "spellcheckworker_tests.h"
 
 #define QTEST_CLASS(TestObject, vName, result) \
     TestObject vName; \
@@ -63,6 +75,18 @@ int main(int argc, char *argv[]) {
     QTEST_CLASS(DeleteKeywordsTests, dkt, result);
     QTEST_CLASS(PresetTests, pst, result);
     QTEST_CLASS(QuickBufferTests, qbt, result);
+    QTEST_CLASS(LocalLibraryIndexTests, llit, result);
+    QTEST_CLASS(LibraryStorageTests, lst, result);
+    QTEST_CLASS(SuggestionsCacheTests, sct, result);
+    QTEST_CLASS(ArtworksSearchIndexTests, asit, result);
+    QTEST_CLASS(DirectoryScannerTests, dst, result);
+    QTEST_CLASS(FilesChangeMonitorTests, fcmt, result);
+    QTEST_CLASS(ItemProcessingWorkerTests, ipwt, result);
+    QTEST_CLASS(DecodedImageCacheTests, dict, result);
+    QTEST_CLASS(ArchivesPipelineTests, apt, result);
+    QTEST_CLASS(ExiftoolTests, ett, result);
+    QTEST_CLASS(ImageCacheIndexTests, icit, result);
+    QTEST_CLASS(SpellCheckWorkerTests, scwt, result);
 
     QThread::sleep(1);
 
@@ -1,6 +1,7 @@
 #include "replace_tests.h"
 #include <QString>
 #include <QtAlgorithms>
+#include <QtConcurrent>
 #include "Mocks/artitemsmodelmock.h"
 #include "Mocks/commandmanagermock.h"
 #include "../../xpiks-qt/Commands/findandreplacecommand.h"
@@ -414,3 +415,50 @@ void ReplaceTests::replaceKeywordsToEmptyTest() {
     }
 }
 
+
+void ReplaceTests::replaceWithPlansFromBackgroundTest() {
+    const int itemsToGenerate = 10;
+    DECLARE_MODELS_AND_GENERATE(itemsToGenerate);
+
+    QString replaceFrom = "Replace";
+    QString replaceTo = "Replaced";
+
+    auto flags = Common::SearchFlags::CaseSensitive |
+            Common::SearchFlags::Description |
+            Common::SearchFlags::Title |
+            Common::SearchFlags::Keywords;
+
+    for (int i = 0; i < itemsToGenerate; i++) {
+        Models::ArtworkMetadata *metadata = artItemsModelMock.getArtwork(i);
+        QString text = (i % 3 == 0) ? QString("KeepMe %1").arg(i) : QString("ReplaceMe %1").arg(i);
+        metadata->initialize(text, text, QStringList() << text);
+    }
+
+    auto artWorksInfo = filteredItemsModel.getAllPreviewOriginalItems();
+    artWorksInfo.at(1).setSelected(false);
+
+    const QVector<int> selected = Commands::getSelectedElements(artWorksInfo);
+    QCOMPARE(selected.size(), itemsToGenerate - 1);
+
+    QFuture<Commands::ReplacePlan> future = QtConcurrent::mapped(selected,
+                                                                 Commands::ReplacePlanner(&artWorksInfo, replaceFrom, replaceTo, flags));
+    future.waitForFinished();
+    const QVector<Commands::ReplacePlan> plans = future.results().toVector();
+    QCOMPARE(plans.size(), selected.size());
+
+    std::shared_ptr<Commands::FindAndReplaceCommand> replaceCommand(
+                new Commands::FindAndReplaceCommand(artWorksInfo, plans, replaceFrom, replaceTo, flags));
+    auto result = commandManagerMock.processCommand(replaceCommand);
+
+    for (int i = 0; i < itemsToGenerate; i++) {
+        Models::ArtworkMetadata *metadata = artItemsModelMock.getArtwork(i);
+        const bool shouldReplace = (i % 3 != 0) && (i != 1);
+        QString text = (i % 3 == 0) ? QString("KeepMe %1").arg(i) : QString("ReplaceMe %1").arg(i);
+        QString finalText = shouldReplace ? QString("ReplacedMe %1").arg(i) : text;
+
+        QCOMPARE(metadata->getDescription(), finalText);
+        QCOMPARE(metadata->getTitle(), finalText);
+        QCOMPARE(metadata->getKeywords(), QStringList() << finalText);
+        QCOMPARE(metadata->isModified(), shouldReplace);
+    }
+}
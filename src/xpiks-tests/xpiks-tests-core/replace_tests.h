@@ -20,6 +20,7 @@ private slots:
     void replaceSpacesToWordsTest();
     void replaceSpacesToSpacesTest();
     void replaceKeywordsToEmptyTest();
+    void replaceWithPlansFromBackgroundTest();
 };
 
 #endif // REPLACETEST_H
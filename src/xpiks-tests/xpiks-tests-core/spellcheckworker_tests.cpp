@@ -0,0 +1,233 @@
+#include "spellcheckworker_tests.h"
+#include <QFile>
+#include <QDir>
+#include <QThread>
+#include <memory>
+#include <vector>
+#include "../../xpiks-qt/SpellCheck/spellcheckworker.h"
+#include "../../xpiks-qt/SpellCheck/spellcheckitem.h"
+#include "../../xpiks-qt/Common/basickeywordsmodel.h"
+#include "../../xpiks-qt/Common/flags.h"
+
+// every even word up to this index is in the test dictionary
+#define DICTIONARY_WORDS_COUNT 1000
+
+#define DECLARE_SPELLCHECK_WORKER(worker) \
+    SpellCheck::SpellCheckWorker worker(&m_SettingsModel); \
+    QVERIFY(worker.initDictionary(getAffPath(), getDicPath()));
+
+static QString getWord(int index) {
+    QString word = "w";
+    for (int i = 0; i < 5; ++i) {
+        word.append(QChar('a' + (index % 26)));
+        index /= 26;
+    }
+
+    return word;
+}
+
+static bool isWordInDictionary(int index) {
+    return (index < DICTIONARY_WORDS_COUNT) && (index % 2 == 0);
+}
+
+static QStringList getWords(int from, int count) {
+    QStringList words;
+    words.reserve(count);
+    for (int i = from; i < from + count; ++i) {
+        words.append(getWord(i));
+    }
+
+    return words;
+}
+
+static void submitBatch(SpellCheck::SpellCheckWorker &worker, const std::vector<std::shared_ptr<SpellCheck::ISpellCheckItem> > &batch) {
+    std::vector<std::shared_ptr<SpellCheck::ISpellCheckItem> > items = batch;
+    worker.processBatch(items);
+}
+
+void SpellCheckWorkerTests::initTestCase() {
+    m_TempDir = new QTemporaryDir();
+    QVERIFY(m_TempDir->isValid());
+
+    QFile affFile(getAffPath());
+    QVERIFY(affFile.open(QIODevice::WriteOnly));
+    affFile.write("SET UTF-8\n");
+    affFile.close();
+
+    QStringList dictionary;
+    dictionary << "London";
+    for (int i = 0; i < DICTIONARY_WORDS_COUNT; ++i) {
+        if (isWordInDictionary(i)) { dictionary << getWord(i); }
+    }
+
+    QFile dicFile(getDicPath());
+    QVERIFY(dicFile.open(QIODevice::WriteOnly));
+    dicFile.write(QString("%1\n%2\n").arg(dictionary.size()).arg(dictionary.join('\n')).toUtf8());
+    dicFile.close();
+}
+
+void SpellCheckWorkerTests::cleanupTestCase() {
+    delete m_TempDir;
+    m_TempDir = nullptr;
+}
+
+QString SpellCheckWorkerTests::getAffPath() const {
+    return QDir(m_TempDir->path()).filePath("en_US.aff");
+}
+
+QString SpellCheckWorkerTests::getDicPath() const {
+    return QDir(m_TempDir->path()).filePath("en_US.dic");
+}
+
+void SpellCheckWorkerTests::pooledAndSequentialResultsAreSameTest() {
+    DECLARE_SPELLCHECK_WORKER(pooledWorker);
+    DECLARE_SPELLCHECK_WORKER(sequentialWorker);
+
+    const int threshold = SpellCheck::SpellCheckWorker::getParallelSpellCheckMinWords();
+    QStringList words = getWords(0, 3 * threshold);
+    words << "london" << "London" << "lndon";
+
+    pooledWorker.checkWords(words);
+
+    // smaller chunks are always checked on the worker thread
+    for (int i = 0; i < words.size(); i += threshold - 1) {
+        sequentialWorker.checkWords(words.mid(i, threshold - 1));
+    }
+
+    QCOMPARE(sequentialWorker.getHunspellPoolSize(), 0);
+    QCOMPARE(pooledWorker.getSpellingCache().size(), words.size());
+    QVERIFY(pooledWorker.getSpellingCache() == sequentialWorker.getSpellingCache());
+
+    auto &spellingCache = pooledWorker.getSpellingCache();
+    for (int i = 0; i < 3 * threshold; ++i) {
+        QCOMPARE(spellingCache.value(getWord(i)), isWordInDictionary(i));
+    }
+
+    // lowercase words are checked capitalized too
+    QCOMPARE(spellingCache.value("london"), true);
+    QCOMPARE(spellingCache.value("London"), true);
+    QCOMPARE(spellingCache.value("lndon"), false);
+}
+
+void SpellCheckWorkerTests::hunspellPoolIsUsedFromThresholdTest() {
+    if (QThread::idealThreadCount() < 2) {
+        QSKIP("Hunspell pool is not used with one core");
+    }
+
+    DECLARE_SPELLCHECK_WORKER(worker);
+
+    const int threshold = SpellCheck::SpellCheckWorker::getParallelSpellCheckMinWords();
+
+    worker.checkWords(getWords(0, threshold - 1));
+    QCOMPARE(worker.getHunspellPoolSize(), 0);
+
+    worker.checkWords(getWords(threshold, threshold));
+    QVERIFY(worker.getHunspellPoolSize() > 0);
+    QCOMPARE(worker.getSpellingCache().size(), 2 * threshold - 1);
+}
+
+void SpellCheckWorkerTests::duplicateWordsAreCheckedOnceTest() {
+    DECLARE_SPELLCHECK_WORKER(worker);
+
+    const int threshold = SpellCheck::SpellCheckWorker::getParallelSpellCheckMinWords();
+    const QStringList words = getWords(0, threshold - 1);
+
+    Common::BasicKeywordsModel first(m_FakeHold);
+    Common::BasicKeywordsModel second(m_FakeHold);
+    first.appendKeywords(words);
+    second.appendKeywords(words);
+
+    std::vector<std::shared_ptr<SpellCheck::ISpellCheckItem> > batch;
+    batch.emplace_back(new SpellCheck::SpellCheckItem(&first, Common::SpellCheckFlags::Keywords));
+    batch.emplace_back(new SpellCheck::SpellCheckItem(&second, Common::SpellCheckFlags::Keywords));
+    submitBatch(worker, batch);
+
+    // queries of both items exceed the threshold but unique words do not
+    QCOMPARE(worker.getHunspellPoolSize(), 0);
+    QCOMPARE(worker.getSpellingCache().size(), words.size());
+
+    for (int i = 0; i < words.size(); ++i) {
+        QCOMPARE(first.getSpellCheckResults().at(i), isWordInDictionary(i));
+        QCOMPARE(second.getSpellCheckResults().at(i), isWordInDictionary(i));
+    }
+}
+
+void SpellCheckWorkerTests::cachedWordsAreNotCheckedAgainTest() {
+    DECLARE_SPELLCHECK_WORKER(worker);
+
+    const int threshold = SpellCheck::SpellCheckWorker::getParallelSpellCheckMinWords();
+    worker.checkWords(getWords(0, threshold - 1));
+
+    const QStringList words = getWords(0, threshold + 10);
+    Common::BasicKeywordsModel model(m_FakeHold);
+    model.appendKeywords(words);
+
+    std::vector<std::shared_ptr<SpellCheck::ISpellCheckItem> > batch;
+    batch.emplace_back(new SpellCheck::SpellCheckItem(&model, Common::SpellCheckFlags::Keywords));
+    submitBatch(worker, batch);
+
+    // only words missing in the cache are checked so the batch is not pooled
+    QCOMPARE(worker.getHunspellPoolSize(), 0);
+    QCOMPARE(worker.getSpellingCache().size(), words.size());
+
+    for (int i = 0; i < words.size(); ++i) {
+        QCOMPARE(model.getSpellCheckResults().at(i), isWordInDictionary(i));
+    }
+}
+
+void SpellCheckWorkerTests::itemsSeeUserDictionaryChangesQueuedBeforeTest() {
+    DECLARE_SPELLCHECK_WORKER(worker);
+
+    Common::BasicKeywordsModel before(m_FakeHold);
+    Common::BasicKeywordsModel after(m_FakeHold);
+    before.appendKeywords(QStringList() << getWord(0) << "lndon");
+    after.appendKeywords(QStringList() << getWord(0) << "lndon");
+
+    std::vector<std::shared_ptr<SpellCheck::ISpellCheckItem> > batch;
+    batch.emplace_back(new SpellCheck::SpellCheckItem(&before, Common::SpellCheckFlags::Keywords));
+    batch.emplace_back(new SpellCheck::ModifyUserDictItem(QStringList() << "lndon"));
+    batch.emplace_back(new SpellCheck::SpellCheckItem(&after, Common::SpellCheckFlags::Keywords));
+    submitBatch(worker, batch);
+
+    QCOMPARE(worker.getUserDictionarySize(), 1);
+
+    QCOMPARE(before.getSpellCheckResults().at(0), true);
+    QCOMPARE(before.getSpellCheckResults().at(1), false);
+    QCOMPARE(after.getSpellCheckResults().at(0), true);
+    QCOMPARE(after.getSpellCheckResults().at(1), true);
+}
+
+void SpellCheckWorkerTests::spellingCacheIsResetWhenFullTest() {
+    DECLARE_SPELLCHECK_WORKER(worker);
+
+    const int threshold = SpellCheck::SpellCheckWorker::getParallelSpellCheckMinWords();
+    const int maxCachedSpellings = SpellCheck::SpellCheckWorker::getMaxCachedSpellings();
+    int nextWord = 0;
+
+    worker.checkWords(getWords(nextWord, maxCachedSpellings - 10));
+    nextWord += maxCachedSpellings - 10;
+    QCOMPARE(worker.getSpellingCache().size(), maxCachedSpellings - 10);
+
+    // sequential checks drop the cache once the next word does not fit
+    worker.checkWords(getWords(nextWord, 20));
+    nextWord += 20;
+    QCOMPARE(worker.getSpellingCache().size(), 10);
+    QVERIFY(!worker.getSpellingCache().contains(getWord(0)));
+    QVERIFY(worker.getSpellingCache().contains(getWord(nextWord - 1)));
+
+    worker.checkWords(getWords(nextWord, maxCachedSpellings - 20));
+    nextWord += maxCachedSpellings - 20;
+    QCOMPARE(worker.getSpellingCache().size(), maxCachedSpellings - 10);
+
+    worker.checkWords(getWords(nextWord, threshold));
+    nextWord += threshold;
+    QVERIFY(worker.getSpellingCache().contains(getWord(nextWord - 1)));
+
+    if (worker.getHunspellPoolSize() > 0) {
+        // pooled batch is cached as a whole after the reset
+        QCOMPARE(worker.getSpellingCache().size(), threshold);
+        QVERIFY(worker.getSpellingCache().contains(getWord(nextWord - threshold)));
+    } else {
+        QCOMPARE(worker.getSpellingCache().size(), threshold - 10);
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef SPELLCHECKWORKERTESTS_H
+#define SPELLCHECKWORKERTESTS_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include "../../xpiks-qt/Common/hold.h"
+#include "../../xpiks-qt/Models/settingsmodel.h"
+
+class SpellCheckWorkerTests: public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void pooledAndSequentialResultsAreSameTest();
+    void hunspellPoolIsUsedFromThresholdTest();
+    void duplicateWordsAreCheckedOnceTest();
+    void cachedWordsAreNotCheckedAgainTest();
+    void itemsSeeUserDictionaryChangesQueuedBeforeTest();
+    void spellingCacheIsResetWhenFullTest();
+
+private:
+    QString getAffPath() const;
+    QString getDicPath() const;
+
+private:
+    QTemporaryDir *m_TempDir;
+    Models::SettingsModel m_SettingsModel;
+    Common::Hold m_FakeHold;
+};
+
+#endif // SPELLCHECKWORKERTESTS_H
@@ -0,0 +1,98 @@
+#include "suggestionscache_tests.h"
+#include "../../xpiks-qt/SpellCheck/suggestionscache.h"
+
+void SuggestionsCacheTests::init() {
+    m_TempDir = new QTemporaryDir();
+    QVERIFY(m_TempDir->isValid());
+}
+
+void SuggestionsCacheTests::cleanup() {
+    delete m_TempDir;
+    m_TempDir = nullptr;
+}
+
+QString SuggestionsCacheTests::getCachePath() const {
+    return QDir(m_TempDir->path()).filePath("suggestions.cache");
+}
+
+void SuggestionsCacheTests::getMissingWordTest() {
+    SpellCheck::SuggestionsCache cache(10);
+    QStringList suggestions;
+    QVERIFY(!cache.tryGet("wrod", suggestions));
+    QVERIFY(!cache.contains("wrod"));
+}
+
+void SuggestionsCacheTests::insertAndGetTest() {
+    SpellCheck::SuggestionsCache cache(10);
+    cache.insert("wrod", QStringList() << "word" << "wood");
+    cache.insert("nothing", QStringList());
+
+    QStringList suggestions;
+    QVERIFY(cache.tryGet("wrod", suggestions));
+    QCOMPARE(suggestions, QStringList() << "word" << "wood");
+
+    // empty suggestions are cached too
+    QVERIFY(cache.tryGet("nothing", suggestions));
+    QVERIFY(suggestions.isEmpty());
+    QCOMPARE(cache.size(), 2);
+}
+
+void SuggestionsCacheTests::leastRecentlyUsedIsEvictedTest() {
+    SpellCheck::SuggestionsCache cache(2);
+    cache.insert("a", QStringList() << "1");
+    cache.insert("b", QStringList() << "2");
+
+    QStringList suggestions;
+    QVERIFY(cache.tryGet("a", suggestions));
+
+    cache.insert("c", QStringList() << "3");
+
+    QCOMPARE(cache.size(), 2);
+    QVERIFY(cache.contains("a"));
+    QVERIFY(!cache.contains("b"));
+    QVERIFY(cache.contains("c"));
+}
+
+void SuggestionsCacheTests::saveAndLoadTest() {
+    {
+        SpellCheck::SuggestionsCache cache(10);
+        cache.setStorage(getCachePath(), "dict1");
+        cache.insert("a", QStringList() << "1");
+        cache.insert("b", QStringList() << "2");
+        cache.insert("c", QStringList() << "3");
+
+        QStringList suggestions;
+        QVERIFY(cache.tryGet("a", suggestions));
+
+        QCOMPARE(cache.getUnsavedCount(), 3);
+        QVERIFY(cache.save());
+        QCOMPARE(cache.getUnsavedCount(), 0);
+    }
+
+    // smaller cache keeps only most recently used words
+    SpellCheck::SuggestionsCache cache(2);
+    cache.setStorage(getCachePath(), "dict1");
+    QVERIFY(cache.load());
+
+    QCOMPARE(cache.size(), 2);
+    QVERIFY(cache.contains("a"));
+    QVERIFY(cache.contains("c"));
+
+    QStringList suggestions;
+    QVERIFY(cache.tryGet("c", suggestions));
+    QCOMPARE(suggestions, QStringList() << "3");
+}
+
+void SuggestionsCacheTests::loadForOtherDictionaryTest() {
+    {
+        SpellCheck::SuggestionsCache cache(10);
+        cache.setStorage(getCachePath(), "dict1");
+        cache.insert("a", QStringList() << "1");
+        QVERIFY(cache.save());
+    }
+
+    SpellCheck::SuggestionsCache cache(10);
+    cache.setStorage(getCachePath(), "dict2");
+    QVERIFY(!cache.load());
+    QCOMPARE(cache.size(), 0);
+}
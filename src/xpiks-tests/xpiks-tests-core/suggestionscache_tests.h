@@ -0,0 +1,27 @@
+#ifndef SUGGESTIONSCACHETESTS_H
+#define SUGGESTIONSCACHETESTS_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+
+class SuggestionsCacheTests: public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+    void getMissingWordTest();
+    void insertAndGetTest();
+    void leastRecentlyUsedIsEvictedTest();
+    void saveAndLoadTest();
+    void loadForOtherDictionaryTest();
+
+private:
+    QString getCachePath() const;
+
+private:
+    QTemporaryDir *m_TempDir;
+};
+
+#endif // SUGGESTIONSCACHETESTS_H
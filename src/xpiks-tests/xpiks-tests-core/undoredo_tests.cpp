@@ -45,7 +45,7 @@ void UndoRedoTests::undoAddCommandTest() {
     QCOMPARE(artItemsMock.getArtworksCount(), 0);
 }
 
-void UndoRedoTests::undoUndoAddCommandTest() {
+void UndoRedoTests::undoRedoAddCommandTest() {
     SETUP_TEST;
 
     QStringList filenames;
@@ -61,9 +61,10 @@ void UndoRedoTests::undoUndoAddCommandTest() {
 
     bool undoSucceeded = undoRedoManager.undoLastAction();
     QVERIFY(undoSucceeded);
+    QCOMPARE(artItemsMock.getArtworksCount(), 0);
 
-    undoSucceeded = undoRedoManager.undoLastAction();
-    QVERIFY(undoSucceeded);
+    bool redoSucceeded = undoRedoManager.redoLastAction();
+    QVERIFY(redoSucceeded);
 
     QCOMPARE(artItemsMock.getArtworksCount(), filenames.length());
     for (int i = 0; i < filenames.length(); ++i) {
@@ -71,7 +72,7 @@ void UndoRedoTests::undoUndoAddCommandTest() {
     }
 }
 
-void UndoRedoTests::undoUndoAddWithVectorsTest() {
+void UndoRedoTests::undoRedoAddWithVectorsTest() {
     SETUP_TEST;
 
     QStringList filenames, vectors;
@@ -88,9 +89,10 @@ void UndoRedoTests::undoUndoAddWithVectorsTest() {
 
     bool undoSucceeded = undoRedoManager.undoLastAction();
     QVERIFY(undoSucceeded);
+    QCOMPARE(artItemsMock.getArtworksCount(), 0);
 
-    undoSucceeded = undoRedoManager.undoLastAction();
-    QVERIFY(undoSucceeded);
+    bool redoSucceeded = undoRedoManager.redoLastAction();
+    QVERIFY(redoSucceeded);
 
     QCOMPARE(newFilesCount, filenames.length());
     QCOMPARE(artItemsMock.getArtworksCount(), filenames.length());
@@ -127,7 +129,7 @@ void UndoRedoTests::undoRemoveItemsTest() {
     QCOMPARE(artItemsMock.getArtworksCount(), itemsToAdd);
 }
 
-void UndoRedoTests::undoUndoRemoveItemsTest() {
+void UndoRedoTests::undoRedoRemoveItemsTest() {
     SETUP_TEST;
     int itemsToAdd = 5;
     commandManagerMock.generateAndAddArtworks(itemsToAdd);
@@ -143,9 +145,10 @@ void UndoRedoTests::undoUndoRemoveItemsTest() {
 
     bool undoStatus = undoRedoManager.undoLastAction();
     QVERIFY(undoStatus);
+    QCOMPARE(artItemsMock.getArtworksCount(), itemsToAdd);
 
-    undoStatus = undoRedoManager.undoLastAction();
-    QVERIFY(undoStatus);
+    bool redoStatus = undoRedoManager.redoLastAction();
+    QVERIFY(redoStatus);
 
     QCOMPARE(artItemsMock.getArtworksCount(), 2);
 }
@@ -231,6 +234,138 @@ void UndoRedoTests::undoUndoModifyCommandTest() {
     QVERIFY(!undoStatus);
 }
 
+void UndoRedoTests::undoRedoModifyCommandTest() {
+    SETUP_TEST;
+    int itemsToAdd = 5;
+    commandManagerMock.generateAndAddArtworks(itemsToAdd);
+
+    QString originalTitle = "title";
+    QString originalDescription = "some description here";
+    QStringList originalKeywords = QString("test1,test2,test3").split(',');
+    std::vector<Models::MetadataElement> infos;
+
+    for (int i = 0; i < itemsToAdd; ++i) {
+        artItemsMock.getArtwork(i)->initialize(originalTitle, originalDescription, originalKeywords);
+        infos.emplace_back(artItemsMock.getArtwork(i), i);
+    }
+
+    auto flags = Common::CombinedEditFlags::EditKeywords;
+    QStringList otherKeywords = QString("another,keywords,here").split(',');
+    std::shared_ptr<Commands::CombinedEditCommand> combinedEditCommand(
+        new Commands::CombinedEditCommand(flags, infos, "", "", otherKeywords));
+    commandManagerMock.processCommand(combinedEditCommand);
+
+    bool undoStatus = undoRedoManager.undoLastAction();
+    QVERIFY(undoStatus);
+    QVERIFY(!undoRedoManager.getCanUndo());
+    QVERIFY(undoRedoManager.getCanRedo());
+
+    bool redoStatus = undoRedoManager.redoLastAction();
+    QVERIFY(redoStatus);
+    QVERIFY(undoRedoManager.getCanUndo());
+    QVERIFY(!undoRedoManager.getCanRedo());
+
+    for (int i = 0; i < itemsToAdd; ++i) {
+        Models::ArtworkMetadata *metadata = artItemsMock.getArtwork(i);
+        QCOMPARE(metadata->getDescription(), originalDescription);
+        QCOMPARE(metadata->getTitle(), originalTitle);
+        QCOMPARE(metadata->getKeywords(), otherKeywords);
+        QVERIFY(metadata->isModified());
+    }
+
+    undoStatus = undoRedoManager.undoLastAction();
+    QVERIFY(undoStatus);
+
+    for (int i = 0; i < itemsToAdd; ++i) {
+        QCOMPARE(artItemsMock.getArtwork(i)->getKeywords(), originalKeywords);
+        QVERIFY(!artItemsMock.getArtwork(i)->isModified());
+    }
+}
+
+void UndoRedoTests::multipleUndoModifyCommandTest() {
+    SETUP_TEST;
+    int itemsToAdd = 3;
+    commandManagerMock.generateAndAddArtworks(itemsToAdd);
+
+    QString originalTitle = "title";
+    QString originalDescription = "some description here";
+    QStringList originalKeywords = QString("test1,test2,test3").split(',');
+    std::vector<Models::MetadataElement> infos;
+
+    for (int i = 0; i < itemsToAdd; ++i) {
+        artItemsMock.getArtwork(i)->initialize(originalTitle, originalDescription, originalKeywords);
+        infos.emplace_back(artItemsMock.getArtwork(i), i);
+    }
+
+    QString firstTitle = "first title";
+    std::shared_ptr<Commands::CombinedEditCommand> firstEditCommand(
+        new Commands::CombinedEditCommand(Common::CombinedEditFlags::EditTitle, infos, "", firstTitle, QStringList()));
+    commandManagerMock.processCommand(firstEditCommand);
+
+    for (int i = 0; i < itemsToAdd; ++i) {
+        infos.emplace_back(artItemsMock.getArtwork(i), i);
+    }
+
+    QString secondDescription = "second description";
+    std::shared_ptr<Commands::CombinedEditCommand> secondEditCommand(
+        new Commands::CombinedEditCommand(Common::CombinedEditFlags::EditDescription, infos, secondDescription, "", QStringList()));
+    commandManagerMock.processCommand(secondEditCommand);
+
+    QCOMPARE(undoRedoManager.getUndoStackSize(), (size_t)2);
+
+    bool undoStatus = undoRedoManager.undoLastAction();
+    QVERIFY(undoStatus);
+
+    for (int i = 0; i < itemsToAdd; ++i) {
+        QCOMPARE(artItemsMock.getArtwork(i)->getDescription(), originalDescription);
+        QCOMPARE(artItemsMock.getArtwork(i)->getTitle(), firstTitle);
+    }
+
+    undoStatus = undoRedoManager.undoLastAction();
+    QVERIFY(undoStatus);
+
+    for (int i = 0; i < itemsToAdd; ++i) {
+        QCOMPARE(artItemsMock.getArtwork(i)->getDescription(), originalDescription);
+        QCOMPARE(artItemsMock.getArtwork(i)->getTitle(), originalTitle);
+        QCOMPARE(artItemsMock.getArtwork(i)->getKeywords(), originalKeywords);
+    }
+
+    QVERIFY(!undoRedoManager.getCanUndo());
+    QCOMPARE(undoRedoManager.getRedoStackSize(), (size_t)2);
+}
+
+void UndoRedoTests::newActionClearsRedoTest() {
+    SETUP_TEST;
+    int itemsToAdd = 3;
+    commandManagerMock.generateAndAddArtworks(itemsToAdd);
+
+    std::vector<Models::MetadataElement> infos;
+    for (int i = 0; i < itemsToAdd; ++i) {
+        artItemsMock.getArtwork(i)->initialize("title", "description", QStringList() << "keyword");
+        infos.emplace_back(artItemsMock.getArtwork(i), i);
+    }
+
+    std::shared_ptr<Commands::CombinedEditCommand> firstEditCommand(
+        new Commands::CombinedEditCommand(Common::CombinedEditFlags::EditTitle, infos, "", "first title", QStringList()));
+    commandManagerMock.processCommand(firstEditCommand);
+
+    bool undoStatus = undoRedoManager.undoLastAction();
+    QVERIFY(undoStatus);
+    QVERIFY(undoRedoManager.getCanRedo());
+
+    for (int i = 0; i < itemsToAdd; ++i) {
+        infos.emplace_back(artItemsMock.getArtwork(i), i);
+    }
+
+    std::shared_ptr<Commands::CombinedEditCommand> secondEditCommand(
+        new Commands::CombinedEditCommand(Common::CombinedEditFlags::EditTitle, infos, "", "second title", QStringList()));
+    commandManagerMock.processCommand(secondEditCommand);
+
+    QVERIFY(undoRedoManager.getCanUndo());
+    QVERIFY(!undoRedoManager.getCanRedo());
+    QVERIFY(!undoRedoManager.redoLastAction());
+}
+
 void UndoRedoTests::undoPasteCommandTest() {
     SETUP_TEST;
     int itemsToAdd = 5;
@@ -396,3 +531,44 @@ void UndoRedoTests::undoReplaceCommandTest() {
         QVERIFY(!artItemsMock.getArtwork(i)->isModified());
     }
 }
+
+void UndoRedoTests::undoPartialReplaceCommandTest() {
+    SETUP_TEST;
+    int itemsToAdd = 6;
+    Models::FilteredArtItemsProxyModel filteredItemsModel;
+    filteredItemsModel.setSourceModel(artItemsModel);
+    commandManagerMock.InjectDependency(&filteredItemsModel);
+    commandManagerMock.generateAndAddArtworks(itemsToAdd);
+
+    for (int i = 0; i < itemsToAdd; i++) {
+        Models::ArtworkMetadata *metadata = artItemsModel->getArtwork(i);
+        QString text = (i % 2 == 0) ? QString("ReplaceMe %1").arg(i) : QString("KeepMe %1").arg(i);
+        metadata->initialize(text, text, QStringList() << text);
+    }
+
+    QString replaceTo = "Replaced";
+    QString replaceFrom = "Replace";
+    auto flags = Common::SearchFlags::CaseSensitive |Common::SearchFlags::Description |
+                Common::SearchFlags::Title | Common::SearchFlags::Keywords;
+    // selected artworks without a match should not shift the undo backups
+    std::vector<Models::PreviewMetadataElement> artWorksInfo = filteredItemsModel.getAllPreviewOriginalItems();
+    std::shared_ptr<Commands::FindAndReplaceCommand> replaceCommand(new Commands::FindAndReplaceCommand(artWorksInfo, replaceFrom, replaceTo, flags) );
+    auto result = commandManagerMock.processCommand(replaceCommand);
+
+    for (int i = 0; i < itemsToAdd; i++) {
+        Models::ArtworkMetadata *metadata = artItemsMock.getArtwork(i);
+        QCOMPARE(metadata->isModified(), i % 2 == 0);
+    }
+
+    bool undoStatus = undoRedoManager.undoLastAction();
+    QVERIFY(undoStatus);
+
+    for (int i = 0; i < itemsToAdd; ++i) {
+        Models::ArtworkMetadata *metadata = artItemsMock.getArtwork(i);
+        QString text = (i % 2 == 0) ? QString("ReplaceMe %1").arg(i) : QString("KeepMe %1").arg(i);
+        QCOMPARE(metadata->getDescription(), text);
+        QCOMPARE(metadata->getTitle(), text);
+        QCOMPARE(metadata->getKeywords(), QStringList() << text);
+        QVERIFY(!metadata->isModified());
+    }
+}
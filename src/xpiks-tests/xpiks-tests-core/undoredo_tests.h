@@ -9,16 +9,20 @@ class UndoRedoTests : public QObject
     Q_OBJECT
 private slots:
     void undoAddCommandTest();
-    void undoUndoAddCommandTest();
-    void undoUndoAddWithVectorsTest();
+    void undoRedoAddCommandTest();
+    void undoRedoAddWithVectorsTest();
     void undoRemoveItemsTest();
-    void undoUndoRemoveItemsTest();
+    void undoRedoRemoveItemsTest();
     void undoModifyCommandTest();
     void undoUndoModifyCommandTest();
+    void undoRedoModifyCommandTest();
+    void multipleUndoModifyCommandTest();
+    void newActionClearsRedoTest();
     void undoPasteCommandTest();
     void undoClearAllTest();
     void undoClearKeywordsTest();
     void undoReplaceCommandTest();
+    void undoPartialReplaceCommandTest();
 };
 
 #endif // UNDOREDOTESTS_H
@@ -79,7 +79,10 @@ SOURCES += main.cpp \
     ../../xpiks-qt/Models/artworksrepository.cpp \
     addcommand_tests.cpp \
     ../../xpiks-qt/Models/artitemsmodel.cpp \
+    ../../xpiks-qt/Models/directoryscanner.cpp \
+    ../../xpiks-qt/Models/fileschangemonitor.cpp \
         ../../xpiks-qt/Models/filteredartitemsproxymodel.cpp \
+        ../../xpiks-qt/Models/artworkssearchindex.cpp \
     ../../xpiks-qt/Commands/addartworkscommand.cpp \
     ../../xpiks-qt/Models/artworksprocessor.cpp \
     ../../xpiks-qt/Models/combinedartworksmodel.cpp \
@@ -104,6 +107,10 @@ SOURCES += main.cpp \
     ../../xpiks-qt/SpellCheck/spellcheckerservice.cpp \
     ../../xpiks-qt/SpellCheck/spellcheckitem.cpp \
     ../../xpiks-qt/SpellCheck/spellcheckworker.cpp \
+    ../../xpiks-qt/SpellCheck/suggestionscache.cpp \
+    ../../xpiks-qt/QMLExtensions/decodedimagecache.cpp \
+    ../../xpiks-qt/QMLExtensions/imagecacheindex.cpp \
+    ../../xpiks-qt/SpellCheck/suggestionsworker.cpp \
     ../../xpiks-qt/SpellCheck/spellchecksuggestionmodel.cpp \
     ../../xpiks-qt/MetadataIO/backupsaverservice.cpp \
     ../../xpiks-qt/MetadataIO/backupsaverworker.cpp \
@@ -126,11 +133,18 @@ SOURCES += main.cpp \
     ../../xpiks-qt/MetadataIO/metadatareadingworker.cpp \
     ../../xpiks-qt/MetadataIO/saverworkerjobitem.cpp \
     ../../xpiks-qt/Suggestion/locallibrary.cpp \
+    ../../xpiks-qt/Suggestion/locallibraryindex.cpp \
+    ../../xpiks-qt/Suggestion/librarystorage.cpp \
     ../../xpiks-qt/Suggestion/libraryloaderworker.cpp \
     ../../xpiks-qt/MetadataIO/metadatawritingworker.cpp \
+    ../../xpiks-qt/MetadataIO/backupslookup.cpp \
+    ../../xpiks-qt/MetadataIO/exiftoolprocess.cpp \
+    ../../xpiks-qt/MetadataIO/exiftoolworker.cpp \
+    ../../xpiks-qt/MetadataIO/exiftoolservice.cpp \
     filteredmodel_tests.cpp \
     conectivityhelpers_tests.cpp \
     ../../xpiks-qt/Conectivity/conectivityhelpers.cpp \
+    ../../xpiks-qt/Conectivity/archivespipeline.cpp \
     undoredo_tests.cpp \
     ../../xpiks-qt/Helpers/filterhelpers.cpp \
     artworkfilter_tests.cpp \
@@ -145,10 +159,12 @@ SOURCES += main.cpp \
     fixspelling_tests.cpp \
     deleteoldlogstest.cpp \
     ../../xpiks-qt/Helpers/deletelogshelper.cpp \
+    ../../xpiks-qt/Helpers/logger.cpp \
     ../../xpiks-qt/Models/findandreplacemodel.cpp \
     replacepreview_tests.cpp \
     replace_tests.cpp \
     stringhelpersfortests.cpp \
+    filehelpersfortests.cpp \
     ../../xpiks-qt/Models/artworksviewmodel.cpp \
     deletekeywords_tests.cpp \
     ../../xpiks-qt/Models/deletekeywordsviewmodel.cpp \
@@ -161,6 +177,18 @@ SOURCES += main.cpp \
     preset_tests.cpp \
     ../../xpiks-qt/Commands/expandpresetcommand.cpp \
     quickbuffer_tests.cpp \
+    locallibraryindex_tests.cpp \
+    librarystorage_tests.cpp \
+    suggestionscache_tests.cpp \
+    artworkssearchindex_tests.cpp \
+    directoryscanner_tests.cpp \
+    fileschangemonitor_tests.cpp \
+    itemprocessingworker_tests.cpp \
+    decodedimagecache_tests.cpp \
+    archivespipeline_tests.cpp \
+    exiftool_tests.cpp \
+    imagecacheindex_tests.cpp \
+    spellcheckworker_tests.cpp \
     ../../xpiks-qt/QuickBuffer/currenteditableartwork.cpp \
     ../../xpiks-qt/QuickBuffer/currenteditableproxyartwork.cpp \
     ../../xpiks-qt/QuickBuffer/quickbuffer.cpp \
@@ -182,7 +210,10 @@ HEADERS += \
     ../../xpiks-qt/Models/artworksrepository.h \
     addcommand_tests.h \
     ../../xpiks-qt/Models/artitemsmodel.h \
+    ../../xpiks-qt/Models/directoryscanner.h \
+    ../../xpiks-qt/Models/fileschangemonitor.h \
         ../../xpiks-qt/Models/filteredartitemsproxymodel.h \
+        ../../xpiks-qt/Models/artworkssearchindex.h \
     Mocks/artitemsmodelmock.h \
     ../../xpiks-qt/Commands/addartworkscommand.h \
     ../../xpiks-qt/Models/artworksprocessor.h \
@@ -213,6 +244,11 @@ HEADERS += \
     ../../xpiks-qt/SpellCheck/spellcheckerservice.h \
     ../../xpiks-qt/SpellCheck/spellcheckitem.h \
     ../../xpiks-qt/SpellCheck/spellcheckworker.h \
+    ../../xpiks-qt/SpellCheck/suggestionscache.h \
+    ../../xpiks-qt/QMLExtensions/decodedimagecache.h \
+    ../../xpiks-qt/QMLExtensions/imagecacheindex.h \
+    ../../xpiks-qt/QMLExtensions/imagecacherequest.h \
+    ../../xpiks-qt/SpellCheck/suggestionsworker.h \
     ../../xpiks-qt/SpellCheck/spellchecksuggestionmodel.h \
     ../../xpiks-qt/MetadataIO/backupsaverservice.h \
     ../../xpiks-qt/MetadataIO/backupsaverworker.h \
@@ -231,12 +267,21 @@ HEADERS += \
     keywordvalidation_tests.h \
     artworkrepository_tests.h \
     ../../xpiks-qt/Common/itemprocessingworker.h \
+    ../../xpiks-qt/Common/sharedworkqueue.h \
+    ../../xpiks-qt/Common/boundedmpmcqueue.h \
     ../../xpiks-qt/MetadataIO/metadataiocoordinator.h \
     ../../xpiks-qt/MetadataIO/metadatareadingworker.h \
     ../../xpiks-qt/MetadataIO/saverworkerjobitem.h \
     ../../xpiks-qt/Suggestion/locallibrary.h \
+    ../../xpiks-qt/Suggestion/locallibraryindex.h \
+    ../../xpiks-qt/Suggestion/librarystorage.h \
     ../../xpiks-qt/Suggestion/libraryloaderworker.h \
     ../../xpiks-qt/MetadataIO/metadatawritingworker.h \
+    ../../xpiks-qt/MetadataIO/exiftoolprocess.h \
+    ../../xpiks-qt/MetadataIO/exiftoolworker.h \
+    ../../xpiks-qt/MetadataIO/exiftoolservice.h \
+    ../../xpiks-qt/MetadataIO/exiftooljob.h \
+    ../../xpiks-qt/MetadataIO/backupslookup.h \
     filteredmodel_tests.h \
     ../../xpiks-qt/Common/baseentity.h \
     ../../xpiks-qt/Common/defines.h \
@@ -254,6 +299,7 @@ HEADERS += \
     ../../xpiks-qt/Helpers/filterhelpers.h \
     artworkfilter_tests.h \
     ../../xpiks-qt/Conectivity/iftpcoordinator.h \
+    ../../xpiks-qt/Conectivity/archivespipeline.h \
     ../../xpiks-qt/Models/ziparchiver.h \
     removefilesfs_tests.h \
     Mocks/artworksrepositorymock.h \
@@ -268,10 +314,12 @@ HEADERS += \
     fixspelling_tests.h \
     Mocks/spellcheckservicemock.h \
     ../../xpiks-qt/Helpers/deletelogshelper.h \
+    ../../xpiks-qt/Helpers/logger.h \
     ../../xpiks-qt/Models/findandreplacemodel.h \
     replacepreview_tests.h \
     replace_tests.h \
     stringhelpersfortests.h \
+    filehelpersfortests.h \
     ../../xpiks-qt/Models/artworksviewmodel.h \
     deletekeywords_tests.h \
     ../../xpiks-qt/Models/deletekeywordsviewmodel.h \
@@ -286,6 +334,18 @@ HEADERS += \
     preset_tests.h \
     ../../xpiks-qt/Commands/expandpresetcommand.h \
     quickbuffer_tests.h \
+    locallibraryindex_tests.h \
+    librarystorage_tests.h \
+    suggestionscache_tests.h \
+    artworkssearchindex_tests.h \
+    directoryscanner_tests.h \
+    fileschangemonitor_tests.h \
+    itemprocessingworker_tests.h \
+    decodedimagecache_tests.h \
+    archivespipeline_tests.h \
+    exiftool_tests.h \
+    imagecacheindex_tests.h \
+    spellcheckworker_tests.h \
     ../../xpiks-qt/QuickBuffer/currenteditableartwork.h \
     ../../xpiks-qt/QuickBuffer/currenteditableproxyartwork.h \
     ../../xpiks-qt/QuickBuffer/icurrenteditable.h \
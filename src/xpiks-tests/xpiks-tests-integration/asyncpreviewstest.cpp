@@ -0,0 +1,80 @@
+#include "asyncpreviewstest.h"
+#include <QTemporaryDir>
+#include <QFile>
+#include <QDir>
+#include <memory>
+#include <vector>
+#include "signalwaiter.h"
+#include "../../xpiks-qt/QMLExtensions/imagecachingservice.h"
+#include "../../xpiks-qt/QMLExtensions/asynccachingimageprovider.h"
+
+#define SAME_PREVIEW_REQUESTS 3
+
+QString AsyncPreviewsTest::testName() {
+    return QLatin1String("AsyncPreviewsTest");
+}
+
+void AsyncPreviewsTest::setup() {
+}
+
+int AsyncPreviewsTest::doTest() {
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 6, 0))
+    QTemporaryDir tempDir;
+    VERIFY(tempDir.isValid(), "Failed to create temporary directory");
+
+    // unique paths make sure previews are not cached yet
+    QString original = getFilePathForTest("images-for-tests/vector/026.jpg").toLocalFile();
+    QString visiblePath = QDir(tempDir.path()).filePath("visible.jpg");
+    QString scrolledPath = QDir(tempDir.path()).filePath("scrolled.jpg");
+    VERIFY(QFile::copy(original, visiblePath), "Failed to copy test image");
+    VERIFY(QFile::copy(original, scrolledPath), "Failed to copy test image");
+
+    QMLExtensions::ImageCachingService cachingService;
+    cachingService.startService();
+
+    QMLExtensions::AsyncCachingImageProvider provider;
+    provider.setImageCachingService(&cachingService);
+
+    const QSize requestedSize(150, 150);
+    std::vector<std::unique_ptr<QQuickImageResponse> > responses;
+    SignalWaiter allFinishedWaiter;
+    int finishedCount = 0;
+
+    for (int i = 0; i < SAME_PREVIEW_REQUESTS; ++i) {
+        responses.emplace_back(provider.requestImageResponse(visiblePath, requestedSize));
+        QObject::connect(responses.back().get(), &QQuickImageResponse::finished, &allFinishedWaiter, [&]() {
+            finishedCount++;
+            if (finishedCount == SAME_PREVIEW_REQUESTS) { emit allFinishedWaiter.finished(); }
+        });
+    }
+
+    if (!allFinishedWaiter.wait(20)) {
+        VERIFY(false, "Timeout exceeded for previews");
+    }
+
+    for (auto &response: responses) {
+        std::unique_ptr<QQuickTextureFactory> factory(response->textureFactory());
+        VERIFY(factory, "Preview is empty");
+        QSize previewSize = factory->textureSize();
+        VERIFY((previewSize.width() <= requestedSize.width()) && (previewSize.height() <= requestedSize.height()),
+               "Preview was not downscaled");
+    }
+
+    QString cachedPath;
+    bool needsUpdate = false;
+    VERIFY(cachingService.tryGetCachedImage(visiblePath, requestedSize, cachedPath, needsUpdate), "Preview was not cached");
+
+    std::unique_ptr<QQuickImageResponse> scrolledResponse(provider.requestImageResponse(scrolledPath, requestedSize));
+    SignalWaiter cancelWaiter;
+    QObject::connect(scrolledResponse.get(), SIGNAL(finished()), &cancelWaiter, SIGNAL(finished()));
+    scrolledResponse->cancel();
+
+    if (!cancelWaiter.wait(20)) {
+        VERIFY(false, "Cancelled preview was not finished");
+    }
+
+    cachingService.stopService();
+#endif
+
+    return 0;
+}
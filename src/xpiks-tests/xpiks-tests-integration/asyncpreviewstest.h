@@ -0,0 +1,20 @@
+#ifndef ASYNCPREVIEWSTEST_H
+#define ASYNCPREVIEWSTEST_H
+
+#include "integrationtestbase.h"
+
+class AsyncPreviewsTest : public IntegrationTestBase
+{
+public:
+    AsyncPreviewsTest(Commands::CommandManager *commandManager):
+        IntegrationTestBase(commandManager)
+    {}
+
+    // IntegrationTestBase interface
+public:
+    virtual QString testName();
+    virtual void setup();
+    virtual int doTest();
+};
+
+#endif // ASYNCPREVIEWSTEST_H
@@ -53,15 +53,30 @@ int FindAndReplaceModelTest::doTest() {
     findAndReplaceModel->setReplaceFrom("wall");
     findAndReplaceModel->setReplaceTo("wallpaper");
     findAndReplaceModel->setSearchWholeWords(true);
+
+    SignalWaiter previewWaiter;
+    QObject::connect(findAndReplaceModel, SIGNAL(previewFinished()), &previewWaiter, SIGNAL(finished()));
+
     findAndReplaceModel->initArtworksList();
 
+    if (!previewWaiter.wait(20)) {
+        VERIFY(false, "Timeout exceeded for replace preview.");
+    }
+
     VERIFY(findAndReplaceModel->getArtworksCount() == 2, "Items are missing!");
     findAndReplaceModel->setItemSelected(1, false);
 
     int keywordsCount = artItemsModel->getBasicModel(0)->getKeywordsCount();
 
+    SignalWaiter replaceWaiter;
+    QObject::connect(findAndReplaceModel, SIGNAL(replaceSucceeded()), &replaceWaiter, SIGNAL(finished()));
+
     findAndReplaceModel->replace();
 
+    if (!replaceWaiter.wait(20)) {
+        VERIFY(false, "Timeout exceeded for replace.");
+    }
+
     VERIFY(artItemsModel->getBasicModel(0)->getKeywordsCount() == (keywordsCount - 1), "Keyword duplicate wasn't removed");
     VERIFY(artItemsModel->getBasicModel(0)->getKeywords().last() == "wallpaper", "Keyword wasn't replaced");
     VERIFY(artItemsModel->getBasicModel(0)->getDescription() == "wallpaper inside the Wall is not a wallpaper", "Description wasn't replaced");
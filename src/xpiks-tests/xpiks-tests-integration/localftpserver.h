@@ -0,0 +1,254 @@
+#ifndef LOCALFTPSERVER
+#define LOCALFTPSERVER
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QByteArray>
+#include <QString>
+#include <QHash>
+
+// minimal passive mode ftp server which keeps uploaded files in memory
+class LocalFtpServer: public QObject {
+    Q_OBJECT
+public:
+    LocalFtpServer(QObject *parent=0):
+        QObject(parent),
+        m_ConnectionsCount(0),
+        m_LoginsCount(0),
+        m_AppendsCount(0),
+        m_FailAfterBytes(-1)
+    {
+        QObject::connect(&m_Server, SIGNAL(newConnection()), this, SLOT(onNewConnection()));
+    }
+
+    bool start() { return m_Server.listen(QHostAddress::LocalHost, 0); }
+    QString getHost() const { return QString("127.0.0.1:%1").arg(m_Server.serverPort()); }
+    int getConnectionsCount() const { return m_ConnectionsCount; }
+    int getLoginsCount() const { return m_LoginsCount; }
+    int getAppendsCount() const { return m_AppendsCount; }
+    QByteArray getFile(const QString &filename) const { return m_Files.value(filename); }
+
+    // first upload of the file is dropped after receiving this number of bytes
+    void failUploadOnce(const QString &filename, int afterBytes) {
+        m_FailFilename = filename;
+        m_FailAfterBytes = afterBytes;
+    }
+
+private:
+    struct Session {
+        Session(): m_PassiveServer(nullptr), m_DataSocket(nullptr),
+            m_IsAppend(false), m_IsTransferring(false), m_IsDataFinished(false) {}
+
+        QByteArray m_Buffer;
+        QTcpServer *m_PassiveServer;
+        QTcpSocket *m_DataSocket;
+        QByteArray m_Data;
+        QString m_Filename;
+        bool m_IsAppend;
+        bool m_IsTransferring;
+        bool m_IsDataFinished;
+    };
+
+private slots:
+    void onNewConnection() {
+        while (m_Server.hasPendingConnections()) {
+            QTcpSocket *socket = m_Server.nextPendingConnection();
+            m_ConnectionsCount++;
+            m_Sessions.insert(socket, Session());
+            QObject::connect(socket, SIGNAL(readyRead()), this, SLOT(onControlReadyRead()));
+            QObject::connect(socket, SIGNAL(disconnected()), this, SLOT(onControlDisconnected()));
+            reply(socket, "220 Ready");
+        }
+    }
+
+    void onControlReadyRead() {
+        QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+        if (!m_Sessions.contains(socket)) { return; }
+
+        m_Sessions[socket].m_Buffer.append(socket->readAll());
+
+        int lineEnd = -1;
+        while (m_Sessions.contains(socket) &&
+               (lineEnd = m_Sessions[socket].m_Buffer.indexOf("\r\n")) != -1) {
+            QByteArray &buffer = m_Sessions[socket].m_Buffer;
+            const QString line = QString::fromUtf8(buffer.left(lineEnd));
+            buffer.remove(0, lineEnd + 2);
+            processCommand(socket, line);
+        }
+    }
+
+    void onControlDisconnected() {
+        QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+        auto it = m_Sessions.find(socket);
+        if (it != m_Sessions.end()) {
+            closeDataConnection(it.value());
+            m_Sessions.erase(it);
+        }
+
+        socket->deleteLater();
+    }
+
+    void onDataConnection() {
+        QTcpServer *passiveServer = qobject_cast<QTcpServer *>(sender());
+        QTcpSocket *control = m_DataOwners.value(passiveServer, nullptr);
+        if ((control == nullptr) || !m_Sessions.contains(control)) { return; }
+
+        Session &session = m_Sessions[control];
+        session.m_DataSocket = passiveServer->nextPendingConnection();
+        m_DataOwners.insert(session.m_DataSocket, control);
+        QObject::connect(session.m_DataSocket, SIGNAL(readyRead()), this, SLOT(onDataReadyRead()));
+        QObject::connect(session.m_DataSocket, SIGNAL(disconnected()), this, SLOT(onDataDisconnected()));
+
+        // only one data connection is expected per passive command
+        passiveServer->close();
+    }
+
+    void onDataReadyRead() {
+        QTcpSocket *dataSocket = qobject_cast<QTcpSocket *>(sender());
+        QTcpSocket *control = m_DataOwners.value(dataSocket, nullptr);
+        if ((control == nullptr) || !m_Sessions.contains(control)) { return; }
+
+        Session &session = m_Sessions[control];
+        session.m_Data.append(dataSocket->readAll());
+
+        if (session.m_IsTransferring && !session.m_IsAppend &&
+                (session.m_Filename == m_FailFilename) &&
+                (session.m_Data.size() >= m_FailAfterBytes)) {
+            m_FailFilename.clear();
+            m_Files.insert(session.m_Filename, session.m_Data.left(m_FailAfterBytes));
+
+            closeDataConnection(session);
+            session.m_IsTransferring = false;
+            reply(control, "426 Connection closed; transfer aborted");
+        }
+    }
+
+    void onDataDisconnected() {
+        QTcpSocket *dataSocket = qobject_cast<QTcpSocket *>(sender());
+        QTcpSocket *control = m_DataOwners.value(dataSocket, nullptr);
+        if ((control == nullptr) || !m_Sessions.contains(control)) { return; }
+
+        Session &session = m_Sessions[control];
+        session.m_Data.append(dataSocket->readAll());
+        session.m_IsDataFinished = true;
+        tryFinishTransfer(control, session);
+    }
+
+private:
+    void processCommand(QTcpSocket *control, const QString &line) {
+        const QString command = line.section(' ', 0, 0).toUpper();
+        const QString argument = line.section(' ', 1);
+        Session &session = m_Sessions[control];
+
+        if (command == "USER") {
+            reply(control, "331 Password required");
+        } else if (command == "PASS") {
+            m_LoginsCount++;
+            reply(control, "230 Logged in");
+        } else if (command == "PWD") {
+            reply(control, "257 \"/\" is current directory");
+        } else if ((command == "CWD") || (command == "MKD")) {
+            reply(control, "250 Ok");
+        } else if ((command == "TYPE") || (command == "NOOP")) {
+            reply(control, "200 Ok");
+        } else if (command == "REST") {
+            reply(control, "350 Restart position accepted");
+        } else if (command == "SIZE") {
+            const QString filename = getFilename(argument);
+            if (m_Files.contains(filename)) {
+                reply(control, "213 " + QString::number(m_Files.value(filename).size()));
+            } else {
+                reply(control, "550 File not found");
+            }
+        } else if ((command == "EPSV") || (command == "PASV")) {
+            const quint16 port = openPassiveServer(control, session);
+            if (command == "EPSV") {
+                reply(control, QString("229 Entering Extended Passive Mode (|||%1|)").arg(port));
+            } else {
+                reply(control, QString("227 Entering Passive Mode (127,0,0,1,%1,%2)").arg(port / 256).arg(port % 256));
+            }
+        } else if ((command == "STOR") || (command == "APPE")) {
+            session.m_Filename = getFilename(argument);
+            session.m_IsAppend = (command == "APPE");
+            session.m_IsTransferring = true;
+            if (session.m_IsAppend) { m_AppendsCount++; }
+
+            reply(control, "150 Ok to send data");
+            tryFinishTransfer(control, session);
+        } else if (command == "QUIT") {
+            reply(control, "221 Bye");
+            control->disconnectFromHost();
+        } else {
+            reply(control, "502 Command not implemented");
+        }
+    }
+
+    quint16 openPassiveServer(QTcpSocket *control, Session &session) {
+        closeDataConnection(session);
+
+        session.m_PassiveServer = new QTcpServer(this);
+        m_DataOwners.insert(session.m_PassiveServer, control);
+        QObject::connect(session.m_PassiveServer, SIGNAL(newConnection()), this, SLOT(onDataConnection()));
+        session.m_PassiveServer->listen(QHostAddress::LocalHost, 0);
+
+        return session.m_PassiveServer->serverPort();
+    }
+
+    void tryFinishTransfer(QTcpSocket *control, Session &session) {
+        if (!session.m_IsTransferring || !session.m_IsDataFinished) { return; }
+
+        if (session.m_IsAppend) {
+            m_Files[session.m_Filename].append(session.m_Data);
+        } else {
+            m_Files.insert(session.m_Filename, session.m_Data);
+        }
+
+        closeDataConnection(session);
+        session.m_IsTransferring = false;
+        reply(control, "226 Transfer complete");
+    }
+
+    void closeDataConnection(Session &session) {
+        if (session.m_DataSocket != nullptr) {
+            m_DataOwners.remove(session.m_DataSocket);
+            session.m_DataSocket->disconnect(this);
+            session.m_DataSocket->abort();
+            session.m_DataSocket->deleteLater();
+            session.m_DataSocket = nullptr;
+        }
+
+        if (session.m_PassiveServer != nullptr) {
+            m_DataOwners.remove(session.m_PassiveServer);
+            session.m_PassiveServer->close();
+            session.m_PassiveServer->deleteLater();
+            session.m_PassiveServer = nullptr;
+        }
+
+        session.m_Data.clear();
+        session.m_IsDataFinished = false;
+    }
+
+    static QString getFilename(const QString &path) {
+        return path.section('/', -1);
+    }
+
+    static void reply(QTcpSocket *control, const QString &response) {
+        control->write(response.toUtf8() + "\r\n");
+    }
+
+private:
+    QTcpServer m_Server;
+    QHash<QTcpSocket*, Session> m_Sessions;
+    // passive servers and data sockets to their control connections
+    QHash<QObject*, QTcpSocket*> m_DataOwners;
+    QHash<QString, QByteArray> m_Files;
+    QString m_FailFilename;
+    int m_ConnectionsCount;
+    int m_LoginsCount;
+    int m_AppendsCount;
+    int m_FailAfterBytes;
+};
+
+#endif // LOCALFTPSERVER
@@ -0,0 +1,66 @@
+#ifndef LOCALHTTPSERVER
+#define LOCALHTTPSERVER
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QByteArray>
+#include <QHash>
+
+// minimal keep-alive http server standing in for remote apis
+class LocalHttpServer: public QObject {
+    Q_OBJECT
+public:
+    LocalHttpServer(const QByteArray &responseBody, QObject *parent=0):
+        QObject(parent),
+        m_ResponseBody(responseBody),
+        m_ConnectionsCount(0),
+        m_RequestsCount(0)
+    {
+        QObject::connect(&m_Server, SIGNAL(newConnection()), this, SLOT(onNewConnection()));
+    }
+
+    bool start() { return m_Server.listen(QHostAddress::LocalHost, 0); }
+    QString getUrl() const { return QString("http://127.0.0.1:%1/").arg(m_Server.serverPort()); }
+    int getConnectionsCount() const { return m_ConnectionsCount; }
+    int getRequestsCount() const { return m_RequestsCount; }
+
+private slots:
+    void onNewConnection() {
+        while (m_Server.hasPendingConnections()) {
+            QTcpSocket *socket = m_Server.nextPendingConnection();
+            m_ConnectionsCount++;
+            QObject::connect(socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+            QObject::connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+        }
+    }
+
+    void onReadyRead() {
+        QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+        QByteArray &buffer = m_Buffers[socket];
+        buffer.append(socket->readAll());
+
+        int headersEnd = -1;
+        while ((headersEnd = buffer.indexOf("\r\n\r\n")) != -1) {
+            buffer.remove(0, headersEnd + 4);
+            m_RequestsCount++;
+
+            QByteArray response = "HTTP/1.1 200 OK\r\n"
+                                  "Content-Type: application/json\r\n"
+                                  "Connection: keep-alive\r\n"
+                                  "Content-Length: " + QByteArray::number(m_ResponseBody.size()) + "\r\n\r\n";
+            response.append(m_ResponseBody);
+            socket->write(response);
+        }
+    }
+
+private:
+    QTcpServer m_Server;
+    QHash<QTcpSocket*, QByteArray> m_Buffers;
+    QByteArray m_ResponseBody;
+    int m_ConnectionsCount;
+    int m_RequestsCount;
+};
+
+#endif // LOCALHTTPSERVER
@@ -81,6 +81,9 @@
 #include "translatorbasictest.h"
 #include "userdictedittest.h"
 #include "weirdnamesreadtest.h"
+#include "pooledrequeststest.h"
+#include "parallelftpuploadtest.h"
+#include "asyncpreviewstest.h"
 
 #if defined(WITH_LOGS)
 #undef WITH_LOGS
@@ -256,6 +259,9 @@ int main(int argc, char *argv[]) {
     integrationTests.append(new TranslatorBasicTest(&commandManager));
     integrationTests.append(new UserDictEditTest(&commandManager));
     integrationTests.append(new WeirdNamesReadTest(&commandManager));
+    integrationTests.append(new PooledRequestsTest(&commandManager));
+    integrationTests.append(new ParallelFtpUploadTest(&commandManager));
+    integrationTests.append(new AsyncPreviewsTest(&commandManager));
 
     qDebug("\n");
     int succeededTestsCount = 0, failedTestsCount = 0;
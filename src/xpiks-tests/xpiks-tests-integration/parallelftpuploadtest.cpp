@@ -0,0 +1,104 @@
+#include "parallelftpuploadtest.h"
+#include <QUrl>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+#include <QSignalSpy>
+#include <memory>
+#include "localftpserver.h"
+#include "../../xpiks-qt/Conectivity/curlftpuploader.h"
+#include "../../xpiks-qt/Conectivity/uploadbatch.h"
+#include "../../xpiks-qt/Conectivity/uploadcontext.h"
+
+static std::shared_ptr<Conectivity::UploadContext> createContext(const LocalFtpServer &server, int maxConnections) {
+    std::shared_ptr<Conectivity::UploadContext> context(new Conectivity::UploadContext());
+    context->m_Host = server.getHost();
+    context->m_Username = "xpiks";
+    context->m_Password = "password";
+    context->m_UsePassiveMode = true;
+    context->m_UseEPSV = true;
+    context->m_RetriesCount = 3;
+    context->m_TimeoutSeconds = 10;
+    context->m_UseProxy = false;
+    context->m_VerboseLogging = false;
+    context->m_ProxySettings = nullptr;
+    context->m_MaxConnections = maxConnections;
+    return context;
+}
+
+static bool isUploaded(const LocalFtpServer &server, const QString &filepath) {
+    QFile file(filepath);
+    if (!file.open(QIODevice::ReadOnly)) { return false; }
+
+    return server.getFile(QFileInfo(filepath).fileName()) == file.readAll();
+}
+
+QString ParallelFtpUploadTest::testName() {
+    return QLatin1String("ParallelFtpUploadTest");
+}
+
+void ParallelFtpUploadTest::setup() {
+}
+
+int ParallelFtpUploadTest::doTest() {
+    QStringList files;
+    files << getFilePathForTest("images-for-tests/mixed/026.jpg").toLocalFile();
+    files << getFilePathForTest("images-for-tests/mixed/027.jpg").toLocalFile();
+    files << getFilePathForTest("images-for-tests/mixed/0267.jpg").toLocalFile();
+    files << getFilePathForTest("images-for-tests/mixed/026.eps").toLocalFile();
+    files << getFilePathForTest("images-for-tests/mixed/027.eps").toLocalFile();
+
+    // files of the batch share control connections
+    {
+        LocalFtpServer server;
+        VERIFY(server.start(), "Failed to start local ftp server");
+
+        const int maxConnections = 2;
+        std::shared_ptr<Conectivity::UploadBatch> batch(new Conectivity::UploadBatch(createContext(server, maxConnections), files));
+        Conectivity::CurlFtpUploader uploader(batch);
+
+        QSignalSpy failedSpy(&uploader, SIGNAL(transferFailed(QString, QString)));
+        QSignalSpy finishedSpy(&uploader, SIGNAL(uploadFinished(bool)));
+
+        uploader.uploadBatch();
+
+        VERIFY(finishedSpy.count() == 1, "Upload did not finish");
+        VERIFY(finishedSpy.at(0).at(0).toBool() == false, "Upload finished with errors");
+        VERIFY(failedSpy.count() == 0, "Some files failed to upload");
+
+        foreach (const QString &filepath, files) {
+            VERIFY(isUploaded(server, filepath), "File was not uploaded or is corrupted");
+        }
+
+        VERIFY(server.getConnectionsCount() <= maxConnections, "Control connections were not reused");
+        VERIFY(server.getLoginsCount() <= maxConnections, "Login was repeated for the same connection");
+    }
+
+    // interrupted upload is resumed with SIZE and APPE
+    {
+        LocalFtpServer server;
+        VERIFY(server.start(), "Failed to start local ftp server");
+
+        const QString filepath = files.first();
+        const int fileSize = (int)QFileInfo(filepath).size();
+        VERIFY(fileSize > 2, "File for resume is too small");
+        server.failUploadOnce(QFileInfo(filepath).fileName(), fileSize / 2);
+
+        std::shared_ptr<Conectivity::UploadBatch> batch(new Conectivity::UploadBatch(createContext(server, 1),
+                                                                                     QStringList() << filepath));
+        Conectivity::CurlFtpUploader uploader(batch);
+
+        QSignalSpy failedSpy(&uploader, SIGNAL(transferFailed(QString, QString)));
+        QSignalSpy finishedSpy(&uploader, SIGNAL(uploadFinished(bool)));
+
+        uploader.uploadBatch();
+
+        VERIFY(finishedSpy.count() == 1, "Upload did not finish");
+        VERIFY(finishedSpy.at(0).at(0).toBool() == false, "Resumed upload finished with errors");
+        VERIFY(failedSpy.count() == 0, "Resumed file failed to upload");
+        VERIFY(server.getAppendsCount() == 1, "Upload was not resumed");
+        VERIFY(isUploaded(server, filepath), "Resumed file is corrupted");
+    }
+
+    return 0;
+}
@@ -0,0 +1,20 @@
+#ifndef PARALLELFTPUPLOADTEST_H
+#define PARALLELFTPUPLOADTEST_H
+
+#include "integrationtestbase.h"
+
+class ParallelFtpUploadTest : public IntegrationTestBase
+{
+public:
+    ParallelFtpUploadTest(Commands::CommandManager *commandManager):
+        IntegrationTestBase(commandManager)
+    {}
+
+    // IntegrationTestBase interface
+public:
+    virtual QString testName();
+    virtual void setup();
+    virtual int doTest();
+};
+
+#endif // PARALLELFTPUPLOADTEST_H
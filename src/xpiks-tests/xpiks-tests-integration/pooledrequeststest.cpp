@@ -0,0 +1,83 @@
+#include "pooledrequeststest.h"
+#include <QByteArray>
+#include <memory>
+#include <vector>
+#include "signalwaiter.h"
+#include "localhttpserver.h"
+#include "../../xpiks-qt/Conectivity/simplecurlrequest.h"
+#include "../../xpiks-qt/Conectivity/curlrequestsengine.h"
+
+#define SEQUENTIAL_REQUESTS_COUNT 5
+#define PARALLEL_REQUESTS_COUNT 10
+
+QString PooledRequestsTest::testName() {
+    return QLatin1String("PooledRequestsTest");
+}
+
+void PooledRequestsTest::setup() {
+}
+
+int PooledRequestsTest::doTest() {
+    QByteArray responseBody(100*1024, 'x');
+    responseBody.prepend("{\"data\":\"");
+    responseBody.append("\"}");
+
+    LocalHttpServer server(responseBody);
+    VERIFY(server.start(), "Failed to start local http server");
+
+    auto &engine = Conectivity::CurlRequestsEngine::getInstance();
+    const int handlesCountBefore = engine.getCreatedHandlesCount();
+
+    for (int i = 0; i < SEQUENTIAL_REQUESTS_COUNT; ++i) {
+        Conectivity::SimpleCurlRequest request(server.getUrl());
+        SignalWaiter waiter;
+        QObject::connect(&request, SIGNAL(requestFinished(bool)), &waiter, SIGNAL(finished()));
+
+        request.sendRequestAsync();
+
+        if (!waiter.wait(10)) {
+            VERIFY(false, "Timeout exceeded for request");
+        }
+
+        VERIFY(request.getErrorString().isEmpty(), "Request failed");
+        VERIFY(request.getResponseData() == responseBody, "Response data is corrupted");
+    }
+
+    VERIFY(server.getRequestsCount() == SEQUENTIAL_REQUESTS_COUNT, "Not all requests reached the server");
+    VERIFY(server.getConnectionsCount() == 1, "Connection was not reused between requests");
+    VERIFY(engine.getCreatedHandlesCount() - handlesCountBefore <= 1, "Easy handles are not pooled");
+
+    std::vector<std::unique_ptr<Conectivity::SimpleCurlRequest> > requests;
+    SignalWaiter allFinishedWaiter;
+    int finishedCount = 0, succeededCount = 0;
+
+    for (int i = 0; i < PARALLEL_REQUESTS_COUNT; ++i) {
+        requests.emplace_back(new Conectivity::SimpleCurlRequest(server.getUrl()));
+        // context object makes the lambda run in the main thread
+        QObject::connect(requests.back().get(), &Conectivity::SimpleCurlRequest::requestFinished, &allFinishedWaiter,
+                         [&](bool success) {
+            finishedCount++;
+            if (success) { succeededCount++; }
+            if (finishedCount == PARALLEL_REQUESTS_COUNT) { emit allFinishedWaiter.finished(); }
+        });
+    }
+
+    for (auto &request: requests) {
+        request->sendRequestAsync();
+    }
+
+    if (!allFinishedWaiter.wait(20)) {
+        VERIFY(false, "Timeout exceeded for parallel requests");
+    }
+
+    VERIFY(succeededCount == PARALLEL_REQUESTS_COUNT, "Some of parallel requests failed");
+
+    for (auto &request: requests) {
+        VERIFY(request->getResponseData() == responseBody, "Response data of parallel request is corrupted");
+    }
+
+    VERIFY(server.getRequestsCount() == SEQUENTIAL_REQUESTS_COUNT + PARALLEL_REQUESTS_COUNT, "Not all parallel requests reached the server");
+    VERIFY(engine.getCreatedHandlesCount() - handlesCountBefore <= PARALLEL_REQUESTS_COUNT, "Too many easy handles were created");
+
+    return 0;
+}
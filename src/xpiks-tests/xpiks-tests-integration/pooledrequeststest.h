@@ -0,0 +1,20 @@
+#ifndef POOLEDREQUESTSTEST_H
+#define POOLEDREQUESTSTEST_H
+
+#include "integrationtestbase.h"
+
+class PooledRequestsTest : public IntegrationTestBase
+{
+public:
+    PooledRequestsTest(Commands::CommandManager *commandManager):
+        IntegrationTestBase(commandManager)
+    {}
+
+    // IntegrationTestBase interface
+public:
+    virtual QString testName();
+    virtual void setup();
+    virtual int doTest();
+};
+
+#endif // POOLEDREQUESTSTEST_H
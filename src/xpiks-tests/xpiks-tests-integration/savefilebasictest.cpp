@@ -61,6 +61,11 @@ int SaveFileBasicTest::doTest() {
 
     VERIFY(!ioCoordinator->getHasErrors(), "Errors in IO Coordinator while writing");
 
+    if (!m_CommandManager->getSettingsModel()->getUseExifTool()) {
+        // exiv2 writing marks every written item as saved
+        VERIFY(!metadata->isModified(), "Written artwork was not marked as saved");
+    }
+
     artItemsModel->removeSelectedArtworks(QVector<int>() << 0);
 
     addedCount = artItemsModel->addLocalArtworks(files);
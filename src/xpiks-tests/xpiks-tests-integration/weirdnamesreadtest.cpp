@@ -32,8 +32,17 @@ int WeirdNamesReadTest::doTest() {
     SignalWaiter waiter;
     QObject::connect(ioCoordinator, SIGNAL(metadataReadingFinished()), &waiter, SIGNAL(finished()));
 
-    int addedCount = artItemsModel->addLocalDirectories(directories);
-    VERIFY(addedCount == FILES_IN_WEIRD_DIRECTORY, "Failed to add directory");
+    SignalWaiter scanWaiter;
+    QObject::connect(artItemsModel, SIGNAL(directoriesAdded(int)), &scanWaiter, SIGNAL(finished()));
+
+    int scannedCount = artItemsModel->addLocalDirectories(directories);
+    VERIFY(scannedCount == directories.length(), "Failed to scan directory");
+
+    if (!scanWaiter.wait(20)) {
+        VERIFY(false, "Timeout exceeded for scanning directories.");
+    }
+
+    VERIFY(artItemsModel->getArtworksCount() == FILES_IN_WEIRD_DIRECTORY, "Failed to add directory");
     ioCoordinator->continueReading(true);
 
     if (!waiter.wait(20)) {
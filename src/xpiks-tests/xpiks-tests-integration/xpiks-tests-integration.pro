@@ -3,7 +3,7 @@ TARGET = xpiks-tests-integration
 
 QMAKE_MAC_SDK = macosx10.11
 
-QT += qml quick widgets concurrent svg testlib
+QT += qml quick widgets concurrent svg testlib network
 QT -= gui
 
 CONFIG   += console
@@ -32,6 +32,7 @@ SOURCES += main.cpp \
     ../../xpiks-qt/Common/basickeywordsmodel.cpp \
     ../../xpiks-qt/Common/basicmetadatamodel.cpp \
     ../../xpiks-qt/Conectivity/conectivityhelpers.cpp \
+    ../../xpiks-qt/Conectivity/archivespipeline.cpp \
     ../../xpiks-qt/Conectivity/curlftpuploader.cpp \
     ../../xpiks-qt/Conectivity/ftpcoordinator.cpp \
     ../../xpiks-qt/Conectivity/ftphelpers.cpp \
@@ -59,14 +60,20 @@ SOURCES += main.cpp \
     ../../xpiks-qt/MetadataIO/metadataiocoordinator.cpp \
     ../../xpiks-qt/MetadataIO/metadatareadingworker.cpp \
     ../../xpiks-qt/MetadataIO/metadatawritingworker.cpp \
+    ../../xpiks-qt/MetadataIO/exiftoolprocess.cpp \
+    ../../xpiks-qt/MetadataIO/exiftoolworker.cpp \
+    ../../xpiks-qt/MetadataIO/exiftoolservice.cpp \
     ../../xpiks-qt/MetadataIO/saverworkerjobitem.cpp \
     ../../xpiks-qt/Models/artitemsmodel.cpp \
+    ../../xpiks-qt/Models/directoryscanner.cpp \
+    ../../xpiks-qt/Models/fileschangemonitor.cpp \
     ../../xpiks-qt/Models/artworkmetadata.cpp \
     ../../xpiks-qt/Models/artworksprocessor.cpp \
     ../../xpiks-qt/Models/artworksrepository.cpp \
     ../../xpiks-qt/Models/artworkuploader.cpp \
     ../../xpiks-qt/Models/combinedartworksmodel.cpp \
     ../../xpiks-qt/Models/filteredartitemsproxymodel.cpp \
+    ../../xpiks-qt/Models/artworkssearchindex.cpp \
     ../../xpiks-qt/Models/languagesmodel.cpp \
     ../../xpiks-qt/Models/logsmodel.cpp \
     ../../xpiks-qt/Models/recentitemsmodel.cpp \
@@ -86,11 +93,15 @@ SOURCES += main.cpp \
     ../../xpiks-qt/SpellCheck/spellcheckiteminfo.cpp \
     ../../xpiks-qt/SpellCheck/spellchecksuggestionmodel.cpp \
     ../../xpiks-qt/SpellCheck/spellcheckworker.cpp \
+    ../../xpiks-qt/SpellCheck/suggestionscache.cpp \
+    ../../xpiks-qt/SpellCheck/suggestionsworker.cpp \
     ../../xpiks-qt/SpellCheck/spellsuggestionsitem.cpp \
     ../../xpiks-qt/Suggestion/keywordssuggestor.cpp \
     ../../xpiks-qt/Suggestion/libraryloaderworker.cpp \
     ../../xpiks-qt/Suggestion/libraryqueryworker.cpp \
     ../../xpiks-qt/Suggestion/locallibrary.cpp \
+    ../../xpiks-qt/Suggestion/locallibraryindex.cpp \
+    ../../xpiks-qt/Suggestion/librarystorage.cpp \
     ../../xpiks-qt/UndoRedo/addartworksitem.cpp \
     ../../xpiks-qt/UndoRedo/artworkmetadatabackup.cpp \
     ../../xpiks-qt/UndoRedo/modifyartworkshistoryitem.cpp \
@@ -127,13 +138,17 @@ SOURCES += main.cpp \
     undoaddwithvectorstest.cpp \
     ../../xpiks-qt/MetadataIO/exiv2readingworker.cpp \
     ../../xpiks-qt/MetadataIO/readingorchestrator.cpp \
+    ../../xpiks-qt/MetadataIO/backupslookup.cpp \
     ../../xpiks-qt/MetadataIO/exiv2writingworker.cpp \
     ../../xpiks-qt/MetadataIO/writingorchestrator.cpp \
     ../../xpiks-qt/Common/flags.cpp \
     readlegacysavedtest.cpp \
     ../../xpiks-qt/QMLExtensions/imagecachingservice.cpp \
     ../../xpiks-qt/QMLExtensions/imagecachingworker.cpp \
+    ../../xpiks-qt/QMLExtensions/imagecacheindex.cpp \
     ../../xpiks-qt/QMLExtensions/cachingimageprovider.cpp \
+    ../../xpiks-qt/QMLExtensions/asynccachingimageprovider.cpp \
+    ../../xpiks-qt/QMLExtensions/decodedimagecache.cpp \
     clearmetadatatest.cpp \
     savewithemptytitletest.cpp \
     jsonmerge_tests.cpp \
@@ -151,6 +166,7 @@ SOURCES += main.cpp \
     removefromuserdictionarytest.cpp \
     testshelpers.cpp \
     ../../xpiks-qt/Conectivity/simplecurlrequest.cpp \
+    ../../xpiks-qt/Conectivity/curlrequestsengine.cpp \
     ../../xpiks-qt/Conectivity/simplecurldownloader.cpp \
     ../../xpiks-qt/Conectivity/curlinithelper.cpp \
     artworkuploaderbasictest.cpp \
@@ -178,6 +194,9 @@ SOURCES += main.cpp \
     ../../xpiks-qt/SpellCheck/userdicteditmodel.cpp \
     userdictedittest.cpp \
     weirdnamesreadtest.cpp \
+    pooledrequeststest.cpp \
+    parallelftpuploadtest.cpp \
+    asyncpreviewstest.cpp \
     ../../xpiks-qt/QMLExtensions/tabsmodel.cpp
 
 RESOURCES +=
@@ -206,6 +225,7 @@ HEADERS += \
     ../../xpiks-qt/Common/ibasicartwork.h \
     ../../xpiks-qt/Common/iservicebase.h \
     ../../xpiks-qt/Common/itemprocessingworker.h \
+    ../../xpiks-qt/Common/sharedworkqueue.h \
     ../../xpiks-qt/Common/version.h \
     ../../xpiks-qt/Conectivity/analyticsuserevent.h \
     ../../xpiks-qt/Conectivity/conectivityhelpers.h \
@@ -214,6 +234,7 @@ HEADERS += \
     ../../xpiks-qt/Conectivity/ftphelpers.h \
     ../../xpiks-qt/Conectivity/ftpuploaderworker.h \
     ../../xpiks-qt/Conectivity/iftpcoordinator.h \
+    ../../xpiks-qt/Conectivity/archivespipeline.h \
     ../../xpiks-qt/Conectivity/telemetryservice.h \
     ../../xpiks-qt/Conectivity/testconnection.h \
     ../../xpiks-qt/Conectivity/updatescheckerworker.h \
@@ -241,10 +262,16 @@ HEADERS += \
     ../../xpiks-qt/MetadataIO/metadataiocoordinator.h \
     ../../xpiks-qt/MetadataIO/metadatareadingworker.h \
     ../../xpiks-qt/MetadataIO/metadatawritingworker.h \
+    ../../xpiks-qt/MetadataIO/exiftoolprocess.h \
+    ../../xpiks-qt/MetadataIO/exiftoolworker.h \
+    ../../xpiks-qt/MetadataIO/exiftoolservice.h \
+    ../../xpiks-qt/MetadataIO/exiftooljob.h \
     ../../xpiks-qt/MetadataIO/saverworkerjobitem.h \
     ../../xpiks-qt/Common/abstractlistmodel.h \
     ../../xpiks-qt/Models/metadataelement.h \
     ../../xpiks-qt/Models/artitemsmodel.h \
+    ../../xpiks-qt/Models/directoryscanner.h \
+    ../../xpiks-qt/Models/fileschangemonitor.h \
     ../../xpiks-qt/Models/artworkmetadata.h \
     ../../xpiks-qt/Models/artworksprocessor.h \
     ../../xpiks-qt/Models/artworksrepository.h \
@@ -252,6 +279,7 @@ HEADERS += \
     ../../xpiks-qt/Models/combinedartworksmodel.h \
     ../../xpiks-qt/Models/exportinfo.h \
     ../../xpiks-qt/Models/filteredartitemsproxymodel.h \
+    ../../xpiks-qt/Models/artworkssearchindex.h \
     ../../xpiks-qt/Models/languagesmodel.h \
     ../../xpiks-qt/Models/logsmodel.h \
     ../../xpiks-qt/Models/recentitemsmodel.h \
@@ -275,11 +303,15 @@ HEADERS += \
     ../../xpiks-qt/SpellCheck/spellcheckiteminfo.h \
     ../../xpiks-qt/SpellCheck/spellchecksuggestionmodel.h \
     ../../xpiks-qt/SpellCheck/spellcheckworker.h \
+    ../../xpiks-qt/SpellCheck/suggestionscache.h \
+    ../../xpiks-qt/SpellCheck/suggestionsworker.h \
     ../../xpiks-qt/SpellCheck/spellsuggestionsitem.h \
     ../../xpiks-qt/Suggestion/keywordssuggestor.h \
     ../../xpiks-qt/Suggestion/libraryloaderworker.h \
     ../../xpiks-qt/Suggestion/libraryqueryworker.h \
     ../../xpiks-qt/Suggestion/locallibrary.h \
+    ../../xpiks-qt/Suggestion/locallibraryindex.h \
+    ../../xpiks-qt/Suggestion/librarystorage.h \
     ../../xpiks-qt/Suggestion/suggestionartwork.h \
     ../../xpiks-qt/UndoRedo/addartworksitem.h \
     ../../xpiks-qt/UndoRedo/artworkmetadatabackup.h \
@@ -327,6 +359,7 @@ HEADERS += \
     ../../xpiks-qt/MetadataIO/imetadatareader.h \
     ../../xpiks-qt/MetadataIO/importdataresult.h \
     ../../xpiks-qt/MetadataIO/readingorchestrator.h \
+    ../../xpiks-qt/MetadataIO/backupslookup.h \
     ../../xpiks-qt/MetadataIO/exiv2writingworker.h \
     ../../xpiks-qt/MetadataIO/imetadatawriter.h \
     ../../xpiks-qt/MetadataIO/exiv2tagnames.h \
@@ -335,7 +368,10 @@ HEADERS += \
     ../../xpiks-qt/QMLExtensions/imagecacherequest.h \
     ../../xpiks-qt/QMLExtensions/imagecachingservice.h \
     ../../xpiks-qt/QMLExtensions/imagecachingworker.h \
+    ../../xpiks-qt/QMLExtensions/imagecacheindex.h \
     ../../xpiks-qt/QMLExtensions/cachingimageprovider.h \
+    ../../xpiks-qt/QMLExtensions/asynccachingimageprovider.h \
+    ../../xpiks-qt/QMLExtensions/decodedimagecache.h \
     clearmetadatatest.h \
     savewithemptytitletest.h \
     spellingproduceswarningstest.h \
@@ -356,6 +392,7 @@ HEADERS += \
     removefromuserdictionarytest.h \
     testshelpers.h \
     ../../xpiks-qt/Conectivity/simplecurlrequest.h \
+    ../../xpiks-qt/Conectivity/curlrequestsengine.h \
     ../../xpiks-qt/Conectivity/simplecurldownloader.h \
     ../../xpiks-qt/Conectivity/curlinithelper.h \
     artworkuploaderbasictest.h \
@@ -387,6 +424,11 @@ HEADERS += \
     ../../xpiks-qt/SpellCheck/userdicteditmodel.h \
     userdictedittest.h \
     weirdnamesreadtest.h \
+    pooledrequeststest.h \
+    localhttpserver.h \
+    localftpserver.h \
+    parallelftpuploadtest.h \
+    asyncpreviewstest.h \
     ../../xpiks-qt/QMLExtensions/tabsmodel.h
 
 INCLUDEPATH += ../../../vendors/tiny-aes
@@ -12,6 +12,8 @@
 #include "../../xpiks-qt/Models/filteredartitemsproxymodel.h"
 #include "../../xpiks-qt/Models/ziparchiver.h"
 #include "../../xpiks-qt/Helpers/filenameshelpers.h"
+#include <quazip/quazip.h>
+#include <quazip/quazipfileinfo.h>
 
 QString ZipArtworksTest::testName() {
     return QLatin1String("ZipArtworksTest");
@@ -49,6 +51,7 @@ int ZipArtworksTest::doTest() {
     Models::ZipArchiver *zipArchiver = m_CommandManager->getZipArchiver();
 
     QObject::connect(zipArchiver, SIGNAL(finishedProcessing()), &waiter, SIGNAL(finished()));
+    QSignalSpy archiveReadySpy(zipArchiver, SIGNAL(archiveReady(QString)));
 
     zipArchiver->archiveArtworks();
 
@@ -57,12 +60,27 @@ int ZipArtworksTest::doTest() {
     }
 
     VERIFY(!zipArchiver->getIsError(), "Errors while zipping");
+    VERIFY(archiveReadySpy.count() == files.length(), "Not every archive was reported");
 
     for (int i = 0; i < files.length(); ++i) {
         Models::ArtworkMetadata *metadata = artItemsModel->getArtwork(i);
         QString zipPath = Helpers::getArchivePath(metadata->getFilepath());
 
         VERIFY(QFileInfo(zipPath).exists(), "Zip file not found");
+
+        QuaZip zip(zipPath);
+        VERIFY(zip.open(QuaZip::mdUnzip), "Failed to open zip file");
+
+        QList<QuaZipFileInfo64> entries = zip.getFileInfoList64();
+        VERIFY(entries.length() == 2, "Zip file should contain image and vector");
+
+        for (auto &entry: entries) {
+            const bool isJpeg = entry.name.endsWith(".jpg", Qt::CaseInsensitive);
+            // jpegs are stored as is and vectors are deflated
+            VERIFY((entry.method == 0) == isJpeg, "Wrong compression method in zip file");
+        }
+
+        zip.close();
     }
 
     return 0;